@@ -20,6 +20,7 @@
 #define CHARACTER_HPP
 
 #include "Attribute.hpp"
+#include "CharacterHandles.hpp"
 #include "Item.hpp"
 #include "ItemLookAt.hpp"
 #include "Language.hpp"
@@ -136,6 +137,7 @@ public:
     };
 
     virtual auto getId() const -> TYPE_OF_CHARACTER_ID;
+    [[nodiscard]] auto getHandle() const -> CharacterHandle { return handle; }
     auto getName() const -> const std::string &;
     virtual auto to_string() const -> std::string = 0;
 
@@ -489,7 +491,10 @@ protected:
     appearance _appearance;
 
 private:
+    friend class CharacterHandles;
+
     TYPE_OF_CHARACTER_ID id = 0;
+    CharacterHandle handle;
     std::string name;
     movement_type _movement = movement_type::walk;
     std::vector<Attribute> attributes;
@@ -23,25 +23,28 @@
 #include "Player.hpp"
 #include "globals.hpp"
 
-#include <cmath>
-#include <map>
-#include <range/v3/all.hpp>
+#include <algorithm>
 #include <unordered_map>
 
-template <class T> auto CharacterContainer<T>::getPosition(TYPE_OF_CHARACTER_ID id, position &pos) -> bool {
-    auto i = container.find(id);
-    if (i != container.end()) {
-        pos = (i->second)->getPosition();
-        return true;
-    }
-    return false;
+template <class T> void CharacterContainer<T>::addToGrid(const position &pos, pointer p) {
+    grid[cellOf(pos)].push_back({pos, p});
 }
 
-template <class T>
-auto CharacterContainer<T>::projection_x_axis(const position &pos, int r) const
-        -> iterator_range<typename CharacterContainer<T>::position_to_id_type::const_iterator> {
-    return {{position_to_id.upper_bound(position(pos.x - r - 1, 0, 0)),
-             position_to_id.upper_bound(position(pos.x + r + 1, 0, 0))}};
+template <class T> void CharacterContainer<T>::removeFromGrid(const position &pos, pointer p) {
+    const auto cell = grid.find(cellOf(pos));
+
+    if (cell == grid.end()) {
+        return;
+    }
+
+    auto &characters = cell->second;
+    const auto it = std::find_if(characters.begin(), characters.end(),
+                                 [p](const located_type &located) { return located.character == p; });
+
+    if (it != characters.end()) {
+        *it = characters.back();
+        characters.pop_back();
+    }
 }
 
 template <class T> auto CharacterContainer<T>::find(const std::string &name) const -> pointer {
@@ -51,13 +54,12 @@ template <class T> auto CharacterContainer<T>::find(const std::string &name) con
         return find(id);
     }
 
-    using namespace ranges;
-    auto namesMatch = [&name](pointer character) { return comparestrings_nocase(character->getName(), name); };
-    auto characters = container | view::values;
-    auto result = find_if(characters, namesMatch);
+    for (const auto &key_value : container) {
+        auto *character = key_value.second.character;
 
-    if (result != characters.end()) {
-        return *result;
+        if (comparestrings_nocase(character->getName(), name)) {
+            return character;
+        }
     }
 
     return nullptr;
@@ -67,97 +69,74 @@ template <class T> auto CharacterContainer<T>::find(TYPE_OF_CHARACTER_ID id) con
     const auto it = container.find(id);
 
     if (it != container.end()) {
-        return it->second;
+        return it->second.character;
     }
 
     return nullptr;
 }
 
 template <class T> auto CharacterContainer<T>::find(const position &pos) const -> pointer {
-    const auto i = position_to_id.find(pos);
+    const auto cell = grid.find(cellOf(pos));
 
-    if (i != position_to_id.end()) {
-        return find(i->second);
+    if (cell != grid.end()) {
+        for (const auto &located : cell->second) {
+            if (located.pos == pos) {
+                return located.character;
+            }
+        }
     }
+
     return nullptr;
 }
 
 template <class T> void CharacterContainer<T>::update(pointer p, const position &newPosition) {
-    const auto id = p->getId();
+    const auto it = container.find(p->getId());
 
-    if (!find(id)) {
+    if (it == container.end()) {
         return;
     }
 
-    const auto &oldPosition = p->getPosition();
-    const auto range = position_to_id.equal_range(oldPosition);
+    auto &oldPosition = it->second.pos;
 
-    for (auto it = range.first; it != range.second; ++it) {
-        if (it->second == id) {
-            position_to_id.erase(it);
-            position_to_id.insert(std::make_pair(newPosition, id));
-            return;
+    if (cellOf(oldPosition) == cellOf(newPosition)) {
+        for (auto &located : grid[cellOf(newPosition)]) {
+            if (located.character == p) {
+                located.pos = newPosition;
+                break;
+            }
         }
+    } else {
+        removeFromGrid(oldPosition, p);
+        addToGrid(newPosition, p);
     }
+
+    oldPosition = newPosition;
 }
 
 template <class T> auto CharacterContainer<T>::erase(TYPE_OF_CHARACTER_ID id) -> bool {
-    position pos{};
-
-    if (getPosition(id, pos)) {
-        const auto range = position_to_id.equal_range(pos);
+    const auto it = container.find(id);
 
-        for (auto it = range.first; it != range.second; ++it) {
-            if (it->second == id) {
-                position_to_id.erase(it);
-                break;
-            }
-        }
+    if (it == container.end()) {
+        return false;
     }
 
-    return container.erase(id) > 0;
+    removeFromGrid(it->second.pos, it->second.character);
+    container.erase(it);
+    return true;
 }
 
 template <class T>
 auto CharacterContainer<T>::findAllCharactersInRangeOf(const position &pos, const Range &range) const
         -> std::vector<pointer> {
     std::vector<pointer> temp;
-    auto candidates = projection_x_axis(pos, range.radius);
-
-    for (auto &c : candidates) {
-        const position &p = c.first;
-        TYPE_OF_CHARACTER_ID id = c.second;
-        short int dx = p.x - pos.x;
-        short int dy = p.y - pos.y;
-        short int dz = p.z - pos.z;
-
-        if (std::abs(dx) <= range.radius && std::abs(dy) <= range.radius && -range.zRadius <= dz &&
-            dz <= range.zRadius) {
-            if (auto *character = find(id)) {
-                temp.push_back(character);
-            }
-        }
-    }
-
+    forEachCharacterInRangeOf(pos, range, [&temp](pointer character) { temp.push_back(character); });
     return temp;
 }
 
 template <class T>
 auto CharacterContainer<T>::findAllCharactersInScreen(const position &pos) const -> std::vector<pointer> {
     std::vector<pointer> temp;
-    const int MAX_SCREEN_RANGE = 30;
-    auto candidates = projection_x_axis(pos, MAX_SCREEN_RANGE);
-
-    for (auto &c : candidates) {
-        TYPE_OF_CHARACTER_ID id = c.second;
-
-        if (auto *character = find(id)) {
-            if (character->isInScreen(pos)) {
-                temp.push_back(character);
-            }
-        }
-    }
-
+    forEachCharacterInScreen(pos, [&temp](pointer character) { temp.push_back(character); });
     return temp;
 }
 
@@ -165,24 +144,12 @@ template <class T>
 auto CharacterContainer<T>::findAllAliveCharactersInRangeOf(const position &pos, const Range &range) const
         -> std::vector<pointer> {
     std::vector<pointer> temp;
-    auto candidates = projection_x_axis(pos, range.radius);
-
-    for (auto &c : candidates) {
-        const position &p = c.first;
-        TYPE_OF_CHARACTER_ID id = c.second;
-        short int dx = p.x - pos.x;
-        short int dy = p.y - pos.y;
-        short int dz = p.z - pos.z;
-
-        if (std::abs(dx) <= range.radius && std::abs(dy) <= range.radius && -range.zRadius <= dz &&
-            dz <= range.zRadius) {
-            if (auto *character = find(id)) {
-                if (character->isAlive()) {
-                    temp.push_back(character);
-                }
-            }
+
+    forEachCharacterInRangeOf(pos, range, [&temp](pointer character) {
+        if (character->isAlive()) {
+            temp.push_back(character);
         }
-    }
+    });
 
     return temp;
 }
@@ -23,6 +23,7 @@
 #include "globals.hpp"
 #include "utility.hpp"
 
+#include <cstdlib>
 #include <functional>
 #include <string>
 #include <unordered_map>
@@ -35,14 +36,53 @@ public:
 private:
     using for_each_type = std::function<void(pointer)>;
     using for_each_member_type = void (T::*)();
-    using container_type = std::unordered_map<TYPE_OF_CHARACTER_ID, pointer>;
-    using position_to_id_type = std::multimap<position, TYPE_OF_CHARACTER_ID, PositionComparison>;
-    position_to_id_type position_to_id;
+
+    struct located_type {
+        position pos;
+        pointer character;
+    };
+
+    // characters are bucketed into square cells per level, about the size of a
+    // screen, so that range queries only look at the few cells around a position
+    static constexpr Coordinate cellBits = 5;
+    static constexpr Coordinate maxScreenRange = 30;
+    using cell_type = std::vector<located_type>;
+    using grid_type = std::unordered_map<position, cell_type>;
+    using container_type = std::unordered_map<TYPE_OF_CHARACTER_ID, located_type>;
+    grid_type grid;
     container_type container;
 
-    auto getPosition(TYPE_OF_CHARACTER_ID id, position &pos) -> bool;
-    [[nodiscard]] auto projection_x_axis(const position &pos, int r) const
-            -> iterator_range<position_to_id_type::const_iterator>;
+    [[nodiscard]] static auto cellOf(const position &pos) -> position {
+        return {Coordinate(pos.x >> cellBits), Coordinate(pos.y >> cellBits), pos.z};
+    }
+
+    void addToGrid(const position &pos, pointer p);
+    void removeFromGrid(const position &pos, pointer p);
+
+    template <class Visitor>
+    void forEachLocatedInBox(const position &pos, Coordinate radius, Coordinate zBelow, Coordinate zAbove,
+                             const Visitor &visitor) const {
+        const auto minCell = cellOf(position(pos.x - radius, pos.y - radius, 0));
+        const auto maxCell = cellOf(position(pos.x + radius, pos.y + radius, 0));
+
+        for (Coordinate z = pos.z - zBelow; z <= pos.z + zAbove; ++z) {
+            for (Coordinate y = minCell.y; y <= maxCell.y; ++y) {
+                for (Coordinate x = minCell.x; x <= maxCell.x; ++x) {
+                    const auto cell = grid.find(position(x, y, z));
+
+                    if (cell == grid.end()) {
+                        continue;
+                    }
+
+                    for (const auto &located : cell->second) {
+                        if (std::abs(located.pos.x - pos.x) <= radius && std::abs(located.pos.y - pos.y) <= radius) {
+                            visitor(located);
+                        }
+                    }
+                }
+            }
+        }
+    }
 
 public:
     [[nodiscard]] auto empty() const -> bool { return container.empty(); }
@@ -53,8 +93,9 @@ public:
         const auto id = p->getId();
 
         if (!find(id)) {
-            container.emplace(id, p);
-            position_to_id.insert(std::make_pair(p->getPosition(), id));
+            const auto &pos = p->getPosition();
+            container.emplace(id, located_type{pos, p});
+            addToGrid(pos, p);
         }
     }
 
@@ -65,7 +106,23 @@ public:
     auto erase(TYPE_OF_CHARACTER_ID id) -> bool;
     void clear() {
         container.clear();
-        position_to_id.clear();
+        grid.clear();
+    }
+
+    // calls visitor(pointer) for every character in range, without building a
+    // result; the visitor must not move, add or remove characters of this container
+    template <class Visitor>
+    void forEachCharacterInRangeOf(const position &pos, const Range &range, const Visitor &visitor) const {
+        forEachLocatedInBox(pos, range.radius, range.zRadius, range.zRadius,
+                            [&visitor](const located_type &located) { visitor(located.character); });
+    }
+
+    template <class Visitor> void forEachCharacterInScreen(const position &pos, const Visitor &visitor) const {
+        forEachLocatedInBox(pos, maxScreenRange, RANGEUP, RANGEUP, [&pos, &visitor](const located_type &located) {
+            if (located.character->isInScreen(pos)) {
+                visitor(located.character);
+            }
+        });
     }
 
     auto findAllCharactersInRangeOf(const position &pos, const Range &range) const -> std::vector<pointer>;
@@ -74,13 +131,13 @@ public:
 
     void for_each(const for_each_type &function) const {
         for (const auto &key_value : container) {
-            function(key_value.second);
+            function(key_value.second.character);
         }
     }
 
     void for_each(const for_each_member_type &function) const {
         for (const auto &key_value : container) {
-            (key_value.second->*function)();
+            (key_value.second.character->*function)();
         }
     }
 };
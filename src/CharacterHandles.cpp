@@ -0,0 +1,55 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "CharacterHandles.hpp"
+
+#include "Character.hpp"
+
+void CharacterHandles::add(Character *character) {
+    if (get(character->handle) == character) {
+        return;
+    }
+
+    uint32_t index = 0;
+
+    if (freeSlots.empty()) {
+        index = slots.size();
+        slots.emplace_back();
+    } else {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    auto &slot = slots[index];
+    slot.character = character;
+    character->handle = {index, slot.generation};
+}
+
+void CharacterHandles::remove(Character *character) {
+    const auto handle = character->handle;
+
+    if (get(handle) != character) {
+        return;
+    }
+
+    auto &slot = slots[handle.index];
+    slot.character = nullptr;
+    ++slot.generation;
+    freeSlots.push_back(handle.index);
+    character->handle = {};
+}
@@ -0,0 +1,68 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CHARACTER_HANDLES_HPP
+#define CHARACTER_HANDLES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Character;
+
+// refers to a character in the world, turns stale when the character leaves it
+struct CharacterHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0; // never issued, so a default handle is stale
+};
+
+/**
+ * Slot map of all characters in the world. A handle resolves with one index
+ * and one generation compare. Whenever a character leaves the world, its slot
+ * moves to the next generation, so handles to it no longer resolve, even after
+ * the slot has been reused or the character has come back.
+ * Only to be used from the game loop.
+ */
+class CharacterHandles {
+public:
+    // sets the handle of the character, does nothing if it is already in the world
+    void add(Character *character);
+    // makes all handles to the character stale, does nothing if it is not in the world
+    void remove(Character *character);
+
+    [[nodiscard]] auto get(CharacterHandle handle) const -> Character * {
+        if (handle.index < slots.size() && slots[handle.index].generation == handle.generation) {
+            return slots[handle.index].character;
+        }
+
+        return nullptr;
+    }
+
+    [[nodiscard]] auto size() const -> size_t { return slots.size() - freeSlots.size(); }
+
+private:
+    struct Slot {
+        Character *character = nullptr;
+        uint32_t generation = 1;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+};
+
+#endif
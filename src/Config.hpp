@@ -84,18 +84,38 @@ public:
     const ConfigEntry<std::string> scriptdir{"scriptdir", "./script/"};
 
     const ConfigEntry<uint16_t> port{"port", 3012};
+    // threads handling the network I/O of all connections, 0 for one per core
+    const ConfigEntry<uint16_t> network_threads{"network_threads", 0};
 
     const ConfigEntry<std::string> postgres_db{"postgres_db", "illarion"};
     const ConfigEntry<std::string> postgres_user{"postgres_user", "illarion"};
     const ConfigEntry<std::string> postgres_pwd{"postgres_pwd", "illarion"};
     const ConfigEntry<std::string> postgres_host{"postgres_host", "/var/run/postgresql"};
     const ConfigEntry<uint16_t> postgres_port{"postgres_port", 5432};
+    const ConfigEntry<uint16_t> postgres_max_connections{"postgres_max_connections", 8};
     const ConfigEntry<std::string> postgres_schema_server{"postgres_schema_server", "server"};
     const ConfigEntry<std::string> postgres_schema_account{"postgres_schema_account", "accounts"};
 
     const ConfigEntry<int16_t> debug{"debug", 0};
 
+    // measure the scheduled tasks from the start, it can be switched with !taskstats as well
+    const ConfigEntry<int16_t> scheduler_profiling{"scheduler_profiling", 0};
+    // milliseconds a round of scheduled tasks may take before it counts as overrun
+    const ConfigEntry<uint16_t> scheduler_tick_budget{"scheduler_tick_budget", 100};
+
+    // a Lua entrypoint call is aborted after so many instructions or milliseconds, 0 for no limit;
+    // this includes server.reload and the startup scripts, so leave room for them
+    const ConfigEntry<uint32_t> lua_instruction_budget{"lua_instruction_budget", 0};
+    const ConfigEntry<uint32_t> lua_time_budget{"lua_time_budget", 0};
+    // pause and step multiplier of the Lua garbage collector, as in collectgarbage
+    const ConfigEntry<uint16_t> lua_gc_pause{"lua_gc_pause", 200};
+    const ConfigEntry<uint16_t> lua_gc_stepmul{"lua_gc_stepmul", 200};
+    // microseconds the Lua garbage collector may take when the game loop is idle
+    const ConfigEntry<uint16_t> lua_gc_idle_budget{"lua_gc_idle_budget", 2000};
+
     const ConfigEntry<uint16_t> clientversion{"clientversion", 122};
+    // clients with this version are accepted as well and get batched, compact map stripes, 0 to disable
+    const ConfigEntry<uint16_t> mapstripesclientversion{"mapstripesclientversion", 0};
     const ConfigEntry<int16_t> playerstart_x{"playerstart_x", 0};
     const ConfigEntry<int16_t> playerstart_y{"playerstart_y", 0};
     const ConfigEntry<int16_t> playerstart_z{"playerstart_z", 0};
@@ -22,8 +22,10 @@
 #include "Logger.hpp"
 #include "netinterface/NetInterface.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <thread>
+#include <vector>
 
 auto InitialConnection::create() -> std::shared_ptr<InitialConnection> {
     std::shared_ptr<InitialConnection> ptr(new InitialConnection());
@@ -47,20 +49,54 @@ void InitialConnection::run_service() {
                                [shared_this = shared_from_this(), newConnection](auto &&PH1) {
                                    shared_this->accept_connection(newConnection, PH1);
                                });
-        Logger::info(LogFacility::Other) << "Starting the io service." << Log::end;
-        io_service.run();
     } catch (const boost::system::system_error &e) {
         Logger::critical(LogFacility::Other) << "Failed to start io service: " << e.what() << Log::end;
         std::exit(EXIT_FAILURE);
     }
+
+    unsigned int threadCount = Config::instance().network_threads;
+
+    if (threadCount == 0) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    Logger::info(LogFacility::Other) << "Starting the io service with " << threadCount << " threads." << Log::end;
+
+    // reads, decoding and writes of all connections are spread over these threads,
+    // the handlers of each connection are serialised by its strand
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 1; i < threadCount; ++i) {
+        threads.emplace_back([this] { run_io_service(); });
+    }
+
+    run_io_service();
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void InitialConnection::run_io_service() {
+    while (true) {
+        try {
+            io_service.run();
+            return;
+        } catch (std::exception &e) {
+            Logger::error(LogFacility::Other) << "Exception in io service: " << e.what() << Log::end;
+        }
+    }
 }
 
 void InitialConnection::accept_connection(const std::shared_ptr<NetInterface> &connection,
                                           const boost::system::error_code &error) {
     if (!error) {
-        if (connection->activate()) {
-            newPlayers.push_back(connection);
-        } else {
+        // the connection is queued for the login threads once its login command arrived
+        connection->setLoginHandler([shared_this = shared_from_this()](const auto &loggingIn) {
+            shared_this->newPlayers.push_back(loggingIn);
+        });
+
+        if (!connection->activate()) {
             Logger::error(LogFacility::Other) << "Error while activating connection!" << Log::end;
         }
 
@@ -42,6 +42,7 @@ public:
 private:
     InitialConnection() = default;
     void run_service();
+    void run_io_service();
 
     boost::asio::io_service io_service;
     std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor = nullptr;
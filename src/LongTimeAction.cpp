@@ -34,6 +34,9 @@
 
 LongTimeAction::LongTimeAction(Player *player, World *world) : _owner(player), _world(world) {}
 
+// players are deleted away from the game loop, so pending tasks must not find them afterwards
+LongTimeAction::~LongTimeAction() { cancelTasks(); }
+
 void LongTimeAction::setLastAction(std::shared_ptr<LuaScript> script, const SouTar &srce, const SouTar &trgt,
                                    ActionType at) {
     _script = std::move(script);
@@ -51,26 +54,6 @@ void LongTimeAction::setLastAction(std::shared_ptr<LuaScript> script, const SouT
     }
 }
 
-auto LongTimeAction::checkAction() -> bool {
-    if (_actionrunning) {
-        // check if timetowaittimer is initialized and if we hit the next time
-        if (_timetowaitTimer && _timetowaitTimer->intervalExceeded()) {
-            successAction();
-            return true;
-        }
-
-        if ((_redoaniTimer) && (_redoaniTimer->intervalExceeded()) && (_ani != 0)) {
-            _world->gfx(_ani, _owner->getPosition());
-        }
-
-        if ((_redosoundTimer) && (_redosoundTimer->intervalExceeded()) && (_sound != 0)) {
-            _world->makeSound(_sound, _owner->getPosition());
-        }
-    }
-
-    return false;
-}
-
 void LongTimeAction::startLongTimeAction(unsigned short int timetowait, unsigned short int ani,
                                          unsigned short int redoani, unsigned short int sound,
                                          unsigned short int redosound) {
@@ -80,30 +63,27 @@ void LongTimeAction::startLongTimeAction(unsigned short int timetowait, unsigned
     constexpr auto dsToMsFactor = 100;
     using std::chrono::milliseconds;
 
-    _timetowaitTimer = std::make_unique<Timer>(milliseconds(timetowait * dsToMsFactor));
-
-    if (_redoaniTimer) {
-        _redoaniTimer.reset();
-    }
+    cancelTasks();
+    auto &scheduler = _world->scheduler;
+    _successTask = scheduler.addOneshotTask(whileOwnerOnline(&LongTimeAction::successAction),
+                                            milliseconds(timetowait * dsToMsFactor), "long_time_action");
 
     if (_ani != 0 && redoani != 0) {
-        _redoaniTimer = std::make_unique<Timer>(milliseconds(redoani * dsToMsFactor));
-    }
-
-    if (_redosoundTimer) {
-        _redosoundTimer.reset();
+        _animationTask = scheduler.addRecurringTask(whileOwnerOnline(&LongTimeAction::showAnimation),
+                                                    milliseconds(redoani * dsToMsFactor), "long_time_action_animation");
     }
 
     if (_sound != 0 && redosound != 0) {
-        _redosoundTimer = std::make_unique<Timer>(milliseconds(redosound * dsToMsFactor));
+        _soundTask = scheduler.addRecurringTask(whileOwnerOnline(&LongTimeAction::playSound),
+                                                milliseconds(redosound * dsToMsFactor), "long_time_action_sound");
     }
 
     if (_sound != 0) {
-        _world->makeSound(_sound, _owner->getPosition());
+        playSound();
     }
 
     if (_ani != 0) {
-        _world->gfx(_ani, _owner->getPosition());
+        showAnimation();
     }
 }
 
@@ -115,6 +95,7 @@ auto LongTimeAction::actionDisturbed(Character *disturber) -> bool {
         if (_at == ACTION_CRAFT) {
             if (_source.Type == LUA_DIALOG) {
                 _actionrunning = false;
+                cancelTasks();
                 _owner->executeCraftingDialogCraftingAborted(_source.dialog);
             }
         } else if (_script) {
@@ -165,6 +146,7 @@ auto LongTimeAction::actionDisturbed(Character *disturber) -> bool {
 
         } else {
             _actionrunning = false;
+            cancelTasks();
         }
     }
 
@@ -240,9 +222,7 @@ void LongTimeAction::abortAction() {
 
     _actionrunning = false;
     _script.reset();
-    _redoaniTimer.reset();
-    _redosoundTimer.reset();
-    _timetowaitTimer.reset();
+    cancelTasks();
     _ani = 0;
     _sound = 0;
 }
@@ -257,6 +237,12 @@ void LongTimeAction::successAction() {
         if (_at == ACTION_CRAFT) {
             if (_source.Type == LUA_DIALOG) {
                 _owner->executeCraftingDialogCraftingComplete(_source.dialog);
+
+                // unless crafting goes on with the next action
+                if (!_actionrunning) {
+                    cancelTasks();
+                }
+
                 return;
             }
         } else if (_script) {
@@ -318,9 +304,7 @@ void LongTimeAction::successAction() {
 
     if (!_actionrunning) {
         _script.reset();
-        _redoaniTimer.reset();
-        _redosoundTimer.reset();
-        _timetowaitTimer.reset();
+        cancelTasks();
         _ani = 0;
         _sound = 0;
     }
@@ -435,3 +419,23 @@ void LongTimeAction::changeTarget(position pos) {
 }
 
 void LongTimeAction::changeTarget() { _target.Type = LUA_NONE; }
+
+void LongTimeAction::showAnimation() { _world->gfx(_ani, _owner->getPosition()); }
+
+void LongTimeAction::playSound() { _world->makeSound(_sound, _owner->getPosition()); }
+
+auto LongTimeAction::whileOwnerOnline(void (LongTimeAction::*action)()) const -> std::function<void()> {
+    // nothing of the owner is touched before it is known to be still around
+    return [world = _world, owner = _owner, id = _owner->getId(), action] {
+        if (world->Players.find(id) == owner && owner->Connection->online) {
+            (owner->ltAction.get()->*action)();
+        }
+    };
+}
+
+void LongTimeAction::cancelTasks() {
+    auto &scheduler = _world->scheduler;
+    scheduler.cancel(_successTask);
+    scheduler.cancel(_animationTask);
+    scheduler.cancel(_soundTask);
+}
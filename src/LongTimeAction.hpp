@@ -20,9 +20,10 @@
 #define CLONGTIMEACTION_HPP
 
 #include "Item.hpp"
-#include "Timer.hpp"
+#include "Scheduler.hpp"
 #include "script/LuaScript.hpp"
 
+#include <functional>
 #include <memory>
 
 class Player;
@@ -72,6 +73,12 @@ public:
      *@param world the gameworld
      */
     LongTimeAction(Player *player, World *world);
+    ~LongTimeAction();
+
+    LongTimeAction(const LongTimeAction &) = delete;
+    auto operator=(const LongTimeAction &) -> LongTimeAction & = delete;
+    LongTimeAction(LongTimeAction &&) = delete;
+    auto operator=(LongTimeAction &&) -> LongTimeAction & = delete;
 
     /**
      *sets the last action to the new values so the script can called correctly
@@ -155,12 +162,6 @@ public:
      */
     void successAction();
 
-    /**
-     *checks the last Action of the player if its maybe succseful
-     *@return true if the action was successfully performed
-     */
-    auto checkAction() -> bool;
-
     /**
      *checks if currently an action is running or not
      * @return true if there is a action running
@@ -181,12 +182,9 @@ private:
 
     bool _actionrunning = false; /**< boolean value, if true there is currently a action running*/
 
-    std::unique_ptr<Timer> _timetowaitTimer =
-            nullptr; /**< timer which determines how many ms the action has to wait until it is sucessful*/
-    std::unique_ptr<Timer> _redoaniTimer =
-            nullptr; /**< timer which determines after how many ms the animation is shown again*/
-    std::unique_ptr<Timer> _redosoundTimer =
-            nullptr; /**< timer which determines how many ms the sound is played again.*/
+    TaskHandle _successTask;   /**< scheduled task which makes the action sucessful*/
+    TaskHandle _animationTask; /**< scheduled task which shows the animation again*/
+    TaskHandle _soundTask;     /**< scheduled task which plays the sound again*/
 
     ActionType _at = ACTION_USE; /**< type of the action @see ActionType*/
 
@@ -195,6 +193,16 @@ private:
 
     void checkTarget();
     void checkSource();
+
+    void showAnimation();
+    void playSound();
+
+    /**
+     *wraps a member function for the scheduler, it is only called while the owner is in the world
+     */
+    [[nodiscard]] auto whileOwnerOnline(void (LongTimeAction::*action)()) const -> std::function<void()>;
+
+    void cancelTasks();
 };
 
 #endif
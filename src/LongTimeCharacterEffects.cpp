@@ -22,18 +22,66 @@
 
 #include "LongTimeEffect.hpp"
 #include "Player.hpp"
+#include "World.hpp"
 #include "data/Data.hpp"
-#include "db/Connection.hpp"
-#include "db/ConnectionManager.hpp"
-#include "db/DeleteQuery.hpp"
-#include "db/Result.hpp"
 #include "db/SelectQuery.hpp"
+#include "netinterface/NetInterface.hpp"
+#include "tuningConstants.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <range/v3/all.hpp>
 #include <string>
+#include <unordered_map>
 
-LongTimeCharacterEffects::LongTimeCharacterEffects(Character *owner) : owner(owner), time(0) {}
+LongTimeCharacterEffects::LongTimeCharacterEffects(Character *owner) : owner(owner) {}
+
+// players are deleted away from the game loop, so a pending check must not find them afterwards
+LongTimeCharacterEffects::~LongTimeCharacterEffects() { World::get()->scheduler.cancel(checkTask); }
+
+auto LongTimeCharacterEffects::currentTime() -> int32_t {
+    using deciseconds = std::chrono::duration<int32_t, std::deci>;
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<deciseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void LongTimeCharacterEffects::scheduleCheck() {
+    auto &scheduler = World::get()->scheduler;
+
+    if (effects.empty()) {
+        scheduler.cancel(checkTask);
+        return;
+    }
+
+    const auto delay = std::chrono::duration<int32_t, std::deci>(
+            std::max(0, effects.front()->getExecutionTime() - currentTime()));
+
+    if (scheduler.reschedule(checkTask, delay)) {
+        return;
+    }
+
+    checkTask = scheduler.addOneshotTask(
+            [world = World::get(), character = owner, id = owner->getId()] {
+                // nothing of the owner is touched before it is known to be still around
+                if (world->findCharacter(id) != character) {
+                    return;
+                }
+
+                bool active = character->isAlive();
+
+                if (character->getType() == Character::player) {
+                    active = dynamic_cast<Player *>(character)->Connection->online;
+                }
+
+                if (active) {
+                    character->effects.checkEffects();
+                } else {
+                    // offline players and dead characters wait, like they did when being checked every turn
+                    world->scheduler.reschedule(character->effects.checkTask, gameLoopInterval);
+                }
+            },
+            delay, "long_time_effects");
+}
 
 auto LongTimeCharacterEffects::find(uint16_t effectid, LongTimeEffect *&effect) const -> bool {
     using namespace ranges;
@@ -74,7 +122,7 @@ void LongTimeCharacterEffects::addEffect(std::unique_ptr<LongTimeEffect> effect)
     }
 
     if (!find(effect->getEffectId(), foundeffect)) {
-        effect->setExecutionTime(time);
+        effect->setExecutionTime(currentTime());
 
         if (effect->isFirstAdd()) {
             const auto &script = Data::longTimeEffects().script(effect->getEffectId());
@@ -87,6 +135,7 @@ void LongTimeCharacterEffects::addEffect(std::unique_ptr<LongTimeEffect> effect)
         effect->firstAdd();
         effects.push_back(std::move(effect));
         std::push_heap(effects.begin(), effects.end(), LongTimeEffect::priority);
+        scheduleCheck();
     } else {
         const auto &script = Data::longTimeEffects().script(effect->getEffectId());
 
@@ -107,6 +156,7 @@ auto LongTimeCharacterEffects::removeEffect(uint16_t effectid) -> bool {
 
             effects.erase(it);
             std::make_heap(effects.begin(), effects.end(), LongTimeEffect::priority);
+            scheduleCheck();
             return true;
         }
     }
@@ -125,6 +175,7 @@ auto LongTimeCharacterEffects::removeEffect(const std::string &name) -> bool {
 
             effects.erase(it);
             std::make_heap(effects.begin(), effects.end(), LongTimeEffect::priority);
+            scheduleCheck();
             return true;
         }
     }
@@ -143,6 +194,7 @@ auto LongTimeCharacterEffects::removeEffect(LongTimeEffect *effect) -> bool {
 
             effects.erase(it);
             std::make_heap(effects.begin(), effects.end(), LongTimeEffect::priority);
+            scheduleCheck();
             return true;
         }
     }
@@ -151,7 +203,7 @@ auto LongTimeCharacterEffects::removeEffect(LongTimeEffect *effect) -> bool {
 }
 
 void LongTimeCharacterEffects::checkEffects() {
-    ++time;
+    const int32_t time = currentTime();
     constexpr auto scriptLimit = 200;
     int emexit = 0;
 
@@ -171,117 +223,85 @@ void LongTimeCharacterEffects::checkEffects() {
             }
         }
     }
+
+    // the rest of the effects if the limit was hit, otherwise the next one due
+    scheduleCheck();
 }
 
-auto LongTimeCharacterEffects::save() -> bool {
-    using namespace Database;
+auto LongTimeCharacterEffects::snapshot() const -> std::vector<PlayerSnapshot::Effect> {
+    std::vector<PlayerSnapshot::Effect> result;
+    result.reserve(effects.size());
+    const int32_t time = currentTime();
 
-    if ((owner != nullptr) && owner->getType() != Character::player) {
-        return false;
+    for (const auto &effect : effects) {
+        result.push_back(effect->snapshot(time));
     }
 
-    auto *player = dynamic_cast<Player *>(owner);
+    return result;
+}
 
-    if (owner == nullptr) {
-        return false;
-    }
+void LongTimeCharacterEffects::addLoadQueries(const Database::PConnection &connection, TYPE_OF_CHARACTER_ID playerId,
+                                              std::vector<std::string> &queries) {
+    using namespace Database;
 
-    PConnection connection = ConnectionManager::getInstance().getConnection();
-    connection->beginTransaction();
+    SelectQuery query(connection);
+    query.addColumn("playerlteffects", "plte_effectid");
+    query.addColumn("playerlteffects", "plte_nextcalled");
+    query.addColumn("playerlteffects", "plte_numbercalled");
+    query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playerlteffects", "plte_playerid", playerId);
+    query.addServerTable("playerlteffects");
+    query.addOrderBy("playerlteffects", "plte_nextcalled", SelectQuery::ASC);
+    queries.push_back(query.buildQuery());
+
+    SelectQuery valuesQuery(connection);
+    valuesQuery.addColumn("playerlteffectvalues", "pev_effectid");
+    valuesQuery.addColumn("playerlteffectvalues", "pev_name");
+    valuesQuery.addColumn("playerlteffectvalues", "pev_value");
+    valuesQuery.addEqualCondition<TYPE_OF_CHARACTER_ID>("playerlteffectvalues", "pev_playerid", playerId);
+    valuesQuery.addServerTable("playerlteffectvalues");
+    queries.push_back(valuesQuery.buildQuery());
+}
 
-    try {
-        {
-            DeleteQuery query(connection);
-            query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playerlteffects", "plte_playerid", player->getId());
-            query.setServerTable("playerlteffects");
-            query.execute();
-        }
-        {
-            DeleteQuery query(connection);
-            query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playerlteffectvalues", "pev_playerid", player->getId());
-            query.setServerTable("playerlteffectvalues");
-            query.execute();
-        }
-        connection->commitTransaction();
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::Database)
-                << "Error while saving long time effects for " << player->to_string() << ": " << e.what() << Log::end;
-        connection->rollbackTransaction();
-        return false;
-    }
+void LongTimeCharacterEffects::restore(const Database::Result &effectRows, const Database::Result &valueRows) {
+    std::unordered_map<uint16_t, LongTimeEffect *> restored;
 
-    bool allok = true;
+    for (const auto &row : effectRows) {
+        auto effectId = row["plte_effectid"].as<uint16_t>();
+        auto effect = std::make_unique<LongTimeEffect>(effectId, row["plte_nextcalled"].as<int32_t>());
 
-    for (auto &effect : effects) {
-        allok and_eq effect->save(player->getId(), time);
+        effect->setExecutionTime(currentTime());
+        effect->firstAdd();
+        effect->setNumberOfCalls(row["plte_numberCalled"].as<uint32_t>());
+        restored[effectId] = effect.get();
+        effects.push_back(std::move(effect));
     }
 
-    return allok;
-}
-
-auto LongTimeCharacterEffects::load() -> bool {
-    using namespace Database;
+    for (const auto &row : valueRows) {
+        auto effect = restored.find(row["pev_effectid"].as<uint16_t>());
 
-    if (owner->getType() != Character::player) {
-        return false;
+        if (effect != restored.end()) {
+            effect->second->addValue(row["pev_name"].as<std::string>(), row["pev_value"].as<uint32_t>());
+        }
     }
 
-    auto *player = dynamic_cast<Player *>(owner);
+    std::make_heap(effects.begin(), effects.end(), LongTimeEffect::priority);
+}
 
-    PConnection connection = ConnectionManager::getInstance().getConnection();
-
-    try {
-        SelectQuery query(connection);
-        query.addColumn("playerlteffects", "plte_effectid");
-        query.addColumn("playerlteffects", "plte_nextcalled");
-        query.addColumn("playerlteffects", "plte_numbercalled");
-        query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playerlteffects", "plte_playerid", player->getId());
-        query.addServerTable("playerlteffects");
-        query.addOrderBy("playerlteffects", "plte_nextcalled", SelectQuery::ASC);
-
-        Result results = query.execute();
-
-        if (!results.empty()) {
-            for (const auto &row : results) {
-                auto effectId = row["plte_effectid"].as<uint16_t>();
-                auto effect = std::make_unique<LongTimeEffect>(effectId, row["plte_nextcalled"].as<int32_t>());
-
-                effect->setExecutionTime(time);
-                effect->firstAdd();
-                effect->setNumberOfCalls(row["plte_numberCalled"].as<uint32_t>());
-
-                SelectQuery valuesQuery(connection);
-                valuesQuery.addColumn("playerlteffectvalues", "pev_name");
-                valuesQuery.addColumn("playerlteffectvalues", "pev_value");
-                valuesQuery.addEqualCondition<TYPE_OF_CHARACTER_ID>("playerlteffectvalues", "pev_playerid",
-                                                                    player->getId());
-                valuesQuery.addEqualCondition<uint16_t>("playerlteffectvalues", "pev_effectid", effectId);
-                valuesQuery.addServerTable("playerlteffectvalues");
-
-                Result valuesResults = valuesQuery.execute();
-
-                if (!valuesResults.empty()) {
-                    for (const auto &valueRow : valuesResults) {
-                        effect->addValue(valueRow["pev_name"].as<std::string>(), valueRow["pev_value"].as<uint32_t>());
-                    }
-                }
+void LongTimeCharacterEffects::load() {
+    auto *player = dynamic_cast<Player *>(owner);
 
-                const auto &script = Data::longTimeEffects().script(effectId);
+    if (player == nullptr) {
+        return;
+    }
 
-                if (script) {
-                    script->loadEffect(effect.get(), player);
-                }
+    for (const auto &effect : effects) {
+        const auto &script = Data::longTimeEffects().script(effect->getEffectId());
 
-                effects.push_back(std::move(effect));
-            }
+        if (script) {
+            script->loadEffect(effect.get(), player);
         }
-
-        std::make_heap(effects.begin(), effects.end(), LongTimeEffect::priority);
-
-        return true;
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::Database)
-                << "Error while loading long time effects for " << player->to_string() << ": " << e.what() << Log::end;
-        return false;
     }
+
+    // restored away from the game loop, so only scheduled now
+    scheduleCheck();
 }
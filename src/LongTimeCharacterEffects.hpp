@@ -22,6 +22,10 @@
 #define LONGTIMECHARACTEREFFECTS_HPP_
 
 #include "LongTimeEffect.hpp"
+#include "Scheduler.hpp"
+#include "db/Connection.hpp"
+#include "db/Result.hpp"
+#include "types.hpp"
 
 #include <memory>
 #include <string>
@@ -32,6 +36,12 @@ class Character;
 class LongTimeCharacterEffects {
 public:
     explicit LongTimeCharacterEffects(Character *owner);
+    ~LongTimeCharacterEffects();
+
+    LongTimeCharacterEffects(const LongTimeCharacterEffects &) = delete;
+    auto operator=(const LongTimeCharacterEffects &) -> LongTimeCharacterEffects & = delete;
+    LongTimeCharacterEffects(LongTimeCharacterEffects &&) = delete;
+    auto operator=(LongTimeCharacterEffects &&) -> LongTimeCharacterEffects & = delete;
 
     void addEffect(LongTimeEffect *effect);
     void addEffect(std::unique_ptr<LongTimeEffect> effect);
@@ -41,9 +51,16 @@ public:
     auto removeEffect(const std::string &name) -> bool;
     auto removeEffect(LongTimeEffect *effect) -> bool;
 
+    // calls the effects that are due, run by the scheduler of the world
     void checkEffects();
-    auto save() -> bool;
-    auto load() -> bool;
+    [[nodiscard]] auto snapshot() const -> std::vector<PlayerSnapshot::Effect>;
+
+    // appends the queries fetching the stored effects of a player, their results go to restore
+    static void addLoadQueries(const Database::PConnection &connection, TYPE_OF_CHARACTER_ID playerId,
+                               std::vector<std::string> &queries);
+    void restore(const Database::Result &effectRows, const Database::Result &valueRows);
+    // hands the restored effects to their scripts, needs to run in the main thread
+    void load();
 
 private:
     using EFFECTS = std::vector<std::unique_ptr<LongTimeEffect>>;
@@ -51,7 +68,12 @@ private:
 
     Character *owner;
 
-    int32_t time;
+    // the one task calling the next due effect
+    TaskHandle checkTask;
+
+    // deciseconds since the server started, effects are called in multiples of them
+    static auto currentTime() -> int32_t;
+    void scheduleCheck();
 };
 
 #endif
@@ -0,0 +1,169 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * Bounded lock-free queue for handing items from any number of producer
+ * threads to a single consumer thread. Every slot carries a sequence number
+ * telling whether it is free for the producer of a given position or holds the
+ * item for the consumer, so neither side ever blocks the other.
+ *
+ * tryPush may be called from any thread, everything else belongs to the
+ * consumer. Only empty() may also be asked elsewhere, the answer is a snapshot.
+ */
+template <typename T> class MPSCQueue {
+public:
+    // the capacity is rounded up to the next power of two
+    explicit MPSCQueue(size_t minCapacity) : mask(roundUp(minCapacity) - 1), cells(std::make_unique<Cell[]>(mask + 1)) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    auto operator=(const MPSCQueue &) -> MPSCQueue & = delete;
+    MPSCQueue(MPSCQueue &&) = delete;
+    auto operator=(MPSCQueue &&) -> MPSCQueue & = delete;
+    ~MPSCQueue() = default;
+
+    // false if the queue is full, the item is left untouched then
+    auto tryPush(T &&item) -> bool {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+
+        while (true) {
+            cell = &cells[position & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = std::move(item);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    auto tryPush(const T &item) -> bool {
+        T copy = item;
+        return tryPush(std::move(copy));
+    }
+
+    // the oldest item or nullptr, it stays queued
+    auto peek() -> T * {
+        const size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        Cell &cell = cells[position & mask];
+
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            return nullptr;
+        }
+
+        return &cell.item;
+    }
+
+    auto tryPop(T &item) -> bool {
+        T *front = peek();
+
+        if (front == nullptr) {
+            return false;
+        }
+
+        item = std::move(*front);
+        release();
+        return true;
+    }
+
+    // hands every item queued so far to the consumer, items pushed meanwhile wait for the next call
+    template <typename Consumer> auto drain(Consumer &&consumer) -> size_t {
+        const size_t end = enqueuePosition.load(std::memory_order_acquire);
+        size_t count = 0;
+
+        while (dequeuePosition.load(std::memory_order_relaxed) != end) {
+            T *front = peek();
+
+            // a producer claimed the slot but did not fill it yet
+            if (front == nullptr) {
+                break;
+            }
+
+            T item = std::move(*front);
+            release();
+            ++count;
+            consumer(std::move(item));
+        }
+
+        return count;
+    }
+
+    [[nodiscard]] auto empty() const -> bool {
+        return enqueuePosition.load(std::memory_order_acquire) == dequeuePosition.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] auto capacity() const -> size_t { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T item{};
+    };
+
+    static auto roundUp(size_t minCapacity) -> size_t {
+        size_t result = 2;
+
+        while (result < minCapacity) {
+            result *= 2;
+        }
+
+        return result;
+    }
+
+    // frees the front slot for the producer one round later
+    void release() {
+        const size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        Cell &cell = cells[position & mask];
+        cell.item = T{};
+        cell.sequence.store(position + mask + 1, std::memory_order_release);
+        dequeuePosition.store(position + 1, std::memory_order_release);
+    }
+
+    static constexpr size_t cacheLineSize = 64;
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(cacheLineSize) std::atomic<size_t> enqueuePosition = 0;
+    alignas(cacheLineSize) std::atomic<size_t> dequeuePosition = 0;
+};
+
+#endif
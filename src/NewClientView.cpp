@@ -16,42 +16,26 @@
 //  You should have received a copy of the GNU Affero General Public License
 //  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
 
+
 #include "NewClientView.hpp"
 
-#include "World.hpp"
 #include "map/Field.hpp"
+#include "map/WorldMap.hpp"
 
-#include <algorithm>
-#include <iostream>
-
-void NewClientView::fillStripe(position pos, stripedirection dir, Coordinate length) {
-    clearStripe();
-    viewPosition = pos;
-    stripedir = dir;
-    readFields(length);
-}
-
-void NewClientView::clearStripe() {
-    std::fill(std::begin(mapStripe), std::end(mapStripe), nullptr);
-    exists = false;
-    viewPosition.x = 0;
-    viewPosition.y = 0;
-    viewPosition.z = 0;
-    maxtiles = 0;
-}
+#include <climits>
 
-void NewClientView::readFields(Coordinate length) {
-    position pos = viewPosition;
-    Coordinate x_inc = (stripedir == dir_right) ? 1 : -1;
-    maxtiles = length;
-    exists = true;
+auto NewClientView::readStripe(const map::WorldMap &maps, position start, stripedirection dir, Coordinate length)
+        -> MAPSTRIPE {
+    MAPSTRIPE stripe{nullptr};
+    position pos = start;
+    Coordinate x_inc = (dir == dir_right) ? 1 : -1;
 
     for (Coordinate i = 0; i < length; ++i) {
         try {
-            map::Field &field = World::get()->fieldAt(pos);
+            const map::Field &field = maps.at(pos);
 
             if (!field.isTransparent() || field.itemCount() > 0) {
-                mapStripe[i] = &field;
+                stripe[i] = &field;
             }
         } catch (FieldNotFound &) {
         }
@@ -61,4 +45,165 @@ void NewClientView::readFields(Coordinate length) {
         // increase y due to perspective
         ++pos.y;
     }
+
+    return stripe;
+}
+
+auto NewClientView::encodeStripe(const map::WorldMap &maps, const StripeRequest &stripe, stripeencoding encoding)
+        -> EncodedStripe {
+    StripeWriter writer;
+    const auto fields = readStripe(maps, stripe.start, stripe.dir, stripe.length);
+
+    if (encoding == encoding_compact) {
+        writer.addCompactFields(fields.data(), stripe.length);
+    } else {
+        writer.addFields(fields.data(), stripe.length);
+    }
+
+    return std::move(writer.encoded);
+}
+
+void NewClientView::StripeWriter::addUnsignedChar(unsigned char data) {
+    encoded.bytes.push_back(static_cast<char>(data));
+    encoded.checkSum += data;
+}
+
+void NewClientView::StripeWriter::addShortInt(short int data) {
+    addUnsignedChar(data >> CHAR_BIT);
+    addUnsignedChar(data & UCHAR_MAX);
+}
+
+void NewClientView::StripeWriter::addFieldLook(const map::Field *field) {
+    if (field != nullptr) {
+        addShortInt(field->getTileCode());
+        addUnsignedChar(field->getMovementCost());
+        addShortInt(field->getMusicId());
+    } else {
+        addShortInt(-1);
+        addUnsignedChar(0);
+        addShortInt(0);
+    }
+}
+
+void NewClientView::StripeWriter::addItems(const map::Field *field) {
+    const auto &items = field->peekItemStack();
+    addUnsignedChar(static_cast<unsigned char>(items.size()));
+
+    for (const auto &item : items) {
+        addShortInt(item.getId());
+
+        if (item.isContainer()) {
+            addShortInt(1);
+        } else {
+            addShortInt(item.getNumber());
+        }
+    }
+}
+
+void NewClientView::StripeWriter::addFields(const map::Field *const *fields, Coordinate length) {
+    for (Coordinate i = 0; i < length; ++i) {
+        addFieldLook(fields[i]);
+
+        if (fields[i] != nullptr) {
+            addItems(fields[i]);
+        } else {
+            addUnsignedChar(0);
+        }
+    }
+}
+
+void NewClientView::StripeWriter::addCompactFields(const map::Field *const *fields, Coordinate length) {
+    const auto hasItems = [](const map::Field *field) { return field != nullptr && field->itemCount() > 0; };
+
+    const auto looksAlike = [](const map::Field *first, const map::Field *second) {
+        if (first == nullptr || second == nullptr) {
+            return first == second;
+        }
+
+        return first->getTileCode() == second->getTileCode() &&
+               first->getMovementCost() == second->getMovementCost() &&
+               first->getMusicId() == second->getMusicId();
+    };
+
+    Coordinate i = 0;
+
+    while (i < length) {
+        const auto *field = fields[i];
+
+        if (hasItems(field)) {
+            addUnsignedChar(compactItemsFlag | 1);
+            addFieldLook(field);
+            addItems(field);
+            ++i;
+            continue;
+        }
+
+        Coordinate run = 1;
+
+        while (i + run < length && run < compactMaxRun && !hasItems(fields[i + run]) &&
+               looksAlike(field, fields[i + run])) {
+            ++run;
+        }
+
+        addUnsignedChar(static_cast<unsigned char>(run));
+        addFieldLook(field);
+        i += run;
+    }
+}
+
+void NewClientView::addFullMapStripes(const position &pos, Coordinate screenwidth, Coordinate screenheight,
+                                      std::vector<StripeRequest> &stripes) {
+    for (Coordinate zoffs = -2; zoffs <= 2; ++zoffs) {
+        addLevelStripes(pos, screenwidth, screenheight, zoffs, stripes);
+    }
+}
+
+void NewClientView::addLevelStripes(const position &pos, Coordinate screenwidth, Coordinate screenheight,
+                                    Coordinate zoffs, std::vector<StripeRequest> &stripes) {
+    if ((screenwidth == 0) && (screenheight == 0)) {
+        // static view
+        Coordinate x = pos.x;
+        Coordinate y = pos.y - MAP_DIMENSION;
+        Coordinate z = pos.z + zoffs;
+        Coordinate e = zoffs * 3;
+
+        if (zoffs < 0) {
+            x -= e;
+            y += e;
+            e = 0;
+        }
+
+        for (Coordinate i = 0; i <= (MAP_DIMENSION + MAP_DOWN_EXTRA + e) * 2; ++i) {
+            stripes.push_back({position(x, y, z), dir_right, Coordinate(MAP_DIMENSION + 1 - (i % 2))});
+
+            if (i % 2 == 0) {
+                y += 1;
+            } else {
+                x -= 1;
+            }
+        }
+    } else {
+        // dynamic view
+        Coordinate x = pos.x - screenwidth + screenheight;
+        Coordinate y = pos.y - screenwidth - screenheight;
+        Coordinate z = pos.z + zoffs;
+        Coordinate e = zoffs * 3;
+
+        if (zoffs < 0) {
+            x -= e;
+            y += e;
+            e = 0;
+        }
+
+        // schleife von 0ben nach unten durch alle tiles
+        for (Coordinate i = 0; i <= (2 * screenheight + MAP_DOWN_EXTRA + e) * 2; ++i) {
+            stripes.push_back({position(x, y, z), dir_right, Coordinate(2 * screenwidth + 1 - (i % 2))});
+
+            if (i % 2 == 0) {
+                y += 1;
+            } else {
+                x -= 1;
+            }
+        }
+    }
 }
@@ -16,22 +16,29 @@
 //  You should have received a copy of the GNU Affero General Public License
 //  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
 
+
 #ifndef NEWCLIENTVIEW_HPP_
 #define NEWCLIENTVIEW_HPP_
 
 #include "globals.hpp"
 #include "types.hpp"
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 constexpr Coordinate MAP_DIMENSION = 17; // map extends into all 4 directions for this number of tiles
 constexpr Coordinate MAP_DOWN_EXTRA = 3; // extra downwards extension
 
 // forward declarations
 namespace map {
 class Field;
-}
+class WorldMap;
+} // namespace map
 
 /**
- * class which holds isometric view specific data
+ * isometric view specific functions, all of them only read the map and may
+ * be called from several threads at once while the map is not changed
  */
 class NewClientView {
 public:
@@ -40,82 +47,82 @@ public:
      */
     enum stripedirection { dir_right, dir_down };
 
-    static constexpr Coordinate mapStripeLength = 100;
-    /**
-     * defines one mapstripe
-     */
-    using MAPSTRIPE = std::array<map::Field *, mapStripeLength>;
-
     /**
-     * stores the pointers to the fields inside a specific mapstripe
+     * how the fields of a stripe are encoded
+     * classic: tile, movement cost, music and item stack of every field
+     * compact: runs of fields, a run starts with a byte holding its length in the
+     * lower seven bits, followed by tile, movement cost and music shared by all
+     * fields of the run; if the highest bit is set the run is a single field
+     * followed by its item stack, empty item stacks are left out
      */
-    MAPSTRIPE mapStripe{nullptr};
-
-    /**
-     * returns the initial position of this stripe
-     * @return the starting position of the stripe
-     */
-    [[nodiscard]] auto getViewPosition() const -> position { return viewPosition; }
+    enum stripeencoding { encoding_classic, encoding_compact };
+    static constexpr unsigned char compactItemsFlag = 0x80;
+    static constexpr Coordinate compactMaxRun = 0x7F;
 
+    static constexpr Coordinate mapStripeLength = 100;
     /**
-     * returns if the stripe exists
-     * @return true if the stripe exists otherwise false
+     * defines one mapstripe
      */
-    [[nodiscard]] auto getExists() const -> bool { return exists; }
+    using MAPSTRIPE = std::array<const map::Field *, mapStripeLength>;
 
     /**
-     * returns the number of tiles in the view
-     * @return the number of maximal tiles in the view
+     * a stripe of the map as seen by the client
      */
-    [[nodiscard]] auto getMaxTiles() const -> Coordinate { return maxtiles; }
+    struct StripeRequest {
+        position start;
+        stripedirection dir;
+        Coordinate length;
+    };
 
     /**
-     * the stripedirection, in which direction the mapstripe shows
-     * @return the current direction of the mapstripe
+     * the payload of a map stripe command
      */
-    [[nodiscard]] auto getStripeDirection() const -> stripedirection { return stripedir; }
+    struct EncodedStripe {
+        std::vector<char> bytes;
+        uint32_t checkSum = 0;
+    };
 
     /**
-     * fills the stripe with the specific isometric data
-     * @param pos the starting position of the stripe
+     * reads the fields of a stripe, fields which are missing or not visible stay nullptr
+     * @param maps the maps from which we want to read the stripe
+     * @param start the starting position of the stripe
      * @param dir the direction in which the stipe looks
      * @param length number of tiles to be read
-     * @param maps the maps from which we want to calculate the stripes
-     */
-    void fillStripe(position pos, stripedirection dir, Coordinate length);
-
-    /**
-     * clears all current stripe infos
-     */
-    void clearStripe();
-
-private:
-    /**
-     * reads all fields for the current stripe on a specific map from startingpos towards direction stripedir
-     * @param length number of tiles to be read
-     * @param maps the map vector from which we want to read the fields
      */
-    void readFields(Coordinate length);
+    [[nodiscard]] static auto readStripe(const map::WorldMap &maps, position start, stripedirection dir,
+                                         Coordinate length) -> MAPSTRIPE;
 
     /**
-     * the starting position of the current view
+     * encodes a stripe the way it is sent to the client
      */
-    position viewPosition{};
+    [[nodiscard]] static auto encodeStripe(const map::WorldMap &maps, const StripeRequest &stripe,
+                                           stripeencoding encoding = encoding_classic) -> EncodedStripe;
 
     /**
-     * if there is a view stripe
+     * adds the stripes of all levels around pos, in the order the client expects them on a full map update
+     * @param pos the position of the viewer
+     * @param screenwidth the horizontal view range of the client, 0 for the static view
+     * @param screenheight the vertical view range of the client, 0 for the static view
+     * @param stripes the list the stripes are appended to
      */
-    bool exists{false};
+    static void addFullMapStripes(const position &pos, Coordinate screenwidth, Coordinate screenheight,
+                                  std::vector<StripeRequest> &stripes);
 
-    /**
-     * which direction do we read
-     */
-    stripedirection stripedir{dir_right};
-
-    /**
-     * how many tiles are stored
-     */
-    Coordinate maxtiles{0};
+private:
+    struct StripeWriter {
+        EncodedStripe encoded;
+
+        // same byte order and checksum as BasicServerCommand
+        void addUnsignedChar(unsigned char data);
+        void addShortInt(short int data);
+        void addFieldLook(const map::Field *field);
+        void addItems(const map::Field *field);
+        void addFields(const map::Field *const *fields, Coordinate length);
+        void addCompactFields(const map::Field *const *fields, Coordinate length);
+    };
+
+    static void addLevelStripes(const position &pos, Coordinate screenwidth, Coordinate screenheight,
+                                Coordinate zoffs, std::vector<StripeRequest> &stripes);
 };
 
 #endif
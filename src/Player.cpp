@@ -30,7 +30,6 @@
 #include "data/Data.hpp"
 #include "db/Connection.hpp"
 #include "db/ConnectionManager.hpp"
-#include "db/DeleteQuery.hpp"
 #include "db/InsertQuery.hpp"
 #include "db/Result.hpp"
 #include "db/SchemaHelper.hpp"
@@ -52,6 +51,7 @@
 
 #include <memory>
 #include <range/v3/all.hpp>
+#include <set>
 #include <sstream>
 #include <utility>
 
@@ -67,6 +67,8 @@ Player::Player(std::shared_ptr<NetInterface> newConnection)
 
     const auto loginCommand = Connection->getLoginData();
     setName(loginCommand->getLoginName());
+    const uint16_t mapStripesVersion = Config::instance().mapstripesclientversion;
+    batchedMapStripes = mapStripesVersion != 0 && loginCommand->getClientVersion() == mapStripesVersion;
 
     check_logindata();
 
@@ -411,10 +413,10 @@ auto Player::lookIntoContainerOnField(direction dir) -> bool {
 
         if (field.viewItemOnStack(item)) {
             if (item.getId() != DEPOTITEM && item.isContainer()) {
-                auto it = field.containers.find(item.getNumber());
+                auto *container = field.getContainer(item.getNumber());
 
-                if (it != field.containers.end()) {
-                    openShowcase(it->second, static_cast<ScriptItem>(item), false);
+                if (container != nullptr) {
+                    openShowcase(container, static_cast<ScriptItem>(item), false);
                     return true;
                 }
             } else {
@@ -804,6 +806,9 @@ void Player::check_logindata() {
     Database::PConnection connection = Database::ConnectionManager::getInstance().getConnection();
 
     try {
+        // one transaction for the whole check instead of one per query
+        connection->beginTransaction();
+
         Database::SelectQuery charQuery(connection);
         charQuery.addColumn("chars", "chr_playerid");
         charQuery.addColumn("chars", "chr_accid");
@@ -1004,6 +1009,8 @@ void Player::check_logindata() {
         _appearance.skin.green = playerRow["ply_skingreen"].as<uint16_t>();
         _appearance.skin.blue = playerRow["ply_skinblue"].as<uint16_t>();
         _appearance.skin.alpha = playerRow["ply_skinalpha"].as<uint16_t>();
+
+        connection->commitTransaction();
     } catch (std::exception &e) {
         Logger::error(LogFacility::Player) << "Exception on loading player: " << e.what() << Log::end;
         throw LogoutException(NOCHARACTERFOUND);
@@ -1019,273 +1026,134 @@ struct container_struct {
             : container(cc), id(aboveid), depotid(depot) {}
 };
 
-auto Player::save() noexcept -> bool {
-    using namespace Database;
-
-    Logger::info(LogFacility::Player) << "Saving " << to_string() << Log::end;
+auto Player::createSnapshot() -> PlayerSnapshot {
+    PlayerSnapshot snapshot;
+    snapshot.id = getId();
+    snapshot.name = getName();
+    snapshot.description = to_string();
 
-    PConnection connection = ConnectionManager::getInstance().getConnection();
-
-    try {
-        connection->beginTransaction();
+    time(&lastsavetime);
+    auto &playerStatus = snapshot.status;
+    playerStatus.status = status;
+    playerStatus.lastIp = last_ip;
+    playerStatus.onlineTime = onlinetime + lastsavetime - logintime;
+    playerStatus.lastSaveTime = lastsavetime;
 
-        {
-            DeleteQuery introductionQuery(connection);
-            introductionQuery.addEqualCondition<TYPE_OF_CHARACTER_ID>("introduction", "intro_player", getId());
-            introductionQuery.addServerTable("introduction");
-            introductionQuery.execute();
-        }
+    if (status != 0) {
+        playerStatus.statusTime = statustime;
+        playerStatus.statusGm = statusgm;
+        playerStatus.statusReason = statusreason;
+    }
 
-        {
-            InsertQuery introductionQuery(connection);
-            const InsertQuery::columnIndex playerColumn = introductionQuery.addColumn("intro_player");
-            const InsertQuery::columnIndex knownPlayerColumn = introductionQuery.addColumn("intro_known_player");
-            introductionQuery.addServerTable("introduction");
-
-            for (const auto player : knownPlayers) {
-                introductionQuery.addValue<TYPE_OF_CHARACTER_ID>(playerColumn, getId());
-                introductionQuery.addValue<TYPE_OF_CHARACTER_ID>(knownPlayerColumn, player);
-            }
+    auto &attributes = snapshot.attributes;
+    const auto &pos = getPosition();
+    attributes.x = pos.x;
+    attributes.y = pos.y;
+    attributes.z = pos.z;
+    attributes.faceTo = static_cast<uint16_t>(getFaceTo());
+    attributes.hitpoints = getAttribute(Character::hitpoints);
+    attributes.mana = getAttribute(Character::mana);
+    attributes.foodLevel = getAttribute(Character::foodlevel);
+    attributes.lifeState = isAlive() ? 1 : 0;
+    attributes.magicType = getMagicType();
+    attributes.mageFlags = getMagicFlags(MAGE);
+    attributes.priestFlags = getMagicFlags(PRIEST);
+    attributes.bardFlags = getMagicFlags(BARD);
+    attributes.druidFlags = getMagicFlags(DRUID);
+    attributes.poison = poisonvalue;
+    attributes.mentalCapacity = mental_capacity;
+    attributes.hairType = _appearance.hairtype;
+    attributes.beardType = _appearance.beardtype;
+    attributes.hair = _appearance.hair;
+    attributes.skin = _appearance.skin;
+
+    snapshot.tables = snapshotTables();
+    snapshot.markChanges(savedTables);
+    // should this snapshot fail to be written, PlayerSaver writes all tables of the next one
+    savedTables = snapshot.tables;
+    snapshot.effects = effects.snapshot();
+
+    return snapshot;
+}
+
+auto Player::snapshotTables() const -> PlayerSnapshot::Tables {
+    PlayerSnapshot::Tables tables;
+
+    tables.introductions.assign(knownPlayers.begin(), knownPlayers.end());
+    std::sort(tables.introductions.begin(), tables.introductions.end());
+    tables.namings.assign(namedPlayers.begin(), namedPlayers.end());
+    std::sort(tables.namings.begin(), tables.namings.end());
 
-            introductionQuery.execute();
-        }
+    for (const auto &skill : skills) {
+        tables.skills.push_back({skill.first, static_cast<uint16_t>(skill.second.major),
+                                 static_cast<uint16_t>(skill.second.minor)});
+    }
 
-        {
-            DeleteQuery namingQuery(connection);
-            namingQuery.addEqualCondition<TYPE_OF_CHARACTER_ID>("naming", "name_player", getId());
-            namingQuery.addServerTable("naming");
-            namingQuery.execute();
-        }
+    std::list<container_struct> containers;
 
-        {
-            InsertQuery namingQuery(connection);
-            const InsertQuery::columnIndex playerColumn = namingQuery.addColumn("name_player");
-            const InsertQuery::columnIndex namedPlayerColumn = namingQuery.addColumn("name_named_player");
-            const InsertQuery::columnIndex playerNameColumn = namingQuery.addColumn("name_player_name");
-            namingQuery.addServerTable("naming");
-
-            for (const auto &playerAndName : namedPlayers) {
-                namingQuery.addValue<TYPE_OF_CHARACTER_ID>(playerColumn, getId());
-                namingQuery.addValue<TYPE_OF_CHARACTER_ID>(namedPlayerColumn, playerAndName.first);
-                namingQuery.addValue<std::string>(playerNameColumn, playerAndName.second);
-            }
+    // add backpack to containerlist
+    if (items.at(BACKPACK).getId() != 0 && (backPackContents != nullptr)) {
+        containers.emplace_back(backPackContents, BACKPACK + 1);
+    }
 
-            namingQuery.execute();
-        }
+    // add depot to containerlist
+    ranges::transform(depotContents, ranges::back_inserter(containers),
+                      [](const auto &depot) { return container_struct(depot.second, 0, depot.first); });
 
-        time(&lastsavetime);
-        {
-            UpdateQuery query(connection);
-            query.addAssignColumn<uint16_t>("chr_status", (uint16_t)status);
-            query.addAssignColumn<std::string>("chr_lastip", last_ip);
-            query.addAssignColumn<uint32_t>("chr_onlinetime", onlinetime + lastsavetime - logintime);
-            query.addAssignColumn<time_t>("chr_lastsavetime", lastsavetime);
-
-            if (status != 0) {
-                query.addAssignColumn<time_t>("chr_statustime", statustime);
-                query.addAssignColumn<TYPE_OF_CHARACTER_ID>("chr_statusgm", statusgm);
-                query.addAssignColumn<std::string>("chr_statusreason", statusreason);
-            } else {
-                query.addAssignColumnNull("chr_statustime");
-                query.addAssignColumnNull("chr_statusgm");
-                query.addAssignColumnNull("chr_statusreason");
-            }
+    int linenumber = 0;
 
-            query.addEqualCondition<TYPE_OF_CHARACTER_ID>("chars", "chr_playerid", getId());
-            query.setServerTable("chars");
+    // save all items directly on the body...
+    for (int thisItemSlot = 0; thisItemSlot < MAX_BODY_ITEMS + MAX_BELT_SLOTS; ++thisItemSlot) {
+        ++linenumber;
+        const auto &item = items.at(thisItemSlot);
 
-            query.execute();
+        // if there is no item on this place, do not save it
+        if (item.getId() == 0) {
+            continue;
         }
 
-        {
-            UpdateQuery query(connection);
-            query.addAssignColumn<int32_t>("ply_posx", getPosition().x);
-            query.addAssignColumn<int32_t>("ply_posy", getPosition().y);
-            query.addAssignColumn<int32_t>("ply_posz", getPosition().z);
-            query.addAssignColumn<uint16_t>("ply_faceto", (uint16_t)getFaceTo());
-            query.addAssignColumn<uint16_t>("ply_hitpoints", getAttribute(Character::hitpoints));
-            query.addAssignColumn<uint16_t>("ply_mana", getAttribute(Character::mana));
-            query.addAssignColumn<uint32_t>("ply_foodlevel", getAttribute(Character::foodlevel));
-            query.addAssignColumn<uint32_t>("ply_lifestate", isAlive() ? 1 : 0);
-            query.addAssignColumn<uint32_t>("ply_magictype", (uint32_t)getMagicType());
-            query.addAssignColumn<uint64_t>("ply_magicflagsmage", getMagicFlags(MAGE));
-            query.addAssignColumn<uint64_t>("ply_magicflagspriest", getMagicFlags(PRIEST));
-            query.addAssignColumn<uint64_t>("ply_magicflagsbard", getMagicFlags(BARD));
-            query.addAssignColumn<uint64_t>("ply_magicflagsdruid", getMagicFlags(DRUID));
-            query.addAssignColumn<uint16_t>("ply_poison", poisonvalue);
-            query.addAssignColumn<uint32_t>("ply_mental_capacity", mental_capacity);
-            query.addAssignColumn<uint16_t>("ply_hair", _appearance.hairtype);
-            query.addAssignColumn<uint16_t>("ply_beard", _appearance.beardtype);
-            query.addAssignColumn<uint16_t>("ply_hairred", _appearance.hair.red);
-            query.addAssignColumn<uint16_t>("ply_hairgreen", _appearance.hair.green);
-            query.addAssignColumn<uint16_t>("ply_hairblue", _appearance.hair.blue);
-            query.addAssignColumn<uint16_t>("ply_hairalpha", _appearance.hair.alpha);
-            query.addAssignColumn<uint16_t>("ply_skinred", _appearance.skin.red);
-            query.addAssignColumn<uint16_t>("ply_skingreen", _appearance.skin.green);
-            query.addAssignColumn<uint16_t>("ply_skinblue", _appearance.skin.blue);
-            query.addAssignColumn<uint16_t>("ply_skinalpha", _appearance.skin.alpha);
-            query.addEqualCondition<TYPE_OF_CHARACTER_ID>("player", "ply_playerid", getId());
-            query.addServerTable("player");
-            query.execute();
-        }
+        tables.items.push_back({linenumber, 0, 0, item.getId(), item.getWear(), item.getNumber(), item.getQuality(),
+                                0});
 
-        {
-            DeleteQuery query(connection);
-            query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playerskills", "psk_playerid", getId());
-            query.setServerTable("playerskills");
-            query.execute();
-        }
-
-        if (!skills.empty()) {
-            InsertQuery query(connection);
-            const InsertQuery::columnIndex playerIdColumn = query.addColumn("psk_playerid");
-            const InsertQuery::columnIndex skillIdColumn = query.addColumn("psk_skill_id");
-            const InsertQuery::columnIndex valueColumn = query.addColumn("psk_value");
-            const InsertQuery::columnIndex minorColumn = query.addColumn("psk_minor");
-
-            // now store the skills
-            for (const auto &skill : skills) {
-                query.addValue<uint16_t>(skillIdColumn, skill.first);
-                query.addValue<uint16_t>(valueColumn, (uint16_t)skill.second.major);
-                query.addValue<uint16_t>(minorColumn, (uint16_t)skill.second.minor);
+        for (auto it = item.getDataBegin(); it != item.getDataEnd(); ++it) {
+            if (it->second.length() > 0) {
+                tables.itemData.push_back({linenumber, it->first, it->second});
             }
-
-            query.addValues<TYPE_OF_CHARACTER_ID>(playerIdColumn, getId(), InsertQuery::FILL);
-            query.addServerTable("playerskills");
-            query.execute();
-        }
-
-        {
-            DeleteQuery query(connection);
-            query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playeritems", "pit_playerid", getId());
-            query.setServerTable("playeritems");
-            query.execute();
         }
+    }
 
-        {
-            DeleteQuery query(connection);
-            query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playeritem_datavalues", "idv_playerid", getId());
-            query.setServerTable("playeritem_datavalues");
-            query.execute();
-        }
-
-        {
-            std::list<container_struct> containers;
-
-            // add backpack to containerlist
-            if (items.at(BACKPACK).getId() != 0 && (backPackContents != nullptr)) {
-                containers.emplace_back(backPackContents, BACKPACK + 1);
-            }
+    // add backpack contents...
+    while (!containers.empty()) {
+        // get container to save...
+        container_struct &currentContainerStruct = containers.front();
+        Container &currentContainer = *currentContainerStruct.container;
+        const auto &containedItems = currentContainer.getItems();
 
-            // add depot to containerlist
-            ranges::transform(depotContents, ranges::back_inserter(containers),
-                              [](const auto &depot) { return container_struct(depot.second, 0, depot.first); });
-
-            InsertQuery itemsQuery(connection);
-            const InsertQuery::columnIndex itemsPlyIdColumn = itemsQuery.addColumn("pit_playerid");
-            const InsertQuery::columnIndex itemsLineColumn = itemsQuery.addColumn("pit_linenumber");
-            const InsertQuery::columnIndex itemsContainerColumn = itemsQuery.addColumn("pit_in_container");
-            const InsertQuery::columnIndex itemsDepotColumn = itemsQuery.addColumn("pit_depot");
-            const InsertQuery::columnIndex itemsItmIdColumn = itemsQuery.addColumn("pit_itemid");
-            const InsertQuery::columnIndex itemsWearColumn = itemsQuery.addColumn("pit_wear");
-            const InsertQuery::columnIndex itemsNumberColumn = itemsQuery.addColumn("pit_number");
-            const InsertQuery::columnIndex itemsQualColumn = itemsQuery.addColumn("pit_quality");
-            const InsertQuery::columnIndex itemsSlotColumn = itemsQuery.addColumn("pit_containerslot");
-            itemsQuery.setServerTable("playeritems");
-
-            InsertQuery dataQuery(connection);
-            const InsertQuery::columnIndex dataPlyIdColumn = dataQuery.addColumn("idv_playerid");
-            const InsertQuery::columnIndex dataLineColumn = dataQuery.addColumn("idv_linenumber");
-            const InsertQuery::columnIndex dataKeyColumn = dataQuery.addColumn("idv_key");
-            const InsertQuery::columnIndex dataValueColumn = dataQuery.addColumn("idv_value");
-            dataQuery.setServerTable("playeritem_datavalues");
-
-            int linenumber = 0;
-
-            // save all items directly on the body...
-            for (int thisItemSlot = 0; thisItemSlot < MAX_BODY_ITEMS + MAX_BELT_SLOTS; ++thisItemSlot) {
-                ++linenumber;
-
-                // if there is no item on this place, do not save it
-                if (items.at(thisItemSlot).getId() == 0) {
-                    continue;
-                }
+        for (const auto &slotAndItem : containedItems) {
+            const Item &item = slotAndItem.second;
+            tables.items.push_back({++linenumber, (int16_t)currentContainerStruct.id,
+                                    (int32_t)currentContainerStruct.depotid, item.getId(), item.getWear(),
+                                    item.getNumber(), item.getQuality(), slotAndItem.first});
 
-                itemsQuery.addValue<int32_t>(itemsLineColumn, linenumber);
-                itemsQuery.addValue<int16_t>(itemsContainerColumn, 0);
-                itemsQuery.addValue<int32_t>(itemsDepotColumn, 0);
-                itemsQuery.addValue<TYPE_OF_ITEM_ID>(itemsItmIdColumn, items.at(thisItemSlot).getId());
-                itemsQuery.addValue<uint16_t>(itemsWearColumn, items.at(thisItemSlot).getWear());
-                itemsQuery.addValue<uint16_t>(itemsNumberColumn, items.at(thisItemSlot).getNumber());
-                itemsQuery.addValue<uint16_t>(itemsQualColumn, items.at(thisItemSlot).getQuality());
-                itemsQuery.addValue<TYPE_OF_CONTAINERSLOTS>(itemsSlotColumn, 0);
-
-                for (auto it = items.at(thisItemSlot).getDataBegin(); it != items.at(thisItemSlot).getDataEnd(); ++it) {
-                    if (it->second.length() > 0) {
-                        dataQuery.addValue<int32_t>(dataLineColumn, linenumber);
-                        dataQuery.addValue<std::string>(dataKeyColumn, it->first);
-                        dataQuery.addValue<std::string>(dataValueColumn, it->second);
-                    }
-                }
+            for (auto it = item.getDataBegin(); it != item.getDataEnd(); ++it) {
+                tables.itemData.push_back({linenumber, it->first, it->second});
             }
 
-            // add backpack contents...
-            while (!containers.empty()) {
-                // get container to save...
-                container_struct &currentContainerStruct = containers.front();
-                Container &currentContainer = *currentContainerStruct.container;
-                auto containedItems = currentContainer.getItems();
-
-                for (const auto &slotAndItem : containedItems) {
-                    const Item &item = slotAndItem.second;
-                    itemsQuery.addValue<int32_t>(itemsLineColumn, ++linenumber);
-                    itemsQuery.addValue<int16_t>(itemsContainerColumn, (int16_t)currentContainerStruct.id);
-                    itemsQuery.addValue<int32_t>(itemsDepotColumn, (int32_t)currentContainerStruct.depotid);
-                    itemsQuery.addValue<TYPE_OF_ITEM_ID>(itemsItmIdColumn, item.getId());
-                    itemsQuery.addValue<uint16_t>(itemsWearColumn, item.getWear());
-                    itemsQuery.addValue<uint16_t>(itemsNumberColumn, item.getNumber());
-                    itemsQuery.addValue<uint16_t>(itemsQualColumn, item.getQuality());
-                    itemsQuery.addValue<TYPE_OF_CONTAINERSLOTS>(itemsSlotColumn, slotAndItem.first);
-
-                    for (auto it = item.getDataBegin(); it != item.getDataEnd(); ++it) {
-                        dataQuery.addValue<int32_t>(dataLineColumn, linenumber);
-                        dataQuery.addValue<std::string>(dataKeyColumn, it->first);
-                        dataQuery.addValue<std::string>(dataValueColumn, it->second);
-                    }
-
-                    // if it is a container, add it to the list of containers to save...
-                    if (item.isContainer()) {
-                        auto containedContainers = currentContainer.getContainers();
-                        auto iterat = containedContainers.find(slotAndItem.first);
+            // if it is a container, add it to the list of containers to save...
+            if (item.isContainer()) {
+                const auto &containedContainers = currentContainer.getContainers();
+                auto iterat = containedContainers.find(slotAndItem.first);
 
-                        if (iterat != containedContainers.end()) {
-                            containers.emplace_back(iterat->second, linenumber);
-                        }
-                    }
+                if (iterat != containedContainers.end()) {
+                    containers.emplace_back(iterat->second, linenumber);
                 }
-
-                containers.pop_front();
             }
-
-            itemsQuery.addValues(itemsPlyIdColumn, getId(), InsertQuery::FILL);
-            dataQuery.addValues(dataPlyIdColumn, getId(), InsertQuery::FILL);
-
-            itemsQuery.execute();
-            dataQuery.execute();
-        }
-
-        connection->commitTransaction();
-
-        if (!effects.save()) {
-            Logger::error(LogFacility::Player) << "error while saving lteffects for " << to_string() << Log::end;
         }
 
-        return true;
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::Player) << "Playersave caught exception: " << e.what() << Log::end;
-        connection->rollbackTransaction();
-        return false;
+        containers.pop_front();
     }
+
+    return tables;
 }
 
 auto Player::loadGMFlags() noexcept -> bool {
@@ -1321,109 +1189,63 @@ auto Player::load() noexcept -> bool {
     bool dataOK = true;
 
     using namespace Database;
-    PConnection connection = ConnectionManager::getInstance().getConnection();
 
     try {
+        PConnection connection = ConnectionManager::getInstance().getConnection();
+
+        // all character tables are sent at once and come back in a single round trip
+        std::vector<std::string> queries;
+
         {
-            SelectQuery query;
+            SelectQuery query(connection);
             query.addColumn("questprogress", "qpg_questid");
             query.addColumn("questprogress", "qpg_progress");
             query.addColumn("questprogress", "qpg_time");
             query.addEqualCondition<TYPE_OF_CHARACTER_ID>("questprogress", "qpg_userid", getId());
             query.addServerTable("questprogress");
-
-            Result results = query.execute();
-
-            for (const auto &row : results) {
-                const auto questId = row["qpg_questid"].as<TYPE_OF_QUEST_ID>();
-                const auto questStatus = row["qpg_progress"].as<TYPE_OF_QUESTSTATUS>(0);
-                const auto questTime = row["qpg_time"].as<int>();
-                quests[questId] = std::make_pair(questStatus, questTime);
-            }
+            queries.push_back(query.buildQuery());
         }
 
         {
-            SelectQuery query;
+            SelectQuery query(connection);
             query.addColumn("introduction", "intro_known_player");
             query.addEqualCondition<TYPE_OF_CHARACTER_ID>("introduction", "intro_player", getId());
             query.addServerTable("introduction");
-
-            Result results = query.execute();
-
-            for (const auto &row : results) {
-                knownPlayers.insert(row["intro_known_player"].as<TYPE_OF_CHARACTER_ID>());
-            }
+            queries.push_back(query.buildQuery());
         }
 
         {
-            SelectQuery query;
+            SelectQuery query(connection);
             query.addColumn("naming", "name_named_player");
             query.addColumn("naming", "name_player_name");
             query.addEqualCondition<TYPE_OF_CHARACTER_ID>("naming", "name_player", getId());
             query.addServerTable("naming");
-
-            Result results = query.execute();
-
-            for (const auto &row : results) {
-                namedPlayers.emplace(row["name_named_player"].as<TYPE_OF_CHARACTER_ID>(),
-                                     row["name_player_name"].as<std::string>());
-            }
+            queries.push_back(query.buildQuery());
         }
 
         {
-            SelectQuery query;
+            SelectQuery query(connection);
             query.addColumn("playerskills", "psk_skill_id");
             query.addColumn("playerskills", "psk_value");
             query.addColumn("playerskills", "psk_minor");
             query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playerskills", "psk_playerid", getId());
             query.addServerTable("playerskills");
-
-            Result results = query.execute();
-
-            if (!results.empty()) {
-                for (const auto &row : results) {
-                    setSkill(row["psk_skill_id"].as<uint16_t>(), row["psk_value"].as<uint16_t>(),
-                             row["psk_minor"].as<uint16_t>());
-                }
-            } else {
-                Logger::warn(LogFacility::Player) << to_string() << " has no skills" << Log::end;
-            }
+            queries.push_back(query.buildQuery());
         }
 
-        // load data values
-        std::vector<uint16_t> ditemlinenumber;
-        std::vector<std::string> key;
-        std::vector<std::string> value;
         {
-            SelectQuery query;
+            SelectQuery query(connection);
             query.addColumn("playeritem_datavalues", "idv_linenumber");
             query.addColumn("playeritem_datavalues", "idv_key");
             query.addColumn("playeritem_datavalues", "idv_value");
             query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playeritem_datavalues", "idv_playerid", getId());
             query.addOrderBy("playeritem_datavalues", "idv_linenumber", SelectQuery::ASC);
             query.addServerTable("playeritem_datavalues");
-
-            Result results = query.execute();
-
-            for (const auto &row : results) {
-                ditemlinenumber.push_back(row["idv_linenumber"].as<uint16_t>());
-                key.push_back(row["idv_key"].as<std::string>());
-                value.push_back(row["idv_value"].as<std::string>());
-            }
+            queries.push_back(query.buildQuery());
         }
-        size_t dataRows = ditemlinenumber.size();
 
-        // load inventory
-        std::vector<uint16_t> itemlinenumber;
-        std::vector<uint16_t> itemincontainer;
-        std::vector<uint32_t> itemdepot;
-        std::vector<Item::id_type> itemid;
-        std::vector<Item::wear_type> itemwear;
-        std::vector<Item::number_type> itemnumber;
-        std::vector<Item::quality_type> itemquality;
-        std::vector<TYPE_OF_CONTAINERSLOTS> itemcontainerslot;
         {
-            SelectQuery query;
+            SelectQuery query(connection);
             query.addColumn("playeritems", "pit_linenumber");
             query.addColumn("playeritems", "pit_in_container");
             query.addColumn("playeritems", "pit_depot");
@@ -1435,44 +1257,94 @@ auto Player::load() noexcept -> bool {
             query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playeritems", "pit_playerid", getId());
             query.addOrderBy("playeritems", "pit_linenumber", SelectQuery::ASC);
             query.addServerTable("playeritems");
+            queries.push_back(query.buildQuery());
+        }
+
+        LongTimeCharacterEffects::addLoadQueries(connection, getId(), queries);
+
+        connection->beginTransaction();
+        const auto results = connection->queryAll(queries);
+        connection->commitTransaction();
+
+        const auto &questResults = results[0];
+        const auto &introductionResults = results[1];
+        const auto &namingResults = results[2];
+        const auto &skillResults = results[3];
+        const auto &dataResults = results[4];
+        const auto &itemResults = results[5];
+        const auto &effectResults = results[6];
+        const auto &effectValueResults = results[7];
+
+        for (const auto &row : questResults) {
+            const auto questId = row["qpg_questid"].as<TYPE_OF_QUEST_ID>();
+            const auto questStatus = row["qpg_progress"].as<TYPE_OF_QUESTSTATUS>(0);
+            const auto questTime = row["qpg_time"].as<int>();
+            quests[questId] = std::make_pair(questStatus, questTime);
+        }
+
+        for (const auto &row : introductionResults) {
+            knownPlayers.insert(row["intro_known_player"].as<TYPE_OF_CHARACTER_ID>());
+        }
 
-            Result results = query.execute();
-
-            for (const auto &row : results) {
-                itemlinenumber.push_back(row["pit_linenumber"].as<uint16_t>());
-                itemincontainer.push_back(row["pit_in_container"].as<uint16_t>());
-                itemdepot.push_back(row["pit_depot"].as<uint32_t>());
-                itemid.push_back(row["pit_itemid"].as<Item::id_type>());
-                itemwear.push_back((Item::wear_type)(row["pit_wear"].as<uint16_t>()));
-                itemnumber.push_back(row["pit_number"].as<Item::number_type>());
-                itemquality.push_back(row["pit_quality"].as<Item::quality_type>());
-                itemcontainerslot.push_back(row["pit_containerslot"].as<TYPE_OF_CONTAINERSLOTS>());
+        for (const auto &row : namingResults) {
+            namedPlayers.emplace(row["name_named_player"].as<TYPE_OF_CHARACTER_ID>(),
+                                 row["name_player_name"].as<std::string>());
+        }
+
+        if (!skillResults.empty()) {
+            for (const auto &row : skillResults) {
+                setSkill(row["psk_skill_id"].as<uint16_t>(), row["psk_value"].as<uint16_t>(),
+                         row["psk_minor"].as<uint16_t>());
             }
+        } else {
+            Logger::warn(LogFacility::Player) << to_string() << " has no skills" << Log::end;
         }
-        size_t itemRows = itemlinenumber.size();
 
-        // load depots
-        std::vector<uint32_t> depotid;
-        {
-            SelectQuery query;
-            query.setDistinct(true);
-            query.addColumn("playeritems", "pit_depot");
-            query.addEqualCondition<TYPE_OF_CHARACTER_ID>("playeritems", "pit_playerid", getId());
-            query.addServerTable("playeritems");
+        effects.restore(effectResults, effectValueResults);
 
-            Result results = query.execute();
+        // load data values
+        std::vector<uint16_t> ditemlinenumber;
+        std::vector<std::string> key;
+        std::vector<std::string> value;
 
-            ranges::for_each(results, [&depotid](const ResultTuple &row) {
-                depotid.push_back(row["pit_depot"].as<uint32_t>());
-            });
+        for (const auto &row : dataResults) {
+            ditemlinenumber.push_back(row["idv_linenumber"].as<uint16_t>());
+            key.push_back(row["idv_key"].as<std::string>());
+            value.push_back(row["idv_value"].as<std::string>());
         }
 
-        size_t depotRows = depotid.size();
+        size_t dataRows = ditemlinenumber.size();
 
-        for (size_t i = 0; i < depotRows; ++i) {
-            if (depotid[i] != 0) {
-                depotContents[depotid[i]] = new Container(DEPOTITEM);
-                depots[depotid[i]] = depotContents[depotid[i]];
+        // load inventory
+        std::vector<uint16_t> itemlinenumber;
+        std::vector<uint16_t> itemincontainer;
+        std::vector<uint32_t> itemdepot;
+        std::vector<Item::id_type> itemid;
+        std::vector<Item::wear_type> itemwear;
+        std::vector<Item::number_type> itemnumber;
+        std::vector<Item::quality_type> itemquality;
+        std::vector<TYPE_OF_CONTAINERSLOTS> itemcontainerslot;
+
+        for (const auto &row : itemResults) {
+            itemlinenumber.push_back(row["pit_linenumber"].as<uint16_t>());
+            itemincontainer.push_back(row["pit_in_container"].as<uint16_t>());
+            itemdepot.push_back(row["pit_depot"].as<uint32_t>());
+            itemid.push_back(row["pit_itemid"].as<Item::id_type>());
+            itemwear.push_back((Item::wear_type)(row["pit_wear"].as<uint16_t>()));
+            itemnumber.push_back(row["pit_number"].as<Item::number_type>());
+            itemquality.push_back(row["pit_quality"].as<Item::quality_type>());
+            itemcontainerslot.push_back(row["pit_containerslot"].as<TYPE_OF_CONTAINERSLOTS>());
+        }
+
+        size_t itemRows = itemlinenumber.size();
+
+        // load depots, every depot holding items is known from the item rows already
+        std::set<uint32_t> depotid(itemdepot.begin(), itemdepot.end());
+
+        for (const auto depot : depotid) {
+            if (depot != 0) {
+                depotContents[depot] = new Container(DEPOTITEM);
+                depots[depot] = depotContents[depot];
             }
         }
 
@@ -1570,6 +1442,8 @@ auto Player::load() noexcept -> bool {
         }
 
         backPackContents = nullptr;
+    } else {
+        savedTables = snapshotTables();
     }
 
     //#endif
@@ -2131,76 +2005,46 @@ auto Player::getSkillName(TYPE_OF_SKILL_ID s) const -> std::string {
 
 auto Player::getPlayerLanguage() const -> Language { return _player_language; }
 
-void Player::sendRelativeArea(Coordinate zoffs) {
-    if ((screenwidth == 0) && (screenheight == 0)) {
-        // static view
-        Coordinate x = getPosition().x;
-        Coordinate y = getPosition().y - MAP_DIMENSION;
-        Coordinate z = getPosition().z + zoffs;
-        Coordinate e = zoffs * 3;
-
-        if (zoffs < 0) {
-            x -= e;
-            y += e;
-            e = 0;
-        }
-
-        World *world = World::get();
-
-        for (Coordinate i = 0; i <= (MAP_DIMENSION + MAP_DOWN_EXTRA + e) * 2; ++i) {
-            world->clientview.fillStripe(position(x, y, z), NewClientView::dir_right, MAP_DIMENSION + 1 - (i % 2));
+void Player::sendFullMap() {
+    std::vector<NewClientView::StripeRequest> stripes;
+    NewClientView::addFullMapStripes(getPosition(), screenwidth, screenheight, stripes);
+    sendStripes(stripes);
+    Connection->addCommand(std::make_shared<MapCompleteTC>());
+}
 
-            if (world->clientview.getExists()) {
-                Connection->addCommand(std::make_shared<MapStripeTC>(position(x, y, z), NewClientView::dir_right));
-            }
+void Player::sendStripes(const std::vector<NewClientView::StripeRequest> &stripes) {
+    if (!batchedMapStripes) {
+        const auto encoded = _world->getMapStripes(stripes);
 
-            if (i % 2 == 0) {
-                y += 1;
-            } else {
-                x -= 1;
-            }
+        for (size_t i = 0; i < stripes.size(); ++i) {
+            Connection->addCommand(std::make_shared<MapStripeTC>(stripes[i], *encoded[i]));
         }
-    } else {
-        // dynamic view
-        Coordinate x = getPosition().x - screenwidth + screenheight;
-        Coordinate y = getPosition().y - screenwidth - screenheight;
-        Coordinate z = getPosition().z + zoffs;
-        Coordinate e = zoffs * 3;
 
-        if (zoffs < 0) {
-            x -= e;
-            y += e;
-            e = 0;
-        }
-
-        // schleife von 0ben nach unten durch alle tiles
-        World *world = World::get();
+        return;
+    }
 
-        for (Coordinate i = 0; i <= (2 * screenheight + MAP_DOWN_EXTRA + e) * 2; ++i) {
-            world->clientview.fillStripe(position(x, y, z), NewClientView::dir_right, 2 * screenwidth + 1 - (i % 2));
+    const auto encoding = NewClientView::encoding_compact;
+    const auto encoded = _world->getMapStripes(stripes, encoding);
+    size_t first = 0;
 
-            if (world->clientview.getExists()) {
-                Connection->addCommand(std::make_shared<MapStripeTC>(position(x, y, z), NewClientView::dir_right));
-            }
+    while (first < stripes.size()) {
+        size_t last = first + 1;
+        size_t bytes = encoded[first]->bytes.size();
 
-            if (i % 2 == 0) {
-                y += 1;
-            } else {
-                x -= 1;
-            }
+        while (last < stripes.size() && last - first < MapStripesTC::maxStripes &&
+               bytes + encoded[last]->bytes.size() <= MapStripesTC::maxBytes) {
+            bytes += encoded[last]->bytes.size();
+            ++last;
         }
-    }
-}
 
-void Player::sendFullMap() {
-    for (Coordinate i = -2; i <= 2; ++i) {
-        sendRelativeArea(i);
+        Connection->addCommand(
+                std::make_shared<MapStripesTC>(encoding, &stripes[first], &encoded[first], last - first));
+        first = last;
     }
-
-    Connection->addCommand(std::make_shared<MapCompleteTC>());
 }
 
-void Player::sendDirStripe(viewdir direction, bool extraStripeForDiagonalMove) {
+void Player::addDirStripes(viewdir direction, bool extraStripeForDiagonalMove,
+                           std::vector<NewClientView::StripeRequest> &stripes) const {
     const auto &pos = getPosition();
 
     if ((screenwidth == 0) && (screenheight == 0)) {
@@ -2258,8 +2102,6 @@ void Player::sendDirStripe(viewdir direction, bool extraStripeForDiagonalMove) {
             break;
         }
 
-        NewClientView *view = &(World::get()->clientview);
-
         for (Coordinate z = -2; z <= 2; ++z) {
             Coordinate e =
                     (direction != lower && z > 0) ? z * 3 : 0; // left, right and upper stripes moved up if z>0 to
@@ -2272,12 +2114,7 @@ void Player::sendDirStripe(viewdir direction, bool extraStripeForDiagonalMove) {
                 ++l;
             }
 
-            view->fillStripe(position(x - z * 3 + e, y + z * 3 - e, pos.z + z), dir, length + l);
-
-            if (view->getExists()) {
-                Connection->addCommand(
-                        std::make_shared<MapStripeTC>(position(x - z * 3 + e, y + z * 3 - e, pos.z + z), dir));
-            }
+            stripes.push_back({position(x - z * 3 + e, y + z * 3 - e, pos.z + z), dir, Coordinate(length + l)});
         }
     } else {
         // dynamic view
@@ -2336,8 +2173,6 @@ void Player::sendDirStripe(viewdir direction, bool extraStripeForDiagonalMove) {
             break;
         }
 
-        NewClientView *view = &(World::get()->clientview);
-
         for (Coordinate z = -2; z <= 2; ++z) {
             Coordinate e =
                     (direction != lower && z > 0) ? z * 3 : 0; // left, right and upper stripes moved up if z>0 to
@@ -2350,78 +2185,72 @@ void Player::sendDirStripe(viewdir direction, bool extraStripeForDiagonalMove) {
                 ++l;
             }
 
-            view->fillStripe(position(x - z * 3 + e, y + z * 3 - e, pos.z + z), dir, length + l);
-
-            if (view->getExists()) {
-                Connection->addCommand(
-                        std::make_shared<MapStripeTC>(position(x - z * 3 + e, y + z * 3 - e, pos.z + z), dir));
-            }
+            stripes.push_back({position(x - z * 3 + e, y + z * 3 - e, pos.z + z), dir, Coordinate(length + l)});
         }
     }
 }
 
 void Player::sendStepStripes(direction dir) {
+    std::vector<NewClientView::StripeRequest> stripes;
+
     switch (dir) {
     case (dir_north):
         // bewegung nach norden (Mapstripe links und oben)
-        sendDirStripe(upper, false);
-        sendDirStripe(left, false);
+        addDirStripes(upper, false, stripes);
+        addDirStripes(left, false, stripes);
         break;
 
     case (dir_northeast):
         // bewegung nach nordosten (Mapstripe oben)
-        sendDirStripe(upper, true);
-        sendDirStripe(upper, false);
+        addDirStripes(upper, true, stripes);
+        addDirStripes(upper, false, stripes);
         break;
 
     case (dir_east):
         // bewegung nach osten (Mapstripe oben und rechts)
-        sendDirStripe(upper, false);
-        sendDirStripe(right, false);
+        addDirStripes(upper, false, stripes);
+        addDirStripes(right, false, stripes);
         break;
 
     case (dir_southeast):
         // bewegung suedosten (Mapstripe  rechts)
-        sendDirStripe(right, true);
-        sendDirStripe(right, false);
+        addDirStripes(right, true, stripes);
+        addDirStripes(right, false, stripes);
         break;
 
     case (dir_south):
         // bewegung sueden (Mapstripe rechts und unten)
-        sendDirStripe(right, false);
-        sendDirStripe(lower, false);
+        addDirStripes(right, false, stripes);
+        addDirStripes(lower, false, stripes);
         break;
 
     case (dir_southwest):
         // bewegung suedwesten ( Mapstripe unten )
-        sendDirStripe(lower, true);
-        sendDirStripe(lower, false);
+        addDirStripes(lower, true, stripes);
+        addDirStripes(lower, false, stripes);
         break;
 
     case (dir_west):
         // bewegung westen ( Mapstripe unten und links)
-        sendDirStripe(lower, false);
-        sendDirStripe(left, false);
+        addDirStripes(lower, false, stripes);
+        addDirStripes(left, false, stripes);
         break;
 
     case (dir_northwest):
         // bewegung nordwesten ( Mapstripe links )
-        sendDirStripe(left, true);
-        sendDirStripe(left, false);
+        addDirStripes(left, true, stripes);
+        addDirStripes(left, false, stripes);
         break;
 
     default:
         break;
     }
+
+    sendStripes(stripes);
 }
 
 void Player::sendField(const position &pos) {
-    auto &view = World::get()->clientview;
-    view.fillStripe(pos, NewClientView::dir_right, 1);
-
-    if (view.getExists()) {
-        Connection->addCommand(std::make_shared<MapStripeTC>(pos, NewClientView::dir_right));
-    }
+    sendStripes({{pos, NewClientView::dir_right, 1}});
 }
 
 auto Player::idleTime() const -> uint32_t {
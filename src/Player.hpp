@@ -21,6 +21,9 @@
 
 #include "Character.hpp"
 #include "Item.hpp"
+#include "MPSCQueue.hpp"
+#include "NewClientView.hpp"
+#include "PlayerSnapshot.hpp"
 #include "Showcase.hpp"
 #include "dialog/MerchantDialog.hpp"
 #include "dialog/SelectionDialog.hpp"
@@ -28,9 +31,9 @@
 #include "netinterface/NetInterface.hpp"
 #include "script/LuaScript.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <memory>
-#include <queue>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -134,13 +137,23 @@ public:
     auto getScreenRange() const -> Coordinate override;
 
 private:
+    // client understands MapStripesTC with compact encoding
+    bool batchedMapStripes = false;
+
     std::set<uint32_t> visibleChars;
     std::unordered_set<TYPE_OF_CHARACTER_ID> knownPlayers;
     std::unordered_map<TYPE_OF_CHARACTER_ID, std::string> namedPlayers;
-    using CLIENTCOMMANDLIST = std::queue<ClientCommandPointer>;
-    CLIENTCOMMANDLIST immediateCommands;
-    CLIENTCOMMANDLIST queuedCommands;
-    std::mutex commandMutex;
+    // the tables as they are in the database after the last load or save,
+    // saves skip the ones that did not change
+    PlayerSnapshot::Tables savedTables;
+    // filled by the network thread of the connection, worked out by the game loop
+    using CLIENTCOMMANDLIST = MPSCQueue<ClientCommandPointer>;
+    CLIENTCOMMANDLIST immediateCommands{playerCommandQueueSize};
+    CLIENTCOMMANDLIST queuedCommands{playerCommandQueueSize};
+    // true while the player waits in the immediate action queue of the world
+    std::atomic_bool commandsPending = false;
+    // commands dropped since a queue of the player ran full, reported once the flood is over
+    std::atomic<uint32_t> droppedCommands = 0;
 
 public:
     void receiveCommand(const ClientCommandPointer &cmd);
@@ -262,8 +275,8 @@ public:
     // Checks if a Player has a special GM right
     auto hasGMRight(gm_rights right) const -> bool;
 
-    //! save char to db
-    auto save() noexcept -> bool;
+    //! copies everything a save writes, so that it can be written after the player is gone
+    auto createSnapshot() -> PlayerSnapshot;
 
     //! load data from db
     // \param no_attributes don't load contents of table "player"
@@ -275,22 +288,24 @@ public:
     auto loadGMFlags() noexcept -> bool;
 
     /**
-     * sends one area relative to the current z coordinate to the player
-     * @param zoffs the offset of the z param of the area which should be sended
+     * sends all areas, the stripes are built on the map view workers
      */
-    void sendRelativeArea(Coordinate zoffs);
+    void sendFullMap();
 
     /**
-     * sends all areas
+     * sends mapstripes, batched into as few commands as possible if the client supports it
+     * @param stripes the position, direction and length of the stripes
      */
-    void sendFullMap();
+    void sendStripes(const std::vector<NewClientView::StripeRequest> &stripes);
 
     /**
-     * sends one complete mapstripe ( z-2, z-1, z, z+1, z+2) to the client
+     * adds one complete mapstripe ( z-2, z-1, z, z+1, z+2)
      * @param direction the direction from which the whole stripe has to be sent
      * @param extraStripeForDiagonalMove send an additional stripe for diagonal moves
+     * @param stripes the list the stripes are appended to
      */
-    void sendDirStripe(viewdir direction, bool extraStripeForDiagonalMove);
+    void addDirStripes(viewdir direction, bool extraStripeForDiagonalMove,
+                       std::vector<NewClientView::StripeRequest> &stripes) const;
 
     void sendStepStripes(direction dir);
 
@@ -552,6 +567,7 @@ public:
 private:
     void startCrafting(uint8_t stillToCraft, uint16_t craftingTime, uint16_t sfx, uint16_t sfxDuration,
                        uint32_t dialogId);
+    [[nodiscard]] auto snapshotTables() const -> PlayerSnapshot::Tables;
 
     Language _player_language{};
 
@@ -25,10 +25,12 @@
 #include "Player.hpp"
 #include "World.hpp"
 #include "main_help.hpp"
+#include "netinterface/NetInterface.hpp"
 #include "netinterface/protocol/BBIWIServerCommands.hpp"
 #include "netinterface/protocol/ClientCommands.hpp"
 #include "netinterface/protocol/ServerCommands.hpp"
 #include "script/LuaLogoutScript.hpp"
+#include "tuningConstants.hpp"
 
 #include <chrono>
 #include <memory>
@@ -36,7 +38,7 @@
 
 std::unique_ptr<PlayerManager> PlayerManager::instance = nullptr;
 std::mutex PlayerManager::mut;
-std::mutex PlayerManager::reloadmutex;
+std::shared_mutex PlayerManager::reloadmutex;
 
 auto PlayerManager::get() -> PlayerManager & {
     if (!instance) {
@@ -49,30 +51,65 @@ auto PlayerManager::get() -> PlayerManager & {
 void PlayerManager::activate() {
     running = true;
 
-    login_thread = std::make_unique<std::thread>(loginLoop, this);
+    saver = std::make_unique<PlayerSaver>(playerSaveWorkers);
+
+    for (int i = 0; i < playerLoadWorkers; ++i) {
+        login_threads.emplace_back(loginLoop, this);
+    }
+
     save_thread = std::make_unique<std::thread>(playerSaveLoop, this);
 }
 
 void PlayerManager::stop() {
     running = false;
 
-    Logger::info(LogFacility::Other) << "Waiting for login thread to terminate ..." << Log::end;
-    login_thread->join();
+    Logger::info(LogFacility::Other) << "Waiting for login threads to terminate ..." << Log::end;
+
+    for (auto &login_thread : login_threads) {
+        login_thread.join();
+    }
 
     Logger::info(LogFacility::Other) << "Waiting for player save thread to terminate ..." << Log::end;
     save_thread->join();
 
+    Logger::info(LogFacility::Other) << "Waiting for player saves to be written ..." << Log::end;
+    saver->flush();
+    const auto statistics = saver->getStatistics();
+    Logger::info(LogFacility::Other) << statistics.players << " players saved, " << statistics.failures << " failed"
+                                     << Log::end;
+
     Logger::info(LogFacility::Other) << "Player manager terminated!" << Log::end;
 }
 
 auto PlayerManager::findPlayer(const std::string &name) const -> bool {
     std::lock_guard<std::mutex> lock(mut);
+    return isKnown(name);
+}
 
+auto PlayerManager::isKnown(const std::string &name) const -> bool {
     using namespace ranges;
     auto hasThisName = [&name](const auto &player) { return player->getName() == name; };
-    return any_of(loggedOutPlayers, hasThisName);
+    return loggingIn.count(name) > 0 || any_of(loggedOutPlayers, hasThisName) || (saver && saver->isSaving(name));
+}
+
+auto PlayerManager::claimLogin(const std::string &name) -> bool {
+    std::lock_guard<std::mutex> lock(mut);
+
+    if (isKnown(name)) {
+        return false;
+    }
+
+    loggingIn.insert(name);
+    return true;
+}
+
+void PlayerManager::loginCompleted(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mut);
+    loggingIn.erase(name);
 }
 
+void PlayerManager::savePlayer(PlayerSnapshot snapshot) { saver->save(std::move(snapshot)); }
+
 void PlayerManager::setLoginLogout(bool val) {
     if (val) {
         reloadmutex.lock();
@@ -87,77 +124,13 @@ void PlayerManager::loginLoop(PlayerManager *pmanager) {
         pmanager->threadOk = true;
 
         while (pmanager->running) {
-            // loop must be steered by counter so we parse every connection only one time bevor we getting to the other
-            // loop
-            int curconn = newplayers.size();
-            unsigned short acceptVersion = Config::instance().clientversion;
-
-            for (int i = 0; i < curconn; ++i) {
-                auto Connection = newplayers.pop_front();
-
-                if (Connection) {
-                    try {
-                        if (!Connection->online) {
-                            throw Player::LogoutException(UNSTABLECONNECTION);
-                        }
-
-                        auto loginData = Connection->getLoginData();
-                        if (loginData != nullptr) {
-                            unsigned short int clientversion = loginData->getClientVersion();
-                            if (clientversion == BBIWIClientVersion) {
-                                // TODO handle login for BBIWI Clients...
-                            } else if (clientversion != acceptVersion) {
-                                Logger::error(LogFacility::Player)
-                                        << loginData->getLoginName() << " tried to login with an old client (version "
-                                        << clientversion << ") but version " << acceptVersion << " is required"
-                                        << Log::end;
-                                throw Player::LogoutException(OLDCLIENT);
-                            }
-
-                            // TODO is this check really necessary?
-                            if (loginData->getLoginName().empty() || loginData->getPassword().empty()) {
-                                throw Player::LogoutException(WRONGPWD);
-                            }
-
-                            // player already online?
-                            if ((World::get()->Players.find(loginData->getLoginName()) != nullptr) ||
-                                PlayerManager::get().findPlayer(loginData->getLoginName())) {
-                                Logger::alert(LogFacility::Player)
-                                        << loginData->getLoginName()
-                                        << " tried to login twice from ip: " << Connection->getIPAdress() << Log::end;
-                                throw Player::LogoutException(DOUBLEPLAYER);
-                            }
-
-                            Player *newPlayer = nullptr;
-                            {
-                                std::lock_guard<std::mutex> lock(reloadmutex);
-                                newPlayer = new Player(Connection);
-                            }
-
-                            pmanager->loggedInPlayers.push_back(newPlayer);
-                            World::get()->scheduler.signalNewPlayerAction();
-
-                            Connection.reset();
-                        } else {
-                            if (Connection->nextInactive()) {
-                                throw Player::LogoutException(UNSTABLECONNECTION);
-                            }
-
-                            newplayers.push_back(Connection);
-                            Connection.reset();
-                        }
-                    } catch (Player::LogoutException &e) {
-                        ServerCommandPointer cmd = std::make_shared<LogOutTC>(e.getReason());
-                        Connection->shutdownSend(cmd);
-                    }
-                } else {
-                    Connection.reset();
-                }
-
-            } // get new players
-
+            // connections are queued as soon as their login arrived, the timeout only serves to notice a stop
+            std::shared_ptr<NetInterface> connection;
             using namespace std::chrono_literals;
-            std::this_thread::sleep_for(100ms);
+
+            if (newplayers.wait_pop_front(connection, 100ms) && connection) {
+                pmanager->login(connection);
+            }
         }
     } catch (std::exception &e) {
     } catch (...) {
@@ -165,6 +138,66 @@ void PlayerManager::loginLoop(PlayerManager *pmanager) {
     }
 }
 
+void PlayerManager::login(const std::shared_ptr<NetInterface> &connection) {
+    try {
+        auto loginData = connection->getLoginData();
+
+        // no login command in time
+        if (!connection->online || loginData == nullptr) {
+            throw Player::LogoutException(UNSTABLECONNECTION);
+        }
+
+        unsigned short acceptVersion = Config::instance().clientversion;
+        unsigned short mapStripesVersion = Config::instance().mapstripesclientversion;
+        unsigned short int clientversion = loginData->getClientVersion();
+
+        if (clientversion == BBIWIClientVersion) {
+            // TODO handle login for BBIWI Clients...
+        } else if (clientversion != acceptVersion && (mapStripesVersion == 0 || clientversion != mapStripesVersion)) {
+            Logger::error(LogFacility::Player) << loginData->getLoginName()
+                                               << " tried to login with an old client (version " << clientversion
+                                               << ") but version " << acceptVersion << " is required" << Log::end;
+            throw Player::LogoutException(OLDCLIENT);
+        }
+
+        // TODO is this check really necessary?
+        if (loginData->getLoginName().empty() || loginData->getPassword().empty()) {
+            throw Player::LogoutException(WRONGPWD);
+        }
+
+        const auto &name = loginData->getLoginName();
+
+        // player already online?
+        if ((World::get()->Players.find(name) != nullptr) || !claimLogin(name)) {
+            Logger::alert(LogFacility::Player)
+                    << name << " tried to login twice from ip: " << connection->getIPAdress() << Log::end;
+            throw Player::LogoutException(DOUBLEPLAYER);
+        }
+
+        Player *newPlayer = nullptr;
+
+        try {
+            // several login threads load at once, only a reload needs them all to wait
+            std::shared_lock<std::shared_mutex> lock(reloadmutex);
+            newPlayer = new Player(connection);
+        } catch (...) {
+            loginCompleted(name);
+            throw;
+        }
+
+        // the game loop takes a few players per turn, a full queue holds back further logins
+        while (!loggedInPlayers.tryPush(newPlayer)) {
+            using namespace std::chrono_literals;
+            std::this_thread::sleep_for(10ms);
+        }
+
+        World::get()->scheduler.signalNewPlayerAction();
+    } catch (Player::LogoutException &e) {
+        ServerCommandPointer cmd = std::make_shared<LogOutTC>(e.getReason());
+        connection->shutdownSend(cmd);
+    }
+}
+
 void PlayerManager::playerSaveLoop(PlayerManager *pmanager) {
     try {
         World *world = World::get();
@@ -178,8 +211,8 @@ void PlayerManager::playerSaveLoop(PlayerManager *pmanager) {
 
                     if (!tmpPl->isMonitoringClient()) {
                         {
-                            std::lock_guard<std::mutex> lock(reloadmutex);
-                            tmpPl->save();
+                            std::shared_lock<std::shared_mutex> lock(reloadmutex);
+                            pmanager->savePlayer(tmpPl->createSnapshot());
                         }
                         tmpPl->Connection->closeConnection();
                         ServerCommandPointer cmd = std::make_shared<BBLogOutTC>(tmpPl->getId());
@@ -20,13 +20,21 @@
 #define PLAYERMANAGER_HPP
 
 #include "InitialConnection.hpp"
+#include "MPSCQueue.hpp"
+#include "PlayerSaver.hpp"
 #include "thread_safe_vector.hpp"
+#include "tuningConstants.hpp"
 
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <thread>
+#include <unordered_set>
+#include <vector>
 
+class NetInterface;
 class Player;
 
 class PlayerManager {
@@ -40,12 +48,19 @@ public:
 
     [[nodiscard]] auto findPlayer(const std::string &name) const -> bool;
 
+    // called by the main loop once a loaded player was taken over into the world
+    void loginCompleted(const std::string &name);
+
+    // queues the snapshot to be written in the background
+    void savePlayer(PlayerSnapshot snapshot);
+
     static void setLoginLogout(bool val);
 
     using TPLAYERVECTOR = thread_safe_vector<Player *>;
+    using LoggedInQueue = MPSCQueue<Player *>;
 
     auto getLogOutPlayers() -> TPLAYERVECTOR & { return loggedOutPlayers; }
-    auto getLogInPlayers() -> TPLAYERVECTOR & { return loggedInPlayers; }
+    auto getLogInPlayers() -> LoggedInQueue & { return loggedInPlayers; }
 
 private:
     static std::unique_ptr<PlayerManager> instance;
@@ -56,10 +71,14 @@ private:
      */
     static void loginLoop(PlayerManager *pmanager);
     static void playerSaveLoop(PlayerManager *pmanager);
+    void login(const std::shared_ptr<NetInterface> &connection);
+    // reserves the name for this login, false if the player is online or logging in already
+    auto claimLogin(const std::string &name) -> bool;
+    [[nodiscard]] auto isKnown(const std::string &name) const -> bool;
     static std::mutex mut;
 
     // Mutex der gesetzt wird beim reloaden. (Als multi read single write lock)
-    static std::mutex reloadmutex;
+    static std::shared_mutex reloadmutex;
 
     /**
      * true if the thread is running
@@ -82,16 +101,26 @@ private:
     TPLAYERVECTOR loggedOutPlayers;
 
     /**
-     * players which are logged in and correctly loaded
+     * players which are logged in and correctly loaded, filled by the login threads
+     */
+    LoggedInQueue loggedInPlayers{loggedInPlayerQueueSize};
+
+    /**
+     * names of the players being loaded or waiting for the main loop, guarded by mut
      */
-    TPLAYERVECTOR loggedInPlayers;
+    std::unordered_set<std::string> loggingIn;
 
     /**
      * initial connection to get the new connections
      */
     std::shared_ptr<InitialConnection> incon = InitialConnection::create();
 
-    std::unique_ptr<std::thread> login_thread = nullptr;
+    /**
+     * writes the players saved by the save thread to the database
+     */
+    std::unique_ptr<PlayerSaver> saver = nullptr;
+
+    std::vector<std::thread> login_threads;
     std::unique_ptr<std::thread> save_thread = nullptr;
 };
 
@@ -0,0 +1,460 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "PlayerSaver.hpp"
+
+#include "Logger.hpp"
+#include "db/ConnectionManager.hpp"
+#include "db/DeleteQuery.hpp"
+#include "db/InsertQuery.hpp"
+#include "db/UpdateQuery.hpp"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+void deleteRows(const Database::PConnection &connection, const std::string &table, const std::string &playerColumn,
+                const std::vector<TYPE_OF_CHARACTER_ID> &players) {
+    if (players.empty()) {
+        return;
+    }
+
+    Database::DeleteQuery query(connection);
+    query.addInCondition<TYPE_OF_CHARACTER_ID>(table, playerColumn, players);
+    query.setServerTable(table);
+    query.execute();
+}
+
+void updateStatus(const Database::PConnection &connection, const PlayerSnapshot &snapshot) {
+    const auto &status = snapshot.status;
+    Database::UpdateQuery query(connection);
+    query.addAssignColumn<uint16_t>("chr_status", status.status);
+    query.addAssignColumn<std::string>("chr_lastip", status.lastIp);
+    query.addAssignColumn<uint32_t>("chr_onlinetime", status.onlineTime);
+    query.addAssignColumn<time_t>("chr_lastsavetime", status.lastSaveTime);
+
+    if (status.status != 0) {
+        query.addAssignColumn<time_t>("chr_statustime", status.statusTime);
+        query.addAssignColumn<TYPE_OF_CHARACTER_ID>("chr_statusgm", status.statusGm);
+        query.addAssignColumn<std::string>("chr_statusreason", status.statusReason);
+    } else {
+        query.addAssignColumnNull("chr_statustime");
+        query.addAssignColumnNull("chr_statusgm");
+        query.addAssignColumnNull("chr_statusreason");
+    }
+
+    query.addEqualCondition<TYPE_OF_CHARACTER_ID>("chars", "chr_playerid", snapshot.id);
+    query.setServerTable("chars");
+    query.execute();
+}
+
+void updateAttributes(const Database::PConnection &connection, const PlayerSnapshot &snapshot) {
+    const auto &attributes = snapshot.attributes;
+    Database::UpdateQuery query(connection);
+    query.addAssignColumn<int32_t>("ply_posx", attributes.x);
+    query.addAssignColumn<int32_t>("ply_posy", attributes.y);
+    query.addAssignColumn<int32_t>("ply_posz", attributes.z);
+    query.addAssignColumn<uint16_t>("ply_faceto", attributes.faceTo);
+    query.addAssignColumn<uint16_t>("ply_hitpoints", attributes.hitpoints);
+    query.addAssignColumn<uint16_t>("ply_mana", attributes.mana);
+    query.addAssignColumn<uint32_t>("ply_foodlevel", attributes.foodLevel);
+    query.addAssignColumn<uint32_t>("ply_lifestate", attributes.lifeState);
+    query.addAssignColumn<uint32_t>("ply_magictype", attributes.magicType);
+    query.addAssignColumn<uint64_t>("ply_magicflagsmage", attributes.mageFlags);
+    query.addAssignColumn<uint64_t>("ply_magicflagspriest", attributes.priestFlags);
+    query.addAssignColumn<uint64_t>("ply_magicflagsbard", attributes.bardFlags);
+    query.addAssignColumn<uint64_t>("ply_magicflagsdruid", attributes.druidFlags);
+    query.addAssignColumn<uint16_t>("ply_poison", attributes.poison);
+    query.addAssignColumn<uint32_t>("ply_mental_capacity", attributes.mentalCapacity);
+    query.addAssignColumn<uint16_t>("ply_hair", attributes.hairType);
+    query.addAssignColumn<uint16_t>("ply_beard", attributes.beardType);
+    query.addAssignColumn<uint16_t>("ply_hairred", attributes.hair.red);
+    query.addAssignColumn<uint16_t>("ply_hairgreen", attributes.hair.green);
+    query.addAssignColumn<uint16_t>("ply_hairblue", attributes.hair.blue);
+    query.addAssignColumn<uint16_t>("ply_hairalpha", attributes.hair.alpha);
+    query.addAssignColumn<uint16_t>("ply_skinred", attributes.skin.red);
+    query.addAssignColumn<uint16_t>("ply_skingreen", attributes.skin.green);
+    query.addAssignColumn<uint16_t>("ply_skinblue", attributes.skin.blue);
+    query.addAssignColumn<uint16_t>("ply_skinalpha", attributes.skin.alpha);
+    query.addEqualCondition<TYPE_OF_CHARACTER_ID>("player", "ply_playerid", snapshot.id);
+    query.addServerTable("player");
+    query.execute();
+}
+
+void writeIntroductions(const Database::PConnection &connection, const std::vector<PlayerSnapshot> &snapshots) {
+    using Database::InsertQuery;
+    std::vector<TYPE_OF_CHARACTER_ID> players;
+    InsertQuery query(connection);
+    const InsertQuery::columnIndex playerColumn = query.addColumn("intro_player");
+    const InsertQuery::columnIndex knownPlayerColumn = query.addColumn("intro_known_player");
+    query.addServerTable("introduction");
+
+    for (const auto &snapshot : snapshots) {
+        if (snapshot.introductionsChanged) {
+            players.push_back(snapshot.id);
+
+            for (const auto knownPlayer : snapshot.tables.introductions) {
+                query.addValue<TYPE_OF_CHARACTER_ID>(playerColumn, snapshot.id);
+                query.addValue<TYPE_OF_CHARACTER_ID>(knownPlayerColumn, knownPlayer);
+            }
+        }
+    }
+
+    deleteRows(connection, "introduction", "intro_player", players);
+    query.execute();
+}
+
+void writeNamings(const Database::PConnection &connection, const std::vector<PlayerSnapshot> &snapshots) {
+    using Database::InsertQuery;
+    std::vector<TYPE_OF_CHARACTER_ID> players;
+    InsertQuery query(connection);
+    const InsertQuery::columnIndex playerColumn = query.addColumn("name_player");
+    const InsertQuery::columnIndex namedPlayerColumn = query.addColumn("name_named_player");
+    const InsertQuery::columnIndex playerNameColumn = query.addColumn("name_player_name");
+    query.addServerTable("naming");
+
+    for (const auto &snapshot : snapshots) {
+        if (snapshot.namingsChanged) {
+            players.push_back(snapshot.id);
+
+            for (const auto &[namedPlayer, name] : snapshot.tables.namings) {
+                query.addValue<TYPE_OF_CHARACTER_ID>(playerColumn, snapshot.id);
+                query.addValue<TYPE_OF_CHARACTER_ID>(namedPlayerColumn, namedPlayer);
+                query.addValue<std::string>(playerNameColumn, name);
+            }
+        }
+    }
+
+    deleteRows(connection, "naming", "name_player", players);
+    query.execute();
+}
+
+void writeSkills(const Database::PConnection &connection, const std::vector<PlayerSnapshot> &snapshots) {
+    using Database::InsertQuery;
+    std::vector<TYPE_OF_CHARACTER_ID> players;
+    InsertQuery query(connection);
+    const InsertQuery::columnIndex playerIdColumn = query.addColumn("psk_playerid");
+    const InsertQuery::columnIndex skillIdColumn = query.addColumn("psk_skill_id");
+    const InsertQuery::columnIndex valueColumn = query.addColumn("psk_value");
+    const InsertQuery::columnIndex minorColumn = query.addColumn("psk_minor");
+    query.addServerTable("playerskills");
+
+    for (const auto &snapshot : snapshots) {
+        if (snapshot.skillsChanged) {
+            players.push_back(snapshot.id);
+
+            for (const auto &skill : snapshot.tables.skills) {
+                query.addValue<TYPE_OF_CHARACTER_ID>(playerIdColumn, snapshot.id);
+                query.addValue<uint16_t>(skillIdColumn, skill.id);
+                query.addValue<uint16_t>(valueColumn, skill.major);
+                query.addValue<uint16_t>(minorColumn, skill.minor);
+            }
+        }
+    }
+
+    deleteRows(connection, "playerskills", "psk_playerid", players);
+    query.execute();
+}
+
+void writeItems(const Database::PConnection &connection, const std::vector<PlayerSnapshot> &snapshots) {
+    using Database::InsertQuery;
+    std::vector<TYPE_OF_CHARACTER_ID> players;
+
+    InsertQuery itemsQuery(connection);
+    const InsertQuery::columnIndex itemsPlyIdColumn = itemsQuery.addColumn("pit_playerid");
+    const InsertQuery::columnIndex itemsLineColumn = itemsQuery.addColumn("pit_linenumber");
+    const InsertQuery::columnIndex itemsContainerColumn = itemsQuery.addColumn("pit_in_container");
+    const InsertQuery::columnIndex itemsDepotColumn = itemsQuery.addColumn("pit_depot");
+    const InsertQuery::columnIndex itemsItmIdColumn = itemsQuery.addColumn("pit_itemid");
+    const InsertQuery::columnIndex itemsWearColumn = itemsQuery.addColumn("pit_wear");
+    const InsertQuery::columnIndex itemsNumberColumn = itemsQuery.addColumn("pit_number");
+    const InsertQuery::columnIndex itemsQualColumn = itemsQuery.addColumn("pit_quality");
+    const InsertQuery::columnIndex itemsSlotColumn = itemsQuery.addColumn("pit_containerslot");
+    itemsQuery.setServerTable("playeritems");
+
+    InsertQuery dataQuery(connection);
+    const InsertQuery::columnIndex dataPlyIdColumn = dataQuery.addColumn("idv_playerid");
+    const InsertQuery::columnIndex dataLineColumn = dataQuery.addColumn("idv_linenumber");
+    const InsertQuery::columnIndex dataKeyColumn = dataQuery.addColumn("idv_key");
+    const InsertQuery::columnIndex dataValueColumn = dataQuery.addColumn("idv_value");
+    dataQuery.setServerTable("playeritem_datavalues");
+
+    for (const auto &snapshot : snapshots) {
+        if (!snapshot.itemsChanged) {
+            continue;
+        }
+
+        players.push_back(snapshot.id);
+
+        for (const auto &item : snapshot.tables.items) {
+            itemsQuery.addValue<TYPE_OF_CHARACTER_ID>(itemsPlyIdColumn, snapshot.id);
+            itemsQuery.addValue<int32_t>(itemsLineColumn, item.line);
+            itemsQuery.addValue<int16_t>(itemsContainerColumn, item.container);
+            itemsQuery.addValue<int32_t>(itemsDepotColumn, item.depot);
+            itemsQuery.addValue<TYPE_OF_ITEM_ID>(itemsItmIdColumn, item.id);
+            itemsQuery.addValue<uint16_t>(itemsWearColumn, item.wear);
+            itemsQuery.addValue<uint16_t>(itemsNumberColumn, item.number);
+            itemsQuery.addValue<uint16_t>(itemsQualColumn, item.quality);
+            itemsQuery.addValue<TYPE_OF_CONTAINERSLOTS>(itemsSlotColumn, item.slot);
+        }
+
+        for (const auto &data : snapshot.tables.itemData) {
+            dataQuery.addValue<TYPE_OF_CHARACTER_ID>(dataPlyIdColumn, snapshot.id);
+            dataQuery.addValue<int32_t>(dataLineColumn, data.line);
+            dataQuery.addValue<std::string>(dataKeyColumn, data.key);
+            dataQuery.addValue<std::string>(dataValueColumn, data.value);
+        }
+    }
+
+    deleteRows(connection, "playeritems", "pit_playerid", players);
+    deleteRows(connection, "playeritem_datavalues", "idv_playerid", players);
+    itemsQuery.execute();
+    dataQuery.execute();
+}
+
+void writeEffects(const Database::PConnection &connection, const std::vector<PlayerSnapshot> &snapshots) {
+    using Database::InsertQuery;
+    std::vector<TYPE_OF_CHARACTER_ID> players;
+
+    InsertQuery effectsQuery(connection);
+    const InsertQuery::columnIndex userColumn = effectsQuery.addColumn("plte_playerid");
+    const InsertQuery::columnIndex effectColumn = effectsQuery.addColumn("plte_effectid");
+    const InsertQuery::columnIndex nextCalledColumn = effectsQuery.addColumn("plte_nextcalled");
+    const InsertQuery::columnIndex numberCalledColumn = effectsQuery.addColumn("plte_numbercalled");
+    effectsQuery.setServerTable("playerlteffects");
+
+    InsertQuery valuesQuery(connection);
+    const InsertQuery::columnIndex valueUserColumn = valuesQuery.addColumn("pev_playerid");
+    const InsertQuery::columnIndex valueEffectColumn = valuesQuery.addColumn("pev_effectid");
+    const InsertQuery::columnIndex nameColumn = valuesQuery.addColumn("pev_name");
+    const InsertQuery::columnIndex valueColumn = valuesQuery.addColumn("pev_value");
+    valuesQuery.setServerTable("playerlteffectvalues");
+
+    for (const auto &snapshot : snapshots) {
+        players.push_back(snapshot.id);
+
+        for (const auto &effect : snapshot.effects) {
+            effectsQuery.addValue<TYPE_OF_CHARACTER_ID>(userColumn, snapshot.id);
+            effectsQuery.addValue<uint16_t>(effectColumn, effect.id);
+            effectsQuery.addValue<int32_t>(nextCalledColumn, effect.nextCalled);
+            effectsQuery.addValue<uint32_t>(numberCalledColumn, effect.calls);
+
+            for (const auto &[name, value] : effect.values) {
+                valuesQuery.addValue<TYPE_OF_CHARACTER_ID>(valueUserColumn, snapshot.id);
+                valuesQuery.addValue<uint16_t>(valueEffectColumn, effect.id);
+                valuesQuery.addValue<std::string>(nameColumn, name);
+                valuesQuery.addValue<uint32_t>(valueColumn, value);
+            }
+        }
+    }
+
+    deleteRows(connection, "playerlteffects", "plte_playerid", players);
+    deleteRows(connection, "playerlteffectvalues", "pev_playerid", players);
+    effectsQuery.execute();
+    valuesQuery.execute();
+}
+
+} // namespace
+
+PlayerSaver::PlayerSaver(size_t threads) {
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+        this->threads.emplace_back([this] { work(); });
+    }
+}
+
+PlayerSaver::~PlayerSaver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    snapshotQueued.notify_all();
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void PlayerSaver::save(PlayerSnapshot snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (queue.empty() && busyThreads == 0) {
+            burstStart = Clock::now();
+            beforeBurst = statistics;
+        }
+
+        saving.insert(snapshot.name);
+        queue.push_back(std::move(snapshot));
+    }
+
+    snapshotQueued.notify_one();
+}
+
+auto PlayerSaver::isSaving(const std::string &name) const -> bool {
+    std::lock_guard<std::mutex> lock(mutex);
+    return saving.count(name) > 0;
+}
+
+void PlayerSaver::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    batchDone.wait(lock, [this] { return queue.empty() && busyThreads == 0; });
+}
+
+auto PlayerSaver::getStatistics() const -> Statistics {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
+
+void PlayerSaver::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        auto batch = takeBatch();
+
+        if (batch.empty()) {
+            if (stopping && queue.empty()) {
+                return;
+            }
+
+            snapshotQueued.wait(lock);
+            continue;
+        }
+
+        ++busyThreads;
+        lock.unlock();
+        writeBatch(batch);
+        lock.lock();
+        --busyThreads;
+
+        for (const auto &snapshot : batch) {
+            writing.erase(snapshot.name);
+            saving.erase(saving.find(snapshot.name));
+        }
+
+        // snapshots held back for these players can be written now
+        snapshotQueued.notify_all();
+
+        if (queue.empty() && busyThreads == 0) {
+            using std::chrono::duration;
+            const duration<double> seconds = std::max<Clock::duration>(Clock::now() - burstStart, 1ms);
+            const auto players = statistics.players - beforeBurst.players;
+            const auto rows = statistics.rows - beforeBurst.rows;
+            Logger::info(LogFacility::Player)
+                    << "Saved " << players << " players with " << rows << " rows in "
+                    << static_cast<int>(seconds.count() * 1000) << "ms: " << static_cast<int>(players / seconds.count())
+                    << " players/s, " << static_cast<int>(rows / seconds.count()) << " rows/s" << Log::end;
+        }
+
+        batchDone.notify_all();
+    }
+}
+
+auto PlayerSaver::takeBatch() -> std::vector<PlayerSnapshot> {
+    std::vector<PlayerSnapshot> batch;
+
+    for (auto it = queue.begin(); it != queue.end() && batch.size() < maxPlayersPerTransaction;) {
+        if (writing.count(it->name) > 0) {
+            ++it;
+            continue;
+        }
+
+        writing.insert(it->name);
+        batch.push_back(std::move(*it));
+        it = queue.erase(it);
+
+        if (failed.count(batch.back().name) > 0) {
+            batch.back().markAllChanged();
+        }
+    }
+
+    return batch;
+}
+
+void PlayerSaver::writeBatch(const std::vector<PlayerSnapshot> &snapshots) {
+    for (const auto &snapshot : snapshots) {
+        Logger::info(LogFacility::Player) << "Saving " << snapshot.description << Log::end;
+    }
+
+    try {
+        write(snapshots);
+        uint64_t rows = 0;
+
+        for (const auto &snapshot : snapshots) {
+            rows += snapshot.rows();
+        }
+
+        finishBatch(snapshots, snapshots.size(), rows);
+        return;
+    } catch (std::exception &e) {
+        if (snapshots.size() == 1) {
+            Logger::error(LogFacility::Player) << "Playersave of " << snapshots.front().description
+                                               << " caught exception: " << e.what() << Log::end;
+            finishBatch(snapshots, 0, 0);
+            return;
+        }
+    }
+
+    // one broken player must not keep the others from being saved
+    for (const auto &snapshot : snapshots) {
+        writeBatch({snapshot});
+    }
+}
+
+void PlayerSaver::finishBatch(const std::vector<PlayerSnapshot> &snapshots, uint64_t savedPlayers, uint64_t rows) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++statistics.transactions;
+    statistics.players += savedPlayers;
+    statistics.failures += snapshots.size() - savedPlayers;
+    statistics.rows += rows;
+
+    for (const auto &snapshot : snapshots) {
+        if (savedPlayers == 0) {
+            failed.insert(snapshot.name);
+        } else {
+            failed.erase(snapshot.name);
+        }
+    }
+}
+
+void PlayerSaver::write(const std::vector<PlayerSnapshot> &snapshots) {
+    using namespace Database;
+    PConnection connection = ConnectionManager::getInstance().getConnection();
+
+    try {
+        connection->beginTransaction();
+
+        for (const auto &snapshot : snapshots) {
+            updateStatus(connection, snapshot);
+            updateAttributes(connection, snapshot);
+        }
+
+        writeIntroductions(connection, snapshots);
+        writeNamings(connection, snapshots);
+        writeSkills(connection, snapshots);
+        writeItems(connection, snapshots);
+        writeEffects(connection, snapshots);
+
+        connection->commitTransaction();
+    } catch (std::exception &) {
+        connection->rollbackTransaction();
+        throw;
+    }
+}
@@ -0,0 +1,102 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PLAYER_SAVER_HPP
+#define PLAYER_SAVER_HPP
+
+#include "PlayerSnapshot.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Writes player snapshots to the database with a few threads. Each thread
+ * takes several queued players at once and writes them in one transaction
+ * with one statement per table. Snapshots of the same player are written one
+ * after the other, in the order they were queued.
+ */
+class PlayerSaver {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Statistics {
+        uint64_t players = 0;
+        uint64_t rows = 0;
+        uint64_t transactions = 0;
+        uint64_t failures = 0;
+    };
+
+    static constexpr size_t maxPlayersPerTransaction = 16;
+
+    explicit PlayerSaver(size_t threads);
+    PlayerSaver(const PlayerSaver &) = delete;
+    auto operator=(const PlayerSaver &) -> PlayerSaver & = delete;
+    PlayerSaver(PlayerSaver &&) = delete;
+    auto operator=(PlayerSaver &&) -> PlayerSaver & = delete;
+    // writes what is still queued
+    ~PlayerSaver();
+
+    void save(PlayerSnapshot snapshot);
+
+    /**
+     * @return true if the player with that name is queued or being written,
+     * loading it now would read outdated data
+     */
+    [[nodiscard]] auto isSaving(const std::string &name) const -> bool;
+
+    // blocks until everything queued so far is written
+    void flush();
+
+    [[nodiscard]] auto getStatistics() const -> Statistics;
+
+    // writes all snapshots in one transaction, throws if that fails
+    static void write(const std::vector<PlayerSnapshot> &snapshots);
+
+private:
+    void work();
+    // takes the next queued snapshots of players that are not being written right now
+    auto takeBatch() -> std::vector<PlayerSnapshot>;
+    void writeBatch(const std::vector<PlayerSnapshot> &snapshots);
+    void finishBatch(const std::vector<PlayerSnapshot> &snapshots, uint64_t savedPlayers, uint64_t rows);
+
+    mutable std::mutex mutex;
+    std::condition_variable snapshotQueued;
+    std::condition_variable batchDone;
+    std::deque<PlayerSnapshot> queue;
+    std::unordered_multiset<std::string> saving;
+    std::unordered_set<std::string> writing;
+    // players whose last save failed, their next snapshot cannot rely on what it was compared with
+    std::unordered_set<std::string> failed;
+    size_t busyThreads = 0;
+    bool stopping = false;
+    Statistics statistics;
+
+    // a burst lasts from the first queued snapshot until all are written
+    Clock::time_point burstStart;
+    Statistics beforeBurst;
+    std::vector<std::thread> threads;
+};
+
+#endif
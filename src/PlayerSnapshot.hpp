@@ -0,0 +1,182 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PLAYER_SNAPSHOT_HPP
+#define PLAYER_SNAPSHOT_HPP
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Everything a player save writes to the database, copied from the player so
+ * that the writing can happen on other threads once the player is gone.
+ */
+struct PlayerSnapshot {
+    // row in chars
+    struct Status {
+        uint16_t status = 0;
+        std::string lastIp;
+        uint32_t onlineTime = 0;
+        time_t lastSaveTime = 0;
+        time_t statusTime = 0;
+        TYPE_OF_CHARACTER_ID statusGm = 0;
+        std::string statusReason;
+    };
+
+    // row in player
+    struct Attributes {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+        uint16_t faceTo = 0;
+        uint16_t hitpoints = 0;
+        uint16_t mana = 0;
+        uint32_t foodLevel = 0;
+        uint32_t lifeState = 0;
+        uint32_t magicType = 0;
+        uint64_t mageFlags = 0;
+        uint64_t priestFlags = 0;
+        uint64_t bardFlags = 0;
+        uint64_t druidFlags = 0;
+        uint16_t poison = 0;
+        uint32_t mentalCapacity = 0;
+        uint16_t hairType = 0;
+        uint16_t beardType = 0;
+        Colour hair;
+        Colour skin;
+    };
+
+    struct Skill {
+        TYPE_OF_SKILL_ID id = 0;
+        uint16_t major = 0;
+        uint16_t minor = 0;
+
+        auto operator==(const Skill &other) const -> bool {
+            return std::tie(id, major, minor) == std::tie(other.id, other.major, other.minor);
+        }
+    };
+
+    struct ItemRow {
+        int32_t line = 0;
+        int16_t container = 0;
+        int32_t depot = 0;
+        TYPE_OF_ITEM_ID id = 0;
+        uint16_t wear = 0;
+        uint16_t number = 0;
+        uint16_t quality = 0;
+        TYPE_OF_CONTAINERSLOTS slot = 0;
+
+        auto operator==(const ItemRow &other) const -> bool {
+            return std::tie(line, container, depot, id, wear, number, quality, slot) ==
+                   std::tie(other.line, other.container, other.depot, other.id, other.wear, other.number,
+                            other.quality, other.slot);
+        }
+    };
+
+    struct ItemData {
+        int32_t line = 0;
+        std::string key;
+        std::string value;
+
+        auto operator==(const ItemData &other) const -> bool {
+            return std::tie(line, key, value) == std::tie(other.line, other.key, other.value);
+        }
+    };
+
+    struct Effect {
+        uint16_t id = 0;
+        int32_t nextCalled = 0;
+        uint32_t calls = 0;
+        std::vector<std::pair<std::string, uint32_t>> values;
+    };
+
+    // the tables that hold several rows per player, these are only written
+    // when they differ from what was loaded
+    struct Tables {
+        std::vector<TYPE_OF_CHARACTER_ID> introductions;
+        std::vector<std::pair<TYPE_OF_CHARACTER_ID, std::string>> namings;
+        std::vector<Skill> skills;
+        std::vector<ItemRow> items;
+        std::vector<ItemData> itemData;
+    };
+
+    TYPE_OF_CHARACTER_ID id = 0;
+    std::string name;
+    // how the player shows up in the log
+    std::string description;
+    Status status;
+    Attributes attributes;
+    Tables tables;
+    std::vector<Effect> effects;
+
+    bool introductionsChanged = true;
+    bool namingsChanged = true;
+    bool skillsChanged = true;
+    bool itemsChanged = true;
+
+    // compares the tables with the state they had in the database before
+    void markChanges(const Tables &saved) {
+        introductionsChanged = tables.introductions != saved.introductions;
+        namingsChanged = tables.namings != saved.namings;
+        skillsChanged = tables.skills != saved.skills;
+        itemsChanged = tables.items != saved.items || tables.itemData != saved.itemData;
+    }
+
+    // for when the state compared against in markChanges never made it into the database
+    void markAllChanged() {
+        introductionsChanged = true;
+        namingsChanged = true;
+        skillsChanged = true;
+        itemsChanged = true;
+    }
+
+    // number of rows this snapshot inserts or updates
+    [[nodiscard]] auto rows() const -> size_t {
+        size_t count = 2 + effects.size();
+
+        for (const auto &effect : effects) {
+            count += effect.values.size();
+        }
+
+        if (introductionsChanged) {
+            count += tables.introductions.size();
+        }
+
+        if (namingsChanged) {
+            count += tables.namings.size();
+        }
+
+        if (skillsChanged) {
+            count += tables.skills.size();
+        }
+
+        if (itemsChanged) {
+            count += tables.items.size() + tables.itemData.size();
+        }
+
+        return count;
+    }
+};
+
+#endif
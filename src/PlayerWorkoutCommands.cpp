@@ -23,21 +23,19 @@
 #include "tuningConstants.hpp"
 
 void Player::workoutCommands() {
-    std::unique_lock<std::mutex> lock(commandMutex);
-    while (!immediateCommands.empty()) {
-        ClientCommandPointer cmd = immediateCommands.front();
-        immediateCommands.pop();
-        lock.unlock();
-        cmd->performAction(this);
-        lock.lock();
-    }
+    // commands arriving from now on queue the player again
+    commandsPending.exchange(false);
+
+    immediateCommands.drain([this](const ClientCommandPointer &cmd) { cmd->performAction(this); });
+
+    while (const auto *next = queuedCommands.peek()) {
+        if ((*next)->getMinAP() > getActionPoints()) {
+            break;
+        }
 
-    while (!queuedCommands.empty() && queuedCommands.front()->getMinAP() <= getActionPoints()) {
-        ClientCommandPointer cmd = queuedCommands.front();
-        queuedCommands.pop();
-        lock.unlock();
+        ClientCommandPointer cmd;
+        queuedCommands.tryPop(cmd);
         cmd->performAction(this);
-        lock.lock();
     }
 }
 
@@ -49,22 +47,25 @@ void Player::checkFightMode() {
 }
 
 void Player::receiveCommand(const ClientCommandPointer &cmd) {
-    bool notify = false;
-    {
-        std::unique_lock<std::mutex> lock(commandMutex);
-        if (cmd->getMinAP() == 0) {
-            immediateCommands.push(cmd);
-            notify = true;
-        } else {
-            if (getActionPoints() > cmd->getMinAP() && queuedCommands.empty()) {
-                notify = true;
-            }
+    const bool immediate = cmd->getMinAP() == 0;
+    const bool notify = immediate || (getActionPoints() > cmd->getMinAP() && queuedCommands.empty());
+    auto &queue = immediate ? immediateCommands : queuedCommands;
 
-            queuedCommands.push(cmd);
+    if (!queue.tryPush(cmd)) {
+        // only the first dropped command is logged, the log must not grow with the flood
+        if (droppedCommands++ == 0) {
+            Logger::warn(LogFacility::Player) << *this << " floods the server with commands, dropping them" << Log::end;
         }
+
+        return;
+    }
+
+    if (droppedCommands.load(std::memory_order_relaxed) > 0) {
+        Logger::warn(LogFacility::Player) << *this << " stopped flooding, " << droppedCommands.exchange(0)
+                                          << " commands were dropped" << Log::end;
     }
 
-    if (notify) {
+    if (notify && !commandsPending.exchange(true)) {
         World::get()->addPlayerImmediateActionQueue(this);
         World::get()->scheduler.signalNewPlayerAction();
     }
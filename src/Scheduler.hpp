@@ -19,55 +19,175 @@
 #ifndef SCHEDULER_HPP
 #define SCHEDULER_HPP
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
-#include <memory>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <mutex>
-#include <queue>
 #include <string>
-
-template <typename clock_type> class Task {
+#include <unordered_map>
+#include <vector>
+
+/**
+ * identifies a task of a ClockBasedScheduler, it turns stale once the task is
+ * cancelled or a oneshot task ran, so that it never refers to a later task
+ */
+class TaskHandle {
 public:
-    Task(std::function<void()> task, typename clock_type::time_point start_point, std::chrono::nanoseconds interval,
-         std::string name);
+    TaskHandle() = default;
 
-    inline auto operator<(const Task &other) const -> bool { return other._next < _next; }
+    [[nodiscard]] inline auto isValid() const -> bool { return generation != 0; }
 
-    auto run() -> bool;
+private:
+    template <typename clock_type> friend class ClockBasedScheduler;
 
-    [[nodiscard]] inline auto getName() const -> std::string { return _name; }
+    TaskHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
 
-    [[nodiscard]] inline auto getNextTime() const -> typename clock_type::time_point { return _next; }
+    uint32_t index = 0;
+    uint32_t generation = 0;
+};
 
-private:
-    std::function<void()> _task;
+// what was measured of all tasks with the same name while profiling was enabled
+struct TaskStatistics {
+    // upper limits of the buckets of the lateness histogram, the last bucket takes everything beyond
+    static constexpr std::array<std::chrono::microseconds, 7> latenessLimits = {
+            std::chrono::microseconds(100), std::chrono::milliseconds(1),   std::chrono::milliseconds(5),
+            std::chrono::milliseconds(10),  std::chrono::milliseconds(50),  std::chrono::milliseconds(100),
+            std::chrono::seconds(1)};
+
+    std::string name;
+    uint64_t runs = 0;
+    std::chrono::nanoseconds totalDuration{0};
+    std::chrono::nanoseconds maxDuration{0};
+    // runs that took longer than the tick budget on their own
+    uint64_t overruns = 0;
+    // how late the runs started, bucketed by latenessLimits
+    std::array<uint64_t, latenessLimits.size() + 1> lateness{};
+};
 
-    typename clock_type::time_point _next;
-    std::chrono::nanoseconds _interval;
-    std::string _name;
+// a tick is one round of running all tasks that are due
+struct TickStatistics {
+    uint64_t ticks = 0;
+    uint64_t overruns = 0;
+    std::chrono::nanoseconds maxDuration{0};
 };
 
+/**
+ * Runs tasks at their time in the main loop. The tasks are kept in a
+ * hierarchical timing wheel with millisecond resolution: four levels of 256
+ * buckets each, where a level covers 256 times the span of the one below.
+ * Adding, cancelling and rescheduling a task are constant time. Running the
+ * due tasks looks at one bucket of the lowest level per millisecond and skips
+ * empty stretches; tasks further away trickle down a level whenever the level
+ * below wrapped around.
+ *
+ * Tasks live in slots that are reused, so with tasks small enough for the
+ * inline storage of std::function scheduling does not allocate. Task names are
+ * interned, and with profiling enabled the runs of all tasks with the same
+ * name are measured together. Disabled, profiling costs a flag check per task.
+ */
 template <typename clock_type> class ClockBasedScheduler {
 public:
-    void addOneshotTask(std::function<void()> task, std::chrono::nanoseconds delay, const std::string &taskname);
-    void addRecurringTask(std::function<void()> task, std::chrono::nanoseconds interval, const std::string &taskname,
-                          bool start_immediately = false);
-    void addRecurringTask(std::function<void()> task, std::chrono::nanoseconds interval,
-                          typename clock_type::time_point first_time, const std::string &taskname);
+    using Task = std::function<void()>;
+    // gets the time until the next task is due
+    using IdleTask = std::function<void(std::chrono::nanoseconds)>;
+
+    ClockBasedScheduler();
+
+    auto addOneshotTask(Task task, std::chrono::nanoseconds delay, const std::string &taskname) -> TaskHandle;
+    auto addRecurringTask(Task task, std::chrono::nanoseconds interval, const std::string &taskname,
+                          bool start_immediately = false) -> TaskHandle;
+    auto addRecurringTask(Task task, std::chrono::nanoseconds interval, typename clock_type::time_point first_time,
+                          const std::string &taskname) -> TaskHandle;
+
+    // removes the task, also from within the task itself, and resets the handle; false if it was not scheduled
+    auto cancel(TaskHandle &handle) -> bool;
+    // moves the next run of the task, a recurring task keeps its interval from there on
+    auto reschedule(TaskHandle handle, std::chrono::nanoseconds delay) -> bool;
+    [[nodiscard]] auto isScheduled(TaskHandle handle) const -> bool;
+    [[nodiscard]] auto size() const -> size_t;
+
     void signalNewPlayerAction();
 
     void run_once(std::chrono::nanoseconds max_timeout);
+    // runs at the end of run_once if there is time left until the next task, it should not use all of it
+    void setIdleTask(IdleTask task);
+
+    void setProfiling(bool enabled);
+    [[nodiscard]] auto isProfiling() const -> bool;
+    // ticks and single tasks running longer than this count as overruns
+    void setTickBudget(std::chrono::nanoseconds budget);
+    // tasks that ran since the last reset, longest total duration first
+    [[nodiscard]] auto getTaskStatistics() const -> std::vector<TaskStatistics>;
+    [[nodiscard]] auto getTickStatistics() const -> TickStatistics;
+    void resetStatistics();
 
 private:
+    using Tick = uint64_t;
+
+    enum class State : uint8_t { free, waiting, ready, running };
+
+    struct Slot {
+        Task task;
+        Tick due = 0;
+        Tick interval = 0;
+        uint32_t name = 0;
+        uint32_t generation = 1;
+        uint32_t previous = none;
+        uint32_t next = none;
+        uint32_t bucket = none;
+        State state = State::free;
+        bool rescheduled = false;
+    };
+
+    static constexpr uint32_t none = UINT32_MAX;
+    static constexpr int levels = 4;
+    static constexpr int bitsPerLevel = 8;
+    static constexpr Tick bucketsPerLevel = Tick{1} << bitsPerLevel;
+    static constexpr Tick bucketMask = bucketsPerLevel - 1;
+    static constexpr Tick wheelSpan = Tick{1} << (levels * bitsPerLevel);
+    static constexpr Tick never = UINT64_MAX;
+
     auto getNextTaskTime() -> std::chrono::nanoseconds;
     void execute_tasks();
 
+    auto add(Task &&task, typename clock_type::time_point first_time, std::chrono::nanoseconds interval,
+             const std::string &taskname) -> TaskHandle;
+    auto find(TaskHandle handle) const -> const Slot *;
+    auto internName(const std::string &name) -> uint32_t;
+    void recordRun(uint32_t name, typename clock_type::time_point due, typename clock_type::time_point start,
+                   typename clock_type::time_point end);
+    [[nodiscard]] auto toTick(typename clock_type::time_point time) const -> Tick;
+    [[nodiscard]] auto fromTick(Tick tick) const -> typename clock_type::time_point;
+    [[nodiscard]] auto nextEventTick() const -> Tick;
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level, Tick bucket);
+    void collectDueTasks(Tick now);
+
     std::mutex _new_action_signal_mutex;
     std::condition_variable _new_action_available_cond;
 
-    using task_container_t = std::priority_queue<Task<std::chrono::steady_clock>>;
-    task_container_t _tasks;
-    std::mutex _container_mutex;
+    typename clock_type::time_point _start;
+    Tick _current = 0;
+    size_t _scheduled = 0;
+    std::deque<Slot> _slots;
+    std::vector<uint32_t> _free_slots;
+    std::array<uint32_t, levels * bucketsPerLevel> _buckets{};
+    std::array<uint32_t, levels> _level_tasks{};
+    std::vector<std::pair<uint32_t, uint32_t>> _ready;
+    IdleTask _idle_task;
+    // indexed by the interned names, which live here as well
+    std::vector<TaskStatistics> _statistics;
+    std::unordered_map<std::string, uint32_t> _name_ids;
+    TickStatistics _tick_statistics;
+    std::atomic_bool _profiling = false;
+    std::chrono::nanoseconds _tick_budget{std::chrono::milliseconds(100)};
+    mutable std::mutex _container_mutex;
 };
 
 #include "Scheduler.tcc"
@@ -1,6 +1,3 @@
-#include <utility>
-
-
 
 //  illarionserver - server for the game Illarion
 //  Copyright 2011 Illarion e.V.
@@ -20,93 +17,497 @@
 //  You should have received a copy of the GNU Affero General Public License
 //  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
 
-template<typename clock_type>
-Task<clock_type>::Task(std::function<void()> task, typename clock_type::time_point start_point, std::chrono::nanoseconds interval, std::string  name) : _task(std::move(task)), _next(start_point), _interval(interval), _name(std::move(name)) { }
+#include <algorithm>
+#include <utility>
+
+template <typename clock_type> ClockBasedScheduler<clock_type>::ClockBasedScheduler() : _start(clock_type::now()) {
+    _buckets.fill(none);
+}
+
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::addOneshotTask(Task task, std::chrono::nanoseconds delay,
+                                                     const std::string &taskname) -> TaskHandle {
+    const auto start_time =
+            clock_type::now() + std::chrono::duration_cast<typename clock_type::duration>(delay);
+    return add(std::move(task), start_time, std::chrono::nanoseconds::zero(), taskname);
+}
+
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::addRecurringTask(Task task, std::chrono::nanoseconds interval,
+                                                       const std::string &taskname, bool start_immediately)
+        -> TaskHandle {
+    typename clock_type::time_point start_time = clock_type::now();
+
+    if (!start_immediately) {
+        start_time += std::chrono::duration_cast<typename clock_type::duration>(interval);
+    }
+
+    return add(std::move(task), start_time, interval, taskname);
+}
+
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::addRecurringTask(Task task, std::chrono::nanoseconds interval,
+                                                       typename clock_type::time_point first_time,
+                                                       const std::string &taskname) -> TaskHandle {
+    return add(std::move(task), first_time, interval, taskname);
+}
+
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::add(Task &&task, typename clock_type::time_point first_time,
+                                          std::chrono::nanoseconds interval, const std::string &taskname)
+        -> TaskHandle {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+    uint32_t index = 0;
+
+    if (_free_slots.empty()) {
+        index = static_cast<uint32_t>(_slots.size());
+        _slots.emplace_back();
+    } else {
+        index = _free_slots.back();
+        _free_slots.pop_back();
+    }
+
+    Slot &slot = _slots[index];
+    slot.task = std::move(task);
+    slot.due = toTick(first_time);
+    slot.interval = 0;
+
+    if (interval > std::chrono::nanoseconds::zero()) {
+        // rounded up, so that a recurring task never runs more often than asked for
+        const auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(interval).count();
+        slot.interval = static_cast<Tick>(milliseconds);
+    }
+
+    slot.name = internName(taskname);
+    insert(index);
+    ++_scheduled;
+    return {index, slot.generation};
+}
+
+template <typename clock_type> auto ClockBasedScheduler<clock_type>::cancel(TaskHandle &handle) -> bool {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+    const Slot *slot = find(handle);
+    const uint32_t index = handle.index;
+    handle = TaskHandle();
+
+    if (slot == nullptr) {
+        return false;
+    }
+
+    if (slot->state == State::waiting) {
+        unlink(index);
+    }
+
+    // a running task is destroyed once it returned
+    release(index);
+    return true;
+}
+
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::reschedule(TaskHandle handle, std::chrono::nanoseconds delay) -> bool {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+
+    if (find(handle) == nullptr) {
+        return false;
+    }
+
+    Slot &slot = _slots[handle.index];
+    slot.due = toTick(clock_type::now() + std::chrono::duration_cast<typename clock_type::duration>(delay));
+
+    switch (slot.state) {
+    case State::waiting:
+        unlink(handle.index);
+        insert(handle.index);
+        break;
+    case State::ready:
+        // not run in this round anymore
+        insert(handle.index);
+        break;
+    case State::running:
+        slot.rescheduled = true;
+        break;
+    case State::free:
+        break;
+    }
+
+    return true;
+}
+
+template <typename clock_type> auto ClockBasedScheduler<clock_type>::isScheduled(TaskHandle handle) const -> bool {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+    return find(handle) != nullptr;
+}
+
+template <typename clock_type> auto ClockBasedScheduler<clock_type>::size() const -> size_t {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+    return _scheduled;
+}
+
+template <typename clock_type> void ClockBasedScheduler<clock_type>::signalNewPlayerAction() {
+    std::unique_lock<std::mutex> lock(_new_action_signal_mutex);
+    _new_action_available_cond.notify_all();
+}
+
+template <typename clock_type> void ClockBasedScheduler<clock_type>::run_once(std::chrono::nanoseconds max_timeout) {
+    auto next_action_time = getNextTaskTime();
+
+    if (next_action_time > max_timeout) {
+        next_action_time = max_timeout;
+    }
+
+    // a task that is due already does not need to wait on the condition
+    if (next_action_time > std::chrono::nanoseconds::zero()) {
+        std::unique_lock<std::mutex> lock(_new_action_signal_mutex);
+        _new_action_available_cond.wait_for(lock, next_action_time);
+    }
+
+    execute_tasks();
+
+    if (_idle_task) {
+        const auto idle_time = std::min(getNextTaskTime(), max_timeout);
+
+        if (idle_time > std::chrono::nanoseconds::zero()) {
+            _idle_task(idle_time);
+        }
+    }
+}
+
+template <typename clock_type> void ClockBasedScheduler<clock_type>::setIdleTask(IdleTask task) {
+    _idle_task = std::move(task);
+}
+
+template <typename clock_type> auto ClockBasedScheduler<clock_type>::getNextTaskTime() -> std::chrono::nanoseconds {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+    const Tick tick = nextEventTick();
+
+    // nothing waiting, only tasks that are just running
+    if (tick == never) {
+        return std::chrono::nanoseconds::max();
+    }
+
+    return std::max<std::chrono::nanoseconds>(fromTick(tick) - clock_type::now(), std::chrono::nanoseconds::zero());
+}
+
+template <typename clock_type> void ClockBasedScheduler<clock_type>::execute_tasks() {
+    const bool profiling = _profiling;
+    const auto tickStart = clock_type::now();
+    std::unique_lock<std::mutex> lock(_container_mutex);
+    collectDueTasks(toTick(tickStart));
+
+    for (const auto &[index, generation] : _ready) {
+        Slot &slot = _slots[index];
+
+        // cancelled or rescheduled by a task that ran before
+        if (slot.generation != generation || slot.state != State::ready) {
+            continue;
+        }
+
+        slot.state = State::running;
+        slot.rescheduled = false;
+        Task task = std::move(slot.task);
+        const Tick due = slot.due;
+        const uint32_t name = slot.name;
+        lock.unlock();
+
+        if (profiling) {
+            const auto start = clock_type::now();
+            task();
+            const auto end = clock_type::now();
+            lock.lock();
+            recordRun(name, fromTick(due), start, end);
+        } else {
+            task();
+            lock.lock();
+        }
+
+        // the slot is gone if the task cancelled itself
+        if (slot.generation != generation) {
+            continue;
+        }
+
+        if (slot.interval == 0 && !slot.rescheduled) {
+            release(index);
+            continue;
+        }
+
+        if (!slot.rescheduled) {
+            slot.due = due + slot.interval;
+        }
+
+        slot.task = std::move(task);
+        insert(index);
+    }
+
+    if (profiling && !_ready.empty()) {
+        const std::chrono::nanoseconds duration = clock_type::now() - tickStart;
+        ++_tick_statistics.ticks;
+        _tick_statistics.maxDuration = std::max(_tick_statistics.maxDuration, duration);
+
+        if (duration > _tick_budget) {
+            ++_tick_statistics.overruns;
+        }
+    }
 
-template<typename clock_type>
-auto Task<clock_type>::run() -> bool {
-	_task();
+    _ready.clear();
+}
+
+template <typename clock_type>
+void ClockBasedScheduler<clock_type>::recordRun(uint32_t name, typename clock_type::time_point due,
+                                                typename clock_type::time_point start,
+                                                typename clock_type::time_point end) {
+    TaskStatistics &statistics = _statistics[name];
+    const std::chrono::nanoseconds duration = end - start;
+    ++statistics.runs;
+    statistics.totalDuration += duration;
+    statistics.maxDuration = std::max(statistics.maxDuration, duration);
 
-	if (_interval > std::chrono::nanoseconds::zero()) {
-		_next += std::chrono::duration_cast<typename clock_type::duration>(_interval);
-		return true;
-	}
+    if (duration > _tick_budget) {
+        ++statistics.overruns;
+    }
+
+    // due times are rounded up to the next millisecond, so a start can be a little early
+    const auto &limits = TaskStatistics::latenessLimits;
+    const auto lateness = std::max<std::chrono::nanoseconds>(start - due, std::chrono::nanoseconds::zero());
+    const auto bucket = std::lower_bound(limits.begin(), limits.end(), lateness) - limits.begin();
+    ++statistics.lateness[bucket];
+}
 
-	return false;
+template <typename clock_type> void ClockBasedScheduler<clock_type>::setProfiling(bool enabled) {
+    _profiling = enabled;
 }
 
-template<typename clock_type>
-void ClockBasedScheduler<clock_type>::addOneshotTask(std::function<void()> task, std::chrono::nanoseconds delay, const std::string& taskname) {
-	std::unique_lock<std::mutex> lock(_container_mutex);
-	typename clock_type::time_point start_time = clock_type::now() + std::chrono::duration_cast<typename clock_type::duration>(delay);
-	_tasks.emplace(task, start_time, std::chrono::nanoseconds::zero(), taskname);
+template <typename clock_type> auto ClockBasedScheduler<clock_type>::isProfiling() const -> bool {
+    return _profiling;
 }
 
-template<typename clock_type>
-void ClockBasedScheduler<clock_type>::addRecurringTask(std::function<void()> task, std::chrono::nanoseconds interval, const std::string& taskname, bool start_immediately) {
-	std::unique_lock<std::mutex> lock(_container_mutex);
-	typename clock_type::time_point start_time = clock_type::now();
-	if (!start_immediately) {
-		start_time += std::chrono::duration_cast<typename clock_type::duration>(interval);
+template <typename clock_type> void ClockBasedScheduler<clock_type>::setTickBudget(std::chrono::nanoseconds budget) {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+    _tick_budget = budget;
+}
+
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::getTaskStatistics() const -> std::vector<TaskStatistics> {
+    std::vector<TaskStatistics> result;
+
+    {
+        std::unique_lock<std::mutex> lock(_container_mutex);
+
+        for (const auto &statistics : _statistics) {
+            if (statistics.runs > 0) {
+                result.push_back(statistics);
+            }
+        }
     }
 
-	_tasks.emplace(task, start_time, interval, taskname);
+    std::sort(result.begin(), result.end(),
+              [](const auto &lhs, const auto &rhs) { return lhs.totalDuration > rhs.totalDuration; });
+    return result;
 }
 
-template<typename clock_type>
-void ClockBasedScheduler<clock_type>::addRecurringTask(std::function<void()> task, std::chrono::nanoseconds interval, typename clock_type::time_point first_time, const std::string& taskname) {
-	std::unique_lock<std::mutex> lock(_container_mutex);
-	_tasks.emplace(task, first_time, interval, taskname);
+template <typename clock_type> auto ClockBasedScheduler<clock_type>::getTickStatistics() const -> TickStatistics {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+    return _tick_statistics;
 }
 
-template<typename clock_type>
-void ClockBasedScheduler<clock_type>::signalNewPlayerAction() {
-	std::unique_lock<std::mutex> lock(_new_action_signal_mutex);
-	_new_action_available_cond.notify_all();
+template <typename clock_type> void ClockBasedScheduler<clock_type>::resetStatistics() {
+    std::unique_lock<std::mutex> lock(_container_mutex);
+
+    for (auto &statistics : _statistics) {
+        statistics = TaskStatistics{std::move(statistics.name)};
+    }
+
+    _tick_statistics = TickStatistics();
 }
 
-template<typename clock_type>
-void ClockBasedScheduler<clock_type>::run_once(std::chrono::nanoseconds max_timeout) {
-	auto next_action_time = getNextTaskTime();
-	if (next_action_time > max_timeout) {
-		next_action_time = max_timeout;
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::find(TaskHandle handle) const -> const Slot * {
+    if (!handle.isValid() || handle.index >= _slots.size()) {
+        return nullptr;
+    }
 
+    const Slot &slot = _slots[handle.index];
+
+    if (slot.generation != handle.generation || slot.state == State::free) {
+        return nullptr;
     }
 
-	{
-		std::unique_lock<std::mutex> lock(_new_action_signal_mutex);
-		_new_action_available_cond.wait_for(lock, next_action_time);
-	}
+    return &slot;
+}
+
+template <typename clock_type> auto ClockBasedScheduler<clock_type>::internName(const std::string &name) -> uint32_t {
+    const auto it = _name_ids.find(name);
+
+    if (it != _name_ids.end()) {
+        return it->second;
+    }
 
-	execute_tasks();
+    const auto id = static_cast<uint32_t>(_statistics.size());
+    _statistics.emplace_back().name = name;
+    _name_ids.emplace(name, id);
+    return id;
 }
 
-template<typename clock_type>
-auto ClockBasedScheduler<clock_type>::getNextTaskTime() -> std::chrono::nanoseconds {
-	std::unique_lock<std::mutex> lock(_container_mutex);
-	if (_tasks.empty()) {
-		return std::chrono::nanoseconds::max();
+// ticks are milliseconds since the scheduler was created, rounded up, so tasks never run early
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::toTick(typename clock_type::time_point time) const -> Tick {
+    if (time <= _start) {
+        return 0;
     }
 
-	return _tasks.top().getNextTime() - clock_type::now();
+    return static_cast<Tick>(std::chrono::ceil<std::chrono::milliseconds>(time - _start).count());
+}
+
+template <typename clock_type>
+auto ClockBasedScheduler<clock_type>::fromTick(Tick tick) const -> typename clock_type::time_point {
+    return _start + std::chrono::duration_cast<typename clock_type::duration>(std::chrono::milliseconds(tick));
 }
 
-template<typename clock_type>
-void ClockBasedScheduler<clock_type>::execute_tasks() {
-	auto now = clock_type::now();
+// the next tick at which a task is due or a bucket of a higher level trickles down,
+// the latter being the start of the bucket for tasks that are further away
+template <typename clock_type> auto ClockBasedScheduler<clock_type>::nextEventTick() const -> Tick {
+    Tick next = never;
+
+    for (int level = 0; level < levels; ++level) {
+        if (_level_tasks[level] == 0) {
+            continue;
+        }
+
+        const int shift = level * bitsPerLevel;
+        const Tick current = _current >> shift;
+
+        // the current bucket of a higher level was spread to the lower levels already
+        const Tick first = level == 0 ? 0 : 1;
+
+        for (Tick offset = first; offset < first + bucketsPerLevel; ++offset) {
+            if (_buckets[level * bucketsPerLevel + ((current + offset) & bucketMask)] != none) {
+                next = std::min(next, (current + offset) << shift);
+                break;
+            }
+        }
+    }
 
-	std::unique_lock<std::mutex> lock(_container_mutex);
-	while (!_tasks.empty() && now >= _tasks.top().getNextTime()) {
-		auto task = _tasks.top();
-		_tasks.pop();
-		lock.unlock();
+    return next;
+}
 
-		bool runResult = task.run();
+// the level follows from how far away the task is, the bucket from its due tick
+template <typename clock_type> void ClockBasedScheduler<clock_type>::insert(uint32_t index) {
+    Slot &slot = _slots[index];
+    Tick due = std::max(slot.due, _current);
+    const Tick distance = due - _current;
+    int level = 0;
 
-		lock.lock();
-		if (runResult) {
-			_tasks.push(task);
+    if (distance >= wheelSpan) {
+        // beyond the wheel, trickles down once the top level came around
+        level = levels - 1;
+        due = _current + wheelSpan - 1;
+    } else {
+        while (distance >= (Tick{1} << ((level + 1) * bitsPerLevel))) {
+            ++level;
         }
-	}
+    }
+
+    const auto bucket = static_cast<uint32_t>(level * bucketsPerLevel + ((due >> (level * bitsPerLevel)) & bucketMask));
+    slot.bucket = bucket;
+    slot.previous = none;
+    slot.next = _buckets[bucket];
+
+    if (slot.next != none) {
+        _slots[slot.next].previous = index;
+    }
+
+    _buckets[bucket] = index;
+    ++_level_tasks[level];
+    slot.state = State::waiting;
+}
+
+template <typename clock_type> void ClockBasedScheduler<clock_type>::unlink(uint32_t index) {
+    Slot &slot = _slots[index];
+
+    if (slot.previous != none) {
+        _slots[slot.previous].next = slot.next;
+    } else {
+        _buckets[slot.bucket] = slot.next;
+    }
+
+    if (slot.next != none) {
+        _slots[slot.next].previous = slot.previous;
+    }
+
+    --_level_tasks[slot.bucket / bucketsPerLevel];
+    slot.previous = none;
+    slot.next = none;
+    slot.bucket = none;
+}
+
+template <typename clock_type> void ClockBasedScheduler<clock_type>::release(uint32_t index) {
+    Slot &slot = _slots[index];
+    slot.task = nullptr;
+    slot.state = State::free;
+
+    // a handle of the former task never matches again
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+
+    _free_slots.push_back(index);
+    --_scheduled;
+}
+
+template <typename clock_type> void ClockBasedScheduler<clock_type>::cascade(int level, Tick bucket) {
+    const auto first = static_cast<uint32_t>(level * bucketsPerLevel + bucket);
+    uint32_t index = _buckets[first];
+    _buckets[first] = none;
+
+    while (index != none) {
+        const uint32_t next = _slots[index].next;
+        --_level_tasks[level];
+        insert(index);
+        index = next;
+    }
 }
 
+template <typename clock_type> void ClockBasedScheduler<clock_type>::collectDueTasks(Tick now) {
+    // nothing to walk through
+    if (_scheduled == 0 && _current <= now) {
+        _current = now + 1;
+        return;
+    }
+
+    while (_current <= now) {
+        const Tick bucket = _current & bucketMask;
+
+        // straight to the next tick where anything happens
+        if (bucket != 0 && _buckets[bucket] == none) {
+            _current = std::min(now + 1, nextEventTick());
+            continue;
+        }
+
+        if (bucket == 0) {
+            for (int level = 1; level < levels; ++level) {
+                const Tick higher = (_current >> (level * bitsPerLevel)) & bucketMask;
+                cascade(level, higher);
+
+                if (higher != 0) {
+                    break;
+                }
+            }
+        }
+
+        uint32_t index = _buckets[bucket];
+        _buckets[bucket] = none;
+
+        while (index != none) {
+            Slot &slot = _slots[index];
+            const uint32_t next = slot.next;
+            slot.previous = none;
+            slot.next = none;
+            slot.bucket = none;
+            slot.state = State::ready;
+            --_level_tasks[0];
+            _ready.emplace_back(index, slot.generation);
+            index = next;
+        }
+
+        ++_current;
+    }
+}
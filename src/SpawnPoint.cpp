@@ -27,6 +27,7 @@
 #include "db/Result.hpp"
 #include "db/SelectQuery.hpp"
 #include "map/Field.hpp"
+#include "tuningConstants.hpp"
 
 #include <boost/cstdint.hpp>
 #include <range/v3/all.hpp>
@@ -35,8 +36,17 @@
 SpawnPoint::SpawnPoint(const position &pos, Coordinate Range, Coordinate Spawnrange, uint16_t Min_Spawntime,
                        uint16_t Max_Spawntime, bool Spawnall)
         : world(World::get()), spawnpos(pos), range(Range), spawnrange(Spawnrange), min_spawntime(Min_Spawntime),
-          max_spawntime(Max_Spawntime), nextspawntime(Random::uniform(Min_Spawntime, Max_Spawntime)),
-          spawnall(Spawnall) {}
+          max_spawntime(Max_Spawntime), spawnall(Spawnall) {
+    scheduleSpawn(Random::uniform(min_spawntime, max_spawntime));
+}
+
+SpawnPoint::~SpawnPoint() { world->scheduler.cancel(spawnTask); }
+
+// a spawn happens in the cycle after the given number of cycles has passed
+void SpawnPoint::scheduleSpawn(uint16_t cycles) {
+    world->scheduler.cancel(spawnTask);
+    spawnTask = world->scheduler.addOneshotTask([this] { spawn(); }, spawnCycleInterval * (cycles + 1), "spawn");
+}
 
 //! add new Monstertyp to SpawnList...
 void SpawnPoint::addMonster(TYPE_OF_CHARACTER_ID type, int count) {
@@ -57,50 +67,47 @@ void SpawnPoint::addMonster(TYPE_OF_CHARACTER_ID type, int count) {
 
 //! do spawns if possible...
 void SpawnPoint::spawn() {
-    if (nextspawntime == 0) {
-        // set new spawntime
-        nextspawntime = Random::uniform(min_spawntime, max_spawntime);
+    // do we want monsters to spawn? if not, wait for the next cycle
+    if (!World::get()->isSpawnEnabled()) {
+        scheduleSpawn(0);
+        return;
+    }
 
-        // do we want monsters to spawn?
-        if (!World::get()->isSpawnEnabled()) {
-            return;
-        }
+    scheduleSpawn(Random::uniform(min_spawntime, max_spawntime));
 
-        // check all monstertyps...
-        for (auto &spawn : SpawnTypes) {
-            // less monster spawned than we need?
-            int num = spawn.max_count - spawn.akt_count;
-            if (num > 0) {
-                try {
-                    // spawn some new baddies :)
-                    if (!spawnall) {
-                        num = Random::uniform(1, num);
-                    }
+    // check all monstertyps...
+    for (auto &spawn : SpawnTypes) {
+        // less monster spawned than we need?
+        int num = spawn.max_count - spawn.akt_count;
+        if (num > 0) {
+            try {
+                // spawn some new baddies :)
+                if (!spawnall) {
+                    num = Random::uniform(1, num);
+                }
 
-                    for (int i = 0; i < num; ++i) {
-                        // set the new spawnpos in the range of the spawnrange around the spawnpoint
-                        const position tempPos(
-                                (spawnpos.x - spawnrange) + Random::uniform(Coordinate{0}, 2 * spawnrange),
-                                (spawnpos.y - spawnrange) + Random::uniform(Coordinate{0}, 2 * spawnrange), spawnpos.z);
-
-                        // end of setting the new spawnpos
-                        try {
-                            map::Field &field = world->walkableFieldNear(tempPos);
-                            auto *newmonster = new Monster(spawn.typ, field.getPosition(), this);
-                            ++spawn.akt_count;
-                            world->newMonsters.push_back(newmonster);
-                            field.setPlayer();
-                            world->sendCharacterMoveToAllVisiblePlayers(newmonster, NORMALMOVE, 4);
-                        } catch (FieldNotFound &) {
-                        }
+                for (int i = 0; i < num; ++i) {
+                    // set the new spawnpos in the range of the spawnrange around the spawnpoint
+                    const position tempPos((spawnpos.x - spawnrange) + Random::uniform(Coordinate{0}, 2 * spawnrange),
+                                           (spawnpos.y - spawnrange) + Random::uniform(Coordinate{0}, 2 * spawnrange),
+                                           spawnpos.z);
+
+                    // end of setting the new spawnpos
+                    try {
+                        map::Field &field = world->walkableFieldNear(tempPos);
+                        auto *newmonster = new Monster(spawn.typ, field.getPosition(), this);
+                        ++spawn.akt_count;
+                        world->newMonsters.push_back(newmonster);
+                        world->characterHandles.add(newmonster);
+                        field.setPlayer();
+                        world->sendCharacterMoveToAllVisiblePlayers(newmonster, NORMALMOVE, 4);
+                    } catch (FieldNotFound &) {
                     }
-                } catch (Monster::unknownIDException &) {
-                    Logger::error(LogFacility::Other) << "Could not create unknown monster " << spawn.typ << Log::end;
                 }
+            } catch (Monster::unknownIDException &) {
+                Logger::error(LogFacility::Other) << "Could not create unknown monster " << spawn.typ << Log::end;
             }
         }
-    } else {
-        --nextspawntime;
     }
 }
 
@@ -21,6 +21,7 @@
 #ifndef SPAWNPOINT_HPP
 #define SPAWNPOINT_HPP
 
+#include "Scheduler.hpp"
 #include "globals.hpp"
 
 #include <list>
@@ -34,12 +35,20 @@ public:
     //! Creates a new SpawnPoint at <pos>
     explicit SpawnPoint(const position &pos, Coordinate Range = defaultWalkRange, Coordinate Spawnrange = 0,
                         uint16_t Min_Spawntime = 1, uint16_t Max_Spawntime = 1, bool Spawnall = false);
+    ~SpawnPoint();
+
+    // monsters point to their spawnpoint and the scheduler runs its spawns, so it stays where it is
+    SpawnPoint(const SpawnPoint &) = delete;
+    auto operator=(const SpawnPoint &) -> SpawnPoint & = delete;
+    SpawnPoint(SpawnPoint &&) = delete;
+    auto operator=(SpawnPoint &&) -> SpawnPoint & = delete;
 
     void addMonster(TYPE_OF_CHARACTER_ID type, int count);
 
     //! load spawnpoints from database
     auto load(const int &id) -> bool;
 
+    //! spawns if spawning is enabled and schedules the next spawn
     void spawn();
 
     //! callback called by dying monsters belonging to spawnpoint
@@ -67,8 +76,8 @@ private:
     uint16_t min_spawntime;
     uint16_t max_spawntime;
 
-    // the number of cycles until the next spawn
-    uint16_t nextspawntime;
+    // the next spawn in the scheduler of the world
+    TaskHandle spawnTask;
 
     // should be all monsters respawned in every cycle
     bool spawnall;
@@ -81,6 +90,8 @@ private:
 
     std::list<struct SpawnEntryStruct> SpawnTypes;
 
+    void scheduleSpawn(uint16_t cycles);
+
     static constexpr Coordinate defaultWalkRange = 20;
 };
 
@@ -0,0 +1,103 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "StripeCache.hpp"
+
+#include <algorithm>
+
+auto StripeCache::lineOf(const position &pos, NewClientView::stripedirection dir) -> position {
+    if (dir == NewClientView::dir_right) {
+        return {Coordinate(pos.x - pos.y), NewClientView::dir_right, pos.z};
+    }
+
+    return {Coordinate(pos.x + pos.y), NewClientView::dir_down, pos.z};
+}
+
+auto StripeCache::find(const NewClientView::StripeRequest &request, NewClientView::stripeencoding encoding)
+        -> StripePointer {
+    if (const auto *entry = findEntry(request); entry != nullptr && entry->stripes[encoding]) {
+        ++statistics.hits;
+        statistics.bytesSaved += entry->stripes[encoding]->bytes.size();
+        return entry->stripes[encoding];
+    }
+
+    ++statistics.misses;
+    return nullptr;
+}
+
+void StripeCache::insert(const NewClientView::StripeRequest &request, NewClientView::stripeencoding encoding,
+                         StripePointer stripe) {
+    if (auto *entry = findEntry(request); entry != nullptr) {
+        entry->stripes[encoding] = std::move(stripe);
+        return;
+    }
+
+    if (stripes >= maxStripes) {
+        clear();
+    }
+
+    auto &entry = lines[lineOf(request.start, request.dir)].emplace_back();
+    entry.startY = request.start.y;
+    entry.length = request.length;
+    entry.stripes[encoding] = std::move(stripe);
+    ++stripes;
+}
+
+auto StripeCache::findEntry(const NewClientView::StripeRequest &request) -> Entry * {
+    if (const auto line = lines.find(lineOf(request.start, request.dir)); line != lines.end()) {
+        for (auto &entry : line->second) {
+            if (entry.startY == request.start.y && entry.length == request.length) {
+                return &entry;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+void StripeCache::invalidate(const position &pos) {
+    for (const auto dir : {NewClientView::dir_right, NewClientView::dir_down}) {
+        const auto line = lines.find(lineOf(pos, dir));
+
+        if (line == lines.end()) {
+            continue;
+        }
+
+        auto &entries = line->second;
+        const auto covered = std::remove_if(entries.begin(), entries.end(), [&pos](const Entry &entry) {
+            return entry.startY <= pos.y && pos.y < entry.startY + entry.length;
+        });
+        stripes -= std::distance(covered, entries.end());
+        entries.erase(covered, entries.end());
+    }
+}
+
+void StripeCache::clear() {
+    lines.clear();
+    stripes = 0;
+}
+
+auto StripeCache::hitRate() const -> double {
+    const auto lookups = statistics.hits + statistics.misses;
+
+    if (lookups == 0) {
+        return 0;
+    }
+
+    return double(statistics.hits) / double(lookups);
+}
@@ -0,0 +1,88 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef STRIPE_CACHE_HPP
+#define STRIPE_CACHE_HPP
+
+#include "NewClientView.hpp"
+#include "globals.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Keeps the encoded payload of map stripes that were sent recently, so that
+ * players looking at the same area share the encoding work. A stripe is
+ * dropped as soon as one of its fields changes.
+ */
+class StripeCache {
+public:
+    using Stripe = NewClientView::EncodedStripe;
+    using StripePointer = std::shared_ptr<const Stripe>;
+
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t bytesSaved = 0;
+    };
+
+    /**
+     * looks up an encoded stripe
+     * @return the stripe or nullptr if it has not been cached
+     */
+    auto find(const NewClientView::StripeRequest &request, NewClientView::stripeencoding encoding) -> StripePointer;
+
+    void insert(const NewClientView::StripeRequest &request, NewClientView::stripeencoding encoding,
+                StripePointer stripe);
+
+    /**
+     * drops all stripes showing the field at pos
+     */
+    void invalidate(const position &pos);
+
+    void clear();
+
+    [[nodiscard]] auto getStatistics() const -> const Statistics & { return statistics; }
+    [[nodiscard]] auto hitRate() const -> double;
+
+private:
+    struct Entry {
+        Coordinate startY;
+        Coordinate length;
+        // indexed by encoding
+        std::array<StripePointer, 2> stripes;
+    };
+
+    // stripes of one direction start on the same line when they run along the
+    // same diagonal, so one field change only needs to check a single line
+    // per direction
+    using Line = std::vector<Entry>;
+    auto findEntry(const NewClientView::StripeRequest &request) -> Entry *;
+    [[nodiscard]] static auto lineOf(const position &pos, NewClientView::stripedirection dir) -> position;
+
+    static constexpr size_t maxStripes = 1 << 16;
+
+    std::unordered_map<position, Line> lines;
+    size_t stripes = 0;
+    Statistics statistics;
+};
+
+#endif
@@ -0,0 +1,109 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(size_t threads) : threadCount(threads) {}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    batchStarted.notify_all();
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(size_t jobs, const Job &job) {
+    if (threadCount == 0 || jobs < 2) {
+        for (size_t i = 0; i < jobs; ++i) {
+            job(i);
+        }
+
+        return;
+    }
+
+    if (threads.empty()) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back(&WorkerPool::work, this);
+        }
+    }
+
+    // the calling thread takes one share of the jobs itself
+    const auto helpers = std::min(threads.size(), jobs - 1);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->job = &job;
+        this->jobs = jobs;
+        nextJob = 0;
+        busyThreads = helpers;
+        openSlots = helpers;
+        ++batch;
+    }
+
+    for (size_t i = 0; i < helpers; ++i) {
+        batchStarted.notify_one();
+    }
+
+    takeJobs();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    batchDone.wait(lock, [this] { return busyThreads == 0; });
+    this->job = nullptr;
+}
+
+void WorkerPool::work() {
+    uint64_t lastBatch = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batchStarted.wait(lock,
+                              [this, lastBatch] { return stopping || (batch != lastBatch && openSlots > 0); });
+
+            if (stopping) {
+                return;
+            }
+
+            lastBatch = batch;
+            --openSlots;
+        }
+
+        takeJobs();
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (--busyThreads == 0) {
+            batchDone.notify_one();
+        }
+    }
+}
+
+void WorkerPool::takeJobs() {
+    for (auto i = nextJob++; i < jobs; i = nextJob++) {
+        (*job)(i);
+    }
+}
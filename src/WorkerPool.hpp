@@ -0,0 +1,78 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of threads that work off batches of independent jobs. The thread
+ * handing in a batch takes part in the work and only returns when the whole
+ * batch is done, so jobs may read the game state as long as they do not
+ * change it. The threads are only started by the first batch that can use
+ * them, and a batch only wakes as many of them as it has jobs to share.
+ */
+class WorkerPool {
+public:
+    using Job = std::function<void(size_t)>;
+
+    explicit WorkerPool(size_t threads);
+    WorkerPool(const WorkerPool &) = delete;
+    auto operator=(const WorkerPool &) -> WorkerPool & = delete;
+    WorkerPool(WorkerPool &&) = delete;
+    auto operator=(WorkerPool &&) -> WorkerPool & = delete;
+    ~WorkerPool();
+
+    /**
+     * calls job for 0 to jobs - 1 and waits until all calls returned
+     * @param jobs the number of jobs in this batch
+     * @param job the work to do for each job, must not throw
+     */
+    void run(size_t jobs, const Job &job);
+
+    [[nodiscard]] auto size() const -> size_t { return threadCount; }
+    [[nodiscard]] auto isStarted() const -> bool { return !threads.empty(); }
+
+private:
+    void work();
+    void takeJobs();
+
+    const size_t threadCount;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable batchStarted;
+    std::condition_variable batchDone;
+    const Job *job = nullptr;
+    size_t jobs = 0;
+    std::atomic<size_t> nextJob = 0;
+    size_t busyThreads = 0;
+    // threads that may still join the current batch
+    size_t openSlots = 0;
+    uint64_t batch = 0;
+    bool stopping = false;
+};
+
+#endif
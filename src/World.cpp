@@ -37,6 +37,7 @@
 #include "data/SkillTable.hpp"
 #include "data/TilesTable.hpp"
 #include "data/WeaponObjectTable.hpp"
+#include "db/ConnectionManager.hpp"
 #include "db/Result.hpp"
 #include "db/SelectQuery.hpp"
 #include "netinterface/BasicCommand.hpp"
@@ -51,12 +52,33 @@
 #include <iterator>
 #include <memory>
 #include <regex>
+#include <sstream>
+#include <thread>
 
 extern ScheduledScriptsTable *scheduledScripts;
 extern MonsterTable *monsterDescriptions;
 
 World *World::_self;
 
+namespace {
+
+auto attackRange(Monster &monster) -> uint16_t {
+    const auto rightTool = monster.GetItemAt(RIGHT_TOOL).getId();
+    const auto leftTool = monster.GetItemAt(LEFT_TOOL).getId();
+
+    if (Data::weaponItems().exists(rightTool)) {
+        return Data::weaponItems()[rightTool].Range;
+    }
+
+    if (Data::weaponItems().exists(leftTool)) {
+        return Data::weaponItems()[leftTool].Range;
+    }
+
+    return 1;
+}
+
+} // namespace
+
 auto World::create() -> World * {
     if ((_self) == nullptr) {
         _self = new World();
@@ -80,7 +102,51 @@ auto World::get() -> World * {
     return _self;
 }
 
-World::World() {
+namespace {
+auto mapViewThreads() -> size_t {
+    const size_t cores = std::thread::hardware_concurrency();
+
+    if (cores < 2) {
+        return 0;
+    }
+
+    return std::min<size_t>(cores - 1, maxMapViewWorkers);
+}
+
+// one line of JSON for tools collecting the log, durations in microseconds
+auto schedulerReport(const std::vector<TaskStatistics> &tasks, const TickStatistics &ticks) -> std::string {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    std::ostringstream report;
+    report << R"({"ticks":)" << ticks.ticks << R"(,"tick_overruns":)" << ticks.overruns << R"(,"tick_max_us":)"
+           << duration_cast<microseconds>(ticks.maxDuration).count() << R"(,"lateness_limits_us":[)";
+
+    for (size_t i = 0; i < TaskStatistics::latenessLimits.size(); ++i) {
+        report << (i > 0 ? "," : "") << TaskStatistics::latenessLimits[i].count();
+    }
+
+    report << R"(],"tasks":[)";
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        const auto &task = tasks[i];
+        report << (i > 0 ? "," : "") << R"({"name":")" << task.name << R"(","runs":)" << task.runs
+               << R"(,"total_us":)" << duration_cast<microseconds>(task.totalDuration).count() << R"(,"max_us":)"
+               << duration_cast<microseconds>(task.maxDuration).count() << R"(,"overruns":)" << task.overruns
+               << R"(,"lateness":[)";
+
+        for (size_t j = 0; j < task.lateness.size(); ++j) {
+            report << (j > 0 ? "," : "") << task.lateness[j];
+        }
+
+        report << "]}";
+    }
+
+    report << "]}";
+    return report.str();
+}
+} // namespace
+
+World::World() : mapViewWorkers(mapViewThreads()) {
     lastTurnIGDay = getTime("day");
 
     startTime = std::chrono::steady_clock::now();
@@ -122,8 +188,6 @@ void World::checkPlayers() {
                 player.increaseFightPoints(ap);
                 player.workoutCommands();
                 player.checkFightMode();
-                player.ltAction->checkAction();
-                player.effects.checkEffects();
             }
             // User timed out.
             else {
@@ -145,6 +209,7 @@ void World::checkPlayers() {
 
             script::server::logout().onLogout(playerPointer);
 
+            characterHandles.remove(playerPointer);
             PlayerManager::get().getLogOutPlayers().push_back(playerPointer);
             sendRemoveCharToVisiblePlayers(player.getId(), pos);
             lostPlayers.push_back(playerPointer);
@@ -161,23 +226,16 @@ void World::checkPlayers() {
 }
 
 void World::checkPlayerImmediateCommands() {
-    std::unique_lock<std::mutex> lock(immediatePlayerCommandsMutex);
-    while (!immediatePlayerCommands.empty()) {
-        auto *player = immediatePlayerCommands.front();
-        immediatePlayerCommands.pop();
-        lock.unlock();
-
+    immediatePlayerCommands.drain([](Player *player) {
         if (player->Connection->online) {
             player->workoutCommands();
         }
-
-        lock.lock();
-    }
+    });
 }
 
 void World::addPlayerImmediateActionQueue(Player *player) {
-    std::unique_lock<std::mutex> lock(immediatePlayerCommandsMutex);
-    immediatePlayerCommands.push(player);
+    // if the queue is full, the commands of the player are worked out with the next turn
+    immediatePlayerCommands.tryPush(player);
 }
 
 void World::invalidatePlayerDialogs() const { Players.for_each(&Player::invalidateDialogs); }
@@ -212,12 +270,13 @@ auto World::initRespawns() -> bool {
             for (const auto &row : results) {
                 const auto spawnId = row["spp_id"].as<uint32_t>();
                 const position pos(row["spp_x"].as<int16_t>(), row["spp_y"].as<int16_t>(), row["spp_z"].as<int16_t>());
-                SpawnPoint newSpawn(pos, row["spp_range"].as<int>(), row["spp_spawnrange"].as<uint16_t>(),
-                                    row["spp_minspawntime"].as<uint16_t>(), row["spp_maxspawntime"].as<uint16_t>(),
-                                    row["spp_spawnall"].as<bool>());
+                // in place, every spawnpoint schedules its own spawns
+                auto &newSpawn = SpawnList.emplace_back(
+                        pos, row["spp_range"].as<int>(), row["spp_spawnrange"].as<uint16_t>(),
+                        row["spp_minspawntime"].as<uint16_t>(), row["spp_maxspawntime"].as<uint16_t>(),
+                        row["spp_spawnall"].as<bool>());
                 Logger::debug(LogFacility::World) << "load spawnpoint " << spawnId << ":" << Log::end;
                 newSpawn.load(spawnId);
-                SpawnList.push_back(newSpawn);
                 Logger::debug(LogFacility::World) << "added spawnpoint " << pos << Log::end;
             }
 
@@ -233,29 +292,20 @@ auto World::initRespawns() -> bool {
 }
 
 void World::checkMonsters() {
-    if (monstertimer.intervalExceeded()) {
-        if (isSpawnEnabled()) {
-            for (auto &spawn : SpawnList) {
-                spawn.spawn();
-            }
-        } else {
-            Logger::info(LogFacility::World) << "World::checkMonsters() spawning disabled!" << Log::end;
-        }
-    }
-
     if (ap > 1) {
         --ap;
     }
 
     std::vector<Monster *> deadMonsters;
+    // shared by all monsters, so that looking for targets does not allocate once it has grown
+    std::vector<Character *> targets;
 
-    Monsters.for_each([this, &deadMonsters](Monster *monsterPointer) {
+    Monsters.for_each([this, &deadMonsters, &targets](Monster *monsterPointer) {
         Monster &monster = *monsterPointer;
 
         if (monster.isAlive()) {
             monster.increaseActionPoints(ap);
             monster.increaseFightPoints(ap);
-            monster.effects.checkEffects();
 
             bool foundMonster = monsterDescriptions->exists(monster.getMonsterType());
             const auto &monStruct = (*monsterDescriptions)[monster.getMonsterType()];
@@ -266,24 +316,13 @@ void World::checkMonsters() {
                         monster.lastTargetSeen = false;
                     }
 
-                    Item itl = monster.GetItemAt(LEFT_TOOL).cloneItem();
-                    Item itr = monster.GetItemAt(RIGHT_TOOL).cloneItem();
-
-                    uint16_t range = 1;
-
-                    if (Data::weaponItems().exists(itr.getId())) {
-                        range = Data::weaponItems()[itr.getId()].Range;
-                    } else if (Data::weaponItems().exists(itl.getId())) {
-                        range = Data::weaponItems()[itl.getId()].Range;
-                    }
-
-                    const auto temp = getTargetsInRange(monster.getPosition(), range);
+                    getTargetsInRange(monster.getPosition(), attackRange(monster), targets);
                     bool has_attacked = false;
                     Character *target = nullptr;
 
-                    if ((!temp.empty()) && monster.canAttack()) {
-                        if (!monStruct.script || !monStruct.script->setTarget(monsterPointer, temp, target)) {
-                            target = script::server::fighting().setTarget(monsterPointer, temp);
+                    if ((!targets.empty()) && monster.canAttack()) {
+                        if (!monStruct.script || !monStruct.script->setTarget(monsterPointer, targets, target)) {
+                            target = script::server::fighting().setTarget(monsterPointer, targets);
                         }
 
                         if (target != nullptr) {
@@ -314,7 +353,7 @@ void World::checkMonsters() {
                     }
 
                     if (!has_attacked) {
-                        const auto targets = getTargetsInRange(monster.getPosition(), MONSTERVIEWRANGE);
+                        getTargetsInRange(monster.getPosition(), MONSTERVIEWRANGE, targets);
 
                         bool canMakeRandomStep = true;
 
@@ -447,24 +486,13 @@ void World::checkMonsters() {
                         }
                     }
                 } else {
-                    Item itl = monster.GetItemAt(LEFT_TOOL).cloneItem();
-                    Item itr = monster.GetItemAt(RIGHT_TOOL).cloneItem();
-
-                    uint16_t range = 1;
-
-                    if (Data::weaponItems().exists(itr.getId())) {
-                        range = Data::weaponItems()[itr.getId()].Range;
-                    } else if (Data::weaponItems().exists(itl.getId())) {
-                        range = Data::weaponItems()[itl.getId()].Range;
-                    }
+                    getTargetsInRange(monster.getPosition(), attackRange(monster), targets);
 
-                    const auto temp = getTargetsInRange(monster.getPosition(), range);
-
-                    if (!temp.empty()) {
+                    if (!targets.empty()) {
                         Character *target = nullptr;
 
-                        if (!monStruct.script || !monStruct.script->setTarget(monsterPointer, temp, target)) {
-                            target = script::server::fighting().setTarget(monsterPointer, temp);
+                        if (!monStruct.script || !monStruct.script->setTarget(monsterPointer, targets, target)) {
+                            target = script::server::fighting().setTarget(monsterPointer, targets);
                         }
 
                         if (target != nullptr) {
@@ -477,13 +505,13 @@ void World::checkMonsters() {
                         }
                     }
 
-                    const auto temp2 = getTargetsInRange(monster.getPosition(), MONSTERVIEWRANGE);
+                    getTargetsInRange(monster.getPosition(), MONSTERVIEWRANGE, targets);
 
-                    if (!temp2.empty()) {
+                    if (!targets.empty()) {
                         Character *target = nullptr;
 
-                        if (!monStruct.script || !monStruct.script->setTarget(monsterPointer, temp2, target)) {
-                            target = script::server::fighting().setTarget(monsterPointer, temp2);
+                        if (!monStruct.script || !monStruct.script->setTarget(monsterPointer, targets, target)) {
+                            target = script::server::fighting().setTarget(monsterPointer, targets);
                         }
 
                         if (target != nullptr) {
@@ -531,18 +559,23 @@ void World::checkMonsters() {
     newMonsters.clear();
 }
 
-auto World::getTargetsInRange(const position &pos, int radius) const -> std::vector<Character *> {
+void World::getTargetsInRange(const position &pos, int radius, std::vector<Character *> &targets) const {
     Range range;
     range.radius = radius;
     range.zRadius = 0;
-    const auto players = Players.findAllAliveCharactersInRangeOf(pos, range);
-    const auto monsters = Monsters.findAllAliveCharactersInRangeOf(pos, range);
-    std::vector<Character *> targets;
-    targets.insert(targets.end(), players.begin(), players.end());
-    std::remove_copy_if(monsters.begin(), monsters.end(), std::back_inserter(targets),
-                        [&](const auto &monster) { return pos == monster->getPosition(); });
+    targets.clear();
+
+    Players.forEachCharacterInRangeOf(pos, range, [&targets](Player *player) {
+        if (player->isAlive()) {
+            targets.push_back(player);
+        }
+    });
 
-    return targets;
+    Monsters.forEachCharacterInRangeOf(pos, range, [&pos, &targets](Monster *monster) {
+        if (monster->isAlive() && !(pos == monster->getPosition())) {
+            targets.push_back(monster);
+        }
+    });
 }
 
 void World::checkNPC() {
@@ -551,7 +584,6 @@ void World::checkNPC() {
     Npc.for_each([this](NPC *npc) {
         if (npc->isAlive()) {
             npc->increaseActionPoints(ap);
-            npc->effects.checkEffects();
             std::shared_ptr<LuaNPCScript> npcScript = npc->getScript();
 
             if (npc->canAct() && npcScript) {
@@ -578,6 +610,7 @@ void World::initNPC() {
         }
 
         sendRemoveCharToVisiblePlayers(npc->getId(), npc->getPosition());
+        characterHandles.remove(npc);
         delete npc;
     });
 
@@ -633,6 +666,73 @@ void World::initScheduler() {
     scheduler.addRecurringTask([&] { turntheworld(); }, gameLoopInterval, "turntheworld");
     scheduler.addRecurringTask([&] { sendIGTimeToAllPlayers(); }, ingameTimeUpdateInterval, getNextIGDayTime(),
                                "update_ig_day");
+    scheduler.addRecurringTask(
+            [&] {
+                const auto &statistics = stripeCache.getStatistics();
+                Logger::info(LogFacility::World)
+                        << "Map stripe cache: " << static_cast<int>(stripeCache.hitRate() * 100) << "% hit rate, "
+                        << statistics.hits << " hits, " << statistics.misses << " misses, " << statistics.bytesSaved
+                        << " bytes not encoded again" << Log::end;
+            },
+            stripeCacheReportInterval, "report_stripe_cache");
+    scheduler.addRecurringTask(
+            [] {
+                using std::chrono::duration_cast;
+                using std::chrono::milliseconds;
+                const auto statistics = Database::ConnectionManager::getInstance().getPoolStatistics();
+                Logger::info(LogFacility::Database)
+                        << "Database pool: " << statistics.checkouts << " checkouts, " << statistics.waits
+                        << " waits for " << duration_cast<milliseconds>(statistics.waitTime).count() << "ms (max "
+                        << duration_cast<milliseconds>(statistics.maxWaitTime).count() << "ms), "
+                        << statistics.inUse << " in use (max " << statistics.maxInUse << "), " << statistics.idle
+                        << " idle, " << statistics.reconnects << " reconnects, " << statistics.overflows
+                        << " overflows" << Log::end;
+            },
+            databasePoolReportInterval, "report_db_pool");
+    scheduler.addRecurringTask(
+            [&] {
+                using std::chrono::duration_cast;
+                using std::chrono::milliseconds;
+                const auto statistics = persistenceQueue.getStatistics();
+                Logger::info(LogFacility::Database)
+                        << "Persistent field writes: " << statistics.depth << " queued, " << statistics.queued
+                        << " changes, " << statistics.merged << " merged, " << statistics.written << " written in "
+                        << statistics.batches << " batches (" << statistics.failedBatches << " failed, "
+                        << statistics.lost << " fields lost), lag "
+                        << duration_cast<milliseconds>(statistics.lastLag).count() << "ms (max "
+                        << duration_cast<milliseconds>(statistics.maxLag).count() << "ms)" << Log::end;
+            },
+            persistenceQueueReportInterval, "report_field_persistence");
+
+    scheduler.setTickBudget(std::chrono::milliseconds(Config::instance().scheduler_tick_budget()));
+    scheduler.setProfiling(Config::instance().scheduler_profiling != 0);
+    scheduler.addRecurringTask(
+            [&] {
+                if (scheduler.isProfiling()) {
+                    Logger::info(LogFacility::World)
+                            << "Scheduler profile: "
+                            << schedulerReport(scheduler.getTaskStatistics(), scheduler.getTickStatistics())
+                            << Log::end;
+                }
+            },
+            schedulerReportInterval, "report_scheduler");
+
+    const std::chrono::microseconds garbageCollectionBudget(Config::instance().lua_gc_idle_budget());
+    scheduler.setIdleTask([garbageCollectionBudget](std::chrono::nanoseconds idle) {
+        LuaScript::collectGarbage(std::min<std::chrono::nanoseconds>(idle, garbageCollectionBudget));
+    });
+    scheduler.addRecurringTask(
+            [] {
+                using std::chrono::duration_cast;
+                using std::chrono::microseconds;
+                const auto statistics = LuaScript::getGarbageCollectionStatistics();
+                Logger::info(LogFacility::Script)
+                        << "Lua heap: " << statistics.heapBytes / 1024 << " KB, " << statistics.cycles
+                        << " collection cycles in idle time, " << statistics.steps << " steps taking "
+                        << duration_cast<microseconds>(statistics.duration).count() << "us (max "
+                        << duration_cast<microseconds>(statistics.maxDuration).count() << "us)" << Log::end;
+            },
+            luaHeapReportInterval, "report_lua_heap");
 }
 
 auto World::executeUserCommand(Player *user, const std::string &input, const CommandMap &commands) -> bool {
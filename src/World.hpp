@@ -25,17 +25,21 @@
 
 #include "Character.hpp"
 #include "CharacterContainer.hpp"
+#include "CharacterHandles.hpp"
 #include "Language.hpp"
+#include "MPSCQueue.hpp"
 #include "MonitoringClients.hpp"
 #include "NewClientView.hpp"
 #include "Scheduler.hpp"
 #include "SpawnPoint.hpp"
+#include "StripeCache.hpp"
 #include "TableStructs.hpp"
-#include "Timer.hpp"
+#include "WorkerPool.hpp"
 #include "WorldScriptInterface.hpp"
 #include "character_ptr.hpp"
 #include "data/MonsterAttackTable.hpp"
 #include "data/MonsterTable.hpp"
+#include "map/PersistenceQueue.hpp"
 #include "map/WorldMap.hpp"
 
 #include <chrono>
@@ -95,9 +99,8 @@ public:
     World(World &&) = delete;
     auto operator=(World &&) -> World & = delete;
 
-    /////////////////////////
-    NewClientView clientview;
-    /////////////////////////
+    StripeCache stripeCache;
+    map::PersistenceQueue persistenceQueue;
 
     /**
      *@todo: change the three vectors @see PLAYERVECTOR, @see MONSTERVECTOR, @see NPCVECTOR so there is only one
@@ -153,6 +156,11 @@ public:
      */
     std::vector<TYPE_OF_CHARACTER_ID> LostNpcs;
 
+    /**
+     * handles of all players, monsters and npcs in the world, including new monsters
+     */
+    CharacterHandles characterHandles;
+
     /**
      * holds the monitoring clients on the World
      */
@@ -296,6 +304,15 @@ public:
 
     auto killMonster(TYPE_OF_CHARACTER_ID id) -> bool;
 
+    // calls visitor with every player, monster and npc in range, without building
+    // a result; the visitor must not move, add or remove characters
+    template <class Visitor>
+    void forEachCharacterInRange(const position &pos, const Range &range, const Visitor &visitor) const {
+        Players.forEachCharacterInRangeOf(pos, range, visitor);
+        Monsters.forEachCharacterInRangeOf(pos, range, visitor);
+        Npc.forEachCharacterInRangeOf(pos, range, visitor);
+    }
+
     auto fieldAt(const position &pos) -> map::Field & override;
     auto fieldAt(const position &pos) const -> const map::Field & override;
     auto fieldAtOrBelow(position &pos) -> map::Field &;
@@ -303,6 +320,16 @@ public:
     void makePersistentAt(const position &pos) override;
     void removePersistenceAt(const position &pos) override;
     auto isPersistentAt(const position &pos) const -> bool override;
+    [[nodiscard]] auto currentAgeingCycle() const -> map::AgeingCycle;
+    void scheduleAgeing(const position &pos, map::AgeingCycle due);
+
+    // encoded map stripes, taken from the stripe cache or built by the map view workers
+    auto getMapStripe(const NewClientView::StripeRequest &stripe,
+                      NewClientView::stripeencoding encoding = NewClientView::encoding_classic)
+            -> StripeCache::StripePointer;
+    auto getMapStripes(const std::vector<NewClientView::StripeRequest> &stripes,
+                       NewClientView::stripeencoding encoding = NewClientView::encoding_classic)
+            -> std::vector<StripeCache::StripePointer>;
 
     static auto getItemAttrib(const std::string &s, TYPE_OF_ITEM_ID ItemID) -> int;
 
@@ -311,6 +338,7 @@ public:
     void import();
     auto createMap(const std::string &name, const position &origin, uint16_t width, uint16_t height, uint16_t tile)
             -> bool {
+        stripeCache.clear();
         return maps.createMap(name, origin, width, height, tile);
     }
 
@@ -422,7 +450,7 @@ public:
                                               TYPE_OF_WALKINGCOST duration) const;
     void sendCharacterMoveToAllVisibleChars(Character *cc, TYPE_OF_WALKINGCOST duration) const;
     void sendCharacterWarpToAllVisiblePlayers(Character *cc, const position &oldpos, unsigned char moveType) const;
-    template <class T> void sendCharsInVector(const std::vector<T *> &vec, Player *cp, bool sendSpin);
+    static void sendCharToPlayer(const Character *cc, Player *cp, bool sendSpin);
 
     void lookAtMapItem(Player *player, const position &pos, uint8_t stackPos);
 
@@ -568,7 +596,7 @@ public:
     void summon_command(Player *player, const std::string &text) const;
 
     // ! relaods only the definition from the db no Monsterspawns and no NPC's are loaded.
-    auto reload_defs(Player *cp) const -> bool;
+    auto reload_defs(Player *cp) -> bool;
 
     // ! adds Warpfields to map from textfile
     auto importWarpFields(Player *cp, const std::string &filename) -> bool;
@@ -702,6 +730,7 @@ public:
 protected:
     World(); // used for testcases
     static World *_self;
+    void ageMaps();
 
 private:
     static void logMissingField(const std::string &function, const position &field);
@@ -720,9 +749,6 @@ private:
     //! IG day of last turntheworld
     int lastTurnIGDay;
 
-    Timer monstertimer{std::chrono::minutes(1)};
-
-    void ageMaps();
     void ageInventory() const;
 
     std::string scriptDir;
@@ -763,6 +789,12 @@ private:
     // Give help for GM commands
     static void gmhelp_command(Player *cp);
 
+    // Show or switch the profiling of scheduled tasks
+    void taskstats_command(Player *cp, const std::string &text);
+
+    // Show or switch the profiling of Lua entrypoints, write sampled Lua stacks
+    static void luaprof_command(Player *cp, const std::string &text);
+
     // Sendet eine Nachricht an alle GM's
     auto gmpage_command(Player *player, const std::string &ticket) const -> bool;
 
@@ -774,8 +806,10 @@ public:
 
 private:
     map::WorldMap maps;
+    WorkerPool mapViewWorkers;
 
-    auto getTargetsInRange(const position &pos, int radius) const -> std::vector<Character *>;
+    // fills targets, so that callers can reuse one buffer for many queries
+    void getTargetsInRange(const position &pos, int radius, std::vector<Character *> &targets) const;
 
     static auto active_language_command(Player *cp, const std::string &language) -> bool;
 
@@ -795,8 +829,8 @@ private:
 
     static void version_command(Player *player);
 
-    std::mutex immediatePlayerCommandsMutex;
-    std::queue<Player *> immediatePlayerCommands;
+    // players with commands to work out right away, filled by the network threads
+    MPSCQueue<Player *> immediatePlayerCommands{immediatePlayerQueueSize};
 };
 
 #endif
@@ -32,9 +32,13 @@
 #include "map/Field.hpp"
 #include "netinterface/NetInterface.hpp"
 #include "netinterface/protocol/ServerCommands.hpp"
+#include "script/LuaProfiler.hpp"
 #include "script/LuaReloadScript.hpp"
+#include "script/LuaWatchdog.hpp"
 #include "script/server.hpp"
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <list>
@@ -234,6 +238,132 @@ void World::InitGMCommands() {
         world->spawn_command(player, text);
         return true;
     };
+
+    GMCommands["taskstats"] = [](World *world, Player *player, const std::string &text) -> bool {
+        world->taskstats_command(player, text);
+        return true;
+    };
+
+    GMCommands["luaprof"] = [](World *world, Player *player, const std::string &text) -> bool {
+        luaprof_command(player, text);
+        return true;
+    };
+}
+
+void World::taskstats_command(Player *cp, const std::string &text) {
+    if (!cp->hasGMRight(gmr_reload)) {
+        return;
+    }
+
+    if (text == "on" || text == "off") {
+        scheduler.setProfiling(text == "on");
+        Logger::info(LogFacility::Admin) << *cp << " turns scheduler profiling " << text << Log::end;
+        cp->inform("Scheduler profiling is " + text + ".");
+        return;
+    }
+
+    if (text == "reset") {
+        scheduler.resetStatistics();
+        cp->inform("Scheduler statistics are reset.");
+        return;
+    }
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    const auto ticks = scheduler.getTickStatistics();
+    cp->inform("Scheduler profiling is " + std::string(scheduler.isProfiling() ? "on" : "off") + ": " +
+               std::to_string(ticks.ticks) + " ticks, " + std::to_string(ticks.overruns) + " over budget, longest " +
+               std::to_string(duration_cast<microseconds>(ticks.maxDuration).count()) + "us");
+
+    constexpr size_t shownTasks = 10;
+    const auto tasks = scheduler.getTaskStatistics();
+
+    for (size_t i = 0; i < std::min(shownTasks, tasks.size()); ++i) {
+        const auto &task = tasks[i];
+        const auto total = duration_cast<microseconds>(task.totalDuration).count();
+        cp->inform(task.name + ": " + std::to_string(task.runs) + " runs, " + std::to_string(total) + "us total, " +
+                   std::to_string(total / int64_t(task.runs)) + "us average, " +
+                   std::to_string(duration_cast<microseconds>(task.maxDuration).count()) + "us max, " +
+                   std::to_string(task.overruns) + " over budget");
+    }
+}
+
+void World::luaprof_command(Player *cp, const std::string &text) {
+    if (!cp->hasGMRight(gmr_reload)) {
+        return;
+    }
+
+    auto &profiler = LuaProfiler::get();
+
+    if (text == "on" || text == "off") {
+        profiler.setProfiling(text == "on");
+        Logger::info(LogFacility::Admin) << *cp << " turns Lua profiling " << text << Log::end;
+        cp->inform("Lua profiling is " + text + ".");
+        return;
+    }
+
+    if (text == "reset") {
+        profiler.resetStatistics();
+        LuaWatchdog::get().resetOverruns();
+        cp->inform("Lua statistics are reset.");
+        return;
+    }
+
+    if (text.rfind("sample", 0) == 0) {
+        std::stringstream ss(text.substr(std::string("sample").size()));
+        int instructions = 0;
+        ss >> instructions;
+        profiler.setSampleInterval(instructions);
+        Logger::info(LogFacility::Admin) << *cp << " sets the Lua sample interval to " << instructions
+                                         << " instructions" << Log::end;
+        cp->inform("Lua stacks are sampled every " + std::to_string(profiler.getSampleInterval()) +
+                   " instructions while profiling, 0 means never.");
+        return;
+    }
+
+    if (text == "dump") {
+        const auto path = Config::instance().datadir() + "luaprofile.folded";
+        std::ofstream out(path);
+        profiler.writeFoldedStacks(out);
+
+        if (out.good()) {
+            cp->inform("Lua stacks written to " + path + ".");
+        } else {
+            cp->inform("*** Error: could not write " + path + " ***");
+        }
+
+        return;
+    }
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    cp->inform("Lua profiling is " + std::string(profiler.isProfiling() ? "on" : "off") + ", " +
+               std::to_string(profiler.getSampleCount()) + " stack samples");
+
+    const auto garbageCollection = LuaScript::getGarbageCollectionStatistics();
+    cp->inform("Lua heap: " + std::to_string(garbageCollection.heapBytes / 1024) + " KB, " +
+               std::to_string(garbageCollection.cycles) + " collection cycles in idle time taking " +
+               std::to_string(duration_cast<microseconds>(garbageCollection.duration).count()) + "us, " +
+               std::to_string(duration_cast<microseconds>(garbageCollection.maxDuration).count()) + "us max");
+
+    constexpr size_t shownEntrypoints = 10;
+    const auto entrypoints = profiler.getEntrypointStatistics();
+
+    for (size_t i = 0; i < std::min(shownEntrypoints, entrypoints.size()); ++i) {
+        const auto &entrypoint = entrypoints[i];
+        const auto total = duration_cast<microseconds>(entrypoint.totalDuration).count();
+        cp->inform(entrypoint.script + "." + entrypoint.entrypoint + ": " + std::to_string(entrypoint.calls) +
+                   " calls, " + std::to_string(total) + "us total, " +
+                   std::to_string(total / int64_t(entrypoint.calls)) + "us average, " +
+                   std::to_string(duration_cast<microseconds>(entrypoint.maxDuration).count()) + "us max, " +
+                   std::to_string(entrypoint.allocatedBytes / entrypoint.calls) + " bytes allocated per call");
+    }
+
+    const auto overruns = LuaWatchdog::get().getOverruns();
+
+    for (size_t i = 0; i < std::min(shownEntrypoints, overruns.size()); ++i) {
+        cp->inform(overruns[i].first + ": " + std::to_string(overruns[i].second) + " calls aborted over budget");
+    }
 }
 
 void World::spawn_command(Player *cp, const std::string &monsterId) {
@@ -428,10 +558,15 @@ void World::makeVisible(Player *cp) const {
 
     Logger::info(LogFacility::Admin) << *cp << " becomes visible" << Log::end;
 
+    ServerCommandPointer moveCmd;
+
     for (const auto &player : Players.findAllCharactersInScreen(cp->getPosition())) {
         if (cp != player) {
-            ServerCommandPointer cmd = std::make_shared<MoveAckTC>(cp->getId(), cp->getPosition(), PUSH, 0);
-            player->Connection->addCommand(cmd);
+            if (!moveCmd) {
+                moveCmd = std::make_shared<MoveAckTC>(cp->getId(), cp->getPosition(), PUSH, 0);
+            }
+
+            player->Connection->addCommand(moveCmd);
         }
     }
 
@@ -491,6 +626,7 @@ void World::forceLogoutOfAllPlayers() {
         sendMonitoringMessage(message);
         ServerCommandPointer cmd = std::make_shared<LogOutTC>(SERVERSHUTDOWN);
         player->Connection->shutdownSend(cmd);
+        characterHandles.remove(player);
         PlayerManager::get().getLogOutPlayers().push_back(player);
     });
 
@@ -812,7 +948,7 @@ void World::playersave_command(Player *cp) const {
 
     Logger::info(LogFacility::Admin) << *cp << " saves all players" << Log::end;
 
-    Players.for_each(&Player::save);
+    Players.for_each([](Player *player) { PlayerManager::get().savePlayer(player->createSnapshot()); });
 
     std::string tmessage = "*** All online players saved! ***";
     cp->inform(tmessage);
@@ -943,6 +1079,12 @@ void World::gmhelp_command(Player *cp) {
         cp->inform(tmessage);
         tmessage = "!fullreload - (!fr) reloads all database tables";
         cp->inform(tmessage);
+        tmessage = "!taskstats [on|off|reset] - shows the most expensive scheduled tasks, switches or resets "
+                   "profiling them.";
+        cp->inform(tmessage);
+        tmessage = "!luaprof [on|off|reset|sample <instructions>|dump] - shows the most expensive Lua entrypoints, "
+                   "switches or resets profiling them, samples Lua stacks, writes the samples as folded stacks.";
+        cp->inform(tmessage);
     }
 
     if (cp->hasGMRight(gmr_import)) {
@@ -991,7 +1133,7 @@ void reportTableError(Player *cp, const std::string &dbtable) {
     reportError(cp, "Failed to reload DB table: " + dbtable);
 }
 
-auto World::reload_defs(Player *cp) const -> bool {
+auto World::reload_defs(Player *cp) -> bool {
     if (!cp->hasGMRight(gmr_reload)) {
         return false;
     }
@@ -1056,6 +1198,9 @@ auto World::reload_defs(Player *cp) const -> bool {
     }
 
     if (ok) {
+        maps.refreshFlags();
+        // the stripes carry the movement costs just recomputed
+        stripeCache.clear();
         cp->inform(" *** Definitions reloaded *** ");
     } else {
         cp->inform("CRITICAL ERROR: Failure while reloading definitions");
@@ -89,26 +89,36 @@ void World::moveTo(Character *cc, const position &to) {
 }
 
 void World::sendSpinToAllVisiblePlayers(Character *cc) const {
-    for (const auto &p : Players.findAllCharactersInScreen(cc->getPosition())) {
-        ServerCommandPointer cmd = std::make_shared<PlayerSpinTC>(cc->getFaceTo(), cc->getId());
+    ServerCommandPointer cmd;
+
+    Players.forEachCharacterInScreen(cc->getPosition(), [cc, &cmd](Player *p) {
+        if (!cmd) {
+            cmd = std::make_shared<PlayerSpinTC>(cc->getFaceTo(), cc->getId());
+        }
+
         p->Connection->addCommand(cmd);
-    }
+    });
 }
 
 void World::sendPassiveMoveToAllVisiblePlayers(Character *ccp) const {
     const auto &charPos = ccp->getPosition();
 
-    for (const auto &p : Players.findAllCharactersInScreen(charPos)) {
+    ServerCommandPointer cmd;
+
+    Players.forEachCharacterInScreen(charPos, [ccp, &charPos, &cmd](Player *p) {
         const auto &playerPos = p->getPosition();
         Coordinate xoffs = charPos.x - playerPos.x;
         Coordinate yoffs = charPos.y - playerPos.y;
         Coordinate zoffs = charPos.z - playerPos.z + RANGEDOWN;
 
         if ((xoffs != 0) || (yoffs != 0) || (zoffs != RANGEDOWN)) {
-            ServerCommandPointer cmd = std::make_shared<MoveAckTC>(ccp->getId(), charPos, PUSH, 0);
+            if (!cmd) {
+                cmd = std::make_shared<MoveAckTC>(ccp->getId(), charPos, PUSH, 0);
+            }
+
             p->Connection->addCommand(cmd);
         }
-    }
+    });
 }
 
 void World::sendCharacterMoveToAllVisibleChars(Character *cc, TYPE_OF_WALKINGCOST duration) const {
@@ -119,18 +129,23 @@ void World::sendCharacterMoveToAllVisiblePlayers(Character *cc, unsigned char mo
                                                  TYPE_OF_WALKINGCOST duration) const {
     if (!cc->isInvisible()) {
         const auto &charPos = cc->getPosition();
+        // encoded once on the first viewer and shared by all others
+        ServerCommandPointer cmd;
 
-        for (const auto &p : Players.findAllCharactersInScreen(charPos)) {
+        Players.forEachCharacterInScreen(charPos, [&](Player *p) {
             const auto &playerPos = p->getPosition();
             Coordinate xoffs = charPos.x - playerPos.x;
             Coordinate yoffs = charPos.y - playerPos.y;
             Coordinate zoffs = charPos.z - playerPos.z + RANGEDOWN;
 
             if ((xoffs != 0) || (yoffs != 0) || (zoffs != RANGEDOWN)) {
-                ServerCommandPointer cmd = std::make_shared<MoveAckTC>(cc->getId(), charPos, moveType, duration);
+                if (!cmd) {
+                    cmd = std::make_shared<MoveAckTC>(cc->getId(), charPos, moveType, duration);
+                }
+
                 p->Connection->addCommand(cmd);
             }
-        }
+        });
     }
 }
 
@@ -146,9 +161,14 @@ void World::sendCharacterWarpToAllVisiblePlayers(Character *cc, const position &
             }
         }
 
+        ServerCommandPointer cmd;
+
         for (const auto &p : Players.findAllCharactersInScreen(cc->getPosition())) {
             if (cc != p) {
-                ServerCommandPointer cmd = std::make_shared<MoveAckTC>(cc->getId(), cc->getPosition(), PUSH, 0);
+                if (!cmd) {
+                    cmd = std::make_shared<MoveAckTC>(cc->getId(), cc->getPosition(), PUSH, 0);
+                }
+
                 p->Connection->addCommand(cmd);
             }
         }
@@ -159,37 +179,30 @@ void World::sendAllVisibleCharactersToPlayer(Player *cp, bool sendSpin) {
     Range range;
     range.radius = cp->getScreenRange();
 
-    std::vector<Player *> tempP = Players.findAllCharactersInRangeOf(cp->getPosition(), range);
-    sendCharsInVector<Player>(tempP, cp, sendSpin);
-
-    std::vector<Monster *> tempM = Monsters.findAllCharactersInRangeOf(cp->getPosition(), range);
-    sendCharsInVector<Monster>(tempM, cp, sendSpin);
-
-    std::vector<NPC *> tempN = Npc.findAllCharactersInRangeOf(cp->getPosition(), range);
-    sendCharsInVector<NPC>(tempN, cp, sendSpin);
+    forEachCharacterInRange(cp->getPosition(), range,
+                            [cp, sendSpin](const Character *cc) { sendCharToPlayer(cc, cp, sendSpin); });
 
     cp->sendAvailableQuests();
 }
 
-template <class T> void World::sendCharsInVector(const std::vector<T *> &vec, Player *cp, bool sendSpin) {
-    const auto &playerPos = cp->getPosition();
-
-    for (const auto &cc : vec) {
-        if (!cc->isInvisible()) {
-            const auto &charPos = cc->getPosition();
-            const auto xoffs = charPos.x - playerPos.x;
-            const auto yoffs = charPos.y - playerPos.y;
-            const auto zoffs = charPos.z - playerPos.z + RANGEDOWN;
-
-            if ((xoffs != 0) || (yoffs != 0) || (zoffs != RANGEDOWN)) {
-                ServerCommandPointer cmd = std::make_shared<MoveAckTC>(cc->getId(), charPos, PUSH, 0);
-                cp->Connection->addCommand(cmd);
-                cmd = std::make_shared<PlayerSpinTC>(cc->getFaceTo(), cc->getId());
+void World::sendCharToPlayer(const Character *cc, Player *cp, bool sendSpin) {
+    if (cc->isInvisible()) {
+        return;
+    }
 
-                if (sendSpin) {
-                    cp->Connection->addCommand(cmd);
-                }
-            }
+    const auto &playerPos = cp->getPosition();
+    const auto &charPos = cc->getPosition();
+    const auto xoffs = charPos.x - playerPos.x;
+    const auto yoffs = charPos.y - playerPos.y;
+    const auto zoffs = charPos.z - playerPos.z + RANGEDOWN;
+
+    if ((xoffs != 0) || (yoffs != 0) || (zoffs != RANGEDOWN)) {
+        ServerCommandPointer cmd = std::make_shared<MoveAckTC>(cc->getId(), charPos, PUSH, 0);
+        cp->Connection->addCommand(cmd);
+
+        if (sendSpin) {
+            cmd = std::make_shared<PlayerSpinTC>(cc->getFaceTo(), cc->getId());
+            cp->Connection->addCommand(cmd);
         }
     }
 }
@@ -454,13 +454,10 @@ auto World::takeItemFromMap(Character *cc, const position &itemPosition) -> bool
                 g_item.resetWear();
 
                 if (g_item.isContainer()) {
-                    auto it = field.containers.find(g_item.getNumber());
+                    g_cont = field.takeContainer(g_item.getNumber());
 
-                    if (it != field.containers.end()) {
-                        g_cont = it->second;
+                    if (g_cont != nullptr) {
                         g_cont->resetWear();
-
-                        field.containers.erase(it);
                     } else {
                         g_cont = new Container(g_item.getId());
                     }
@@ -1381,23 +1378,38 @@ void World::pickUpAllItemsFromMap(Player *cp) {
 }
 
 void World::sendRemoveItemFromMapToAllVisibleCharacters(const position &itemPosition) const {
+    ServerCommandPointer cmd;
+
     for (const auto &player : Players.findAllCharactersInScreen(itemPosition)) {
-        ServerCommandPointer cmd = std::make_shared<ItemRemoveTC>(itemPosition);
+        if (!cmd) {
+            cmd = std::make_shared<ItemRemoveTC>(itemPosition);
+        }
+
         player->Connection->addCommand(cmd);
     }
 }
 
 void World::sendSwapItemOnMapToAllVisibleCharacter(TYPE_OF_ITEM_ID id, const position &itemPosition,
                                                    const Item &it) const {
+    ServerCommandPointer cmd;
+
     for (const auto &player : Players.findAllCharactersInScreen(itemPosition)) {
-        ServerCommandPointer cmd = std::make_shared<ItemSwapTC>(itemPosition, id, it);
+        if (!cmd) {
+            cmd = std::make_shared<ItemSwapTC>(itemPosition, id, it);
+        }
+
         player->Connection->addCommand(cmd);
     }
 }
 
 void World::sendPutItemOnMapToAllVisibleCharacters(const position &itemPosition, const Item &it) const {
+    ServerCommandPointer cmd;
+
     for (const auto &player : Players.findAllCharactersInScreen(itemPosition)) {
-        ServerCommandPointer cmd = std::make_shared<ItemPutTC>(itemPosition, it);
+        if (!cmd) {
+            cmd = std::make_shared<ItemPutTC>(itemPosition, it);
+        }
+
         player->Connection->addCommand(cmd);
     }
 }
@@ -45,6 +45,7 @@ auto World::createDynamicNPC(const std::string &name, TYPE_OF_RACE_ID type, cons
 
             // add npc to npc list
             Npc.insert(newNPC);
+            characterHandles.add(newNPC);
 
             try {
                 // try to load the script
@@ -415,6 +416,7 @@ auto World::createMonster(unsigned short id, const position &pos, short movepoin
             auto *newMonster = new Monster(id, pos);
             newMonster->setActionPoints(movepoints);
             newMonsters.push_back(newMonster);
+            characterHandles.add(newMonster);
             field.setChar();
             return character_ptr(newMonster);
 
@@ -432,15 +434,25 @@ auto World::createMonster(unsigned short id, const position &pos, short movepoin
 }
 
 void World::gfx(unsigned short int gfxid, const position &pos) const {
+    ServerCommandPointer cmd;
+
     for (auto &player : Players.findAllCharactersInScreen(pos)) {
-        ServerCommandPointer cmd = std::make_shared<GraphicEffectTC>(pos, gfxid);
+        if (!cmd) {
+            cmd = std::make_shared<GraphicEffectTC>(pos, gfxid);
+        }
+
         player->Connection->addCommand(cmd);
     }
 }
 
 void World::makeSound(unsigned short int soundid, const position &pos) const {
+    ServerCommandPointer cmd;
+
     for (auto &player : Players.findAllCharactersInScreen(pos)) {
-        ServerCommandPointer cmd = std::make_shared<SoundTC>(pos, soundid);
+        if (!cmd) {
+            cmd = std::make_shared<SoundTC>(pos, soundid);
+        }
+
         player->Connection->addCommand(cmd);
     }
 }
@@ -484,6 +496,7 @@ void World::changeTile(short int tileid, const position &pos) {
 
 auto World::createSavedArea(uint16_t tile, const position &origin, uint16_t height, uint16_t width) -> bool {
     if (maps.createMap("by createSavedArea", origin, width, height, tile)) {
+        stripeCache.clear();
         Logger::info(LogFacility::World) << "Map created by createSavedArea command at " << origin
                                          << " height: " << height << " width: " << width << " standard tile: " << tile
                                          << "!" << Log::end;
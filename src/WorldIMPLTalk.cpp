@@ -149,13 +149,13 @@ void World::sendMessageToAllCharsInRange(const std::string &german, const std::s
 
     std::string prefix = languagePrefix(cc->getActiveLanguage());
 
-    for (const auto &player : Players.findAllCharactersInRangeOf(cc->getPosition(), range)) {
+    Players.forEachCharacterInRangeOf(cc->getPosition(), range, [&](Player *player) {
         if (is_action) {
             player->receiveText(tt, player->nls(german, english), cc);
         } else {
             player->receiveText(tt, prefix + player->nls(german, english), cc);
         }
-    }
+    });
 
     if (cc->getType() == Character::player) {
         for (const auto &npc : Npc.findAllCharactersInRangeOf(cc->getPosition(), range)) {
@@ -209,20 +209,20 @@ void World::makeGFXForAllPlayersInRange(const position &pos, int radius, unsigne
     Range range;
     range.radius = radius;
 
-    for (const auto &player : Players.findAllCharactersInRangeOf(pos, range)) {
+    Players.forEachCharacterInRangeOf(pos, range, [&pos, gfx](Player *player) {
         ServerCommandPointer cmd = std::make_shared<GraphicEffectTC>(pos, gfx);
         player->Connection->addCommand(cmd);
-    }
+    });
 }
 
 void World::makeSoundForAllPlayersInRange(const position &pos, int radius, unsigned short int sound) const {
     Range range;
     range.radius = radius;
 
-    for (const auto &player : Players.findAllCharactersInRangeOf(pos, range)) {
+    Players.forEachCharacterInRangeOf(pos, range, [&pos, sound](Player *player) {
         ServerCommandPointer cmd = std::make_shared<SoundTC>(pos, sound);
         player->Connection->addCommand(cmd);
-    }
+    });
 }
 
 void World::lookAtMapItem(Player *player, const position &pos, uint8_t stackPos) {
@@ -53,6 +53,7 @@ void World::deleteAllLostNPC() {
             }
 
             sendRemoveCharToVisiblePlayers(npc->getId(), npc->getPosition());
+            characterHandles.remove(npc);
             delete npc;
         }
     }
@@ -63,8 +64,10 @@ void World::deleteAllLostNPC() {
 auto World::findTargetsInSight(const position &pos, Coordinate range, std::vector<Character *> &ret,
                                Character::face_to direction) const -> bool {
     bool found = false;
+    std::vector<Character *> candidates;
+    getTargetsInRange(pos, range, candidates);
 
-    for (const auto &candidate : getTargetsInRange(pos, range)) {
+    for (const auto &candidate : candidates) {
         bool indir = false;
         const position &candidatePos = candidate->getPosition();
 
@@ -340,6 +343,7 @@ void World::takeMonsterAndNPCFromMap() {
         } catch (FieldNotFound &) {
         }
 
+        characterHandles.remove(monster);
         delete monster;
     });
 
@@ -349,6 +353,7 @@ void World::takeMonsterAndNPCFromMap() {
         } catch (FieldNotFound &) {
         }
 
+        characterHandles.remove(npc);
         delete npc;
     });
 
@@ -464,6 +469,7 @@ auto World::killMonster(TYPE_OF_CHARACTER_ID id) -> bool {
 
         sendRemoveCharToVisiblePlayers(monster->getId(), monsterPos);
         Monsters.erase(id);
+        characterHandles.remove(monster);
         delete monster;
 
         return true;
@@ -476,6 +482,46 @@ auto World::fieldAt(const position &pos) -> map::Field & { return maps.at(pos);
 
 auto World::fieldAt(const position &pos) const -> const map::Field & { return maps.at(pos); }
 
+auto World::getMapStripe(const NewClientView::StripeRequest &stripe, NewClientView::stripeencoding encoding)
+        -> StripeCache::StripePointer {
+    auto encoded = stripeCache.find(stripe, encoding);
+
+    if (!encoded) {
+        encoded = std::make_shared<StripeCache::Stripe>(NewClientView::encodeStripe(maps, stripe, encoding));
+        stripeCache.insert(stripe, encoding, encoded);
+    }
+
+    return encoded;
+}
+
+auto World::getMapStripes(const std::vector<NewClientView::StripeRequest> &stripes,
+                          NewClientView::stripeencoding encoding) -> std::vector<StripeCache::StripePointer> {
+    std::vector<StripeCache::StripePointer> encoded;
+    std::vector<size_t> missing;
+    encoded.reserve(stripes.size());
+
+    for (const auto &stripe : stripes) {
+        encoded.push_back(stripeCache.find(stripe, encoding));
+
+        if (!encoded.back()) {
+            missing.push_back(encoded.size() - 1);
+        }
+    }
+
+    // the workers only read the map, the main thread waits for them and
+    // is the only one touching the cache
+    mapViewWorkers.run(missing.size(), [&](size_t job) {
+        const auto i = missing[job];
+        encoded[i] = std::make_shared<StripeCache::Stripe>(NewClientView::encodeStripe(maps, stripes[i], encoding));
+    });
+
+    for (const auto i : missing) {
+        stripeCache.insert(stripes[i], encoding, encoded[i]);
+    }
+
+    return encoded;
+}
+
 auto World::fieldAtOrBelow(position &pos) -> map::Field & {
     for (size_t i = 0; i <= RANGEDOWN; ++i) {
         map::Field &field = fieldAt(pos);
@@ -492,12 +538,22 @@ auto World::fieldAtOrBelow(position &pos) -> map::Field & {
 
 auto World::walkableFieldNear(const position &pos) -> map::Field & { return walkableNear(maps, pos); }
 
-void World::makePersistentAt(const position &pos) { maps.makePersistentAt(pos); }
+void World::makePersistentAt(const position &pos) {
+    maps.makePersistentAt(pos);
+    stripeCache.invalidate(pos);
+}
 
-void World::removePersistenceAt(const position &pos) { maps.removePersistenceAt(pos); }
+void World::removePersistenceAt(const position &pos) {
+    maps.removePersistenceAt(pos);
+    stripeCache.invalidate(pos);
+}
 
 auto World::isPersistentAt(const position &pos) const -> bool { return maps.isPersistentAt(pos); }
 
+auto World::currentAgeingCycle() const -> map::AgeingCycle { return maps.currentAgeingCycle(); }
+
+void World::scheduleAgeing(const position &pos, map::AgeingCycle due) { maps.scheduleAgeing(pos, due); }
+
 auto World::getItemAttrib(const std::string &s, TYPE_OF_ITEM_ID ItemID) -> int {
     // Armor //
     if (s == "bodyparts") {
@@ -590,12 +646,20 @@ void World::ageInventory() const {
 void World::Save() const { maps.saveToDisk(); }
 
 void World::Load() {
+    stripeCache.clear();
+    // persistent fields are read back from the database
+    persistenceQueue.flush();
+
     if (!maps.loadFromDisk()) {
         maps.importFromEditor();
     }
 }
 
-void World::import() { maps.importFromEditor(); }
+void World::import() {
+    stripeCache.clear();
+    persistenceQueue.flush();
+    maps.importFromEditor();
+}
 
 auto World::getTime(const std::string &timeType) const -> int {
     // return unix timestamp if requsted and quit function
@@ -719,6 +783,7 @@ void World::sendRemoveCharToVisiblePlayers(TYPE_OF_CHARACTER_ID id, const positi
 void World::sendHealthToAllVisiblePlayers(Character *cc, Attribute::attribute_t health) const {
     if (!cc->isInvisible()) {
         const auto &charPos = cc->getPosition();
+        ServerCommandPointer cmd;
 
         for (const auto &player : Players.findAllCharactersInScreen(cc->getPosition())) {
             const auto &playerPos = player->getPosition();
@@ -727,7 +792,10 @@ void World::sendHealthToAllVisiblePlayers(Character *cc, Attribute::attribute_t
             Coordinate zoffs = charPos.z - playerPos.z + RANGEDOWN;
 
             if ((xoffs != 0) || (yoffs != 0) || (zoffs != RANGEDOWN)) {
-                ServerCommandPointer cmd = std::make_shared<UpdateAttribTC>(cc->getId(), "hitpoints", health);
+                if (!cmd) {
+                    cmd = std::make_shared<UpdateAttribTC>(cc->getId(), "hitpoints", health);
+                }
+
                 player->Connection->addCommand(cmd);
             }
         }
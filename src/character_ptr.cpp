@@ -25,14 +25,12 @@
 
 character_ptr::character_ptr(Character *p) {
     if (p != nullptr) {
-        id = p->getId();
-    } else {
-        id = 0;
+        handle = p->getHandle();
     }
 }
 
 auto character_ptr::get() const -> Character * {
-    auto *ptr = getPointerFromId();
+    auto *ptr = getPointerFromHandle();
 
     if (ptr != nullptr) {
         return ptr;
@@ -46,14 +44,10 @@ character_ptr::operator Character *() const { return get(); }
 
 auto character_ptr::operator->() const -> Character * { return get(); }
 
-character_ptr::operator bool() const { return getPointerFromId() != nullptr; }
+character_ptr::operator bool() const { return getPointerFromHandle() != nullptr; }
 
-auto character_ptr::getPointerFromId() const -> Character * {
-    if (id != 0) {
-        return World::get()->findCharacter(id);
-    }
-
-    return nullptr;
+auto character_ptr::getPointerFromHandle() const -> Character * {
+    return World::get()->characterHandles.get(handle);
 }
 
 auto get_pointer(character_ptr const &p) -> Character * { return p.get(); }
@@ -21,12 +21,12 @@
 #ifndef CHARACTER_PTR_HPP
 #define CHARACTER_PTR_HPP
 
-#include "types.hpp"
+#include "CharacterHandles.hpp"
 
 class Character;
 
 class character_ptr {
-    TYPE_OF_CHARACTER_ID id{0};
+    CharacterHandle handle;
 
 public:
     character_ptr() = default;
@@ -38,7 +38,7 @@ public:
     operator bool() const;
 
 private:
-    [[nodiscard]] auto getPointerFromId() const -> Character *;
+    [[nodiscard]] auto getPointerFromHandle() const -> Character *;
 };
 
 auto get_pointer(character_ptr const &p) -> Character *;
@@ -96,6 +96,7 @@ void NPCTable::reload() {
 
                     // add npc to npc list
                     _world->Npc.insert(newNPC);
+                    _world->characterHandles.add(newNPC);
 
                     if (!row["npc_script"].is_null()) {
                         const auto scriptname = row["npc_script"].as<std::string>();
@@ -22,6 +22,8 @@
 
 #include <memory>
 #include <pqxx/connection.hxx>
+#include <pqxx/nontransaction.hxx>
+#include <pqxx/pipeline.hxx>
 #include <pqxx/transaction.hxx>
 #include <stdexcept>
 
@@ -60,3 +62,55 @@ auto Connection::query(const std::string &query) -> pqxx::result {
 
     throw std::domain_error("No active transaction");
 }
+
+auto Connection::queryAll(const std::vector<std::string> &queries) -> std::vector<pqxx::result> {
+    if (!transaction) {
+        throw std::domain_error("No active transaction");
+    }
+
+    pqxx::pipeline pipeline(*transaction);
+    std::vector<pqxx::pipeline::query_id> ids;
+    ids.reserve(queries.size());
+
+    for (const auto &query : queries) {
+        ids.push_back(pipeline.insert(query));
+    }
+
+    pipeline.complete();
+
+    std::vector<pqxx::result> results;
+    results.reserve(ids.size());
+
+    for (const auto id : ids) {
+        results.push_back(pipeline.retrieve(id));
+    }
+
+    return results;
+}
+
+void Connection::prepare(const PreparedStatement &statement) {
+    if (!transaction) {
+        throw std::domain_error("No active transaction");
+    }
+
+    if (preparedStatements.count(statement.name) == 0) {
+        internalConnection->prepare(statement.name, statement.sql);
+        preparedStatements.insert(statement.name);
+    }
+}
+
+auto Connection::isOpen() const -> bool { return internalConnection && internalConnection->is_open(); }
+
+auto Connection::isHealthy() -> bool {
+    if (!isOpen() || transaction) {
+        return false;
+    }
+
+    try {
+        pqxx::nontransaction check(*internalConnection);
+        check.exec("SELECT 1");
+        return true;
+    } catch (std::exception &) {
+        return false;
+    }
+}
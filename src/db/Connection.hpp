@@ -25,17 +25,26 @@
 #include <pqxx/connection.hxx>
 #include <pqxx/transaction.hxx>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace Database {
 class Connection;
 
 using PConnection = std::shared_ptr<Connection>;
 
+/* A query of fixed shape, prepared once per connection on first use. */
+struct PreparedStatement {
+    std::string name;
+    std::string sql;
+};
+
 class Connection {
 private:
     /* The libpgxx representation of the connection to the database. */
     std::unique_ptr<pqxx::connection> internalConnection = nullptr;
     std::unique_ptr<pqxx::transaction_base> transaction = nullptr;
+    std::unordered_set<std::string> preparedStatements;
 
 public:
     explicit Connection(const std::string &connectionString);
@@ -50,11 +59,26 @@ public:
     void commitTransaction();
     void rollbackTransaction();
 
+    /* Sends all queries at once inside the active transaction and waits for the results in a single round trip. */
+    auto queryAll(const std::vector<std::string> &queries) -> std::vector<pqxx::result>;
+
+    template <typename... Args> auto query(const PreparedStatement &statement, Args &&...args) -> pqxx::result {
+        prepare(statement);
+        return transaction->exec_prepared(statement.name, std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] auto isOpen() const -> bool;
+    /* Runs a trivial query outside of any transaction to see if the server still answers. */
+    auto isHealthy() -> bool;
+
     template <typename T> [[nodiscard]] inline auto quote(const T &t) const -> std::string {
         return internalConnection->quote(t);
     }
 
     [[nodiscard]] inline auto transactionActive() const -> bool { return bool(transaction); }
+
+private:
+    void prepare(const PreparedStatement &statement);
 };
 
 } // namespace Database
@@ -42,16 +42,23 @@ void ConnectionManager::setupManager() {
     addConnectionParameterIfValid("dbname", Config::instance().postgres_db);
     addConnectionParameterIfValid("host", Config::instance().postgres_host);
     addConnectionParameterIfValid("port", std::to_string(Config::instance().postgres_port));
-    isOperational = true;
+    pool = std::make_shared<ConnectionPool>(connectionString, Config::instance().postgres_max_connections);
 }
 
 auto ConnectionManager::getConnection() -> PConnection {
-    if (!isOperational) {
+    if (!pool) {
         throw std::logic_error("Connection Manager is not set up yet");
     }
 
-    auto connPtr = std::make_shared<Connection>(connectionString);
-    return connPtr;
+    return pool->checkout();
+}
+
+auto ConnectionManager::getPoolStatistics() const -> ConnectionPool::Statistics {
+    if (!pool) {
+        return {};
+    }
+
+    return pool->getStatistics();
 }
 
 void ConnectionManager::addConnectionParameterIfValid(const string &param, const string &value) {
@@ -22,8 +22,10 @@
 #define CONNECTION_MANAGER_HPP
 
 #include "db/Connection.hpp"
+#include "db/ConnectionPool.hpp"
 
 #include <boost/cstdint.hpp>
+#include <memory>
 #include <stdexcept>
 #include <string>
 
@@ -34,7 +36,7 @@ class ConnectionManager {
 private:
     static ConnectionManager instance;
     string connectionString;
-    bool isOperational{false};
+    std::shared_ptr<ConnectionPool> pool;
 
 public:
     ConnectionManager(const ConnectionManager &org) = delete;
@@ -46,6 +48,7 @@ public:
 
     void setupManager();
     auto getConnection() -> PConnection;
+    [[nodiscard]] auto getPoolStatistics() const -> ConnectionPool::Statistics;
 
 private:
     ConnectionManager() = default;
@@ -0,0 +1,124 @@
+/*
+ * Illarionserver - server for the game Illarion
+ * Copyright 2011 Illarion e.V.
+ *
+ * This file is part of Illarionserver.
+ *
+ * Illarionserver  is  free  software:  you can redistribute it and/or modify it
+ * under the terms of the  GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * Illarionserver is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY;  without  even  the  implied  warranty  of  MERCHANTABILITY  or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * Illarionserver. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "db/ConnectionPool.hpp"
+
+#include <algorithm>
+
+using namespace Database;
+
+ConnectionPool::ConnectionPool(std::string connectionString, size_t maxConnections)
+        : connectionString(std::move(connectionString)), maxConnections(std::max<size_t>(maxConnections, 1)) {}
+
+auto ConnectionPool::checkout() -> PConnection {
+    std::unique_ptr<Connection> connection;
+    bool pooled = true;
+    bool checkHealth = false;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++statistics.checkouts;
+
+        if (idle.empty() && statistics.inUse >= maxConnections) {
+            const auto start = Clock::now();
+            ++statistics.waits;
+            connectionReturned.wait_for(lock, maxWaitTime,
+                                        [this] { return !idle.empty() || statistics.inUse < maxConnections; });
+            const auto waited = Clock::now() - start;
+            statistics.waitTime += waited;
+            statistics.maxWaitTime = std::max(statistics.maxWaitTime, waited);
+            pooled = !idle.empty() || statistics.inUse < maxConnections;
+        }
+
+        if (pooled) {
+            if (!idle.empty()) {
+                checkHealth = Clock::now() - idle.back().since > healthCheckAfter;
+                connection = std::move(idle.back().connection);
+                idle.pop_back();
+            }
+
+            ++statistics.inUse;
+            statistics.maxInUse = std::max(statistics.maxInUse, statistics.inUse);
+        } else {
+            ++statistics.overflows;
+        }
+    }
+
+    // connecting happens outside of the lock, a failure gives the slot back
+    try {
+        if (connection && !(checkHealth ? connection->isHealthy() : connection->isOpen())) {
+            connection.reset();
+            std::lock_guard<std::mutex> lock(mutex);
+            ++statistics.reconnects;
+        }
+
+        if (!connection) {
+            connection = std::make_unique<Connection>(connectionString);
+        }
+    } catch (...) {
+        if (pooled) {
+            std::lock_guard<std::mutex> lock(mutex);
+            --statistics.inUse;
+        }
+
+        connectionReturned.notify_one();
+        throw;
+    }
+
+    return wrap(std::move(connection), pooled);
+}
+
+auto ConnectionPool::wrap(std::unique_ptr<Connection> connection, bool pooled) -> PConnection {
+    if (!pooled) {
+        return PConnection(connection.release());
+    }
+
+    return PConnection(connection.release(), [pool = shared_from_this()](Connection *released) {
+        pool->checkin(released);
+    });
+}
+
+void ConnectionPool::checkin(Connection *released) {
+    std::unique_ptr<Connection> connection(released);
+
+    try {
+        connection->rollbackTransaction();
+    } catch (std::exception &) {
+        connection.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        --statistics.inUse;
+
+        if (connection && connection->isOpen()) {
+            idle.push_back({std::move(connection), Clock::now()});
+        }
+    }
+
+    connectionReturned.notify_one();
+}
+
+auto ConnectionPool::getStatistics() const -> Statistics {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto result = statistics;
+    result.idle = idle.size();
+    return result;
+}
@@ -0,0 +1,92 @@
+/*
+ * Illarionserver - server for the game Illarion
+ * Copyright 2011 Illarion e.V.
+ *
+ * This file is part of Illarionserver.
+ *
+ * Illarionserver  is  free  software:  you can redistribute it and/or modify it
+ * under the terms of the  GNU Affero General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option) any
+ * later version.
+ *
+ * Illarionserver is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY;  without  even  the  implied  warranty  of  MERCHANTABILITY  or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * Illarionserver. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DB_CONNECTION_POOL_HPP
+#define DB_CONNECTION_POOL_HPP
+
+#include "db/Connection.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Database {
+
+/*
+ * Keeps a bounded number of open connections. A checked out connection goes
+ * back to the pool when its last PConnection is released. Connections that
+ * were idle for a while are checked before they are handed out again, broken
+ * ones are replaced by new ones.
+ */
+class ConnectionPool : public std::enable_shared_from_this<ConnectionPool> {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Statistics {
+        uint64_t checkouts = 0;
+        uint64_t waits = 0;
+        Clock::duration waitTime{};
+        Clock::duration maxWaitTime{};
+        uint64_t reconnects = 0;
+        uint64_t overflows = 0;
+        size_t inUse = 0;
+        size_t maxInUse = 0;
+        size_t idle = 0;
+    };
+
+    static constexpr auto healthCheckAfter = std::chrono::seconds(30);
+    // waiting longer than this opens an extra connection, so that nested
+    // checkouts cannot deadlock on an exhausted pool
+    static constexpr auto maxWaitTime = std::chrono::seconds(2);
+
+    ConnectionPool(std::string connectionString, size_t maxConnections);
+    ConnectionPool(const ConnectionPool &) = delete;
+    auto operator=(const ConnectionPool &) -> ConnectionPool & = delete;
+    ConnectionPool(ConnectionPool &&) = delete;
+    auto operator=(ConnectionPool &&) -> ConnectionPool & = delete;
+    ~ConnectionPool() = default;
+
+    auto checkout() -> PConnection;
+    [[nodiscard]] auto getStatistics() const -> Statistics;
+
+private:
+    struct IdleConnection {
+        std::unique_ptr<Connection> connection;
+        Clock::time_point since;
+    };
+
+    auto wrap(std::unique_ptr<Connection> connection, bool pooled) -> PConnection;
+    void checkin(Connection *connection);
+
+    const std::string connectionString;
+    const size_t maxConnections;
+    mutable std::mutex mutex;
+    std::condition_variable connectionReturned;
+    std::vector<IdleConnection> idle;
+    Statistics statistics;
+};
+
+} // namespace Database
+
+#endif
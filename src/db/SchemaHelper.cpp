@@ -35,3 +35,7 @@ void SchemaHelper::setSchemata() {
 auto SchemaHelper::getServerSchema() -> const std::string & { return serverSchema; }
 
 auto SchemaHelper::getAccountSchema() -> const std::string & { return accountSchema; }
+
+auto SchemaHelper::getServerTable(const std::string &table) -> std::string {
+    return serverSchema + ".\"" + table + "\"";
+}
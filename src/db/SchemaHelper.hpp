@@ -33,6 +33,8 @@ public:
     static void setSchemata();
     static auto getServerSchema() -> const std::string &;
     static auto getAccountSchema() -> const std::string &;
+    /* qualified and quoted name of a table in the server schema, for hand written queries */
+    static auto getServerTable(const std::string &table) -> std::string;
 };
 } // namespace Database
 
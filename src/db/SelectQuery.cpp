@@ -55,7 +55,7 @@ void SelectQuery::addOrderBy(const std::string &table, const std::string &column
 
 void SelectQuery::setDistinct(const bool &distinct) { isDistinct = distinct; }
 
-auto SelectQuery::execute() -> Result {
+auto SelectQuery::buildQuery() -> std::string {
     std::stringstream ss;
     ss << "SELECT ";
 
@@ -74,6 +74,10 @@ auto SelectQuery::execute() -> Result {
 
     ss << ";";
 
-    setQuery(ss.str());
+    return ss.str();
+}
+
+auto SelectQuery::execute() -> Result {
+    setQuery(buildQuery());
     return Query::execute();
 }
@@ -53,6 +53,8 @@ public:
 
     void setDistinct(const bool &distinct);
 
+    /* The SQL of this query, for sending it together with others through Connection::queryAll. */
+    auto buildQuery() -> std::string;
     auto execute() -> Result override;
 };
 } // namespace Database
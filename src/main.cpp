@@ -97,7 +97,7 @@ auto main(int argc, char *argv[]) -> int {
     Logger::info(LogFacility::Other) << "create PlayerManager" << Log::end;
     PlayerManager::get().activate();
     Logger::info(LogFacility::Other) << "PlayerManager activated" << Log::end;
-    PlayerManager::TPLAYERVECTOR &newplayers = PlayerManager::get().getLogInPlayers();
+    PlayerManager::LoggedInQueue &newplayers = PlayerManager::get().getLogInPlayers();
     world->initNPC();
 
     try {
@@ -119,11 +119,14 @@ auto main(int argc, char *argv[]) -> int {
         int new_players_processed = 0;
 
         // process new players from connection thread
-        while (!newplayers.empty() && new_players_processed < MAXPLAYERSPROCESSED) {
+        Player *newPlayer = nullptr;
+
+        while (new_players_processed < MAXPLAYERSPROCESSED && newplayers.tryPop(newPlayer)) {
             new_players_processed++;
-            Player *newPlayer = newplayers.pop_front();
 
             if (newPlayer != nullptr) {
+                // a player failing to log in is deleted by the save thread, maybe before the login completes
+                const auto name = newPlayer->getName();
                 login_save(newPlayer);
 
                 if (newPlayer->isMonitoringClient()) {
@@ -131,15 +134,19 @@ auto main(int argc, char *argv[]) -> int {
                 } else {
                     try {
                         world->Players.insert(newPlayer);
+                        world->characterHandles.add(newPlayer);
                         newPlayer->login();
                         script::server::login().onLogin(newPlayer);
                         world->updatePlayerList();
                     } catch (Player::LogoutException &e) {
                         ServerCommandPointer cmd = std::make_shared<LogOutTC>(e.getReason());
                         newPlayer->Connection->shutdownSend(cmd);
+                        world->characterHandles.remove(newPlayer);
                         PlayerManager::get().getLogOutPlayers().push_back(newPlayer);
                     }
                 }
+
+                PlayerManager::get().loginCompleted(name);
             }
         }
 
@@ -159,6 +166,9 @@ auto main(int argc, char *argv[]) -> int {
 
     world->Save();
 
+    world->persistenceQueue.flush();
+    Logger::info(LogFacility::Other) << "Persistent fields saved!" << Log::end;
+
     reset_sighandlers();
 
     Logger::info(LogFacility::Other) << "Illarion has been terminated! " << Log::end;
@@ -0,0 +1,45 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "map/AgeingSchedule.hpp"
+
+namespace map {
+
+void AgeingSchedule::startCycle() {
+    ++cycle;
+    statistics = {};
+}
+
+void AgeingSchedule::schedule(const position &pos, AgeingCycle due) { entries.push({due, pos}); }
+
+auto AgeingSchedule::hasDueFields() const -> bool { return !entries.empty() && entries.top().due <= cycle; }
+
+auto AgeingSchedule::popDueField() -> position {
+    const auto pos = entries.top().pos;
+    entries.pop();
+    return pos;
+}
+
+void AgeingSchedule::countAgedField(size_t rottedItems) {
+    ++statistics.fields;
+    statistics.rottedItems += rottedItems;
+}
+
+void AgeingSchedule::addDuration(std::chrono::steady_clock::duration duration) { statistics.duration += duration; }
+
+} // namespace map
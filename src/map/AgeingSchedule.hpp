@@ -0,0 +1,73 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef AGEING_SCHEDULE_HPP
+#define AGEING_SCHEDULE_HPP
+
+#include "globals.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace map {
+
+using AgeingCycle = uint32_t;
+
+// Remembers in which ageing cycle each field holding decaying items or
+// containers has to be aged next, so that an ageing cycle only visits the
+// fields that are actually due. Entries are never removed early: a field that
+// changed in the meantime is just looked up again when its entry comes up.
+class AgeingSchedule {
+public:
+    struct Statistics {
+        size_t fields = 0;
+        // items that rotted into another item or vanished, not all the items on the aged fields
+        size_t rottedItems = 0;
+        std::chrono::steady_clock::duration duration{};
+    };
+
+    [[nodiscard]] auto currentCycle() const -> AgeingCycle { return cycle; }
+    void startCycle();
+    void schedule(const position &pos, AgeingCycle due);
+    [[nodiscard]] auto hasDueFields() const -> bool;
+    auto popDueField() -> position;
+    [[nodiscard]] auto pendingEntries() const -> size_t { return entries.size(); }
+
+    void countAgedField(size_t rottedItems);
+    void addDuration(std::chrono::steady_clock::duration duration);
+    [[nodiscard]] auto lastCycle() const -> const Statistics & { return statistics; }
+
+private:
+    struct Entry {
+        AgeingCycle due;
+        position pos;
+
+        auto operator>(const Entry &other) const -> bool { return due > other.due; }
+    };
+
+    AgeingCycle cycle = 0;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> entries;
+    Statistics statistics;
+};
+
+} // namespace map
+
+#endif
@@ -0,0 +1,163 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "map/ChunkDirectory.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace map {
+
+void ChunkDirectory::Chunk::set(const position &pos, MapIndex map) {
+    if (!tiles) {
+        if (uniformMap == map) {
+            return;
+        }
+
+        tiles = std::make_unique<TileTable>();
+        tiles->fill(uniformMap);
+    }
+
+    (*tiles)[tileIndex(pos)] = map;
+}
+
+void ChunkDirectory::clear() {
+    minLevel = 0;
+    levels.clear();
+}
+
+void ChunkDirectory::insert(Coordinate minX, Coordinate minY, Coordinate maxX, Coordinate maxY, Coordinate z,
+                            MapIndex map) {
+    auto &lvl = level(z);
+    lvl.cover(minX, minY, maxX, maxY);
+
+    for (auto chunkY = toChunk(minY); chunkY <= toChunk(maxY); ++chunkY) {
+        for (auto chunkX = toChunk(minX); chunkX <= toChunk(maxX); ++chunkX) {
+            const Coordinate chunkMinX = (chunkX << chunkBits) + std::numeric_limits<int16_t>::min();
+            const Coordinate chunkMinY = (chunkY << chunkBits) + std::numeric_limits<int16_t>::min();
+            const Coordinate chunkMaxX = chunkMinX + chunkSize - 1;
+            const Coordinate chunkMaxY = chunkMinY + chunkSize - 1;
+            auto &chunk = lvl.chunkAt(position(chunkMinX, chunkMinY, z));
+
+            const bool coversChunk =
+                    minX <= chunkMinX && minY <= chunkMinY && maxX >= chunkMaxX && maxY >= chunkMaxY;
+
+            if (coversChunk && !chunk.tiles) {
+                chunk.uniformMap = map;
+                continue;
+            }
+
+            for (auto y = std::max(minY, chunkMinY); y <= std::min(maxY, chunkMaxY); ++y) {
+                for (auto x = std::max(minX, chunkMinX); x <= std::min(maxX, chunkMaxX); ++x) {
+                    chunk.set(position(x, y, z), map);
+                }
+            }
+        }
+    }
+}
+
+void ChunkDirectory::addPersistentField(const position &pos) {
+    auto &lvl = level(pos.z);
+    lvl.cover(pos.x, pos.y, pos.x, pos.y);
+    ++lvl.chunkAt(pos).persistentFields;
+}
+
+void ChunkDirectory::removePersistentField(const position &pos) {
+    const auto *chunk = chunkAt(pos);
+
+    if (chunk != nullptr && chunk->persistentFields > 0) {
+        --level(pos.z).chunkAt(pos).persistentFields;
+    }
+}
+
+auto ChunkDirectory::memoryUsage() const -> size_t {
+    size_t bytes = levels.capacity() * sizeof(Level);
+
+    for (const auto &lvl : levels) {
+        bytes += lvl.memoryUsage();
+    }
+
+    return bytes;
+}
+
+auto ChunkDirectory::level(Coordinate z) -> Level & {
+    if (levels.empty()) {
+        minLevel = z;
+        levels.resize(1);
+    } else if (z < minLevel) {
+        std::vector<Level> newLevels(minLevel - z);
+        std::move(levels.begin(), levels.end(), std::back_inserter(newLevels));
+        levels = std::move(newLevels);
+        minLevel = z;
+    } else if (z - minLevel >= static_cast<Coordinate>(levels.size())) {
+        levels.resize(z - minLevel + 1);
+    }
+
+    return levels[z - minLevel];
+}
+
+auto ChunkDirectory::Level::chunkAt(const position &pos) -> Chunk & {
+    const auto x = toChunk(pos.x) - originX;
+    const auto y = toChunk(pos.y) - originY;
+    return chunks[y * width + x];
+}
+
+void ChunkDirectory::Level::cover(Coordinate minX, Coordinate minY, Coordinate maxX, Coordinate maxY) {
+    auto newOriginX = toChunk(minX);
+    auto newOriginY = toChunk(minY);
+    auto newEndX = toChunk(maxX) + 1;
+    auto newEndY = toChunk(maxY) + 1;
+
+    if (!chunks.empty()) {
+        newOriginX = std::min(newOriginX, originX);
+        newOriginY = std::min(newOriginY, originY);
+        newEndX = std::max(newEndX, originX + width);
+        newEndY = std::max(newEndY, originY + height);
+
+        if (newOriginX == originX && newOriginY == originY && newEndX == originX + width &&
+            newEndY == originY + height) {
+            return;
+        }
+    }
+
+    const auto newWidth = newEndX - newOriginX;
+    const auto newHeight = newEndY - newOriginY;
+    std::vector<Chunk> newChunks(newWidth * newHeight);
+
+    for (Coordinate y = 0; y < height; ++y) {
+        for (Coordinate x = 0; x < width; ++x) {
+            const auto newX = x + originX - newOriginX;
+            const auto newY = y + originY - newOriginY;
+            newChunks[newY * newWidth + newX] = std::move(chunks[y * width + x]);
+        }
+    }
+
+    originX = newOriginX;
+    originY = newOriginY;
+    width = newWidth;
+    height = newHeight;
+    chunks = std::move(newChunks);
+}
+
+auto ChunkDirectory::Level::memoryUsage() const -> size_t {
+    const auto tileTables =
+            std::count_if(chunks.begin(), chunks.end(), [](const auto &chunk) { return bool(chunk.tiles); });
+    return chunks.capacity() * sizeof(Chunk) + tileTables * sizeof(Chunk::TileTable);
+}
+
+} // namespace map
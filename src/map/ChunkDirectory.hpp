@@ -0,0 +1,135 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CHUNK_DIRECTORY_HPP
+#define CHUNK_DIRECTORY_HPP
+
+#include "globals.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace map {
+
+// Spatial index from world positions to the maps covering them. The world is
+// cut into square chunks per level. A chunk covered by a single map stores just
+// that map's index; only chunks on map borders keep a per-tile table.
+class ChunkDirectory {
+public:
+    using MapIndex = uint16_t;
+    static constexpr MapIndex noMap = std::numeric_limits<MapIndex>::max();
+    static constexpr Coordinate chunkBits = 6;
+    static constexpr Coordinate chunkSize = 1 << chunkBits;
+
+    class Chunk {
+        using TileTable = std::array<MapIndex, chunkSize * chunkSize>;
+
+        MapIndex uniformMap = noMap;
+        std::unique_ptr<TileTable> tiles;
+        uint32_t persistentFields = 0;
+
+    public:
+        [[nodiscard]] inline auto mapAt(const position &pos) const -> MapIndex {
+            if (tiles) {
+                return (*tiles)[tileIndex(pos)];
+            }
+
+            return uniformMap;
+        }
+
+        [[nodiscard]] inline auto hasPersistentFields() const -> bool { return persistentFields > 0; }
+
+    private:
+        friend class ChunkDirectory;
+        void set(const position &pos, MapIndex map);
+        [[nodiscard]] static inline auto tileIndex(const position &pos) -> size_t {
+            constexpr Coordinate mask = chunkSize - 1;
+            return ((pos.y & mask) << chunkBits) | (pos.x & mask);
+        }
+    };
+
+    void clear();
+    void insert(Coordinate minX, Coordinate minY, Coordinate maxX, Coordinate maxY, Coordinate z, MapIndex map);
+    void addPersistentField(const position &pos);
+    void removePersistentField(const position &pos);
+
+    [[nodiscard]] inline auto chunkAt(const position &pos) const -> const Chunk * {
+        const auto levelIndex = pos.z - minLevel;
+
+        if (levelIndex < 0 || levelIndex >= static_cast<Coordinate>(levels.size())) {
+            return nullptr;
+        }
+
+        return levels[levelIndex].chunkAt(pos);
+    }
+
+    [[nodiscard]] inline auto mapAt(const position &pos) const -> MapIndex {
+        const auto *chunk = chunkAt(pos);
+
+        if (chunk == nullptr) {
+            return noMap;
+        }
+
+        return chunk->mapAt(pos);
+    }
+
+    [[nodiscard]] auto memoryUsage() const -> size_t;
+
+private:
+    class Level {
+        Coordinate originX = 0;
+        Coordinate originY = 0;
+        Coordinate width = 0;
+        Coordinate height = 0;
+        std::vector<Chunk> chunks;
+
+    public:
+        [[nodiscard]] inline auto chunkAt(const position &pos) const -> const Chunk * {
+            const auto x = toChunk(pos.x) - originX;
+            const auto y = toChunk(pos.y) - originY;
+
+            if (x < 0 || y < 0 || x >= width || y >= height) {
+                return nullptr;
+            }
+
+            return &chunks[y * width + x];
+        }
+
+        auto chunkAt(const position &pos) -> Chunk &;
+        void cover(Coordinate minX, Coordinate minY, Coordinate maxX, Coordinate maxY);
+        [[nodiscard]] auto memoryUsage() const -> size_t;
+    };
+
+    // shift world coordinates into the non-negative range before dividing
+    // so that chunks do not straddle zero
+    [[nodiscard]] static inline auto toChunk(Coordinate c) -> Coordinate {
+        return (c - std::numeric_limits<int16_t>::min()) >> chunkBits;
+    }
+
+    auto level(Coordinate z) -> Level &;
+
+    Coordinate minLevel = 0;
+    std::vector<Level> levels;
+};
+
+} // namespace map
+
+#endif
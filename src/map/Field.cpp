@@ -22,33 +22,69 @@
 #include "World.hpp"
 #include "data/Data.hpp"
 #include "db/ConnectionManager.hpp"
-#include "db/DeleteQuery.hpp"
-#include "db/InsertQuery.hpp"
 #include "db/Result.hpp"
-#include "db/SelectQuery.hpp"
-#include "db/UpdateQuery.hpp"
+#include "db/SchemaHelper.hpp"
 #include "globals.hpp"
 #include "netinterface/protocol/ServerCommands.hpp"
 #include "stream.hpp"
 
 #include <algorithm>
-#include <range/v3/all.hpp>
+#include <iterator>
+#include <optional>
 
 namespace map {
 
+namespace {
+const std::vector<Item> noItems;
+const Container::CONTAINERMAP noContainers;
+
+// the queries loading a persistent field, built on first use when the schema is known
+auto selectItemsStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_select_items", "SELECT mi_stack_pos, mi_item, mi_quality, mi_number, mi_wear FROM " +
+                                          SchemaHelper::getServerTable("map_items") +
+                                          " WHERE mi_x = $1 AND mi_y = $2 AND mi_z = $3 ORDER BY mi_stack_pos ASC"};
+    return statement;
+}
+
+auto selectItemDataStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_select_item_data",
+            "SELECT mid_stack_pos, mid_key, mid_value FROM " + SchemaHelper::getServerTable("map_item_data") +
+                    " WHERE mid_x = $1 AND mid_y = $2 AND mid_z = $3 ORDER BY mid_stack_pos ASC"};
+    return statement;
+}
+
+auto selectWarpStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_select_warp", "SELECT mw_target_x, mw_target_y, mw_target_z FROM " +
+                                         SchemaHelper::getServerTable("map_warps") +
+                                         " WHERE mw_start_x = $1 AND mw_start_y = $2 AND mw_start_z = $3"};
+    return statement;
+}
+} // namespace
+
+Field::Field(const position &here) : here{int16_t(here.x), int16_t(here.y), int16_t(here.z)} { updateFlags(); }
+
 Field::Field(uint16_t tile, uint16_t music, const position &here, bool persistent)
-        : tile(tile), music(music), here(here), persistent(persistent) {
+        : tile(tile), music(music), here{int16_t(here.x), int16_t(here.y), int16_t(here.z)}, persistent(persistent) {
     if (persistent) {
         loadDatabaseWarp();
         loadDatabaseItems();
     }
+
+    updateFlags();
 }
 
 void Field::setTileId(uint16_t id) {
     tile = id;
     updateDatabaseField();
     updateFlags();
-    updateFieldToPlayersInScreen(here);
+    invalidateStripes();
+    updateFieldToPlayersInScreen(getPosition());
 }
 
 auto Field::getTileCode() const -> uint16_t { return tile; }
@@ -70,33 +106,19 @@ auto Field::getSecondaryTileId() const -> uint16_t {
 void Field::setMusicId(uint16_t id) {
     music = id;
     updateDatabaseField();
-    updateFieldToPlayersInScreen(here);
+    invalidateStripes();
+    updateFieldToPlayersInScreen(getPosition());
 }
 
 auto Field::getMusicId() const -> uint16_t { return music; }
 
 auto Field::isTransparent() const -> bool { return getTileId() == TRANSPARENT; }
 
-auto Field::getMovementCost() const -> TYPE_OF_WALKINGCOST {
-    if (isWalkable()) {
-        auto tileId = getTileId();
-        const auto &primaryTile = Data::tiles()[tileId];
-        TYPE_OF_WALKINGCOST tileWalkingCost = primaryTile.walkingCost;
-
-        tileId = getSecondaryTileId();
-        const auto &secondaryTile = Data::tiles()[tileId];
-        uint16_t secondaryWalkingCost = secondaryTile.walkingCost;
-
-        if (secondaryWalkingCost < tileWalkingCost) {
-            tileWalkingCost = secondaryWalkingCost;
-        }
-
-        return tileWalkingCost;
-    }
-    return std::numeric_limits<TYPE_OF_WALKINGCOST>::max();
-}
+auto Field::getMovementCost() const -> TYPE_OF_WALKINGCOST { return movementCost; }
 
 auto Field::getStackItem(uint8_t pos) const -> ScriptItem {
+    const auto &items = getItemStack();
+
     if (pos < items.size()) {
         ScriptItem result(items.at(pos));
         result.type = ScriptItem::it_field;
@@ -107,13 +129,30 @@ auto Field::getStackItem(uint8_t pos) const -> ScriptItem {
     return {};
 }
 
-auto Field::getItemStack() const -> const std::vector<Item> & { return items; }
+auto Field::getItemStack() const -> const std::vector<Item> & {
+    if (contents) {
+        catchUpAgeing();
+        return contents->items;
+    }
+
+    return noItems;
+}
+
+auto Field::peekItemStack() const -> const std::vector<Item> & {
+    if (contents) {
+        return contents->items;
+    }
+
+    return noItems;
+}
 
 auto Field::addItemOnStack(const Item &item) -> bool {
-    if (items.size() < MAXITEMS) {
-        items.push_back(item);
+    if (itemCount() < MAXITEMS) {
+        editContents().items.push_back(item);
+        scheduleAgeing();
         updateDatabaseItems();
         updateFlags();
+        invalidateStripes();
 
         return true;
     }
@@ -130,23 +169,27 @@ auto Field::addItemOnStackIfWalkable(const Item &item) -> bool {
 }
 
 auto Field::takeItemFromStack(Item &item) -> bool {
-    if (items.empty()) {
+    if (itemCount() == 0) {
         return false;
     }
 
+    auto &items = editContents().items;
     item = items.back();
     items.pop_back();
+    releaseEmptyContents();
     updateDatabaseItems();
     updateFlags();
+    invalidateStripes();
 
     return true;
 }
 
 auto Field::increaseItemOnStack(int count, bool &erased) -> int {
-    if (items.empty()) {
+    if (itemCount() == 0) {
         return 0;
     }
 
+    auto &items = editContents().items;
     Item &item = items.back();
     count += item.getNumber();
     auto maxStack = item.getMaxStack();
@@ -157,6 +200,7 @@ auto Field::increaseItemOnStack(int count, bool &erased) -> int {
         erased = false;
     } else if (count <= 0) {
         items.pop_back();
+        releaseEmptyContents();
         updateFlags();
         erased = true;
     } else {
@@ -166,15 +210,16 @@ auto Field::increaseItemOnStack(int count, bool &erased) -> int {
     }
 
     updateDatabaseItems();
+    invalidateStripes();
     return count;
 }
 
 auto Field::swapItemOnStack(TYPE_OF_ITEM_ID newId, uint16_t newQuality) -> bool {
-    if (items.empty()) {
+    if (itemCount() == 0) {
         return false;
     }
 
-    Item &item = items.back();
+    Item &item = editContents().items.back();
     item.setId(newId);
 
     if (newQuality > 0) {
@@ -187,27 +232,36 @@ auto Field::swapItemOnStack(TYPE_OF_ITEM_ID newId, uint16_t newQuality) -> bool
         item.setWear(itemStruct.AgeingSpeed);
     }
 
+    scheduleAgeing();
     updateDatabaseItems();
     updateFlags();
+    invalidateStripes();
     return true;
 }
 
 auto Field::viewItemOnStack(Item &item) const -> bool {
-    if (items.empty()) {
+    if (itemCount() == 0) {
         return false;
     }
 
-    item = items.back();
+    item = getItemStack().back();
 
     return true;
 }
 
-auto Field::itemCount() const -> MAXCOUNTTYPE { return items.size(); }
+auto Field::itemCount() const -> MAXCOUNTTYPE {
+    if (contents) {
+        return contents->items.size();
+    }
+
+    return 0;
+}
 
 auto Field::addContainerOnStackIfWalkable(Item item, Container *container) -> bool {
     if (isWalkable()) {
-        if (items.size() < MAXITEMS - 1) {
+        if (itemCount() < MAXITEMS - 1) {
             if (item.isContainer()) {
+                auto &containers = editContents().containers;
                 MAXCOUNTTYPE count = 0;
 
                 auto iterat = containers.find(count);
@@ -231,6 +285,7 @@ auto Field::addContainerOnStackIfWalkable(Item item, Container *container) -> bo
 
                 if (!addItemOnStackIfWalkable(item)) {
                     containers.erase(count);
+                    releaseEmptyContents();
                 } else {
                     return true;
                 }
@@ -243,6 +298,7 @@ auto Field::addContainerOnStackIfWalkable(Item item, Container *container) -> bo
 
 auto Field::addContainerOnStack(Item item, Container *container) -> bool {
     if (item.isContainer()) {
+        auto &containers = editContents().containers;
         MAXCOUNTTYPE count = 0;
 
         auto iterat = containers.find(count);
@@ -266,6 +322,7 @@ auto Field::addContainerOnStack(Item item, Container *container) -> bool {
 
         if (!addItemOnStack(item)) {
             containers.erase(count);
+            releaseEmptyContents();
         } else {
             return true;
         }
@@ -274,12 +331,48 @@ auto Field::addContainerOnStack(Item item, Container *container) -> bool {
     return false;
 }
 
+auto Field::getContainers() const -> const Container::CONTAINERMAP & {
+    if (contents) {
+        catchUpAgeing();
+        return contents->containers;
+    }
+
+    return noContainers;
+}
+
+auto Field::getContainer(TYPE_OF_CONTAINERSLOTS slot) const -> Container * {
+    const auto &containers = getContainers();
+    const auto it = containers.find(slot);
+
+    if (it != containers.end()) {
+        return it->second;
+    }
+
+    return nullptr;
+}
+
+auto Field::takeContainer(TYPE_OF_CONTAINERSLOTS slot) -> Container * {
+    if (!contents) {
+        return nullptr;
+    }
+
+    auto node = editContents().containers.extract(slot);
+    releaseEmptyContents();
+
+    if (node.empty()) {
+        return nullptr;
+    }
+
+    return node.mapped();
+}
+
 void Field::save(std::ofstream &mapStream, std::ofstream &itemStream, std::ofstream &warpStream,
                  std::ofstream &containerStream) const {
     writeToStream(mapStream, tile);
     writeToStream(mapStream, music);
     writeToStream(mapStream, flags);
 
+    const auto &items = getItemStack();
     const uint8_t itemsSize = items.size();
     writeToStream(itemStream, itemsSize);
 
@@ -290,12 +383,13 @@ void Field::save(std::ofstream &mapStream, std::ofstream &itemStream, std::ofstr
     if (isWarp()) {
         const char b = 1;
         writeToStream(warpStream, b);
-        writeToStream(warpStream, warptarget);
+        writeToStream(warpStream, contents->warptarget);
     } else {
         const char b = 0;
         writeToStream(warpStream, b);
     }
 
+    const auto &containers = getContainers();
     const uint8_t containersSize = containers.size();
     writeToStream(containerStream, containersSize);
 
@@ -308,7 +402,7 @@ void Field::save(std::ofstream &mapStream, std::ofstream &itemStream, std::ofstr
 auto Field::getExportItems() const -> std::vector<Item> {
     std::vector<Item> result;
 
-    for (const auto &item : items) {
+    for (const auto &item : getItemStack()) {
         if (item.isPermanent()) {
             result.push_back(item);
         } else {
@@ -332,17 +426,24 @@ void Field::load(std::ifstream &mapStream, std::ifstream &itemStream, std::ifstr
     readFromStream(mapStream, music);
     readFromStream(mapStream, flags);
 
-    unsetBits(FLAG_NPCONFIELD | FLAG_MONSTERONFIELD | FLAG_PLAYERONFIELD);
+    unsetBits(FLAG_NPCONFIELD | FLAG_MONSTERONFIELD | FLAG_PLAYERONFIELD | FLAG_WARPFIELD);
+
+    if (contents) {
+        for (auto &container : contents->containers) {
+            delete container.second;
+            container.second = nullptr;
+        }
+
+        contents.reset();
+    }
 
     MAXCOUNTTYPE size = 0;
     readFromStream(itemStream, size);
 
-    items.clear();
-
     for (int i = 0; i < size; ++i) {
         Item item;
         item.load(itemStream);
-        items.push_back(item);
+        editContents().items.push_back(item);
     }
 
     char isWarp = 0;
@@ -356,30 +457,24 @@ void Field::load(std::ifstream &mapStream, std::ifstream &itemStream, std::ifstr
 
     readFromStream(containerStream, size);
 
-    for (auto &container : containers) {
-        delete container.second;
-        container.second = nullptr;
-    }
-
-    containers.clear();
-
     for (int i = 0; i < size; ++i) {
         MAXCOUNTTYPE key = 0;
         readFromStream(containerStream, key);
 
-        for (const auto &item : items) {
+        for (const auto &item : getItemStack()) {
             if (item.isContainer() && item.getNumber() == key) {
                 auto *container = new Container(item.getId());
                 container->Load(containerStream);
-                containers.insert(decltype(containers)::value_type(key, container));
+                contents->containers.insert(Container::CONTAINERMAP::value_type(key, container));
             }
         }
     }
 
+    scheduleAgeing();
     updateFlags();
 }
 
-auto Field::getPosition() const -> const position & { return here; }
+auto Field::getPosition() const -> position { return {here.x, here.y, here.z}; }
 
 void Field::makePersistent() {
     if (!isPersistent()) {
@@ -399,66 +494,168 @@ void Field::removePersistence() {
 
 auto Field::isPersistent() const -> bool { return persistent; }
 
-void Field::age() {
-    for (const auto &container : containers) {
-        if (container.second != nullptr) {
-            container.second->doAge();
-        }
-    }
+auto Field::isDueForAgeing(AgeingCycle cycle) const -> bool { return contents && contents->nextAgeing == cycle; }
 
-    if (!items.empty()) {
-        auto it = items.begin();
-        bool refreshItems = false;
+auto Field::age() -> size_t {
+    if (!contents) {
+        return 0;
+    }
 
-        while (it < items.end()) {
-            Item &item = *it;
+    catchUpAgeing();
+    contents->nextAgeing = 0;
 
-            if (!item.survivesAgeing()) {
-                const auto &itemStruct = Data::items()[item.getId()];
-                refreshItems = true;
+    auto &containers = contents->containers;
+    auto &items = contents->items;
+    size_t rottedItems = 0;
+    auto it = items.begin();
+    bool refreshItems = false;
 
-                if (itemStruct.isValid() && item.getId() != itemStruct.ObjectAfterRot) {
-                    item.setId(itemStruct.ObjectAfterRot);
+    while (it < items.end()) {
+        Item &item = *it;
 
-                    const auto &afterRotItemStruct = Data::items()[itemStruct.ObjectAfterRot];
+        if (item.isPermanent()) {
+            ++it;
+            continue;
+        }
 
-                    if (afterRotItemStruct.isValid()) {
-                        item.setWear(afterRotItemStruct.AgeingSpeed);
-                    }
+        if (item.getWear() == 0) {
+            const auto &itemStruct = Data::items()[item.getId()];
+            refreshItems = true;
+            ++rottedItems;
 
-                    ++it;
-                } else {
-                    if (item.isContainer()) {
-                        auto iterat = containers.find(item.getNumber());
+            if (itemStruct.isValid() && item.getId() != itemStruct.ObjectAfterRot) {
+                item.setId(itemStruct.ObjectAfterRot);
 
-                        if (iterat != containers.end()) {
-                            delete iterat->second;
-                            containers.erase(iterat);
-                        }
-                    }
+                const auto &afterRotItemStruct = Data::items()[itemStruct.ObjectAfterRot];
 
-                    it = items.erase(it);
+                if (afterRotItemStruct.isValid()) {
+                    item.setWear(afterRotItemStruct.AgeingSpeed);
                 }
-            } else {
+
                 ++it;
+            } else {
+                if (item.isContainer()) {
+                    auto iterat = containers.find(item.getNumber());
+
+                    if (iterat != containers.end()) {
+                        delete iterat->second;
+                        containers.erase(iterat);
+                    }
+                }
+
+                it = items.erase(it);
             }
+        } else {
+            ++it;
+        }
+    }
+
+    if (refreshItems) {
+        releaseEmptyContents();
+        invalidateStripes();
+        const auto pos = getPosition();
+        std::vector<Player *> playersinview = World::get()->Players.findAllCharactersInScreen(pos);
+
+        for (const auto &player : playersinview) {
+            ServerCommandPointer cmd = std::make_shared<ItemUpdate_TC>(pos, getItemStack());
+            player->Connection->addCommand(cmd);
         }
 
-        if (refreshItems) {
-            std::vector<Player *> playersinview = World::get()->Players.findAllCharactersInScreen(here);
+        updateDatabaseItems();
+        updateFlags();
+    }
+
+    scheduleAgeing();
+    return rottedItems;
+}
+
+auto Field::editContents() -> Contents & {
+    if (contents) {
+        catchUpAgeing();
+    } else {
+        contents = std::make_unique<Contents>();
+        contents->agedUntil = World::get()->currentAgeingCycle();
+    }
+
+    return *contents;
+}
+
+void Field::releaseEmptyContents() {
+    if (contents && contents->items.empty() && contents->containers.empty() && !isWarp()) {
+        contents.reset();
+    }
+}
+
+// Wear is reduced lazily for all cycles since the field was last looked at, so
+// that fields only need to be visited when the next of their items rots.
+void Field::catchUpAgeing() const {
+    if (!contents) {
+        return;
+    }
 
-            for (const auto &player : playersinview) {
-                ServerCommandPointer cmd = std::make_shared<ItemUpdate_TC>(here, getItemStack());
-                player->Connection->addCommand(cmd);
+    const auto now = World::get()->currentAgeingCycle();
+
+    if (contents->agedUntil >= now) {
+        return;
+    }
+
+    const auto elapsed = now - contents->agedUntil;
+    contents->agedUntil = now;
+
+    for (auto &item : contents->items) {
+        if (!item.isPermanent()) {
+            item.setWear(item.getWear() - std::min<AgeingCycle>(item.getWear(), elapsed));
+        }
+    }
+
+    for (const auto &container : contents->containers) {
+        if (container.second != nullptr) {
+            for (AgeingCycle cycle = 0; cycle < elapsed; ++cycle) {
+                container.second->doAge();
             }
+        }
+    }
+}
 
-            updateDatabaseItems();
+void Field::scheduleAgeing() {
+    if (!contents) {
+        return;
+    }
+
+    catchUpAgeing();
+    const auto now = contents->agedUntil;
+    AgeingCycle due = 0;
+
+    if (!contents->containers.empty()) {
+        // container contents are not tracked individually
+        due = now + 1;
+    } else {
+        for (const auto &item : contents->items) {
+            if (!item.isPermanent()) {
+                const AgeingCycle itemDue = now + std::max<AgeingCycle>(item.getWear(), 1);
+
+                if (due == 0 || itemDue < due) {
+                    due = itemDue;
+                }
+            }
         }
     }
 
-    updateFlags();
+    if (due == 0) {
+        return;
+    }
+
+    // an entry due in the current cycle is still pending, an older one is stale
+    if (contents->nextAgeing != 0 && contents->nextAgeing >= now && contents->nextAgeing <= due) {
+        return;
+    }
+
+    contents->nextAgeing = due;
+    World::get()->scheduleAgeing(getPosition(), due);
 }
 
+void Field::invalidateStripes() const { World::get()->stripeCache.invalidate(getPosition()); }
+
 void Field::updateFlags() {
     unsetBits(FLAG_SPECIALITEM | FLAG_BLOCKPATH | FLAG_MAKEPASSABLE);
 
@@ -467,7 +664,7 @@ void Field::updateFlags() {
         setBits(tt.flags & FLAG_BLOCKPATH);
     }
 
-    for (const auto &item : items) {
+    for (const auto &item : getItemStack()) {
         if (Data::tilesModItems().exists(item.getId())) {
             const auto &mod = Data::tilesModItems()[item.getId()];
             setBits(mod.Modificator & FLAG_SPECIALITEM);
@@ -481,6 +678,22 @@ void Field::updateFlags() {
             }
         }
     }
+
+    // cached, since path finding asks for it far more often than fields change, and recomputed
+    // for all fields by WorldMap::refreshFlags when the tile definitions are reloaded
+    movementCost = std::numeric_limits<TYPE_OF_WALKINGCOST>::max();
+
+    if (isWalkable()) {
+        const auto walkingCost = [](uint16_t tileId) -> TYPE_OF_WALKINGCOST {
+            if (Data::tiles().exists(tileId)) {
+                return Data::tiles()[tileId].walkingCost;
+            }
+
+            return {};
+        };
+
+        movementCost = std::min(walkingCost(getTileId()), walkingCost(getSecondaryTileId()));
+    }
 }
 
 auto Field::hasMonster() const -> bool { return anyBitSet(FLAG_MONSTERONFIELD); }
@@ -504,17 +717,24 @@ void Field::removePlayer() { unsetBits(FLAG_PLAYERONFIELD); }
 auto Field::isWarp() const -> bool { return anyBitSet(FLAG_WARPFIELD); }
 
 void Field::setWarp(const position &pos) {
-    warptarget = pos;
+    editContents().warptarget = pos;
     setBits(FLAG_WARPFIELD);
     updateDatabaseWarp();
 }
 
 void Field::removeWarp() {
     unsetBits(FLAG_WARPFIELD);
+    releaseEmptyContents();
     updateDatabaseWarp();
 }
 
-void Field::getWarp(position &pos) const { pos = warptarget; }
+void Field::getWarp(position &pos) const {
+    if (isWarp()) {
+        pos = contents->warptarget;
+    } else {
+        pos = position{};
+    }
+}
 
 auto Field::hasSpecialItem() const -> bool { return anyBitSet(FLAG_SPECIALITEM); }
 
@@ -539,33 +759,7 @@ void Field::insertIntoDatabase() const noexcept {
         return;
     }
 
-    using namespace Database;
-    auto connection = ConnectionManager::getInstance().getConnection();
-
-    try {
-        connection->beginTransaction();
-
-        InsertQuery fieldQuery(connection);
-        const auto xColumn = fieldQuery.addColumn("mt_x");
-        const auto yColumn = fieldQuery.addColumn("mt_y");
-        const auto zColumn = fieldQuery.addColumn("mt_z");
-        const auto tileColumn = fieldQuery.addColumn("mt_tile");
-        const auto musicColumn = fieldQuery.addColumn("mt_music");
-        fieldQuery.addServerTable("map_tiles");
-
-        fieldQuery.addValue<int16_t>(xColumn, here.x);
-        fieldQuery.addValue<int16_t>(yColumn, here.y);
-        fieldQuery.addValue<int16_t>(zColumn, here.z);
-        fieldQuery.addValue<uint16_t>(tileColumn, tile);
-        fieldQuery.addValue<uint16_t>(musicColumn, music);
-
-        fieldQuery.execute();
-
-        connection->commitTransaction();
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::World) << "Error while inserting field into database: " << e.what() << Log::end;
-        connection->rollbackTransaction();
-    }
+    World::get()->persistenceQueue.insertField(getPosition(), tile, music);
 }
 
 void Field::removeFromDatabase() const noexcept {
@@ -573,24 +767,7 @@ void Field::removeFromDatabase() const noexcept {
         return;
     }
 
-    using namespace Database;
-    auto connection = ConnectionManager::getInstance().getConnection();
-
-    try {
-        connection->beginTransaction();
-
-        DeleteQuery fieldQuery(connection);
-        fieldQuery.addEqualCondition<int16_t>("map_tiles", "mt_x", here.x);
-        fieldQuery.addEqualCondition<int16_t>("map_tiles", "mt_y", here.y);
-        fieldQuery.addEqualCondition<int16_t>("map_tiles", "mt_z", here.z);
-        fieldQuery.addServerTable("map_tiles");
-        fieldQuery.execute();
-
-        connection->commitTransaction();
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::World) << "Error while deleting field from database: " << e.what() << Log::end;
-        connection->rollbackTransaction();
-    }
+    World::get()->persistenceQueue.removeField(getPosition());
 }
 
 void Field::updateDatabaseField() const noexcept {
@@ -598,26 +775,7 @@ void Field::updateDatabaseField() const noexcept {
         return;
     }
 
-    using namespace Database;
-    auto connection = ConnectionManager::getInstance().getConnection();
-
-    try {
-        connection->beginTransaction();
-
-        UpdateQuery fieldQuery(connection);
-        fieldQuery.addAssignColumn<uint16_t>("mt_tile", tile);
-        fieldQuery.addAssignColumn<uint16_t>("mt_music", music);
-        fieldQuery.addEqualCondition<int16_t>("map_tiles", "mt_x", here.x);
-        fieldQuery.addEqualCondition<int16_t>("map_tiles", "mt_y", here.y);
-        fieldQuery.addEqualCondition<int16_t>("map_tiles", "mt_z", here.z);
-        fieldQuery.addServerTable("map_tiles");
-        fieldQuery.execute();
-
-        connection->commitTransaction();
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::World) << "Error while updating field in database: " << e.what() << Log::end;
-        connection->rollbackTransaction();
-    }
+    World::get()->persistenceQueue.updateField(getPosition(), tile, music);
 }
 
 void Field::updateDatabaseItems() const noexcept {
@@ -625,77 +783,11 @@ void Field::updateDatabaseItems() const noexcept {
         return;
     }
 
-    using namespace Database;
-    auto connection = ConnectionManager::getInstance().getConnection();
-
-    try {
-        connection->beginTransaction();
-
-        {
-            DeleteQuery itemQuery(connection);
-            itemQuery.addEqualCondition<int16_t>("map_items", "mi_x", here.x);
-            itemQuery.addEqualCondition<int16_t>("map_items", "mi_y", here.y);
-            itemQuery.addEqualCondition<int16_t>("map_items", "mi_z", here.z);
-            itemQuery.addServerTable("map_items");
-            itemQuery.execute();
-        }
-
-        if (itemCount() > 0) {
-            InsertQuery itemQuery(connection);
-            const auto xColumn = itemQuery.addColumn("mi_x");
-            const auto yColumn = itemQuery.addColumn("mi_y");
-            const auto zColumn = itemQuery.addColumn("mi_z");
-            const auto stackPosColumn = itemQuery.addColumn("mi_stack_pos");
-            const auto itemColumn = itemQuery.addColumn("mi_item");
-            const auto qualityColumn = itemQuery.addColumn("mi_quality");
-            const auto numberColumn = itemQuery.addColumn("mi_number");
-            const auto wearColumn = itemQuery.addColumn("mi_wear");
-            itemQuery.addServerTable("map_items");
-
-            InsertQuery dataQuery(connection);
-            const auto xDataColumn = dataQuery.addColumn("mid_x");
-            const auto yDataColumn = dataQuery.addColumn("mid_y");
-            const auto zDataColumn = dataQuery.addColumn("mid_z");
-            const auto stackPosDataColumn = dataQuery.addColumn("mid_stack_pos");
-            const auto keyDataColumn = dataQuery.addColumn("mid_key");
-            const auto valueDataColumn = dataQuery.addColumn("mid_value");
-            dataQuery.addServerTable("map_item_data");
-
-            uint16_t stackPos = 0;
-            auto nonMovable = ranges::view::filter([](const Item &item) { return not item.isMovable(); });
-
-            ranges::for_each(items | nonMovable, [&](const auto &item) {
-                itemQuery.addValue<int16_t>(xColumn, here.x);
-                itemQuery.addValue<int16_t>(yColumn, here.y);
-                itemQuery.addValue<int16_t>(zColumn, here.z);
-
-                itemQuery.addValue<uint16_t>(stackPosColumn, stackPos);
-                itemQuery.addValue<TYPE_OF_ITEM_ID>(itemColumn, item.getId());
-                itemQuery.addValue<uint16_t>(qualityColumn, item.getQuality());
-                itemQuery.addValue<uint16_t>(numberColumn, item.getNumber());
-                itemQuery.addValue<uint16_t>(wearColumn, item.getWear());
-
-                std::for_each(item.getDataBegin(), item.getDataEnd(), [&](const auto &data) {
-                    dataQuery.addValue<int16_t>(xDataColumn, here.x);
-                    dataQuery.addValue<int16_t>(yDataColumn, here.y);
-                    dataQuery.addValue<int16_t>(zDataColumn, here.z);
-                    dataQuery.addValue<uint16_t>(stackPosDataColumn, stackPos);
-                    dataQuery.addValue<std::string>(keyDataColumn, data.first);
-                    dataQuery.addValue<std::string>(valueDataColumn, data.second);
-                });
-
-                ++stackPos;
-            });
-
-            itemQuery.execute();
-            dataQuery.execute();
-        }
-
-        connection->commitTransaction();
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::World) << "Error while updating items in database: " << e.what() << Log::end;
-        connection->rollbackTransaction();
-    }
+    const auto &stack = getItemStack();
+    std::vector<Item> items;
+    std::copy_if(stack.begin(), stack.end(), std::back_inserter(items),
+                 [](const Item &item) { return not item.isMovable(); });
+    World::get()->persistenceQueue.updateItems(getPosition(), std::move(items));
 }
 
 void Field::updateDatabaseWarp() const noexcept {
@@ -703,66 +795,27 @@ void Field::updateDatabaseWarp() const noexcept {
         return;
     }
 
-    using namespace Database;
-    auto connection = ConnectionManager::getInstance().getConnection();
+    std::optional<position> warptarget;
 
-    try {
-        connection->beginTransaction();
-
-        {
-            DeleteQuery warpQuery(connection);
-            warpQuery.addEqualCondition<int16_t>("map_warps", "mw_start_x", here.x);
-            warpQuery.addEqualCondition<int16_t>("map_warps", "mw_start_y", here.y);
-            warpQuery.addEqualCondition<int16_t>("map_warps", "mw_start_z", here.z);
-            warpQuery.addServerTable("map_warps");
-            warpQuery.execute();
-        }
-
-        if (isWarp()) {
-            InsertQuery warpQuery(connection);
-            const auto xStartColumn = warpQuery.addColumn("mw_start_x");
-            const auto yStartColumn = warpQuery.addColumn("mw_start_y");
-            const auto zStartColumn = warpQuery.addColumn("mw_start_z");
-            const auto xTargetColumn = warpQuery.addColumn("mw_target_x");
-            const auto yTargetColumn = warpQuery.addColumn("mw_target_y");
-            const auto zTargetColumn = warpQuery.addColumn("mw_target_z");
-
-            warpQuery.addServerTable("map_warps");
-
-            warpQuery.addValue<int16_t>(xStartColumn, here.x);
-            warpQuery.addValue<int16_t>(yStartColumn, here.y);
-            warpQuery.addValue<int16_t>(zStartColumn, here.z);
-            warpQuery.addValue<int16_t>(xTargetColumn, warptarget.x);
-            warpQuery.addValue<int16_t>(yTargetColumn, warptarget.y);
-            warpQuery.addValue<int16_t>(zTargetColumn, warptarget.z);
-
-            warpQuery.execute();
-        }
-
-        connection->commitTransaction();
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::World) << "Error while updating warp in database: " << e.what() << Log::end;
-        connection->rollbackTransaction();
+    if (isWarp()) {
+        warptarget = contents->warptarget;
     }
+
+    World::get()->persistenceQueue.updateWarp(getPosition(), warptarget);
 }
 
 void Field::loadDatabaseWarp() noexcept {
     try {
         using namespace Database;
 
-        SelectQuery query;
-        query.addColumn("map_warps", "mw_target_x");
-        query.addColumn("map_warps", "mw_target_y");
-        query.addColumn("map_warps", "mw_target_z");
-        query.addEqualCondition<int16_t>("map_warps", "mw_start_x", here.x);
-        query.addEqualCondition<int16_t>("map_warps", "mw_start_y", here.y);
-        query.addEqualCondition<int16_t>("map_warps", "mw_start_z", here.z);
-        query.addServerTable("map_warps");
-
-        auto result = query.execute();
+        auto connection = ConnectionManager::getInstance().getConnection();
+        connection->beginTransaction();
+        auto result = connection->query(selectWarpStatement(), here.x, here.y, here.z);
+        connection->commitTransaction();
 
         if (not result.empty()) {
             const auto &row = result.front();
+            auto &warptarget = editContents().warptarget;
             warptarget.x = row["mw_target_x"].as<int16_t>();
             warptarget.y = row["mw_target_y"].as<int16_t>();
             warptarget.z = row["mw_target_z"].as<int16_t>();
@@ -777,30 +830,12 @@ void Field::loadDatabaseItems() noexcept {
     try {
         using namespace Database;
 
-        SelectQuery query;
-        query.addColumn("map_items", "mi_stack_pos");
-        query.addColumn("map_items", "mi_item");
-        query.addColumn("map_items", "mi_quality");
-        query.addColumn("map_items", "mi_number");
-        query.addColumn("map_items", "mi_wear");
-        query.addEqualCondition<int16_t>("map_items", "mi_x", here.x);
-        query.addEqualCondition<int16_t>("map_items", "mi_y", here.y);
-        query.addEqualCondition<int16_t>("map_items", "mi_z", here.z);
-        query.addOrderBy("map_items", "mi_stack_pos", SelectQuery::ASC);
-        query.addServerTable("map_items");
-
-        SelectQuery dataQuery;
-        dataQuery.addColumn("map_item_data", "mid_stack_pos");
-        dataQuery.addColumn("map_item_data", "mid_key");
-        dataQuery.addColumn("map_item_data", "mid_value");
-        dataQuery.addEqualCondition<int16_t>("map_item_data", "mid_x", here.x);
-        dataQuery.addEqualCondition<int16_t>("map_item_data", "mid_y", here.y);
-        dataQuery.addEqualCondition<int16_t>("map_item_data", "mid_z", here.z);
-        dataQuery.addOrderBy("map_item_data", "mid_stack_pos", SelectQuery::ASC);
-        dataQuery.addServerTable("map_item_data");
-
-        auto result = query.execute();
-        auto dataResult = dataQuery.execute();
+        auto connection = ConnectionManager::getInstance().getConnection();
+        connection->beginTransaction();
+        auto result = connection->query(selectItemsStatement(), here.x, here.y, here.z);
+        auto dataResult = connection->query(selectItemDataStatement(), here.x, here.y, here.z);
+        connection->commitTransaction();
+
         auto dataIterator = dataResult.cbegin();
         auto dataEnd = dataResult.cend();
 
@@ -811,6 +846,7 @@ void Field::loadDatabaseItems() noexcept {
             auto number = row["mi_number"].as<uint16_t>();
             auto wear = row["mi_wear"].as<uint16_t>();
 
+            auto &items = editContents().items;
             items.emplace_back(item, number, wear, quality);
 
             while (dataIterator < dataEnd && (*dataIterator)["mid_stack_pos"].as<uint16_t>() == stackPos) {
@@ -820,6 +856,7 @@ void Field::loadDatabaseItems() noexcept {
             }
         }
 
+        scheduleAgeing();
         updateFlags();
     } catch (std::exception &e) {
         Logger::error(LogFacility::World) << "Error while loading items from database: " << e.what() << Log::end;
@@ -23,7 +23,9 @@
 #include "Item.hpp"
 #include "constants.hpp"
 #include "globals.hpp"
+#include "map/AgeingSchedule.hpp"
 
+#include <memory>
 #include <vector>
 
 namespace map {
@@ -37,18 +39,39 @@ private:
     static constexpr uint16_t secondaryTileBitMask = 0b0000'0011'1110'0000;
     static constexpr uint16_t primaryTileBitMask = 0b0000'0000'0001'1111;
 
+    // Only few fields hold items, containers or warps. These are kept apart from
+    // the data needed for walking, so that a field stays small and path finding
+    // or visibility scans touch just a few bytes per field.
+    struct Contents {
+        std::vector<Item> items;
+        Container::CONTAINERMAP containers;
+        position warptarget{};
+        // wear of the items is accounted for up to this ageing cycle
+        AgeingCycle agedUntil = 0;
+        // cycle the field is scheduled to be aged in, 0 if it is not scheduled
+        AgeingCycle nextAgeing = 0;
+    };
+
+    struct Location {
+        int16_t x = 0;
+        int16_t y = 0;
+        int16_t z = 0;
+    };
+
     uint16_t tile = 0;
     uint16_t music = 0;
+    TYPE_OF_WALKINGCOST movementCost = 0;
+    Location here;
     uint8_t flags = 0;
-    position here;
-    position warptarget{};
-    std::vector<Item> items;
     bool persistent = false;
+    // The wear of the items is brought up to date lazily, also by const getters
+    // like getItemStack, so that callers always see the current items. This
+    // changes the contents without making them look any different, but means the
+    // const getters must not be used by several threads at once, see peekItemStack.
+    mutable std::unique_ptr<Contents> contents;
 
 public:
-    Container::CONTAINERMAP containers;
-
-    explicit Field(const position &here) : here(here){};
+    explicit Field(const position &here);
     Field(uint16_t tile, uint16_t music, const position &here, bool persistent = false);
     Field(const Field &) = delete;
     auto operator=(const Field &) -> Field & = delete;
@@ -78,12 +101,20 @@ public:
     auto viewItemOnStack(Item &item) const -> bool;
     [[nodiscard]] auto getStackItem(uint8_t pos) const -> ScriptItem;
     [[nodiscard]] auto getItemStack() const -> const std::vector<Item> &;
+    // like getItemStack, but leaves the wear of the items behind, so that the
+    // field is not changed and several threads may read it at once
+    [[nodiscard]] auto peekItemStack() const -> const std::vector<Item> &;
     [[nodiscard]] auto itemCount() const -> MAXCOUNTTYPE;
 
     auto addContainerOnStackIfWalkable(Item item, Container *container) -> bool;
     auto addContainerOnStack(Item item, Container *container) -> bool;
+    [[nodiscard]] auto getContainers() const -> const Container::CONTAINERMAP &;
+    [[nodiscard]] auto getContainer(TYPE_OF_CONTAINERSLOTS slot) const -> Container *;
+    auto takeContainer(TYPE_OF_CONTAINERSLOTS slot) -> Container *;
 
-    void age();
+    [[nodiscard]] auto isDueForAgeing(AgeingCycle cycle) const -> bool;
+    // rots the items whose wear ran out, returns the number of rotted items
+    auto age() -> size_t;
 
     void setPlayer();
     void setNPC();
@@ -108,14 +139,22 @@ public:
     void load(std::ifstream &mapStream, std::ifstream &itemStream, std::ifstream &warpStream,
               std::ifstream &containerStream);
 
-    [[nodiscard]] auto getPosition() const -> const position &;
+    [[nodiscard]] auto getPosition() const -> position;
 
     void makePersistent();
     void removePersistence();
     [[nodiscard]] auto isPersistent() const -> bool;
 
-private:
+    // derives the flags and the movement cost from the tile and item definitions, needed after these were reloaded
     void updateFlags();
+
+private:
+    auto editContents() -> Contents &;
+    void releaseEmptyContents();
+    void catchUpAgeing() const;
+    void scheduleAgeing();
+    // drops cached map stripes showing this field after it changed
+    void invalidateStripes() const;
     inline void setBits(uint8_t /*bits*/);
     inline void unsetBits(uint8_t /*bits*/);
     [[nodiscard]] inline auto anyBitSet(uint8_t /*bits*/) const -> bool;
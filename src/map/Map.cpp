@@ -33,30 +33,28 @@ Map::Map(std::string name, position origin, uint16_t width, uint16_t height)
         : origin(origin), width(width), height(height),
 
           name(std::move(name)) {
-    for (auto x = origin.x; x < origin.x + width; ++x) {
-        std::vector<Field> column;
+    fields.reserve(size_t(width) * height);
 
-        for (auto y = origin.y; y < origin.y + height; ++y) {
-            column.emplace_back(position(x, y, origin.z));
+    for (auto y = origin.y; y < origin.y + height; ++y) {
+        for (auto x = origin.x; x < origin.x + width; ++x) {
+            fields.emplace_back(position(x, y, origin.z));
         }
-
-        fields.push_back(std::move(column));
     }
 }
 
 Map::Map(std::string name, position origin, uint16_t width, uint16_t height, uint16_t tile)
         : Map(std::move(name), origin, width, height) {
-    for (auto &column : fields) {
-        for (auto &field : column) {
-            field.setTileId(tile);
-        }
+    for (auto &field : fields) {
+        field.setTileId(tile);
     }
 }
 
-auto Map::at(int16_t x, int16_t y) -> Field & { return fields[convertWorldXToMap(x)][convertWorldYToMap(y)]; }
+auto Map::at(int16_t x, int16_t y) -> Field & {
+    return fields[fieldIndex(convertWorldXToMap(x), convertWorldYToMap(y))];
+}
 
 auto Map::at(int16_t x, int16_t y) const -> const Field & {
-    return fields[convertWorldXToMap(x)][convertWorldYToMap(y)];
+    return fields[fieldIndex(convertWorldXToMap(x), convertWorldYToMap(y))];
 }
 
 auto Map::at(const MapPosition &pos) -> Field & { return at(pos.x, pos.y); }
@@ -76,9 +74,10 @@ void Map::save(const std::string &name) const {
         writeToStream(map, height);
         writeToStream(map, origin);
 
-        for (const auto &column : fields) {
-            for (const auto &field : column) {
-                field.save(map, items, warps, containers);
+        // the file format stores the fields column by column
+        for (uint16_t x = 0; x < width; ++x) {
+            for (uint16_t y = 0; y < height; ++y) {
+                fields[fieldIndex(x, y)].save(map, items, warps, containers);
             }
         }
     } else {
@@ -155,7 +154,7 @@ auto Map::importFields(const std::string &importDir, const std::string &mapName)
                 stringToNumber(fieldMatch[musicPosition].str(), music);
 
                 if (success) {
-                    auto &field = fields[x][y];
+                    auto &field = fields[fieldIndex(x, y)];
 
                     if ((field.getTileCode() != 0) || (field.getMusicId() != 0)) {
                         Logger::warn(LogFacility::Script)
@@ -294,7 +293,7 @@ auto Map::importItems(const std::string &importDir, const std::string &mapName)
                 }
 
                 if (success) {
-                    auto &field = fields[x][y];
+                    auto &field = fields[fieldIndex(x, y)];
 
                     if (item.isContainer()) {
                         field.addContainerOnStack(item, nullptr);
@@ -374,7 +373,7 @@ auto Map::importWarps(const std::string &importDir, const std::string &mapName)
                 stringToNumber(warpMatch[targetZPosition].str(), target.z);
 
                 if (success) {
-                    auto &field = fields[x][y];
+                    auto &field = fields[fieldIndex(x, y)];
 
                     if (field.isWarp()) {
                         Logger::warn(LogFacility::Script)
@@ -417,9 +416,9 @@ auto Map::load(const std::string &name) -> bool {
         readFromStream(map, origin);
 
         if (newWidth == width && newHeight == height) {
-            for (auto &column : fields) {
-                for (auto &field : column) {
-                    field.load(map, items, warps, containers);
+            for (uint16_t x = 0; x < width; ++x) {
+                for (uint16_t y = 0; y < height; ++y) {
+                    fields[fieldIndex(x, y)].load(map, items, warps, containers);
                 }
             }
 
@@ -432,14 +431,6 @@ auto Map::load(const std::string &name) -> bool {
     return false;
 }
 
-void Map::age() {
-    for (auto &row : fields) {
-        for (auto &field : row) {
-            field.age();
-        }
-    }
-}
-
 auto Map::getHeight() const -> uint16_t { return height; }
 
 auto Map::getWidth() const -> uint16_t { return width; }
@@ -476,6 +467,12 @@ inline auto Map::convertWorldYToMap(int16_t y) const -> uint16_t {
     return temp;
 }
 
+void Map::refreshFlags() {
+    for (auto &field : fields) {
+        field.updateFlags();
+    }
+}
+
 auto Map::intersects(const Map &map) const -> bool {
     return map.origin.z == origin.z && getMaxX() >= map.origin.x && origin.x <= map.getMaxX() &&
            getMaxY() >= map.origin.y && origin.y <= map.getMaxY();
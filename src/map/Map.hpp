@@ -23,16 +23,37 @@
 #include "globals.hpp"
 #include "map/Field.hpp"
 
+#include <cstddef>
+#include <new>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace map {
 
+// places the field storage of a map on a cache line boundary
+template <typename T> struct CacheAlignedAllocator {
+    using value_type = T;
+    static constexpr std::align_val_t cacheLine{64};
+
+    CacheAlignedAllocator() = default;
+    template <typename U> explicit CacheAlignedAllocator(const CacheAlignedAllocator<U> & /*unused*/) noexcept {}
+
+    auto allocate(std::size_t n) -> T * { return static_cast<T *>(::operator new(n * sizeof(T), cacheLine)); }
+    void deallocate(T *p, std::size_t /*unused*/) noexcept { ::operator delete(p, cacheLine); }
+
+    template <typename U> auto operator==(const CacheAlignedAllocator<U> & /*unused*/) const -> bool { return true; }
+    template <typename U> auto operator!=(const CacheAlignedAllocator<U> & /*unused*/) const -> bool {
+        return false;
+    }
+};
+
 class Map {
     position origin;
     uint16_t width;
     uint16_t height;
-    std::vector<std::vector<Field>> fields;
+    // row by row, i.e. fields[y * width + x] in map coordinates
+    std::vector<Field, CacheAlignedAllocator<Field>> fields;
     std::string name;
 
 public:
@@ -53,7 +74,6 @@ public:
     auto at(const MapPosition & /*pos*/) -> Field &;
     [[nodiscard]] auto at(const MapPosition & /*pos*/) const -> const Field &;
 
-    void age();
 
     [[nodiscard]] auto getMinX() const -> int16_t;
     [[nodiscard]] auto getMinY() const -> int16_t;
@@ -65,6 +85,7 @@ public:
     [[nodiscard]] auto getName() const -> const std::string &;
 
     [[nodiscard]] auto intersects(const Map &map) const -> bool;
+    void refreshFlags();
 
 private:
     auto importFields(const std::string &importDir, const std::string &mapName) -> bool;
@@ -74,6 +95,7 @@ private:
 
     [[nodiscard]] inline auto convertWorldXToMap(int16_t x) const -> uint16_t;
     [[nodiscard]] inline auto convertWorldYToMap(int16_t y) const -> uint16_t;
+    [[nodiscard]] inline auto fieldIndex(uint16_t x, uint16_t y) const -> size_t { return size_t(y) * width + x; }
 };
 
 } // namespace map
@@ -0,0 +1,368 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "map/PersistenceQueue.hpp"
+
+#include "Logger.hpp"
+#include "db/ConnectionManager.hpp"
+#include "db/InsertQuery.hpp"
+#include "db/SchemaHelper.hpp"
+
+#include <algorithm>
+
+namespace map {
+
+namespace {
+// the queries of fixed shape writing a persistent field, built on first use when the schema is known
+auto insertTileStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_insert_tile", "INSERT INTO " + SchemaHelper::getServerTable("map_tiles") +
+                                         " (mt_x, mt_y, mt_z, mt_tile, mt_music) VALUES ($1, $2, $3, $4, $5)"};
+    return statement;
+}
+
+auto deleteTileStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_delete_tile", "DELETE FROM " + SchemaHelper::getServerTable("map_tiles") +
+                                         " WHERE mt_x = $1 AND mt_y = $2 AND mt_z = $3"};
+    return statement;
+}
+
+auto updateTileStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_update_tile", "UPDATE " + SchemaHelper::getServerTable("map_tiles") +
+                                         " SET mt_tile = $4, mt_music = $5 WHERE mt_x = $1 AND mt_y = $2 AND mt_z = $3"};
+    return statement;
+}
+
+auto deleteItemsStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_delete_items", "DELETE FROM " + SchemaHelper::getServerTable("map_items") +
+                                          " WHERE mi_x = $1 AND mi_y = $2 AND mi_z = $3"};
+    return statement;
+}
+
+auto deleteWarpStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_delete_warp", "DELETE FROM " + SchemaHelper::getServerTable("map_warps") +
+                                         " WHERE mw_start_x = $1 AND mw_start_y = $2 AND mw_start_z = $3"};
+    return statement;
+}
+
+auto insertWarpStatement() -> const Database::PreparedStatement & {
+    using Database::SchemaHelper;
+    static const Database::PreparedStatement statement{
+            "field_insert_warp", "INSERT INTO " + SchemaHelper::getServerTable("map_warps") +
+                                         " (mw_start_x, mw_start_y, mw_start_z, mw_target_x, mw_target_y, mw_target_z)"
+                                         " VALUES ($1, $2, $3, $4, $5, $6)"};
+    return statement;
+}
+} // namespace
+
+PersistenceQueue::PersistenceQueue() : PersistenceQueue(writeToDatabase) {}
+
+PersistenceQueue::PersistenceQueue(Writer writer) : writer(std::move(writer)), thread([this] { work(); }) {}
+
+PersistenceQueue::~PersistenceQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    changeQueued.notify_one();
+    thread.join();
+}
+
+void PersistenceQueue::insertField(const position &pos, uint16_t tile, uint16_t music) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &write = entry(pos);
+        // the row might still be in the database, if its removal was not written yet
+        write.row = write.row == FieldWrite::Row::remove ? FieldWrite::Row::replace : FieldWrite::Row::insert;
+        write.tile = tile;
+        write.music = music;
+    }
+
+    changeQueued.notify_one();
+}
+
+void PersistenceQueue::updateField(const position &pos, uint16_t tile, uint16_t music) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &write = entry(pos);
+
+        if (write.row != FieldWrite::Row::insert && write.row != FieldWrite::Row::replace) {
+            write.row = FieldWrite::Row::update;
+        }
+
+        write.tile = tile;
+        write.music = music;
+    }
+
+    changeQueued.notify_one();
+}
+
+void PersistenceQueue::removeField(const position &pos) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entry(pos).row = FieldWrite::Row::remove;
+    }
+
+    changeQueued.notify_one();
+}
+
+void PersistenceQueue::updateItems(const position &pos, std::vector<Item> items) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &write = entry(pos);
+        write.itemsChanged = true;
+        write.items = std::move(items);
+    }
+
+    changeQueued.notify_one();
+}
+
+void PersistenceQueue::updateWarp(const position &pos, const std::optional<position> &warptarget) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &write = entry(pos);
+        write.warpChanged = true;
+        write.warptarget = warptarget;
+    }
+
+    changeQueued.notify_one();
+}
+
+void PersistenceQueue::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    ++flushing;
+    changeQueued.notify_one();
+    batchWritten.wait(lock, [this] { return pending.empty() && !writing; });
+    --flushing;
+}
+
+auto PersistenceQueue::getStatistics() const -> Statistics {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto result = statistics;
+    result.depth = pending.size();
+    return result;
+}
+
+auto PersistenceQueue::entry(const position &pos) -> FieldWrite & {
+    const auto now = Clock::now();
+
+    if (pending.empty()) {
+        oldestQueued = now;
+    }
+
+    ++statistics.queued;
+    auto [it, inserted] = pending.try_emplace(pos);
+
+    if (inserted) {
+        it->second.queuedAt = now;
+    } else {
+        ++statistics.merged;
+    }
+
+    return it->second;
+}
+
+void PersistenceQueue::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        changeQueued.wait(lock, [this] { return stopping || !pending.empty(); });
+
+        if (pending.empty()) {
+            return;
+        }
+
+        // give changes of the same fields a moment to pile up
+        changeQueued.wait_until(lock, oldestQueued + writeDelay, [this] { return stopping || flushing > 0; });
+
+        Batch batch;
+        batch.reserve(std::min(pending.size(), maxFieldsPerBatch));
+
+        while (!pending.empty() && batch.size() < maxFieldsPerBatch) {
+            auto node = pending.extract(pending.begin());
+            batch.emplace_back(node.key(), std::move(node.mapped()));
+        }
+
+        writing = true;
+        lock.unlock();
+        writeBatch(batch);
+        lock.lock();
+        writing = false;
+        batchWritten.notify_all();
+    }
+}
+
+void PersistenceQueue::writeBatch(const Batch &batch) {
+    try {
+        writer(batch);
+        finishBatch(batch, true);
+        return;
+    } catch (std::exception &e) {
+        if (batch.size() == 1) {
+            Logger::error(LogFacility::World) << "Error while writing persistent field " << batch.front().first
+                                              << " to database: " << e.what() << Log::end;
+            finishBatch(batch, false);
+            return;
+        }
+
+        Logger::warn(LogFacility::World) << "Error while writing " << batch.size()
+                                         << " persistent fields to database, writing them one by one: " << e.what()
+                                         << Log::end;
+    }
+
+    finishBatch(batch, false);
+
+    for (const auto &change : batch) {
+        writeBatch({change});
+    }
+}
+
+void PersistenceQueue::finishBatch(const Batch &batch, bool written) {
+    const auto now = Clock::now();
+    Clock::time_point oldest = now;
+
+    for (const auto &change : batch) {
+        oldest = std::min(oldest, change.second.queuedAt);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ++statistics.batches;
+
+    if (written) {
+        statistics.written += batch.size();
+    } else {
+        ++statistics.failedBatches;
+
+        if (batch.size() == 1) {
+            ++statistics.lost;
+        }
+    }
+
+    statistics.lastLag = now - oldest;
+    statistics.maxLag = std::max(statistics.maxLag, statistics.lastLag);
+}
+
+void PersistenceQueue::writeToDatabase(const Batch &batch) {
+    using namespace Database;
+    auto connection = ConnectionManager::getInstance().getConnection();
+
+    try {
+        connection->beginTransaction();
+
+        // the items of all fields of the batch go in with one statement per table
+        InsertQuery itemQuery(connection);
+        const auto xColumn = itemQuery.addColumn("mi_x");
+        const auto yColumn = itemQuery.addColumn("mi_y");
+        const auto zColumn = itemQuery.addColumn("mi_z");
+        const auto stackPosColumn = itemQuery.addColumn("mi_stack_pos");
+        const auto itemColumn = itemQuery.addColumn("mi_item");
+        const auto qualityColumn = itemQuery.addColumn("mi_quality");
+        const auto numberColumn = itemQuery.addColumn("mi_number");
+        const auto wearColumn = itemQuery.addColumn("mi_wear");
+        itemQuery.addServerTable("map_items");
+
+        InsertQuery dataQuery(connection);
+        const auto xDataColumn = dataQuery.addColumn("mid_x");
+        const auto yDataColumn = dataQuery.addColumn("mid_y");
+        const auto zDataColumn = dataQuery.addColumn("mid_z");
+        const auto stackPosDataColumn = dataQuery.addColumn("mid_stack_pos");
+        const auto keyDataColumn = dataQuery.addColumn("mid_key");
+        const auto valueDataColumn = dataQuery.addColumn("mid_value");
+        dataQuery.addServerTable("map_item_data");
+
+        for (const auto &[pos, write] : batch) {
+            const auto x = static_cast<int16_t>(pos.x);
+            const auto y = static_cast<int16_t>(pos.y);
+            const auto z = static_cast<int16_t>(pos.z);
+
+            switch (write.row) {
+            case FieldWrite::Row::keep:
+                break;
+            case FieldWrite::Row::insert:
+                connection->query(insertTileStatement(), x, y, z, write.tile, write.music);
+                break;
+            case FieldWrite::Row::update:
+                connection->query(updateTileStatement(), x, y, z, write.tile, write.music);
+                break;
+            case FieldWrite::Row::remove:
+                connection->query(deleteTileStatement(), x, y, z);
+                break;
+            case FieldWrite::Row::replace:
+                connection->query(deleteTileStatement(), x, y, z);
+                connection->query(insertTileStatement(), x, y, z, write.tile, write.music);
+                break;
+            }
+
+            if (write.itemsChanged) {
+                connection->query(deleteItemsStatement(), x, y, z);
+                uint16_t stackPos = 0;
+
+                for (const auto &item : write.items) {
+                    itemQuery.addValue<int16_t>(xColumn, x);
+                    itemQuery.addValue<int16_t>(yColumn, y);
+                    itemQuery.addValue<int16_t>(zColumn, z);
+                    itemQuery.addValue<uint16_t>(stackPosColumn, stackPos);
+                    itemQuery.addValue<TYPE_OF_ITEM_ID>(itemColumn, item.getId());
+                    itemQuery.addValue<uint16_t>(qualityColumn, item.getQuality());
+                    itemQuery.addValue<uint16_t>(numberColumn, item.getNumber());
+                    itemQuery.addValue<uint16_t>(wearColumn, item.getWear());
+
+                    std::for_each(item.getDataBegin(), item.getDataEnd(), [&](const auto &data) {
+                        dataQuery.addValue<int16_t>(xDataColumn, x);
+                        dataQuery.addValue<int16_t>(yDataColumn, y);
+                        dataQuery.addValue<int16_t>(zDataColumn, z);
+                        dataQuery.addValue<uint16_t>(stackPosDataColumn, stackPos);
+                        dataQuery.addValue<std::string>(keyDataColumn, data.first);
+                        dataQuery.addValue<std::string>(valueDataColumn, data.second);
+                    });
+
+                    ++stackPos;
+                }
+            }
+
+            if (write.warpChanged) {
+                connection->query(deleteWarpStatement(), x, y, z);
+
+                if (write.warptarget) {
+                    const auto &target = *write.warptarget;
+                    connection->query(insertWarpStatement(), x, y, z, static_cast<int16_t>(target.x),
+                                      static_cast<int16_t>(target.y), static_cast<int16_t>(target.z));
+                }
+            }
+        }
+
+        itemQuery.execute();
+        dataQuery.execute();
+        connection->commitTransaction();
+    } catch (std::exception &) {
+        connection->rollbackTransaction();
+        throw;
+    }
+}
+
+} // namespace map
@@ -0,0 +1,127 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PERSISTENCE_QUEUE_HPP
+#define PERSISTENCE_QUEUE_HPP
+
+#include "Item.hpp"
+#include "globals.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace map {
+
+// Writes changes of persistent fields to the database on a thread of its own,
+// so that the game loop never waits for the database. Changes of a field that
+// pile up before they are written are merged, only the latest state of the
+// field gets written. Fields are written in batches, one transaction each. If
+// a batch fails, its fields are written one by one, so that a single broken
+// field does not cost the others their latest state.
+class PersistenceQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct FieldWrite {
+        // what to do with the row of the field in map_tiles
+        enum class Row : uint8_t { keep, insert, update, remove, replace };
+
+        Row row = Row::keep;
+        uint16_t tile = 0;
+        uint16_t music = 0;
+        bool itemsChanged = false;
+        std::vector<Item> items;
+        bool warpChanged = false;
+        std::optional<position> warptarget;
+        Clock::time_point queuedAt;
+    };
+
+    using Batch = std::vector<std::pair<position, FieldWrite>>;
+    // throws if the batch could not be written
+    using Writer = std::function<void(const Batch &)>;
+
+    struct Statistics {
+        size_t depth = 0;
+        uint64_t queued = 0;
+        uint64_t merged = 0;
+        uint64_t written = 0;
+        uint64_t batches = 0;
+        uint64_t failedBatches = 0;
+        // fields that could not be written even on their own
+        uint64_t lost = 0;
+        // time from queueing a change to the end of its transaction
+        Clock::duration lastLag{};
+        Clock::duration maxLag{};
+    };
+
+    // changes are held back this long, so that bursts are merged
+    static constexpr auto writeDelay = std::chrono::milliseconds(200);
+    static constexpr size_t maxFieldsPerBatch = 256;
+
+    PersistenceQueue();
+    explicit PersistenceQueue(Writer writer);
+    PersistenceQueue(const PersistenceQueue &) = delete;
+    auto operator=(const PersistenceQueue &) -> PersistenceQueue & = delete;
+    PersistenceQueue(PersistenceQueue &&) = delete;
+    auto operator=(PersistenceQueue &&) -> PersistenceQueue & = delete;
+    // writes everything still queued
+    ~PersistenceQueue();
+
+    void insertField(const position &pos, uint16_t tile, uint16_t music);
+    void updateField(const position &pos, uint16_t tile, uint16_t music);
+    void removeField(const position &pos);
+    void updateItems(const position &pos, std::vector<Item> items);
+    void updateWarp(const position &pos, const std::optional<position> &warptarget);
+
+    // blocks until all changes queued so far are written
+    void flush();
+
+    [[nodiscard]] auto getStatistics() const -> Statistics;
+
+    static void writeToDatabase(const Batch &batch);
+
+private:
+    // the pending write of the field at pos, a new one if there is none
+    auto entry(const position &pos) -> FieldWrite &;
+    void work();
+    void writeBatch(const Batch &batch);
+    void finishBatch(const Batch &batch, bool written);
+
+    Writer writer;
+    mutable std::mutex mutex;
+    std::condition_variable changeQueued;
+    std::condition_variable batchWritten;
+    std::unordered_map<position, FieldWrite> pending;
+    Clock::time_point oldestQueued;
+    bool writing = false;
+    size_t flushing = 0;
+    bool stopping = false;
+    Statistics statistics;
+    std::thread thread;
+};
+
+} // namespace map
+
+#endif
@@ -42,8 +42,12 @@
 namespace map {
 
 void WorldMap::clear() {
-    world_map.clear();
+    directory.clear();
     maps.clear();
+
+    for (const auto &pos : persistentFields | ranges::view::keys) {
+        directory.addPersistentField(pos);
+    }
 }
 
 auto WorldMap::intersects(const Map &map) const -> bool {
@@ -65,24 +69,40 @@ auto WorldMap::insert(Map &&newMap) -> bool {
         return false;
     }
 
-    maps.push_back(std::move(newMap));
+    if (maps.size() >= ChunkDirectory::noMap) {
+        Logger::error(LogFacility::Script) << "Could not insert map " << newMap.getName()
+                                           << " because the maximum number of maps is reached" << Log::end;
+        return false;
+    }
 
-    auto &map = maps.back();
-    const auto z = map.getLevel();
+    maps.push_back(std::move(newMap));
 
-    for (auto x = map.getMinX(); x <= map.getMaxX(); ++x) {
-        for (auto y = map.getMinY(); y <= map.getMaxY(); ++y) {
-            position p(x, y, z);
-            world_map[p] = maps.size() - 1;
-        }
-    }
+    const auto &map = maps.back();
+    directory.insert(map.getMinX(), map.getMinY(), map.getMaxX(), map.getMaxY(), map.getLevel(), maps.size() - 1);
 
     return true;
 }
 
 auto WorldMap::insertPersistent(Field &&newField) -> bool {
     newField.makePersistent();
-    return persistentFields.insert({newField.getPosition(), std::move(newField)}).second;
+    const auto pos = newField.getPosition();
+    const bool inserted = persistentFields.insert({pos, std::move(newField)}).second;
+
+    if (inserted) {
+        directory.addPersistentField(pos);
+    }
+
+    return inserted;
+}
+
+void WorldMap::refreshFlags() {
+    for (auto &map : maps) {
+        map.refreshFlags();
+    }
+
+    for (auto &field : persistentFields | ranges::view::values) {
+        field.updateFlags();
+    }
 }
 
 auto WorldMap::allMapsAged() -> bool {
@@ -92,18 +112,39 @@ auto WorldMap::allMapsAged() -> bool {
 
     auto startTime = steady_clock::now();
 
-    while (ageIndex < maps.size() && steady_clock::now() - startTime < ageInterval) {
-        maps[ageIndex++].age();
+    if (!ageingInProgress) {
+        ageing.startCycle();
+        ageingInProgress = true;
     }
 
-    if (ageIndex < maps.size()) {
+    while (ageing.hasDueFields() && steady_clock::now() - startTime < ageInterval) {
+        const auto pos = ageing.popDueField();
+
+        try {
+            auto &field = at(pos);
+
+            if (field.isDueForAgeing(ageing.currentCycle())) {
+                ageing.countAgedField(field.age());
+            }
+        } catch (FieldNotFound &) {
+        }
+    }
+
+    ageing.addDuration(steady_clock::now() - startTime);
+
+    if (ageing.hasDueFields()) {
         return false;
     }
 
-    using namespace ranges;
-    for_each(persistentFields | view::values, [](auto &field) { field.age(); });
+    ageingInProgress = false;
+
+    const auto &statistics = ageing.lastCycle();
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    Logger::debug(LogFacility::World) << "Aged " << statistics.fields << " fields, " << statistics.rottedItems
+                                      << " items rotted in " << duration_cast<microseconds>(statistics.duration).count()
+                                      << "us, " << ageing.pendingEntries() << " fields scheduled" << Log::end;
 
-    ageIndex = 0;
     return true;
 }
 
@@ -399,6 +440,10 @@ auto WorldMap::loadFromDisk() -> bool {
 }
 
 void WorldMap::loadPersistentFields() {
+    for (const auto &pos : persistentFields | ranges::view::keys) {
+        directory.removePersistentField(pos);
+    }
+
     persistentFields.clear();
 
     using namespace Database;
@@ -423,7 +468,9 @@ void WorldMap::loadPersistentFields() {
         auto music = row["mt_music"].as<uint16_t>();
         Field field(tile, music, pos, isPersistent);
 
-        persistentFields.emplace(pos, std::move(field));
+        if (persistentFields.emplace(pos, std::move(field)).second) {
+            directory.addPersistentField(pos);
+        }
     }
 }
 
@@ -485,7 +532,7 @@ void WorldMap::makePersistentAt(const position &pos) {
 }
 
 void WorldMap::removePersistenceAt(const position &pos) {
-    bool existsInMap = world_map.count(pos) > 0;
+    bool existsInMap = directory.mapAt(pos) != ChunkDirectory::noMap;
     bool existsPersistent = persistentFields.count(pos) > 0;
 
     if (!existsInMap && existsPersistent) {
@@ -520,6 +567,7 @@ void WorldMap::removePersistenceAt(const position &pos) {
     auto fieldNode = persistentFields.extract(pos);
 
     if (!fieldNode.empty()) {
+        directory.removePersistentField(pos);
         fieldNode.mapped().removePersistence();
 
         try {
@@ -543,6 +591,8 @@ auto WorldMap::isPersistentAt(const position &pos) const -> bool {
     return persistent;
 }
 
+auto WorldMap::indexMemoryUsage() const -> size_t { return directory.memoryUsage(); }
+
 auto walkableNear(WorldMap &worldMap, const position &pos) -> Field & {
     auto start = pos;
     auto testPos = pos;
@@ -20,6 +20,8 @@
 #define WORLDMAP_HPP
 
 #include "globals.hpp"
+#include "map/AgeingSchedule.hpp"
+#include "map/ChunkDirectory.hpp"
 #include "map/Map.hpp"
 
 #include <unordered_map>
@@ -31,9 +33,10 @@ class Field;
 
 class WorldMap {
     std::vector<Map> maps;
-    std::unordered_map<position, int> world_map;
+    ChunkDirectory directory;
     std::unordered_map<position, Field> persistentFields;
-    size_t ageIndex = 0;
+    AgeingSchedule ageing;
+    bool ageingInProgress = false;
 
 public:
     auto at(const position &pos) -> Field & { return atImpl(*this, pos); }
@@ -41,6 +44,11 @@ public:
     auto intersects(const Map &map) const -> bool;
 
     auto allMapsAged() -> bool;
+    [[nodiscard]] auto currentAgeingCycle() const -> AgeingCycle { return ageing.currentCycle(); }
+    void scheduleAgeing(const position &pos, AgeingCycle due) { ageing.schedule(pos, due); }
+    [[nodiscard]] auto ageingStatistics() const -> const AgeingSchedule::Statistics & { return ageing.lastCycle(); }
+    // fields only update their flags when they change, so this is needed after reloading definitions
+    void refreshFlags();
 
     auto import(const std::string &importDir, const std::string &mapName) -> bool;
     auto exportTo() const -> bool;
@@ -54,6 +62,8 @@ public:
     void removePersistenceAt(const position &pos);
     auto isPersistentAt(const position &pos) const -> bool;
 
+    [[nodiscard]] auto indexMemoryUsage() const -> size_t;
+
 private:
     const std::string worldName{"Illarion"};
     static constexpr auto coordinateChars = 6;
@@ -67,15 +77,25 @@ private:
     static auto isCommentOrEmpty(const std::string &line) -> bool;
 
     template <class T> static auto atImpl(T &t, const position &pos) -> decltype(t.at(pos)) {
-        if (t.persistentFields.count(pos) > 0) {
-            return t.persistentFields.at(pos);
+        const auto *chunk = t.directory.chunkAt(pos);
+
+        if (chunk == nullptr) {
+            throw FieldNotFound();
         }
-        try {
-            return t.maps.at(t.world_map.at(pos)).at(pos.x, pos.y);
 
-        } catch (std::out_of_range &) {
+        if (chunk->hasPersistentFields()) {
+            if (auto it = t.persistentFields.find(pos); it != t.persistentFields.end()) {
+                return it->second;
+            }
+        }
+
+        const auto mapIndex = chunk->mapAt(pos);
+
+        if (mapIndex == ChunkDirectory::noMap) {
             throw FieldNotFound();
         }
+
+        return t.maps[mapIndex].at(pos.x, pos.y);
     }
 };
 
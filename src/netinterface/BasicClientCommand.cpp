@@ -24,14 +24,12 @@
 
 BasicClientCommand::BasicClientCommand(unsigned char defByte, uint16_t minAP) : BasicCommand(defByte), minAP(minAP) {}
 
-void BasicClientCommand::setHeaderData(uint16_t mlength, uint16_t mcheckSum) {
+void BasicClientCommand::setData(const unsigned char *data, uint16_t mlength, uint16_t mcheckSum) {
+    msg_buffer = data;
     length = mlength;
     checkSum = mcheckSum;
-    msg_buffer.resize(length);
 }
 
-auto BasicClientCommand::msg_data() -> std::vector<unsigned char> & { return msg_buffer; }
-
 auto BasicClientCommand::getUnsignedCharFromBuffer() -> unsigned char {
     unsigned char ret = 0;
 
@@ -40,13 +38,13 @@ auto BasicClientCommand::getUnsignedCharFromBuffer() -> unsigned char {
         dataOk = false;
     }
     // we want to read more data than there is in the buffer
-    else if (bytesRetrieved > length) {
+    else if (bytesRetrieved >= length) {
         dataOk = false;
         throw OverflowException();
     }
     // all went well
     else {
-        ret = msg_buffer.at(bytesRetrieved++);
+        ret = msg_buffer[bytesRetrieved++];
     }
 
     crc += ret;
@@ -41,7 +41,11 @@ public:
      */
     BasicClientCommand(unsigned char defByte, uint16_t minAP = 0);
 
-    void setHeaderData(uint16_t mlength, uint16_t mcheckSum);
+    /**
+     * hands the received payload of the command to the decoder, the data is not copied and needs to
+     * stay valid until decodeData returned
+     */
+    void setData(const unsigned char *data, uint16_t mlength, uint16_t mcheckSum);
 
     virtual ~BasicClientCommand() = default;
 
@@ -50,11 +54,6 @@ public:
     BasicClientCommand(BasicClientCommand &&) = delete;
     auto operator=(BasicClientCommand &&) -> BasicClientCommand & = delete;
 
-    /**
-     * returns the data ptr for the command message
-     **/
-    auto msg_data() -> std::vector<unsigned char> &;
-
     /**
      * virtual function which should be overloaded in the concrete classes to get the data
      * of the command
@@ -67,12 +66,6 @@ public:
      */
     virtual void performAction(Player *player) = 0;
 
-    /**
-     * a copy function which returns an empty version of the command
-     * (for usage of the commandFactory class
-     */
-    virtual auto clone() -> ClientCommandPointer = 0;
-
     /**
      * returns if the receiving of the command was sucessfull
      * @return true if the command was receuved complete and without problems
@@ -117,11 +110,11 @@ public:
 protected:
     bool dataOk = true; /*<true if data is ok, will set to false if a command wants to read more data from the buffer as
                     is in it, or if the checksum isn't the same*/
-    std::vector<unsigned char> msg_buffer{}; /*< the current buffer for this command*/
-    uint16_t length = 0;                     /*< the length of this command */
-    uint16_t bytesRetrieved = 0;             /*< how much bytes are currently decoded */
-    uint16_t checkSum = 0;                   /*< the checksum transmitted in the header*/
-    uint32_t crc = 0;                        /*< the checksum of the data*/
+    const unsigned char *msg_buffer = nullptr; /*< the received payload, only valid while decoding*/
+    uint16_t length = 0;                       /*< the length of this command */
+    uint16_t bytesRetrieved = 0;               /*< how much bytes are currently decoded */
+    uint16_t checkSum = 0;                     /*< the checksum transmitted in the header*/
+    uint32_t crc = 0;                          /*< the checksum of the data*/
 
     uint16_t minAP; /*< number of ap necessary to perform command */
     std::chrono::steady_clock::time_point incomingTime;
@@ -20,24 +20,25 @@
 
 #include "BasicCommand.hpp"
 #include "Logger.hpp"
-#include "netinterface/NetInterface.hpp"
+#include "netinterface/CommandBufferPool.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <climits>
 #include <iostream>
 
-BasicServerCommand::BasicServerCommand(unsigned char defByte) : BasicCommand(defByte) {
-    buffer.resize(baseBufferSize);
+BasicServerCommand::BasicServerCommand(unsigned char defByte)
+        : BasicCommand(defByte), buffer(CommandBufferPool::get().acquire(baseBufferSize)) {
     initHeader();
 }
 
 BasicServerCommand::BasicServerCommand(unsigned char defByte, uint16_t bsize)
-        : BasicCommand(defByte), baseBufferSize(bsize) {
-    buffer.resize(baseBufferSize);
+        : BasicCommand(defByte), baseBufferSize(bsize), buffer(CommandBufferPool::get().acquire(baseBufferSize)) {
     initHeader();
 }
 
+BasicServerCommand::~BasicServerCommand() { CommandBufferPool::get().release(std::move(buffer)); }
+
 void BasicServerCommand::initHeader() {
     addUnsignedCharToBuffer(getDefinitionByte());
     addUnsignedCharToBuffer(getDefinitionByte() xor UCHAR_MAX);
@@ -60,6 +61,13 @@ void BasicServerCommand::addHeader() {
     }
 }
 
+void BasicServerCommand::freeze() {
+    if (!frozen) {
+        addHeader();
+        frozen = true;
+    }
+}
+
 auto BasicServerCommand::getLength() const -> int { return bufferPos; }
 
 auto BasicServerCommand::cmdData() const -> const std::vector<char> & { return buffer; }
@@ -83,6 +91,8 @@ void BasicServerCommand::addShortIntToBuffer(short int data) {
 }
 
 void BasicServerCommand::addUnsignedCharToBuffer(unsigned char data) {
+    assert(!frozen);
+
     // resize the buffer if there is not enough place to store
     if ((bufferPos + 1) >= (bufferSizeMod * baseBufferSize)) {
         resizeBuffer();
@@ -94,13 +104,23 @@ void BasicServerCommand::addUnsignedCharToBuffer(unsigned char data) {
     bufferPos++;
 }
 
+void BasicServerCommand::addEncodedToBuffer(const std::vector<char> &data, uint32_t dataCheckSum) {
+    assert(!frozen);
+
+    while ((bufferPos + data.size()) >= (bufferSizeMod * baseBufferSize)) {
+        resizeBuffer();
+    }
+
+    std::copy(data.cbegin(), data.cend(), buffer.begin() + bufferPos);
+    checkSum += dataCheckSum;
+    bufferPos += data.size();
+}
+
 void BasicServerCommand::resizeBuffer() {
-    Logger::info(LogFacility::Other) << "Not enough memory. Resizing the send buffer. Current size: "
-                                     << bufferSizeMod * baseBufferSize << " bytes." << Log::end;
     bufferSizeMod *= 2;
     buffer.resize(bufferSizeMod * baseBufferSize);
-    Logger::info(LogFacility::Other) << "Resizing the send buffer successful. New size: "
-                                     << bufferSizeMod * baseBufferSize << " bytes." << Log::end;
+    Logger::debug(LogFacility::Other) << "Send buffer of command " << int(getDefinitionByte()) << " grown to "
+                                      << bufferSizeMod * baseBufferSize << " bytes" << Log::end;
 }
 
 void BasicServerCommand::addColourToBuffer(const Colour &c) {
@@ -39,7 +39,9 @@ using ServerCommandPointer = std::shared_ptr<BasicServerCommand>;
  *- Byte 2+3: Length of the following data segment
  *- Byte 4+5: Checksum consisting of the sum of all data bytes mod 0xFFFF
  *
- *Once all data has been added to the command, the header needs to be finalized with addHeader()
+ *Once all data has been added to the command, it is frozen: the header is finalized and the
+ *buffer must not change anymore. A frozen command can be queued for any number of connections,
+ *so a broadcast is encoded only once.
  */
 class BasicServerCommand : public BasicCommand {
 public:
@@ -61,7 +63,7 @@ public:
     BasicServerCommand(const BasicServerCommand &) = delete;
     BasicServerCommand(BasicServerCommand &&) = default;
     auto operator=(BasicServerCommand &&) -> BasicServerCommand & = default;
-    ~BasicServerCommand() = default;
+    ~BasicServerCommand();
 
     /**
      * Function which returns the data buffer of the command.
@@ -81,14 +83,29 @@ public:
     void addUnsignedCharToBuffer(unsigned char data);
     void addColourToBuffer(const Colour &c);
 
+    /**
+     * Appends data that was encoded before
+     * @param data the encoded bytes
+     * @param dataCheckSum the sum of all bytes in data
+     */
+    void addEncodedToBuffer(const std::vector<char> &data, uint32_t dataCheckSum);
+
+    /**
+     * Finalizes the header, afterwards nothing may be added to the command.
+     * Freezing a frozen command does nothing.
+     */
+    void freeze();
+    [[nodiscard]] auto isFrozen() const -> bool { return frozen; }
+
+    void initHeader();
+
+private:
     /**
      * Adds all the header information to the top of the buffer
      * which depends on the commands data, like length and checksum
      */
     void addHeader();
-    void initHeader();
 
-private:
     static constexpr uint16_t headerSize = 6;
     static constexpr uint16_t lengthPosition = 2;
     static constexpr uint16_t crcPosition = 4;
@@ -100,6 +117,7 @@ private:
 
     uint16_t bufferPos = 0;     // stores the current buffer position and the size of the used buffer
     uint16_t bufferSizeMod = 1; // bufferSizeMod * baseBufferSize = current buffer size
+    bool frozen = false;
 
     // if there is a buffer overflow this function doubles buffer size
     void resizeBuffer();
@@ -0,0 +1,134 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef CLIENT_COMMAND_POOL_HPP
+#define CLIENT_COMMAND_POOL_HPP
+
+#include "netinterface/BasicClientCommand.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/**
+ *@ingroup Netinterface
+ *Recycles the memory of received client commands. Each command type has its
+ *own free list of blocks holding the command together with its reference
+ *count, so every packet still gets a freshly constructed command, but without
+ *going to the heap. Commands are created by the network threads and dropped
+ *by the game loop, so the lists are locked.
+ */
+class ClientCommandPool {
+public:
+    struct Statistics {
+        uint64_t allocations = 0;
+        uint64_t reuses = 0;
+    };
+
+    static constexpr size_t maxPooledCommands = 256;
+
+    template <typename Command> static auto create() -> ClientCommandPointer {
+        return std::allocate_shared<Command>(Allocator<Command>());
+    }
+
+    [[nodiscard]] static auto getStatistics() -> Statistics;
+
+private:
+    static std::atomic<uint64_t> allocations;
+    static std::atomic<uint64_t> reuses;
+
+    // one list per block type, never destroyed, since commands may outlive static destruction
+    template <typename Block> class FreeList {
+    public:
+        static auto get() -> FreeList & {
+            static auto *instance = new FreeList;
+            return *instance;
+        }
+
+        auto acquire() -> void * {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (!blocks.empty()) {
+                    void *block = blocks.back();
+                    blocks.pop_back();
+                    ++reuses;
+                    return block;
+                }
+            }
+
+            ++allocations;
+            return ::operator new(sizeof(Block));
+        }
+
+        void release(void *block) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (blocks.size() < maxPooledCommands) {
+                    blocks.push_back(block);
+                    return;
+                }
+            }
+
+            ::operator delete(block);
+        }
+
+    private:
+        FreeList() { blocks.reserve(maxPooledCommands); }
+
+        std::mutex mutex;
+        std::vector<void *> blocks;
+    };
+
+    // allocate_shared rebinds this to its control block, which is what ends up in the free list
+    template <typename T> class Allocator {
+    public:
+        using value_type = T;
+
+        Allocator() = default;
+        template <typename U> Allocator(const Allocator<U> & /*other*/) {}
+
+        auto allocate(size_t n) -> T * {
+            if (n != 1) {
+                return std::allocator<T>().allocate(n);
+            }
+
+            return static_cast<T *>(FreeList<T>::get().acquire());
+        }
+
+        void deallocate(T *block, size_t n) {
+            if (n != 1) {
+                std::allocator<T>().deallocate(block, n);
+                return;
+            }
+
+            FreeList<T>::get().release(block);
+        }
+
+        template <typename U> auto operator==(const Allocator<U> & /*other*/) const -> bool { return true; }
+        template <typename U> auto operator!=(const Allocator<U> & /*other*/) const -> bool { return false; }
+    };
+};
+
+#endif
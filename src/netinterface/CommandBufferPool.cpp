@@ -0,0 +1,63 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "netinterface/CommandBufferPool.hpp"
+
+auto CommandBufferPool::get() -> CommandBufferPool & {
+    static CommandBufferPool instance;
+    return instance;
+}
+
+auto CommandBufferPool::acquire(size_t size) -> Buffer {
+    Buffer buffer;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (buffers.empty()) {
+            ++statistics.allocations;
+        } else {
+            buffer = std::move(buffers.back());
+            buffers.pop_back();
+            ++statistics.reuses;
+        }
+    }
+
+    // a reused buffer keeps its capacity, so this neither allocates nor clears it
+    buffer.resize(size);
+    return buffer;
+}
+
+void CommandBufferPool::release(Buffer &&buffer) {
+    if (buffer.capacity() == 0 || buffer.capacity() > maxBufferSize) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (buffers.size() < maxPooledBuffers) {
+        buffers.push_back(std::move(buffer));
+    }
+}
+
+auto CommandBufferPool::getStatistics() const -> Statistics {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto result = statistics;
+    result.pooled = buffers.size();
+    return result;
+}
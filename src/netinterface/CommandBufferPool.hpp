@@ -0,0 +1,61 @@
+//  illarionserver - server for the game Illarion
+//  Copyright 2011 Illarion e.V.
+//
+//  This file is part of illarionserver.
+//
+//  illarionserver is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU Affero General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  illarionserver is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Affero General Public License for more details.
+//
+//  You should have received a copy of the GNU Affero General Public License
+//  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef COMMAND_BUFFER_POOL_HPP
+#define COMMAND_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ *@ingroup Netinterface
+ *Keeps the buffers of sent server commands for reuse. Commands are built in
+ *the game loop and dropped by the network threads once written, so the pool
+ *is shared by all threads.
+ */
+class CommandBufferPool {
+public:
+    using Buffer = std::vector<char>;
+
+    struct Statistics {
+        uint64_t allocations = 0;
+        uint64_t reuses = 0;
+        size_t pooled = 0;
+    };
+
+    // buffers grown beyond this are left to the heap
+    static constexpr size_t maxBufferSize = 16 * 1024;
+    static constexpr size_t maxPooledBuffers = 4096;
+
+    static auto get() -> CommandBufferPool &;
+
+    // a buffer of the given size, its contents are unspecified
+    auto acquire(size_t size) -> Buffer;
+    void release(Buffer &&buffer);
+
+    [[nodiscard]] auto getStatistics() const -> Statistics;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Buffer> buffers;
+    Statistics statistics;
+};
+
+#endif
@@ -18,72 +18,72 @@
 
 #include "netinterface/CommandFactory.hpp"
 
+#include "netinterface/ClientCommandPool.hpp"
 #include "netinterface/protocol/BBIWIClientCommands.hpp"
 #include "netinterface/protocol/ClientCommands.hpp"
 
-#include <memory>
+template <typename Command> void CommandFactory::add(unsigned char commandId) {
+    commands[commandId] = &ClientCommandPool::create<Command>;
+}
 
 CommandFactory::CommandFactory() {
-    templateList[C_MESSAGEDIALOG_TS] = std::make_unique<MessageDialogTS>();
-    templateList[C_INPUTDIALOG_TS] = std::make_unique<InputDialogTS>();
-    templateList[C_MERCHANTDIALOG_TS] = std::make_unique<MerchantDialogTS>();
-    templateList[C_SELECTIONDIALOG_TS] = std::make_unique<SelectionDialogTS>();
-    templateList[C_CRAFTINGDIALOG_TS] = std::make_unique<CraftingDialogTS>();
-    templateList[C_LOGIN_TS] = std::make_unique<LoginCommandTS>();
-    templateList[C_SCREENSIZE_TS] = std::make_unique<ScreenSizeCommandTS>();
-    templateList[C_LOOKATMAPITEM_TS] = std::make_unique<LookAtMapItemTS>();
-    templateList[C_USE_TS] = std::make_unique<UseTS>();
-    templateList[C_CAST_TS] = std::make_unique<CastTS>();
-    templateList[C_ATTACKPLAYER_TS] = std::make_unique<AttackPlayerTS>();
-    templateList[C_CUSTOMNAME_TS] = std::make_unique<CustomNameTS>();
-    templateList[C_INTRODUCE_TS] = std::make_unique<IntroduceTS>();
-    templateList[C_SAY_TS] = std::make_unique<SayTS>();
-    templateList[C_SHOUT_TS] = std::make_unique<ShoutTS>();
-    templateList[C_WHISPER_TS] = std::make_unique<WhisperTS>();
-    templateList[C_REFRESH_TS] = std::make_unique<RefreshTS>();
-    templateList[C_LOGOUT_TS] = std::make_unique<LogOutTS>();
-    templateList[C_PICKUPITEM_TS] = std::make_unique<PickUpItemTS>();
-    templateList[C_PICKUPALLITEMS_TS] = std::make_unique<PickUpAllItemsTS>();
-    templateList[C_LOOKINTOCONTAINERONFIELD_TS] = std::make_unique<LookIntoContainerOnFieldTS>();
-    templateList[C_LOOKINTOINVENTORY_TS] = std::make_unique<LookIntoInventoryTS>();
-    templateList[C_LOOKINTOSHOWCASECONTAINER_TS] = std::make_unique<LookIntoShowCaseContainerTS>();
-    templateList[C_CLOSECONTAINERINSHOWCASE_TS] = std::make_unique<CloseContainerInShowCaseTS>();
-    templateList[C_DROPITEMFROMSHOWCASEONMAP_TS] = std::make_unique<DropItemFromShowCaseOnMapTS>();
-    templateList[C_MOVEITEMBETWEENSHOWCASES_TS] = std::make_unique<MoveItemBetweenShowCasesTS>();
-    templateList[C_MOVEITEMFROMMAPINTOSHOWCASE_TS] = std::make_unique<MoveItemFromMapIntoShowCaseTS>();
-    templateList[C_MOVEITEMFROMMAPTOPLAYER_TS] = std::make_unique<MoveItemFromMapToPlayerTS>();
-    templateList[C_MOVEITEMFROMMAPTOMAP_TS] = std::make_unique<MoveItemFromMapToMapTS>();
-    templateList[C_DROPITEMFROMPLAYERONMAP_TS] = std::make_unique<DropItemFromInventoryOnMapTS>();
-    templateList[C_MOVEITEMINSIDEINVENTORY_TS] = std::make_unique<MoveItemInsideInventoryTS>();
-    templateList[C_MOVEITEMFROMSHOWCASETOPLAYER_TS] = std::make_unique<MoveItemFromShowCaseToPlayerTS>();
-    templateList[C_MOVEITEMFROMPLAYERTOSHOWCASE_TS] = std::make_unique<MoveItemFromPlayerToShowCaseTS>();
-    templateList[C_LOOKATSHOWCASEITEM_TS] = std::make_unique<LookAtShowCaseItemTS>();
-    templateList[C_LOOKATINVENTORYITEM_TS] = std::make_unique<LookAtInventoryItemTS>();
-    templateList[C_ATTACKSTOP_TS] = std::make_unique<AttackStopTS>();
-    templateList[C_REQUESTSKILLS_TS] = std::make_unique<RequestSkillsTS>();
-    templateList[C_KEEPALIVE_TS] = std::make_unique<KeepAliveTS>();
-    templateList[BB_KEEPALIVE_TS] = std::make_unique<BBKeepAliveTS>();
-    templateList[BB_BROADCAST_TS] = std::make_unique<BBBroadCastTS>();
-    templateList[BB_DISCONNECT_TS] = std::make_unique<BBDisconnectTS>();
-    templateList[BB_BAN_TS] = std::make_unique<BBBanTS>();
-    templateList[BB_TALKTO_TS] = std::make_unique<BBTalktoTS>();
-    templateList[BB_CHANGEATTRIB_TS] = std::make_unique<BBChangeAttribTS>();
-    templateList[BB_CHANGESKILL_TS] = std::make_unique<BBChangeSkillTS>();
-    templateList[BB_SERVERCOMMAND_TS] = std::make_unique<BBServerCommandTS>();
-    templateList[BB_WARPPLAYER_TS] = std::make_unique<BBWarpPlayerTS>();
-    templateList[BB_SPEAKAS_TS] = std::make_unique<BBSpeakAsTS>();
-    templateList[C_CHARMOVE_TS] = std::make_unique<CharMoveTS>();
-    templateList[C_PLAYERSPIN_TS] = std::make_unique<PlayerSpinTS>();
-    templateList[C_LOOKATCHARACTER_TS] = std::make_unique<LookAtCharacterTS>();
-    templateList[C_REQUESTAPPEARANCE_TS] = std::make_unique<RequestAppearanceTS>();
+    add<MessageDialogTS>(C_MESSAGEDIALOG_TS);
+    add<InputDialogTS>(C_INPUTDIALOG_TS);
+    add<MerchantDialogTS>(C_MERCHANTDIALOG_TS);
+    add<SelectionDialogTS>(C_SELECTIONDIALOG_TS);
+    add<CraftingDialogTS>(C_CRAFTINGDIALOG_TS);
+    add<LoginCommandTS>(C_LOGIN_TS);
+    add<ScreenSizeCommandTS>(C_SCREENSIZE_TS);
+    add<LookAtMapItemTS>(C_LOOKATMAPITEM_TS);
+    add<UseTS>(C_USE_TS);
+    add<CastTS>(C_CAST_TS);
+    add<AttackPlayerTS>(C_ATTACKPLAYER_TS);
+    add<CustomNameTS>(C_CUSTOMNAME_TS);
+    add<IntroduceTS>(C_INTRODUCE_TS);
+    add<SayTS>(C_SAY_TS);
+    add<ShoutTS>(C_SHOUT_TS);
+    add<WhisperTS>(C_WHISPER_TS);
+    add<RefreshTS>(C_REFRESH_TS);
+    add<LogOutTS>(C_LOGOUT_TS);
+    add<PickUpItemTS>(C_PICKUPITEM_TS);
+    add<PickUpAllItemsTS>(C_PICKUPALLITEMS_TS);
+    add<LookIntoContainerOnFieldTS>(C_LOOKINTOCONTAINERONFIELD_TS);
+    add<LookIntoInventoryTS>(C_LOOKINTOINVENTORY_TS);
+    add<LookIntoShowCaseContainerTS>(C_LOOKINTOSHOWCASECONTAINER_TS);
+    add<CloseContainerInShowCaseTS>(C_CLOSECONTAINERINSHOWCASE_TS);
+    add<DropItemFromShowCaseOnMapTS>(C_DROPITEMFROMSHOWCASEONMAP_TS);
+    add<MoveItemBetweenShowCasesTS>(C_MOVEITEMBETWEENSHOWCASES_TS);
+    add<MoveItemFromMapIntoShowCaseTS>(C_MOVEITEMFROMMAPINTOSHOWCASE_TS);
+    add<MoveItemFromMapToPlayerTS>(C_MOVEITEMFROMMAPTOPLAYER_TS);
+    add<MoveItemFromMapToMapTS>(C_MOVEITEMFROMMAPTOMAP_TS);
+    add<DropItemFromInventoryOnMapTS>(C_DROPITEMFROMPLAYERONMAP_TS);
+    add<MoveItemInsideInventoryTS>(C_MOVEITEMINSIDEINVENTORY_TS);
+    add<MoveItemFromShowCaseToPlayerTS>(C_MOVEITEMFROMSHOWCASETOPLAYER_TS);
+    add<MoveItemFromPlayerToShowCaseTS>(C_MOVEITEMFROMPLAYERTOSHOWCASE_TS);
+    add<LookAtShowCaseItemTS>(C_LOOKATSHOWCASEITEM_TS);
+    add<LookAtInventoryItemTS>(C_LOOKATINVENTORYITEM_TS);
+    add<AttackStopTS>(C_ATTACKSTOP_TS);
+    add<RequestSkillsTS>(C_REQUESTSKILLS_TS);
+    add<KeepAliveTS>(C_KEEPALIVE_TS);
+    add<BBKeepAliveTS>(BB_KEEPALIVE_TS);
+    add<BBBroadCastTS>(BB_BROADCAST_TS);
+    add<BBDisconnectTS>(BB_DISCONNECT_TS);
+    add<BBBanTS>(BB_BAN_TS);
+    add<BBTalktoTS>(BB_TALKTO_TS);
+    add<BBChangeAttribTS>(BB_CHANGEATTRIB_TS);
+    add<BBChangeSkillTS>(BB_CHANGESKILL_TS);
+    add<BBServerCommandTS>(BB_SERVERCOMMAND_TS);
+    add<BBWarpPlayerTS>(BB_WARPPLAYER_TS);
+    add<BBSpeakAsTS>(BB_SPEAKAS_TS);
+    add<CharMoveTS>(C_CHARMOVE_TS);
+    add<PlayerSpinTS>(C_PLAYERSPIN_TS);
+    add<LookAtCharacterTS>(C_LOOKATCHARACTER_TS);
+    add<RequestAppearanceTS>(C_REQUESTAPPEARANCE_TS);
 }
 
-auto CommandFactory::getCommand(unsigned char commandId) -> ClientCommandPointer {
-    COMMANDLIST::iterator it;
-    it = templateList.find(commandId);
-
-    if (it != templateList.end()) {
-        return it->second->clone();
+auto CommandFactory::getCommand(unsigned char commandId) const -> ClientCommandPointer {
+    if (const auto create = commands[commandId]) {
+        return create();
     }
 
     return ClientCommandPointer();
@@ -21,27 +21,31 @@
 
 #include "netinterface/BasicClientCommand.hpp"
 
-#include <memory>
-#include <unordered_map>
+#include <array>
+#include <climits>
 
 /**
- *factory class which holds templates of BasicServerCommand classes
- *an returns an empty command given by an id
+ *factory class which holds a table of the known client commands indexed by
+ *their id and returns an empty command given by an id
  */
 class CommandFactory {
 public:
     CommandFactory();
 
     /**
-     *returns a pointer to an emtpy Server Command
+     *returns a pointer to an emtpy client command, recycled from the command pool
      *@param commandId the id of the command which we want to use
-     *@return a pointer to an empty command with the given commandId
+     *@return a pointer to an empty command with the given commandId, or an empty pointer for unknown ids
      */
-    auto getCommand(unsigned char commandId) -> ClientCommandPointer;
+    auto getCommand(unsigned char commandId) const -> ClientCommandPointer;
+
+    [[nodiscard]] auto isKnown(unsigned char commandId) const -> bool { return commands[commandId] != nullptr; }
 
 private:
-    using COMMANDLIST = std::unordered_map<unsigned char, std::unique_ptr<BasicClientCommand>>;
-    COMMANDLIST templateList;
+    using Create = auto (*)() -> ClientCommandPointer;
+    template <typename Command> void add(unsigned char commandId);
+
+    std::array<Create, UCHAR_MAX + 1> commands{};
 };
 
 #endif
@@ -23,18 +23,27 @@
 #include "netinterface/BasicClientCommand.hpp"
 #include "netinterface/protocol/ClientCommands.hpp"
 
+#include <algorithm>
 #include <climits>
 #include <iomanip>
 
+const CommandFactory NetInterface::commandFactory;
+
 NetInterface::NetInterface(boost::asio::io_service &io_servicen)
-        : online(false), headerBuffer{0}, socket(io_servicen), inactive(0), owner(nullptr) {
-    cmd.reset();
-}
+        : online(false), receiveBuffer(receiveBufferSize), socket(io_servicen),
+          strand(boost::asio::make_strand(io_servicen)), loginTimer(io_servicen), owner(nullptr) {}
 
 auto NetInterface::getIPAdress() -> std::string { return ipadress; }
 
 NetInterface::~NetInterface() {
     try {
+        if (writes > 0) {
+            Logger::debug(LogFacility::Other)
+                    << "Connection to " << ipadress << " closed after " << writes << " writes, "
+                    << double(commandsWritten) / double(writes) << " commands and "
+                    << bytesWritten / writes << " bytes per write" << Log::end;
+        }
+
         online = false;
         sendQueue.clear();
         socket.close();
@@ -46,15 +55,29 @@ NetInterface::~NetInterface() {
 
 void NetInterface::closeConnection() { online = false; }
 
+void NetInterface::setLoginHandler(LoginHandler handler) { loginHandler = std::move(handler); }
+
 auto NetInterface::activate(Player *player) -> bool {
     try {
-        owner = player;
-        boost::asio::async_read(socket, boost::asio::buffer(headerBuffer),
-                                [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                                    shared_this->handle_read_header(error);
-                                });
         ipadress = socket.remote_endpoint().address().to_string();
         online = true;
+
+        if (player == nullptr) {
+            loginTimer.expires_after(loginTimeout);
+            loginTimer.async_wait(onStrand([shared_this = shared_from_this()](const auto &error) {
+                shared_this->handle_login_timeout(error);
+            }));
+        }
+
+        // the login may have arrived together with the first commands, those are still in the buffer
+        boost::asio::post(strand, [shared_this = shared_from_this(), player] {
+            shared_this->owner = player;
+
+            if (shared_this->processFrames()) {
+                shared_this->startRead();
+            }
+        });
+
         return true;
     } catch (std::exception &e) {
         if (player != nullptr) {
@@ -68,182 +91,213 @@ auto NetInterface::activate(Player *player) -> bool {
     }
 }
 
-void NetInterface::handle_read_data(const boost::system::error_code &error) {
-    if (!error) {
+void NetInterface::handle_login_timeout(const boost::system::error_code &error) {
+    if (error != boost::asio::error::operation_aborted) {
+        finishLogin();
+    }
+}
+
+void NetInterface::finishLogin() {
+    if (loginHandler) {
+        auto handler = std::move(loginHandler);
+        loginHandler = nullptr;
+        handler(shared_from_this());
+    }
+}
+
+void NetInterface::startRead() {
+    socket.async_read_some(
+            boost::asio::buffer(receiveBuffer.data() + bytesReceived, receiveBuffer.size() - bytesReceived),
+            onStrand([shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
+                shared_this->handle_read(error, bytes_transferred);
+            }));
+}
+
+void NetInterface::handle_read(const boost::system::error_code &error, size_t bytesTransferred) {
+    if (error) {
         if (online) {
-            try {
-                cmd->decodeData();
+            if (owner != nullptr) {
+                Logger::error(LogFacility::Other) << "Error in NetInterface::handle_read for " << owner->to_string()
+                                                  << " from " << getIPAdress() << ": " << error.message() << Log::end;
+            } else {
+                Logger::error(LogFacility::Other) << "Error in NetInterface::handle_read from " << getIPAdress()
+                                                  << ": " << error.message() << Log::end;
+            }
+        }
 
-                if (cmd->isDataOk()) {
-                    cmd->setReceivedTime();
+        closeConnection();
+        return;
+    }
 
-                    if (owner == nullptr) {
-                        auto login = std::dynamic_pointer_cast<LoginCommandTS>(cmd);
+    bytesReceived += bytesTransferred;
 
-                        if (!login) {
-                            closeConnection();
-                            return;
-                        }
+    if (processFrames()) {
+        startRead();
+    }
+}
 
-                        loginData = login;
-                        return;
-                    }
-                    owner->receiveCommand(cmd);
-                }
-            } catch (OverflowException &e) {
-                std::ostringstream message;
-                message << "Overflow while reading from buffer from ";
-                message << getIPAdress() << ": ";
+// decodes every complete message in the receive buffer, returns false once the connection stops reading
+auto NetInterface::processFrames() -> bool {
+    size_t position = 0;
+    bool reading = online;
 
-                const auto &data = cmd->msg_data();
-                message << std::hex << std::uppercase << std::setfill('0');
+    while (reading && bytesReceived - position >= headerSize) {
+        const unsigned char *header = &receiveBuffer[position];
+        const unsigned char id = header[commandPosition];
 
-                for (int i = 0; i < cmd->getLength(); ++i) {
-                    message << std::setw(2) << (int)data.at(i) << " ";
-                }
+        // no correct header, look for the next command signature
+        if ((id xor UCHAR_MAX) != header[commandPosition + 1] || !commandFactory.isKnown(id)) {
+            ++position;
+            continue;
+        }
 
-                message << std::dec << std::nouppercase;
-                Logger::error(LogFacility::Other) << message.str() << Log::end;
+        const auto length = static_cast<uint16_t>(header[lengthPosition] << CHAR_BIT | header[lengthPosition + 1]);
+        const auto checkSum = static_cast<uint16_t>(header[crcPosition] << CHAR_BIT | header[crcPosition + 1]);
+        const size_t messageSize = headerSize + length;
 
-                closeConnection();
+        if (bytesReceived - position < messageSize) {
+            if (receiveBuffer.size() < messageSize) {
+                receiveBuffer.resize(messageSize);
             }
 
-            cmd.reset();
-            boost::asio::async_read(socket, boost::asio::buffer(headerBuffer),
-                                    [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                                        shared_this->handle_read_header(error);
-                                    });
+            break;
         }
-    } else {
-        closeConnection();
-        boost::asio::async_read(socket, boost::asio::buffer(headerBuffer),
-                                [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                                    shared_this->handle_read_header(error);
-                                });
+
+        reading = decodeCommand(id, header + headerSize, length, checkSum) && online;
+        position += messageSize;
     }
-}
 
-auto NetInterface::nextInactive() -> bool {
-    inactive++;
-    return (inactive > maxInactive);
+    if (position > 0) {
+        std::copy(receiveBuffer.begin() + position, receiveBuffer.begin() + bytesReceived, receiveBuffer.begin());
+        bytesReceived -= position;
+    }
+
+    return reading;
 }
 
-void NetInterface::handle_read_header(const boost::system::error_code &error) {
-    if (!error) {
-        if ((headerBuffer[commandPosition] xor UCHAR_MAX) == headerBuffer[commandPosition + 1]) {
-            // Correcter header decodieren und comand empfangen
-            uint16_t length = headerBuffer[lengthPosition] << CHAR_BIT;
-            length = length | headerBuffer[lengthPosition + 1];
-            uint16_t checkSum = headerBuffer[crcPosition] << CHAR_BIT;
-            checkSum = checkSum | headerBuffer[crcPosition + 1];
-            cmd = commandFactory.getCommand(headerBuffer[commandPosition]);
-
-            if (cmd) {
-                cmd->setHeaderData(length, checkSum);
-                boost::asio::async_read(socket, boost::asio::buffer(cmd->msg_data(), cmd->getLength()),
-                                        [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                                            shared_this->handle_read_data(error);
-                                        });
-
-                return;
-            }
-        }
+// if no player owns the connection yet, only the login command is accepted and reading stops afterwards
+auto NetInterface::decodeCommand(unsigned char id, const unsigned char *data, uint16_t length, uint16_t checkSum)
+        -> bool {
+    auto cmd = commandFactory.getCommand(id);
+    cmd->setData(data, length, checkSum);
 
-        // no correct header
+    try {
+        cmd->decodeData();
+    } catch (OverflowException &e) {
+        std::ostringstream message;
+        message << "Overflow while reading from buffer from ";
+        message << getIPAdress() << ": ";
+        message << std::hex << std::uppercase << std::setfill('0');
+
+        for (int i = 0; i < length; ++i) {
+            message << std::setw(2) << (int)data[i] << " ";
+        }
 
-        // look for command id in header
-        for (int i = 1; i < headerSize - 1; ++i) {
-            // found correct command id
-            if ((headerBuffer.at(i) xor UCHAR_MAX) == headerBuffer.at(i + 1)) {
-                // copy the rest of the correct message to the start of the buffer
-                int start = 0;
+        message << std::dec << std::nouppercase;
+        Logger::error(LogFacility::Other) << message.str() << Log::end;
 
-                while (i < headerSize) {
-                    headerBuffer.at(start++) = headerBuffer.at(i++);
-                }
+        closeConnection();
+        return false;
+    }
 
-                // restheader empfangen
-                boost::asio::async_read(socket, boost::asio::buffer(&headerBuffer.at(start), headerSize - start),
-                                        [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                                            shared_this->handle_read_header(error);
-                                        });
+    if (!cmd->isDataOk()) {
+        return true;
+    }
 
-                return;
-            }
-        }
+    cmd->setReceivedTime();
 
-        // Keine Command Signature gefunden wieder 6 Byte Header auslesen
-        boost::asio::async_read(socket, boost::asio::buffer(headerBuffer),
-                                [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                                    shared_this->handle_read_header(error);
-                                });
+    if (owner == nullptr) {
+        auto login = std::dynamic_pointer_cast<LoginCommandTS>(cmd);
 
-    } else {
-        if (online) {
-            if (owner != nullptr) {
-                Logger::error(LogFacility::Other)
-                        << "Error in NetInterface::handle_read_header for " << owner->to_string() << " from "
-                        << getIPAdress() << ": " << error.message() << Log::end;
-            } else {
-                Logger::error(LogFacility::Other) << "Error in NetInterface::handle_read_header from " << getIPAdress()
-                                                  << ": " << error.message() << Log::end;
-            }
+        if (!login) {
+            closeConnection();
+            return false;
         }
 
-        closeConnection();
+        loginData = login;
+        loginTimer.cancel();
+        finishLogin();
+        return false;
     }
+
+    owner->receiveCommand(cmd);
+    return true;
 }
 
 void NetInterface::addCommand(const ServerCommandPointer &command) {
     if (online) {
-        command->addHeader();
-        std::lock_guard<std::mutex> lock(sendQueueMutex);
-        bool write_in_progress = !sendQueue.empty();
-        sendQueue.push_back(command);
+        command->freeze();
 
-        try {
-            if (!write_in_progress && online) {
-                boost::asio::async_write(
-                        socket, boost::asio::buffer(sendQueue.front()->cmdData(), sendQueue.front()->getLength()),
-                        [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                            shared_this->handle_write(error);
-                        });
+        // the queue belongs to the strand, so the caller neither locks nor touches the socket
+        boost::asio::post(strand, [shared_this = shared_from_this(), command] {
+            shared_this->sendQueue.push_back(command);
+
+            try {
+                if (!shared_this->writeInProgress && shared_this->online) {
+                    shared_this->startWrite();
+                }
+            } catch (std::exception &e) {
+                Logger::error(LogFacility::Other) << "Exception in NetInterface::addCommand: " << e.what() << Log::end;
+                shared_this->closeConnection();
             }
-        } catch (std::exception &e) {
-            Logger::error(LogFacility::Other) << "Exception in NetInterface::addCommand: " << e.what() << Log::end;
-            closeConnection();
-        }
+        });
     }
 }
 
+// runs on the strand, expects sendQueue not to be empty
+void NetInterface::startWrite() {
+    size_t bytes = 0;
+
+    do {
+        auto &command = sendQueue.front();
+        bytes += command->getLength();
+        writeBuffers.emplace_back(command->cmdData().data(), command->getLength());
+        commandsInWrite.push_back(std::move(command));
+        sendQueue.pop_front();
+    } while (!sendQueue.empty() && bytes + sendQueue.front()->getLength() <= maxBytesPerWrite);
+
+    writeInProgress = true;
+    boost::asio::async_write(
+            socket, writeBuffers,
+            onStrand([shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
+                shared_this->handle_write(error, bytes_transferred);
+            }));
+}
+
+auto NetInterface::getWriteStatistics() const -> WriteStatistics {
+    return {writes, commandsWritten, bytesWritten};
+}
+
 void NetInterface::shutdownSend(const ServerCommandPointer &command) {
-    try {
-        command->addHeader();
-        shutdownCmd = command;
-        boost::asio::async_write(socket, boost::asio::buffer(shutdownCmd->cmdData(), shutdownCmd->getLength()),
-                                 [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                                     shared_this->handle_write_shutdown(error);
-                                 });
-    } catch (std::exception &e) {
-        Logger::error(LogFacility::Other) << "Exception in NetInterface::shutownSend: " << e.what() << Log::end;
-        closeConnection();
-    }
+    command->freeze();
+
+    boost::asio::post(strand, [shared_this = shared_from_this(), command] {
+        try {
+            shared_this->shutdownCmd = command;
+            boost::asio::async_write(
+                    shared_this->socket, boost::asio::buffer(command->cmdData(), command->getLength()),
+                    shared_this->onStrand([shared_this](const auto &error, auto bytes_transferred) {
+                        shared_this->handle_write_shutdown(error);
+                    }));
+        } catch (std::exception &e) {
+            Logger::error(LogFacility::Other) << "Exception in NetInterface::shutownSend: " << e.what() << Log::end;
+            shared_this->closeConnection();
+        }
+    });
 }
 
-void NetInterface::handle_write(const boost::system::error_code &error) {
+void NetInterface::handle_write(const boost::system::error_code &error, size_t bytesTransferred) {
     try {
+        ++writes;
+        commandsWritten += commandsInWrite.size();
+        bytesWritten += bytesTransferred;
+        commandsInWrite.clear();
+        writeBuffers.clear();
+        writeInProgress = false;
+
         if (!error) {
-            if (online) {
-                std::lock_guard<std::mutex> lock(sendQueueMutex);
-                sendQueue.pop_front();
-
-                if (!sendQueue.empty() && online) {
-                    boost::asio::async_write(
-                            socket, boost::asio::buffer(sendQueue.front()->cmdData(), sendQueue.front()->getLength()),
-                            [shared_this = shared_from_this()](const auto &error, auto bytes_transferred) {
-                                shared_this->handle_write(error);
-                            });
-                }
+            if (!sendQueue.empty() && online) {
+                startWrite();
             }
         } else {
             Logger::error(LogFacility::Other) << "Error in NetInterface::handle_write: " << error.message() << Log::end;
@@ -29,12 +29,13 @@
 #include "netinterface/CommandFactory.hpp"
 #include "thread_safe_vector.hpp"
 
-#include <array>
 #include <atomic>
 #include <boost/asio.hpp>
+#include <chrono>
 #include <deque>
+#include <functional>
 #include <memory>
-#include <mutex>
+#include <vector>
 
 class LoginCommandTS;
 
@@ -69,7 +70,14 @@ public:
     auto activate(Player * /*player*/ = nullptr)
             -> bool; /*<activates the connection starts the sending and receiving threads, if player == nullptr only
                         login command is accepted and processing stops afterwards*/
-    auto nextInactive() -> bool;
+
+    using LoginHandler = std::function<void(const std::shared_ptr<NetInterface> &)>;
+
+    /**
+     * called once the login command arrived or the client did not send it in time,
+     * needs to be set before the connection is activated without a player
+     */
+    void setLoginHandler(LoginHandler handler);
 
     /**
      * adds a command to the send queue so it will be sended correctly to the connection
@@ -89,35 +97,70 @@ public:
 
     auto getLoginData() const -> std::shared_ptr<LoginCommandTS> { return loginData; }
 
-private:
-    void handle_read_header(const boost::system::error_code &error);
-    void handle_read_data(const boost::system::error_code &error);
+    struct WriteStatistics {
+        uint64_t writes = 0;
+        uint64_t commands = 0;
+        uint64_t bytes = 0;
+    };
 
-    void handle_write(const boost::system::error_code &error);
+    /**
+     * counts the socket writes of this connection and the commands and bytes they carried
+     */
+    [[nodiscard]] auto getWriteStatistics() const -> WriteStatistics;
+
+private:
+    // handlers of one connection never run concurrently, even with several network threads
+    template <typename Handler> auto onStrand(Handler &&handler) {
+        return boost::asio::bind_executor(strand, std::forward<Handler>(handler));
+    }
+
+    void startRead();
+    void handle_read(const boost::system::error_code &error, size_t bytesTransferred);
+    auto processFrames() -> bool;
+    auto decodeCommand(unsigned char id, const unsigned char *data, uint16_t length, uint16_t checkSum) -> bool;
+    void handle_login_timeout(const boost::system::error_code &error);
+    void finishLogin();
+
+    void startWrite();
+    void handle_write(const boost::system::error_code &error, size_t bytesTransferred);
     void handle_write_shutdown(const boost::system::error_code &error);
 
-    // Buffer for the header of messages
-    static constexpr auto headerSize = 6;
+    // layout of the header in front of every message
+    static constexpr size_t headerSize = 6;
     static constexpr auto commandPosition = 0;
     static constexpr auto lengthPosition = 2;
     static constexpr auto crcPosition = 4;
-    std::array<unsigned char, headerSize> headerBuffer;
 
-    ClientCommandPointer cmd;
+    // the socket is read in chunks of up to this size and every complete message in a chunk is decoded
+    // in place, an incomplete one is moved to the front to wait for the next read. A message that does
+    // not fit grows the buffer.
+    static constexpr size_t receiveBufferSize = 8 * 1024;
+    std::vector<unsigned char> receiveBuffer;
+    size_t bytesReceived = 0;
+
     ServerCommandPointer shutdownCmd;
-    ServerCommandPointer cmdToWrite;
 
+    // queued commands are gathered into one write of at most this many bytes,
+    // a single larger command is still written on its own
+    static constexpr size_t maxBytesPerWrite = 64 * 1024;
     SERVERCOMMANDLIST sendQueue;
+    std::vector<ServerCommandPointer> commandsInWrite;
+    std::vector<boost::asio::const_buffer> writeBuffers;
+    bool writeInProgress = false;
+    std::atomic<uint64_t> writes = 0;
+    std::atomic<uint64_t> commandsWritten = 0;
+    std::atomic<uint64_t> bytesWritten = 0;
 
     std::string ipadress;
 
     boost::asio::ip::tcp::socket socket;
+    boost::asio::strand<boost::asio::io_service::executor_type> strand;
 
     // Factory für Commands vom Client
-    CommandFactory commandFactory;
-    static constexpr auto maxInactive = 1000;
-    uint16_t inactive;
-    std::mutex sendQueueMutex;
+    static const CommandFactory commandFactory;
+    static constexpr auto loginTimeout = std::chrono::seconds(100);
+    boost::asio::steady_timer loginTimer;
+    LoginHandler loginHandler;
     std::shared_ptr<LoginCommandTS> loginData;
 
     Player *owner;
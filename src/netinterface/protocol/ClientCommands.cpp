@@ -58,11 +58,6 @@ void InputDialogTS::performAction(Player *player) {
     player->executeInputDialog(dialogId, success, input);
 }
 
-auto InputDialogTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<InputDialogTS>();
-    return cmd;
-}
-
 MessageDialogTS::MessageDialogTS() : BasicClientCommand(C_MESSAGEDIALOG_TS) {}
 
 void MessageDialogTS::decodeData() { dialogId = getIntFromBuffer(); }
@@ -72,11 +67,6 @@ void MessageDialogTS::performAction(Player *player) {
     player->executeMessageDialog(dialogId);
 }
 
-auto MessageDialogTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MessageDialogTS>();
-    return cmd;
-}
-
 MerchantDialogTS::MerchantDialogTS() : BasicClientCommand(C_MERCHANTDIALOG_TS) {}
 
 void MerchantDialogTS::decodeData() {
@@ -127,11 +117,6 @@ void MerchantDialogTS::performAction(Player *player) {
     }
 }
 
-auto MerchantDialogTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MerchantDialogTS>();
-    return cmd;
-}
-
 SelectionDialogTS::SelectionDialogTS() : BasicClientCommand(C_SELECTIONDIALOG_TS) {}
 
 void SelectionDialogTS::decodeData() {
@@ -145,11 +130,6 @@ void SelectionDialogTS::performAction(Player *player) {
     player->executeSelectionDialog(dialogId, success, selectedIndex);
 }
 
-auto SelectionDialogTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<SelectionDialogTS>();
-    return cmd;
-}
-
 CraftingDialogTS::CraftingDialogTS() : BasicClientCommand(C_CRAFTINGDIALOG_TS) {}
 
 void CraftingDialogTS::decodeData() {
@@ -198,11 +178,6 @@ void CraftingDialogTS::performAction(Player *player) {
     }
 }
 
-auto CraftingDialogTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<CraftingDialogTS>();
-    return cmd;
-}
-
 RequestAppearanceTS::RequestAppearanceTS() : BasicClientCommand(C_REQUESTAPPEARANCE_TS) {}
 
 void RequestAppearanceTS::decodeData() { id = getIntFromBuffer(); }
@@ -224,11 +199,6 @@ void RequestAppearanceTS::performAction(Player *player) {
     }
 }
 
-auto RequestAppearanceTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<RequestAppearanceTS>();
-    return cmd;
-}
-
 LookAtCharacterTS::LookAtCharacterTS() : BasicClientCommand(C_LOOKATCHARACTER_TS, P_LOOK_COST) {}
 
 void LookAtCharacterTS::decodeData() {
@@ -284,11 +254,6 @@ void LookAtCharacterTS::performAction(Player *player) {
     }
 }
 
-auto LookAtCharacterTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LookAtCharacterTS>();
-    return cmd;
-}
-
 CastTS::CastTS() : BasicClientCommand(C_CAST_TS) {}
 
 void CastTS::decodeData() {
@@ -560,11 +525,6 @@ void CastTS::performAction(Player *player) {
     }
 }
 
-auto CastTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<CastTS>();
-    return cmd;
-}
-
 UseTS::UseTS() : BasicClientCommand(C_USE_TS, P_MIN_AP) {}
 
 void UseTS::decodeData() {
@@ -828,11 +788,6 @@ void UseTS::performAction(Player *player) {
     World::get()->monitoringClientList->sendCommand(cmd);
 }
 
-auto UseTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<UseTS>();
-    return cmd;
-}
-
 KeepAliveTS::KeepAliveTS() : BasicClientCommand(C_KEEPALIVE_TS) {}
 
 void KeepAliveTS::decodeData() {}
@@ -844,11 +799,6 @@ void KeepAliveTS::performAction(Player *player) {
     player->Connection->addCommand(cmd);
 }
 
-auto KeepAliveTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<KeepAliveTS>();
-    return cmd;
-}
-
 RequestSkillsTS::RequestSkillsTS() : BasicClientCommand(C_REQUESTSKILLS_TS) {}
 
 void RequestSkillsTS::decodeData() {}
@@ -858,11 +808,6 @@ void RequestSkillsTS::performAction(Player *player) {
     player->sendAllSkills();
 }
 
-auto RequestSkillsTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<RequestSkillsTS>();
-    return cmd;
-}
-
 AttackStopTS::AttackStopTS() : BasicClientCommand(C_ATTACKSTOP_TS) {}
 
 void AttackStopTS::decodeData() {}
@@ -875,11 +820,6 @@ void AttackStopTS::performAction(Player *player) {
     player->Connection->addCommand(cmd);
 }
 
-auto AttackStopTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<AttackStopTS>();
-    return cmd;
-}
-
 LookAtInventoryItemTS::LookAtInventoryItemTS() : BasicClientCommand(C_LOOKATINVENTORYITEM_TS, P_LOOK_COST) {}
 
 void LookAtInventoryItemTS::decodeData() { pos = getUnsignedCharFromBuffer(); }
@@ -893,11 +833,6 @@ void LookAtInventoryItemTS::performAction(Player *player) {
     }
 }
 
-auto LookAtInventoryItemTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LookAtInventoryItemTS>();
-    return cmd;
-}
-
 LookAtShowCaseItemTS::LookAtShowCaseItemTS() : BasicClientCommand(C_LOOKATSHOWCASEITEM_TS, P_LOOK_COST) {}
 
 void LookAtShowCaseItemTS::decodeData() {
@@ -914,11 +849,6 @@ void LookAtShowCaseItemTS::performAction(Player *player) {
     }
 }
 
-auto LookAtShowCaseItemTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LookAtShowCaseItemTS>();
-    return cmd;
-}
-
 MoveItemFromPlayerToShowCaseTS::MoveItemFromPlayerToShowCaseTS()
         : BasicClientCommand(C_MOVEITEMFROMPLAYERTOSHOWCASE_TS, P_ITEMMOVE_COST) {}
 
@@ -940,11 +870,6 @@ void MoveItemFromPlayerToShowCaseTS::performAction(Player *player) {
     }
 }
 
-auto MoveItemFromPlayerToShowCaseTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MoveItemFromPlayerToShowCaseTS>();
-    return cmd;
-}
-
 MoveItemFromShowCaseToPlayerTS::MoveItemFromShowCaseToPlayerTS()
         : BasicClientCommand(C_MOVEITEMFROMSHOWCASETOPLAYER_TS, P_ITEMMOVE_COST) {}
 
@@ -966,11 +891,6 @@ void MoveItemFromShowCaseToPlayerTS::performAction(Player *player) {
     }
 }
 
-auto MoveItemFromShowCaseToPlayerTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MoveItemFromShowCaseToPlayerTS>();
-    return cmd;
-}
-
 MoveItemInsideInventoryTS::MoveItemInsideInventoryTS()
         : BasicClientCommand(C_MOVEITEMINSIDEINVENTORY_TS, P_ITEMMOVE_COST) {}
 
@@ -991,11 +911,6 @@ void MoveItemInsideInventoryTS::performAction(Player *player) {
     }
 }
 
-auto MoveItemInsideInventoryTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MoveItemInsideInventoryTS>();
-    return cmd;
-}
-
 DropItemFromInventoryOnMapTS::DropItemFromInventoryOnMapTS()
         : BasicClientCommand(C_DROPITEMFROMPLAYERONMAP_TS, P_ITEMMOVE_COST) {}
 
@@ -1015,11 +930,6 @@ void DropItemFromInventoryOnMapTS::performAction(Player *player) {
     player->increaseActionPoints(-P_ITEMMOVE_COST);
 }
 
-auto DropItemFromInventoryOnMapTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<DropItemFromInventoryOnMapTS>();
-    return cmd;
-}
-
 MoveItemFromMapToPlayerTS::MoveItemFromMapToPlayerTS()
         : BasicClientCommand(C_MOVEITEMFROMMAPTOPLAYER_TS, P_ITEMMOVE_COST) {}
 
@@ -1043,11 +953,6 @@ void MoveItemFromMapToPlayerTS::performAction(Player *player) {
     }
 }
 
-auto MoveItemFromMapToPlayerTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MoveItemFromMapToPlayerTS>();
-    return cmd;
-}
-
 MoveItemFromMapIntoShowCaseTS::MoveItemFromMapIntoShowCaseTS()
         : BasicClientCommand(C_MOVEITEMFROMMAPINTOSHOWCASE_TS, P_ITEMMOVE_COST) {}
 
@@ -1072,11 +977,6 @@ void MoveItemFromMapIntoShowCaseTS::performAction(Player *player) {
     }
 }
 
-auto MoveItemFromMapIntoShowCaseTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MoveItemFromMapIntoShowCaseTS>();
-    return cmd;
-}
-
 MoveItemFromMapToMapTS::MoveItemFromMapToMapTS() : BasicClientCommand(C_MOVEITEMFROMMAPTOMAP_TS, P_ITEMMOVE_COST) {}
 
 void MoveItemFromMapToMapTS::decodeData() {
@@ -1101,11 +1001,6 @@ void MoveItemFromMapToMapTS::performAction(Player *player) {
     }
 }
 
-auto MoveItemFromMapToMapTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MoveItemFromMapToMapTS>();
-    return cmd;
-}
-
 MoveItemBetweenShowCasesTS::MoveItemBetweenShowCasesTS()
         : BasicClientCommand(C_MOVEITEMBETWEENSHOWCASES_TS, P_ITEMMOVE_COST) {}
 
@@ -1128,11 +1023,6 @@ void MoveItemBetweenShowCasesTS::performAction(Player *player) {
     }
 }
 
-auto MoveItemBetweenShowCasesTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<MoveItemBetweenShowCasesTS>();
-    return cmd;
-}
-
 DropItemFromShowCaseOnMapTS::DropItemFromShowCaseOnMapTS()
         : BasicClientCommand(C_DROPITEMFROMSHOWCASEONMAP_TS, P_ITEMMOVE_COST) {}
 
@@ -1153,11 +1043,6 @@ void DropItemFromShowCaseOnMapTS::performAction(Player *player) {
     player->increaseActionPoints(-P_ITEMMOVE_COST);
 }
 
-auto DropItemFromShowCaseOnMapTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<DropItemFromShowCaseOnMapTS>();
-    return cmd;
-}
-
 CloseContainerInShowCaseTS::CloseContainerInShowCaseTS() : BasicClientCommand(C_CLOSECONTAINERINSHOWCASE_TS) {}
 
 void CloseContainerInShowCaseTS::decodeData() { showcase = getUnsignedCharFromBuffer(); }
@@ -1172,11 +1057,6 @@ void CloseContainerInShowCaseTS::performAction(Player *player) {
     }
 }
 
-auto CloseContainerInShowCaseTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<CloseContainerInShowCaseTS>();
-    return cmd;
-}
-
 LookIntoShowCaseContainerTS::LookIntoShowCaseContainerTS()
         : BasicClientCommand(C_LOOKINTOSHOWCASECONTAINER_TS, P_LOOK_COST) {}
 
@@ -1193,11 +1073,6 @@ void LookIntoShowCaseContainerTS::performAction(Player *player) {
     player->increaseActionPoints(-P_LOOK_COST);
 }
 
-auto LookIntoShowCaseContainerTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LookIntoShowCaseContainerTS>();
-    return cmd;
-}
-
 LookIntoInventoryTS::LookIntoInventoryTS() : BasicClientCommand(C_LOOKINTOINVENTORY_TS, P_LOOK_COST) {}
 
 void LookIntoInventoryTS::decodeData() {}
@@ -1210,11 +1085,6 @@ void LookIntoInventoryTS::performAction(Player *player) {
     player->increaseActionPoints(-P_LOOK_COST);
 }
 
-auto LookIntoInventoryTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LookIntoInventoryTS>();
-    return cmd;
-}
-
 LookIntoContainerOnFieldTS::LookIntoContainerOnFieldTS()
         : BasicClientCommand(C_LOOKINTOCONTAINERONFIELD_TS, P_LOOK_COST) {}
 
@@ -1231,11 +1101,6 @@ void LookIntoContainerOnFieldTS::performAction(Player *player) {
     }
 }
 
-auto LookIntoContainerOnFieldTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LookIntoContainerOnFieldTS>();
-    return cmd;
-}
-
 PickUpItemTS::PickUpItemTS() : BasicClientCommand(C_PICKUPITEM_TS, P_ITEMMOVE_COST) {}
 
 void PickUpItemTS::decodeData() {
@@ -1255,11 +1120,6 @@ void PickUpItemTS::performAction(Player *player) {
     }
 }
 
-auto PickUpItemTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<PickUpItemTS>();
-    return cmd;
-}
-
 PickUpAllItemsTS::PickUpAllItemsTS() : BasicClientCommand(C_PICKUPALLITEMS_TS, P_ITEMMOVE_COST) {}
 
 void PickUpAllItemsTS::decodeData() {}
@@ -1275,11 +1135,6 @@ void PickUpAllItemsTS::performAction(Player *player) {
     }
 }
 
-auto PickUpAllItemsTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<PickUpAllItemsTS>();
-    return cmd;
-}
-
 LogOutTS::LogOutTS() : BasicClientCommand(C_LOGOUT_TS) {}
 
 void LogOutTS::decodeData() {}
@@ -1290,11 +1145,6 @@ void LogOutTS::performAction(Player *player) {
     player->Connection->closeConnection();
 }
 
-auto LogOutTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LogOutTS>();
-    return cmd;
-}
-
 WhisperTS::WhisperTS() : BasicClientCommand(C_WHISPER_TS) {}
 
 void WhisperTS::decodeData() { text = getStringFromBuffer(); }
@@ -1305,11 +1155,6 @@ void WhisperTS::performAction(Player *player) {
     player->talk(Character::tt_whisper, text);
 }
 
-auto WhisperTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<WhisperTS>();
-    return cmd;
-}
-
 ShoutTS::ShoutTS() : BasicClientCommand(C_SHOUT_TS) {}
 
 void ShoutTS::decodeData() { text = getStringFromBuffer(); }
@@ -1319,11 +1164,6 @@ void ShoutTS::performAction(Player *player) {
     player->talk(Character::tt_yell, text);
 }
 
-auto ShoutTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<ShoutTS>();
-    return cmd;
-}
-
 SayTS::SayTS() : BasicClientCommand(C_SAY_TS) {}
 
 void SayTS::decodeData() { text = getStringFromBuffer(); }
@@ -1339,11 +1179,6 @@ void SayTS::performAction(Player *player) {
     }
 }
 
-auto SayTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<SayTS>();
-    return cmd;
-}
-
 RefreshTS::RefreshTS() : BasicClientCommand(C_REFRESH_TS) {}
 
 void RefreshTS::decodeData() {}
@@ -1354,11 +1189,6 @@ void RefreshTS::performAction(Player *player) {
     World::get()->sendAllVisibleCharactersToPlayer(player, true);
 }
 
-auto RefreshTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<RefreshTS>();
-    return cmd;
-}
-
 IntroduceTS::IntroduceTS() : BasicClientCommand(C_INTRODUCE_TS) {}
 
 void IntroduceTS::decodeData() {}
@@ -1372,11 +1202,6 @@ void IntroduceTS::performAction(Player *player) {
     }
 }
 
-auto IntroduceTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<IntroduceTS>();
-    return cmd;
-}
-
 CustomNameTS::CustomNameTS() : BasicClientCommand(C_CUSTOMNAME_TS) {}
 
 void CustomNameTS::decodeData() {
@@ -1391,11 +1216,6 @@ void CustomNameTS::performAction(Player *player) {
     player->namePlayer(playerId, playerName);
 }
 
-auto CustomNameTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<CustomNameTS>();
-    return cmd;
-}
-
 AttackPlayerTS::AttackPlayerTS() : BasicClientCommand(C_ATTACKPLAYER_TS) {}
 
 void AttackPlayerTS::decodeData() { enemyid = getIntFromBuffer(); }
@@ -1428,11 +1248,6 @@ void AttackPlayerTS::performAction(Player *player) {
     }
 }
 
-auto AttackPlayerTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<AttackPlayerTS>();
-    return cmd;
-}
-
 LookAtMapItemTS::LookAtMapItemTS() : BasicClientCommand(C_LOOKATMAPITEM_TS, P_LOOK_COST) {}
 
 void LookAtMapItemTS::decodeData() {
@@ -1451,11 +1266,6 @@ void LookAtMapItemTS::performAction(Player *player) {
     }
 }
 
-auto LookAtMapItemTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LookAtMapItemTS>();
-    return cmd;
-}
-
 PlayerSpinTS::PlayerSpinTS() : BasicClientCommand(C_PLAYERSPIN_TS, P_SPIN_COST) {}
 
 void PlayerSpinTS::decodeData() { dir = to_direction(getUnsignedCharFromBuffer()); }
@@ -1468,11 +1278,6 @@ void PlayerSpinTS::performAction(Player *player) {
     player->turn(dir);
 }
 
-auto PlayerSpinTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<PlayerSpinTS>();
-    return cmd;
-}
-
 CharMoveTS::CharMoveTS() : BasicClientCommand(C_CHARMOVE_TS, P_MIN_AP) {}
 
 void CharMoveTS::decodeData() {
@@ -1500,11 +1305,6 @@ void CharMoveTS::performAction(Player *player) {
     }
 }
 
-auto CharMoveTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<CharMoveTS>();
-    return cmd;
-}
-
 LoginCommandTS::LoginCommandTS() : BasicClientCommand(C_LOGIN_TS) {}
 
 void LoginCommandTS::decodeData() {
@@ -1515,11 +1315,6 @@ void LoginCommandTS::decodeData() {
 
 void LoginCommandTS::performAction(Player *player) { time(&(player->lastaction)); }
 
-auto LoginCommandTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<LoginCommandTS>();
-    return cmd;
-}
-
 auto LoginCommandTS::getClientVersion() const -> unsigned short { return clientVersion; }
 
 auto LoginCommandTS::getLoginName() const -> const std::string & { return loginName; }
@@ -1539,8 +1334,3 @@ void ScreenSizeCommandTS::performAction(Player *player) {
     player->sendFullMap();
     player->sendCharacters();
 }
-
-auto ScreenSizeCommandTS::clone() -> ClientCommandPointer {
-    ClientCommandPointer cmd = std::make_shared<ScreenSizeCommandTS>();
-    return cmd;
-}
@@ -82,7 +82,6 @@ public:
     InputDialogTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MessageDialogTS : public BasicClientCommand {
@@ -93,7 +92,6 @@ public:
     MessageDialogTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MerchantDialogTS : public BasicClientCommand {
@@ -112,7 +110,6 @@ public:
     MerchantDialogTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class SelectionDialogTS : public BasicClientCommand {
@@ -125,7 +122,6 @@ public:
     SelectionDialogTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class CraftingDialogTS : public BasicClientCommand {
@@ -140,7 +136,6 @@ public:
     CraftingDialogTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class RequestAppearanceTS : public BasicClientCommand {
@@ -151,7 +146,6 @@ public:
     RequestAppearanceTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LookAtCharacterTS : public BasicClientCommand {
@@ -163,7 +157,6 @@ public:
     LookAtCharacterTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class CastTS : public BasicClientCommand {
@@ -178,7 +171,6 @@ public:
     CastTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class UseTS : public BasicClientCommand {
@@ -192,7 +184,6 @@ public:
     UseTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class KeepAliveTS : public BasicClientCommand {
@@ -200,7 +191,6 @@ public:
     KeepAliveTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class RequestSkillsTS : public BasicClientCommand {
@@ -208,7 +198,6 @@ public:
     RequestSkillsTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class AttackStopTS : public BasicClientCommand {
@@ -216,7 +205,6 @@ public:
     AttackStopTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LookAtInventoryItemTS : public BasicClientCommand {
@@ -227,7 +215,6 @@ public:
     LookAtInventoryItemTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LookAtShowCaseItemTS : public BasicClientCommand {
@@ -239,7 +226,6 @@ public:
     LookAtShowCaseItemTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MoveItemFromPlayerToShowCaseTS : public BasicClientCommand {
@@ -253,7 +239,6 @@ public:
     MoveItemFromPlayerToShowCaseTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MoveItemFromShowCaseToPlayerTS : public BasicClientCommand {
@@ -267,7 +252,6 @@ public:
     MoveItemFromShowCaseToPlayerTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MoveItemInsideInventoryTS : public BasicClientCommand {
@@ -280,7 +264,6 @@ public:
     MoveItemInsideInventoryTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class DropItemFromInventoryOnMapTS : public BasicClientCommand {
@@ -293,7 +276,6 @@ public:
     DropItemFromInventoryOnMapTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MoveItemFromMapToPlayerTS : public BasicClientCommand {
@@ -306,7 +288,6 @@ public:
     MoveItemFromMapToPlayerTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MoveItemFromMapIntoShowCaseTS : public BasicClientCommand {
@@ -320,7 +301,6 @@ public:
     MoveItemFromMapIntoShowCaseTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MoveItemFromMapToMapTS : public BasicClientCommand {
@@ -333,7 +313,6 @@ public:
     MoveItemFromMapToMapTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class MoveItemBetweenShowCasesTS : public BasicClientCommand {
@@ -348,7 +327,6 @@ public:
     MoveItemBetweenShowCasesTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class DropItemFromShowCaseOnMapTS : public BasicClientCommand {
@@ -362,7 +340,6 @@ public:
     DropItemFromShowCaseOnMapTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class CloseContainerInShowCaseTS : public BasicClientCommand {
@@ -373,7 +350,6 @@ public:
     CloseContainerInShowCaseTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LookIntoShowCaseContainerTS : public BasicClientCommand {
@@ -384,7 +360,6 @@ public:
     LookIntoShowCaseContainerTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LookIntoInventoryTS : public BasicClientCommand {
@@ -392,7 +367,6 @@ public:
     LookIntoInventoryTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LookIntoContainerOnFieldTS : public BasicClientCommand {
@@ -403,7 +377,6 @@ public:
     LookIntoContainerOnFieldTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class PickUpItemTS : public BasicClientCommand {
@@ -414,7 +387,6 @@ public:
     PickUpItemTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class PickUpAllItemsTS : public BasicClientCommand {
@@ -422,7 +394,6 @@ public:
     PickUpAllItemsTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LogOutTS : public BasicClientCommand {
@@ -430,7 +401,6 @@ public:
     LogOutTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class WhisperTS : public BasicClientCommand {
@@ -441,7 +411,6 @@ public:
     WhisperTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class ShoutTS : public BasicClientCommand {
@@ -452,7 +421,6 @@ public:
     ShoutTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class SayTS : public BasicClientCommand {
@@ -463,7 +431,6 @@ public:
     SayTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class RefreshTS : public BasicClientCommand {
@@ -471,7 +438,6 @@ public:
     RefreshTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class IntroduceTS : public BasicClientCommand {
@@ -479,7 +445,6 @@ public:
     IntroduceTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class CustomNameTS : public BasicClientCommand {
@@ -491,7 +456,6 @@ public:
     CustomNameTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class AttackPlayerTS : public BasicClientCommand {
@@ -502,7 +466,6 @@ public:
     AttackPlayerTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LookAtMapItemTS : public BasicClientCommand {
@@ -514,7 +477,6 @@ public:
     LookAtMapItemTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class PlayerSpinTS : public BasicClientCommand {
@@ -525,7 +487,6 @@ public:
     PlayerSpinTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class CharMoveTS : public BasicClientCommand {
@@ -538,7 +499,6 @@ public:
     CharMoveTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 class LoginCommandTS : public BasicClientCommand {
@@ -551,7 +511,6 @@ public:
     LoginCommandTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 
     [[nodiscard]] auto getClientVersion() const -> unsigned short;
     [[nodiscard]] auto getLoginName() const -> const std::string &;
@@ -567,7 +526,6 @@ public:
     ScreenSizeCommandTS();
     void decodeData() override;
     void performAction(Player *player) override;
-    auto clone() -> ClientCommandPointer override;
 };
 
 #endif
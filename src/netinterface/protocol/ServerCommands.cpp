@@ -493,39 +493,31 @@ UpdateShowcaseSlotTC::UpdateShowcaseSlotTC(unsigned char showcase, TYPE_OF_CONTA
     }
 }
 
-MapStripeTC::MapStripeTC(const position &pos, NewClientView::stripedirection dir)
+MapStripeTC::MapStripeTC(const NewClientView::StripeRequest &stripe, const NewClientView::EncodedStripe &encoded)
         : BasicServerCommand(SC_MAPSTRIPE_TC) {
-    addShortIntToBuffer(pos.x);
-    addShortIntToBuffer(pos.y);
-    addShortIntToBuffer(pos.z);
-    addUnsignedCharToBuffer(static_cast<unsigned char>(dir));
-    const auto &fields = World::get()->clientview.mapStripe;
-    const uint8_t numberOfTiles = World::get()->clientview.getMaxTiles();
-    addUnsignedCharToBuffer(numberOfTiles);
-
-    ranges::for_each(fields | ranges::view::take(numberOfTiles), [&](const auto &field) {
-        if (field != nullptr) {
-            addShortIntToBuffer(field->getTileCode());
-            addUnsignedCharToBuffer(field->getMovementCost());
-            addShortIntToBuffer(field->getMusicId());
-            addUnsignedCharToBuffer(static_cast<unsigned char>(field->itemCount()));
-
-            for (const auto &item : field->getItemStack()) {
-                addShortIntToBuffer(item.getId());
-
-                if (item.isContainer()) {
-                    addShortIntToBuffer(1);
-                } else {
-                    addShortIntToBuffer(item.getNumber());
-                }
-            }
-        } else {
-            addShortIntToBuffer(-1);
-            addUnsignedCharToBuffer(0);
-            addShortIntToBuffer(0);
-            addUnsignedCharToBuffer(0);
-        }
-    });
+    addShortIntToBuffer(stripe.start.x);
+    addShortIntToBuffer(stripe.start.y);
+    addShortIntToBuffer(stripe.start.z);
+    addUnsignedCharToBuffer(static_cast<unsigned char>(stripe.dir));
+    addUnsignedCharToBuffer(static_cast<uint8_t>(stripe.length));
+    addEncodedToBuffer(encoded.bytes, encoded.checkSum);
+}
+
+MapStripesTC::MapStripesTC(NewClientView::stripeencoding encoding, const NewClientView::StripeRequest *stripes,
+                           const StripeCache::StripePointer *encoded, size_t count)
+        : BasicServerCommand(SC_MAPSTRIPES_TC) {
+    addUnsignedCharToBuffer(static_cast<unsigned char>(encoding));
+    addUnsignedCharToBuffer(static_cast<unsigned char>(count));
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto &stripe = stripes[i];
+        addShortIntToBuffer(stripe.start.x);
+        addShortIntToBuffer(stripe.start.y);
+        addShortIntToBuffer(stripe.start.z);
+        addUnsignedCharToBuffer(static_cast<unsigned char>(stripe.dir));
+        addUnsignedCharToBuffer(static_cast<uint8_t>(stripe.length));
+        addEncodedToBuffer(encoded[i]->bytes, encoded[i]->checkSum);
+    }
 }
 
 MapCompleteTC::MapCompleteTC() : BasicServerCommand(SC_MAPCOMPLETE_TC) {}
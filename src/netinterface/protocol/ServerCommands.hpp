@@ -24,8 +24,10 @@
 #include "Character.hpp"
 #include "Container.hpp"
 #include "NewClientView.hpp"
+#include "StripeCache.hpp"
 #include "netinterface/BasicServerCommand.hpp"
 
+#include <climits>
 #include <vector>
 
 struct WeatherStruct;
@@ -39,6 +41,7 @@ enum ServerCommands {
     SC_SETCOORDINATE_TC = 0xBD,
     SC_MAPSTRIPE_TC = 0xA1,
     SC_MAPCOMPLETE_TC = 0xA2,
+    SC_MAPSTRIPES_TC = 0xA3,
     SC_PLAYERSPIN_TC = 0xE0,
     SC_UPDATEINVENTORYPOS_TC = 0xC1,
     SC_CLEARSHOWCASE_TC = 0xC4,
@@ -285,7 +288,17 @@ public:
 
 class MapStripeTC : public BasicServerCommand {
 public:
-    MapStripeTC(const position &pos, NewClientView::stripedirection dir);
+    MapStripeTC(const NewClientView::StripeRequest &stripe, const NewClientView::EncodedStripe &encoded);
+};
+
+// several map stripes in one command, for clients that announced support for it
+class MapStripesTC : public BasicServerCommand {
+public:
+    static constexpr size_t maxStripes = UCHAR_MAX;
+    static constexpr size_t maxBytes = 0x7FFF;
+
+    MapStripesTC(NewClientView::stripeencoding encoding, const NewClientView::StripeRequest *stripes,
+                 const StripeCache::StripePointer *encoded, size_t count);
 };
 
 class MapCompleteTC : public BasicServerCommand {
@@ -0,0 +1,201 @@
+/*
+ *  illarionserver - server for the game Illarion
+ *  Copyright 2011 Illarion e.V.
+ *
+ *  This file is part of illarionserver.
+ *
+ *  illarionserver is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  illarionserver is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LuaProfiler.hpp"
+
+#include "LuaScript.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+uint64_t LuaProfiler::allocatedBytes = 0;
+
+LuaProfiler::Call::Call(EntrypointStatistics *statistics) {
+    auto &profiler = LuaProfiler::get();
+
+    if (!profiler.profiling || statistics == nullptr) {
+        return;
+    }
+
+    this->statistics = statistics;
+    caller = profiler.currentCall;
+    profiler.currentCall = this;
+    start = std::chrono::steady_clock::now();
+    allocatedBytesAtStart = allocatedBytes;
+
+    // inside another call, the time since the last sample still belongs to the caller's stack
+    if (caller == nullptr) {
+        profiler.lastSample = start;
+    }
+}
+
+LuaProfiler::Call::~Call() {
+    if (statistics == nullptr) {
+        return;
+    }
+
+    const auto duration = std::chrono::steady_clock::now() - start;
+    ++statistics->calls;
+    statistics->totalDuration += duration;
+    statistics->maxDuration = std::max<std::chrono::nanoseconds>(statistics->maxDuration, duration);
+    statistics->allocatedBytes += allocatedBytes - allocatedBytesAtStart;
+    LuaProfiler::get().currentCall = caller;
+}
+
+auto LuaProfiler::get() -> LuaProfiler & {
+    static LuaProfiler profiler;
+    return profiler;
+}
+
+auto LuaProfiler::allocate(void * /*userData*/, void *block, size_t oldSize, size_t newSize) -> void * {
+    if (newSize == 0) {
+        std::free(block);
+        return nullptr;
+    }
+
+    // without a block, the old size tells what kind of object is created
+    if (block == nullptr) {
+        oldSize = 0;
+    }
+
+    if (newSize > oldSize) {
+        allocatedBytes += newSize - oldSize;
+    }
+
+    return std::realloc(block, newSize);
+}
+
+void LuaProfiler::setProfiling(bool enabled) {
+    profiling = enabled;
+    LuaScript::updateHook();
+}
+
+void LuaProfiler::setSampleInterval(int instructions) {
+    sampleInterval = std::max(instructions, 0);
+    instructionsSinceSample = 0;
+    LuaScript::updateHook();
+}
+
+void LuaProfiler::instructionsExecuted(lua_State *luaState, int count) {
+    if (!isSampling()) {
+        return;
+    }
+
+    // the hook may run more often than sampled, when the watchdog needs it to
+    instructionsSinceSample += count;
+
+    if (instructionsSinceSample >= sampleInterval) {
+        instructionsSinceSample = 0;
+        recordSample(luaState);
+    }
+}
+
+auto LuaProfiler::getStatistics(const std::string &script, const std::string &entrypoint) -> EntrypointStatistics * {
+    auto &entry = statistics[script + "." + entrypoint];
+
+    if (entry.entrypoint.empty()) {
+        entry.script = script;
+        entry.entrypoint = entrypoint;
+    }
+
+    return &entry;
+}
+
+auto LuaProfiler::getEntrypointStatistics() const -> std::vector<EntrypointStatistics> {
+    std::vector<EntrypointStatistics> result;
+
+    for (const auto &entry : statistics) {
+        if (entry.second.calls > 0) {
+            result.push_back(entry.second);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) {
+        return a.totalDuration > b.totalDuration;
+    });
+
+    return result;
+}
+
+void LuaProfiler::writeFoldedStacks(std::ostream &out) const {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    for (const auto &stack : stacks) {
+        const auto weight = duration_cast<microseconds>(stack.second).count();
+
+        if (weight > 0) {
+            out << stack.first << ' ' << weight << '\n';
+        }
+    }
+}
+
+void LuaProfiler::resetStatistics() {
+    // entries stay, scripts keep pointers to them
+    for (auto &entry : statistics) {
+        auto &entrypointStatistics = entry.second;
+        entrypointStatistics.calls = 0;
+        entrypointStatistics.totalDuration = {};
+        entrypointStatistics.maxDuration = {};
+        entrypointStatistics.allocatedBytes = 0;
+    }
+
+    stacks.clear();
+    sampleCount = 0;
+}
+
+void LuaProfiler::recordSample(lua_State *luaState) {
+    // Lua that does not run from an entrypoint, like dialog callbacks, is not attributed
+    if (currentCall == nullptr) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto weight = now - lastSample;
+    lastSample = now;
+    ++sampleCount;
+
+    frames.clear();
+    lua_Debug frame;
+
+    for (int level = 0; lua_getstack(luaState, level, &frame) != 0; ++level) {
+        lua_getinfo(luaState, "Sln", &frame);
+        std::string name = frame.short_src;
+
+        if (frame.currentline > 0) {
+            name += ":" + std::to_string(frame.currentline);
+        }
+
+        if (frame.name != nullptr) {
+            name += " (" + std::string(frame.name) + ")";
+        }
+
+        frames.push_back(std::move(name));
+    }
+
+    const auto *entrypoint = currentCall->statistics;
+    std::string stack = entrypoint->script + "." + entrypoint->entrypoint;
+
+    for (auto caller = frames.rbegin(); caller != frames.rend(); ++caller) {
+        stack += ";" + *caller;
+    }
+
+    stacks[stack] += weight;
+}
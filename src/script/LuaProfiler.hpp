@@ -0,0 +1,123 @@
+/*
+ *  illarionserver - server for the game Illarion
+ *  Copyright 2011 Illarion e.V.
+ *
+ *  This file is part of illarionserver.
+ *
+ *  illarionserver is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  illarionserver is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LUA_PROFILER_HPP
+#define LUA_PROFILER_HPP
+
+extern "C" {
+#include <lua.h>
+}
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// what was measured of one entrypoint of one script while profiling was enabled
+struct EntrypointStatistics {
+    std::string script;
+    std::string entrypoint;
+    uint64_t calls = 0;
+    // including the time of entrypoints called from within
+    std::chrono::nanoseconds totalDuration{0};
+    std::chrono::nanoseconds maxDuration{0};
+    // bytes requested from the Lua allocator, memory freed meanwhile is not subtracted
+    uint64_t allocatedBytes = 0;
+};
+
+/**
+ * Measures where the Lua scripts spend their time. While profiling is
+ * enabled, every entrypoint call is accounted to its script and entrypoint.
+ * In addition, the count hook can sample the Lua stack every given number of
+ * instructions. Each sample is weighted with the time since the previous one
+ * and kept as folded stack, the input format of flame graph tools.
+ * Only to be used from the game loop.
+ */
+class LuaProfiler {
+public:
+    // measures an entrypoint call for its lifetime
+    class Call {
+    public:
+        explicit Call(EntrypointStatistics *statistics);
+        ~Call();
+        Call(const Call &) = delete;
+        auto operator=(const Call &) -> Call & = delete;
+        Call(Call &&) = delete;
+        auto operator=(Call &&) -> Call & = delete;
+
+    private:
+        friend class LuaProfiler;
+
+        EntrypointStatistics *statistics = nullptr;
+        Call *caller = nullptr;
+        std::chrono::steady_clock::time_point start;
+        uint64_t allocatedBytesAtStart = 0;
+    };
+
+    LuaProfiler(const LuaProfiler &) = delete;
+    auto operator=(const LuaProfiler &) -> LuaProfiler & = delete;
+    LuaProfiler(LuaProfiler &&) = delete;
+    auto operator=(LuaProfiler &&) -> LuaProfiler & = delete;
+
+    static auto get() -> LuaProfiler &;
+
+    // the allocator of the Lua state, counts all bytes allocated by Lua
+    static auto allocate(void *userData, void *block, size_t oldSize, size_t newSize) -> void *;
+
+    void setProfiling(bool enabled);
+    [[nodiscard]] auto isProfiling() const -> bool { return profiling; }
+    // samples every given number of Lua instructions while profiling, 0 to stop sampling
+    void setSampleInterval(int instructions);
+    [[nodiscard]] auto getSampleInterval() const -> int { return sampleInterval; }
+    [[nodiscard]] auto isSampling() const -> bool { return profiling && sampleInterval > 0; }
+    // called by the count hook
+    void instructionsExecuted(lua_State *luaState, int count);
+
+    // stays valid for the lifetime of the profiler
+    auto getStatistics(const std::string &script, const std::string &entrypoint) -> EntrypointStatistics *;
+    // all called entrypoints, the most expensive first
+    [[nodiscard]] auto getEntrypointStatistics() const -> std::vector<EntrypointStatistics>;
+    [[nodiscard]] auto getSampleCount() const -> uint64_t { return sampleCount; }
+    // one line per stack, "frame;frame;frame microseconds", outermost frame first
+    void writeFoldedStacks(std::ostream &out) const;
+    void resetStatistics();
+
+private:
+    LuaProfiler() = default;
+
+    void recordSample(lua_State *luaState);
+
+    static uint64_t allocatedBytes;
+
+    bool profiling = false;
+    int sampleInterval = 0;
+    int instructionsSinceSample = 0;
+    Call *currentCall = nullptr;
+    std::chrono::steady_clock::time_point lastSample;
+    uint64_t sampleCount = 0;
+    std::unordered_map<std::string, EntrypointStatistics> statistics;
+    std::unordered_map<std::string, std::chrono::nanoseconds> stacks;
+    std::vector<std::string> frames;
+};
+
+#endif
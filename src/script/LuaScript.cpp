@@ -34,6 +34,7 @@ extern "C" {
 #include "data/Data.hpp"
 #include "script/binding/binding.hpp"
 #include "script/forwarder.hpp"
+#include "tuningConstants.hpp"
 
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
@@ -43,6 +44,17 @@ extern "C" {
 
 lua_State *LuaScript::_luaState = nullptr;
 bool LuaScript::initialized = false;
+bool LuaScript::idleCollection = false;
+int LuaScript::heapAfterCollection = 0;
+int LuaScript::lowestHeap = 0;
+int LuaScript::collectorPause = 0;
+LuaScript::GarbageCollectionStatistics LuaScript::garbageCollection;
+uint64_t LuaScript::loadGeneration = 0;
+std::unordered_set<LuaScript::EntrypointCache *> LuaScript::entrypointCaches;
+
+LuaScript::EntrypointCache::EntrypointCache() { entrypointCaches.insert(this); }
+
+LuaScript::EntrypointCache::~EntrypointCache() { entrypointCaches.erase(this); }
 
 LuaScript::LuaScript() { initialize(); }
 
@@ -69,12 +81,22 @@ LuaScript::LuaScript(const std::string &code, const std::string &scriptname) {
 
     lua_setfield(_luaState, -2, _filename.c_str());
     lua_pop(_luaState, 1);
+    invalidateEntrypoints();
 }
 
 void LuaScript::initialize() {
     if (!initialized) {
         initialized = true;
-        _luaState = luaL_newstate();
+        _luaState = lua_newstate(LuaProfiler::allocate, nullptr);
+        lua_atpanic(_luaState, panic);
+        LuaWatchdog::get().setBudget(Config::instance().lua_instruction_budget,
+                                     std::chrono::milliseconds(Config::instance().lua_time_budget));
+        updateHook();
+        collectorPause = Config::instance().lua_gc_pause;
+        lua_gc(_luaState, LUA_GCSETPAUSE, collectorPause);
+        lua_gc(_luaState, LUA_GCSETSTEPMUL, Config::instance().lua_gc_stepmul);
+        idleCollection = false;
+        heapAfterCollection = 0;
         luabind::open(_luaState);
 
         // use another error function to surpress errors from
@@ -95,6 +117,107 @@ void LuaScript::initialize() {
     }
 }
 
+auto LuaScript::panic(lua_State *L) -> int {
+    const char *message = lua_tostring(L, -1);
+    Logger::alert(LogFacility::Script) << "Unprotected error in Lua: " << (message != nullptr ? message : "unknown")
+                                       << Log::end;
+    return 0;
+}
+
+void LuaScript::updateHook() {
+    if (_luaState == nullptr) {
+        return;
+    }
+
+    const auto &profiler = LuaProfiler::get();
+    int hookInterval = 0;
+
+    if (profiler.isSampling()) {
+        hookInterval = profiler.getSampleInterval();
+    }
+
+    if (LuaWatchdog::get().isEnabled()) {
+        hookInterval = hookInterval == 0 ? luaWatchdogCheckInterval : std::min(hookInterval, luaWatchdogCheckInterval);
+    }
+
+    if (hookInterval > 0) {
+        lua_sethook(_luaState, countHook, LUA_MASKCOUNT, hookInterval);
+    } else {
+        lua_sethook(_luaState, nullptr, 0, 0);
+    }
+}
+
+// the watchdog may raise a Lua error, so nothing here may need a destructor
+void LuaScript::countHook(lua_State *L, lua_Debug *debug) {
+    if (debug->event == LUA_HOOKCOUNT) {
+        // not the configured interval, the watchdog shortens it for a thread that ran over budget
+        const int count = lua_gethookcount(L);
+        LuaProfiler::get().instructionsExecuted(L, count);
+        LuaWatchdog::get().instructionsExecuted(L, count);
+    }
+}
+
+void LuaScript::collectGarbage(std::chrono::nanoseconds budget) {
+    if (!initialized || budget <= std::chrono::nanoseconds::zero()) {
+        return;
+    }
+
+    int heap = lua_gc(_luaState, LUA_GCCOUNT, 0);
+
+    // calls only add to the heap, unless the automatic collector finished the cycle during one of them
+    if (idleCollection && heap < lowestHeap) {
+        idleCollection = false;
+        heapAfterCollection = heap;
+    }
+
+    // start halfway to where the automatic collector would, so that it rarely gets to run during a call
+    if (!idleCollection) {
+        const int threshold = heapAfterCollection + heapAfterCollection * (collectorPause - 100) / 200;
+
+        if (heap < threshold) {
+            return;
+        }
+
+        idleCollection = true;
+        lowestHeap = heap;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + budget;
+    auto now = start;
+
+    do {
+        ++garbageCollection.steps;
+        const bool finished = lua_gc(_luaState, LUA_GCSTEP, 0) != 0;
+        heap = lua_gc(_luaState, LUA_GCCOUNT, 0);
+        lowestHeap = std::min(lowestHeap, heap);
+
+        if (finished) {
+            idleCollection = false;
+            heapAfterCollection = heap;
+            ++garbageCollection.cycles;
+        }
+
+        now = std::chrono::steady_clock::now();
+    } while (idleCollection && now < deadline);
+
+    const auto duration = now - start;
+    garbageCollection.duration += duration;
+    garbageCollection.maxDuration = std::max<std::chrono::nanoseconds>(garbageCollection.maxDuration, duration);
+}
+
+auto LuaScript::getGarbageCollectionStatistics() -> GarbageCollectionStatistics {
+    auto statistics = garbageCollection;
+
+    if (initialized) {
+        constexpr uint64_t kilobyte = 1024;
+        statistics.heapBytes = uint64_t(lua_gc(_luaState, LUA_GCCOUNT, 0)) * kilobyte +
+                               uint64_t(lua_gc(_luaState, LUA_GCCOUNTB, 0));
+    }
+
+    return statistics;
+}
+
 void LuaScript::loadIntoLuaState() {
     luaL_getsubtable(_luaState, LUA_REGISTRYINDEX, "_LOADED");
 
@@ -114,6 +237,7 @@ void LuaScript::loadIntoLuaState() {
 
     lua_setfield(_luaState, -2, _filename.c_str());
     lua_pop(_luaState, 1);
+    invalidateEntrypoints();
 }
 
 void LuaScript::handleLuaLoadError(int errorCode) {
@@ -163,6 +287,13 @@ void LuaScript::shutdownLua() {
 
     if (initialized) {
         initialized = false;
+
+        // their references die with the state
+        for (auto *cache : entrypointCaches) {
+            cache->functions.clear();
+        }
+
+        invalidateEntrypoints();
         lua_close(_luaState);
         _luaState = nullptr;
     }
@@ -258,21 +389,42 @@ void LuaScript::writeDeprecatedMsg(const std::string &deprecatedEntity) {
     }
 }
 
-auto LuaScript::buildEntrypoint(const std::string &entrypoint) -> luabind::object {
-    luabind::object obj = luabind::registry(_luaState);
-    obj = obj["_LOADED"][_filename];
+// nullptr if the script does not provide the entrypoint
+auto LuaScript::getEntrypoint(const std::string &entrypoint) const -> const Entrypoint * {
+    auto &functions = entrypoints->functions;
+
+    if (entrypoints->generation != loadGeneration) {
+        functions.clear();
+        entrypoints->generation = loadGeneration;
+    }
+
+    auto function = functions.find(entrypoint);
+
+    if (function == functions.end()) {
+        luabind::object obj = luabind::registry(_luaState);
+        obj = obj["_LOADED"][_filename];
 
-    if (luabind::type(obj) != LUA_TTABLE) {
-        triggerScriptError("Error while loading entrypoint '" + entrypoint + "' from module " + _filename +
-                           ". Check if the script returns its module as table.");
+        // not cached, a module that is not there yet may still be loaded
+        if (luabind::type(obj) != LUA_TTABLE) {
+            triggerScriptError("Error while loading entrypoint '" + entrypoint + "' from module " + _filename +
+                               ". Check if the script returns its module as table.");
+        }
+
+        const Entrypoint resolved{obj[entrypoint], LuaProfiler::get().getStatistics(_filename, entrypoint)};
+        function = functions.emplace(entrypoint, resolved).first;
+    }
+
+    if (luabind::type(function->second.function) == LUA_TNIL) {
+        return nullptr;
     }
 
-    luabind::object callee = obj[entrypoint];
-    return callee;
+    return &function->second;
 }
 
+void LuaScript::invalidateEntrypoints() { ++loadGeneration; }
+
 void LuaScript::addQuestScript(const std::string &entrypoint, const std::shared_ptr<LuaScript> &script) {
-    questScripts.insert(std::pair<const std::string, std::shared_ptr<LuaScript>>(entrypoint, script));
+    questScripts[entrypoint].push_back(script);
 }
 
 void LuaScript::setCurrentWorldScript() { World::get()->setCurrentScript(this); }
@@ -282,16 +434,17 @@ auto LuaScript::existsQuestEntrypoint(const std::string &entrypoint) const -> bo
 }
 
 auto LuaScript::existsEntrypoint(const std::string &entrypoint) const -> bool {
-    luabind::object obj = luabind::registry(_luaState);
-    obj = obj["_LOADED"][_filename];
+    const Entrypoint *function = nullptr;
 
-    if (luabind::type(obj) != LUA_TTABLE) {
+    try {
+        function = getEntrypoint(entrypoint);
+    } catch (luabind::error &) {
+        // the module is no table, drop the message pushed by triggerScriptError
+        lua_pop(_luaState, 1);
         return existsQuestEntrypoint(entrypoint);
     }
 
-    obj = obj[entrypoint];
-
-    if (luabind::type(obj) != LUA_TFUNCTION) {
+    if (function == nullptr || luabind::type(function->function) != LUA_TFUNCTION) {
         return existsQuestEntrypoint(entrypoint);
     }
 
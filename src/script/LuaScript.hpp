@@ -27,13 +27,19 @@ extern "C" {
 
 #include "Item.hpp"
 #include "Logger.hpp"
+#include "LuaProfiler.hpp"
+#include "LuaWatchdog.hpp"
 #include "character_ptr.hpp"
 #include "globals.hpp"
 
+#include <chrono>
 #include <luabind/luabind.hpp>
 #include <luabind/object.hpp>
-#include <map>
+#include <memory>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 class Character;
 class World;
@@ -68,6 +74,15 @@ struct SouTar {
 
 class LuaScript {
 public:
+    // what the collector did in idle time, besides the work Lua does on its own during calls
+    struct GarbageCollectionStatistics {
+        uint64_t heapBytes = 0;
+        uint64_t cycles = 0;
+        uint64_t steps = 0;
+        std::chrono::nanoseconds duration{0};
+        std::chrono::nanoseconds maxDuration{0};
+    };
+
     LuaScript();
     explicit LuaScript(std::string filename);
     LuaScript(const std::string &code, const std::string &scriptname);
@@ -82,6 +97,11 @@ public:
     static auto getLuaState() -> lua_State * { return _luaState; }
 
     static void shutdownLua();
+    // installs the count hook if the profiler or the watchdog needs it
+    static void updateHook();
+    // advances the incremental collector for about the given time, once the heap grew enough since the last cycle
+    static void collectGarbage(std::chrono::nanoseconds budget);
+    [[nodiscard]] static auto getGarbageCollectionStatistics() -> GarbageCollectionStatistics;
     [[nodiscard]] auto existsEntrypoint(const std::string &entrypoint) const -> bool;
     void addQuestScript(const std::string &entrypoint, const std::shared_ptr<LuaScript> &script);
 
@@ -132,6 +152,13 @@ public:
 protected:
     static lua_State *_luaState;
     static bool initialized;
+    // a cycle was started in idle time and is not finished yet
+    static bool idleCollection;
+    static int heapAfterCollection;
+    // smallest heap seen while stepping the current idle cycle, in KB
+    static int lowestHeap;
+    static int collectorPause;
+    static GarbageCollectionStatistics garbageCollection;
 
     template <typename... Args> void callEntrypoint(const std::string &entrypoint, const Args &...args) {
         setCurrentWorldScript();
@@ -154,36 +181,64 @@ private:
     void handleLuaCallError(int errorCode);
     static void init_base_functions();
     static auto add_backtrace(lua_State *L) -> int;
+    static auto panic(lua_State *L) -> int;
+    static void countHook(lua_State *L, lua_Debug *debug);
     static void writeErrorMsg();
     void writeCastErrorMsg(const std::string &entryPoint, const luabind::cast_failed &e) const;
     void setCurrentWorldScript();
-    auto buildEntrypoint(const std::string &entrypoint) -> luabind::object;
+    struct Entrypoint {
+        luabind::object function; // nil if the module does not have the entrypoint
+        EntrypointStatistics *statistics;
+    };
+
+    auto getEntrypoint(const std::string &entrypoint) const -> const Entrypoint *;
     [[nodiscard]] auto existsQuestEntrypoint(const std::string &entrypoint) const -> bool;
 
     template <typename... Args> auto callQuestEntrypoint(const std::string &entrypoint, const Args &...args) -> bool {
-        auto entrypointRange = questScripts.equal_range(entrypoint);
+        // most scripts are not overridden by any quest
+        if (questScripts.empty()) {
+            return false;
+        }
+
+        const auto quests = questScripts.find(entrypoint);
+
+        if (quests == questScripts.end()) {
+            return false;
+        }
+
         bool foundQuest = false;
 
-        for (auto it = entrypointRange.first; it != entrypointRange.second; ++it) {
-            foundQuest = foundQuest || it->second->safeCall<bool>(entrypoint, args...);
+        for (const auto &quest : quests->second) {
+            foundQuest = foundQuest || quest->safeCall<bool>(entrypoint, args...);
         }
 
         return foundQuest;
     }
 
+    // the function is only needed until it is pushed, so an invalidation by the call itself does no harm
     template <typename... Args> void safeCall(const std::string &entrypoint, const Args &...args) {
         try {
-            auto luaEntrypoint = buildEntrypoint(entrypoint);
-            luaEntrypoint(args...);
+            const Entrypoint *luaEntrypoint = getEntrypoint(entrypoint);
+
+            if (luaEntrypoint != nullptr) {
+                LuaProfiler::Call call(luaEntrypoint->statistics);
+                LuaWatchdog::Call guard(_filename, entrypoint);
+                luaEntrypoint->function(args...);
+            }
         } catch (const luabind::error &e) {
             writeErrorMsg();
         }
     }
     template <typename T, typename... Args> auto safeCall(const std::string &entrypoint, const Args &...args) -> T {
         try {
-            auto luaEntrypoint = buildEntrypoint(entrypoint);
-            auto result = luaEntrypoint(args...);
-            return luabind::object_cast<T>(result);
+            const Entrypoint *luaEntrypoint = getEntrypoint(entrypoint);
+
+            if (luaEntrypoint != nullptr) {
+                LuaProfiler::Call call(luaEntrypoint->statistics);
+                LuaWatchdog::Call guard(_filename, entrypoint);
+                auto result = luaEntrypoint->function(args...);
+                return luabind::object_cast<T>(result);
+            }
         } catch (luabind::cast_failed &e) {
             writeCastErrorMsg(entrypoint, e);
         } catch (luabind::error &e) {
@@ -193,9 +248,33 @@ private:
         return T();
     }
 
+    /**
+     * The functions of the module, looked up once by name. Whenever a module
+     * is loaded into the Lua state, modules of the same name may have been
+     * replaced, so all caches start over. They hold references into the Lua
+     * state and are emptied before it is closed.
+     */
+    struct EntrypointCache {
+        EntrypointCache();
+        ~EntrypointCache();
+        EntrypointCache(const EntrypointCache &) = delete;
+        auto operator=(const EntrypointCache &) -> EntrypointCache & = delete;
+        EntrypointCache(EntrypointCache &&) = delete;
+        auto operator=(EntrypointCache &&) -> EntrypointCache & = delete;
+
+        std::unordered_map<std::string, Entrypoint> functions;
+        uint64_t generation = 0;
+    };
+
+    static void invalidateEntrypoints();
+
+    static uint64_t loadGeneration;
+    static std::unordered_set<EntrypointCache *> entrypointCaches;
+
     std::string _filename{};
     std::string luafile{};
-    using QuestScripts = std::multimap<const std::string, std::shared_ptr<LuaScript>>;
+    std::unique_ptr<EntrypointCache> entrypoints = std::make_unique<EntrypointCache>();
+    using QuestScripts = std::unordered_map<std::string, std::vector<std::shared_ptr<LuaScript>>>;
     QuestScripts questScripts;
 };
 
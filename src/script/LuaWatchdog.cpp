@@ -0,0 +1,110 @@
+/*
+ *  illarionserver - server for the game Illarion
+ *  Copyright 2011 Illarion e.V.
+ *
+ *  This file is part of illarionserver.
+ *
+ *  illarionserver is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  illarionserver is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LuaWatchdog.hpp"
+
+#include "Logger.hpp"
+#include "LuaScript.hpp"
+
+#include <algorithm>
+
+LuaWatchdog::Call::Call(const std::string &script, const std::string &entrypoint) {
+    auto &watchdog = LuaWatchdog::get();
+
+    if (!watchdog.isEnabled()) {
+        return;
+    }
+
+    this->script = &script;
+    this->entrypoint = &entrypoint;
+    caller = watchdog.currentCall;
+    watchdog.currentCall = this;
+    instructionsAtStart = watchdog.instructions;
+    start = std::chrono::steady_clock::now();
+}
+
+LuaWatchdog::Call::~Call() {
+    if (script != nullptr) {
+        LuaWatchdog::get().currentCall = caller;
+
+        if (overrun) {
+            LuaScript::updateHook();
+        }
+    }
+}
+
+auto LuaWatchdog::get() -> LuaWatchdog & {
+    static LuaWatchdog watchdog;
+    return watchdog;
+}
+
+void LuaWatchdog::setBudget(uint64_t instructions, std::chrono::milliseconds time) {
+    instructionBudget = instructions;
+    timeBudget = std::max(time, std::chrono::milliseconds::zero());
+    LuaScript::updateHook();
+}
+
+// lua_error does not return, so nothing here may need a destructor
+void LuaWatchdog::instructionsExecuted(lua_State *luaState, int count) {
+    instructions += count;
+
+    if (isOverBudget(luaState)) {
+        lua_error(luaState);
+    }
+}
+
+auto LuaWatchdog::isOverBudget(lua_State *luaState) -> bool {
+    if (currentCall == nullptr) {
+        return false;
+    }
+
+    auto &call = *currentCall;
+
+    if (!call.overrun) {
+        const auto executed = instructions - call.instructionsAtStart;
+        const auto elapsed =
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - call.start);
+
+        if ((instructionBudget == 0 || executed <= instructionBudget) &&
+            (timeBudget.count() == 0 || elapsed <= timeBudget)) {
+            return false;
+        }
+
+        call.overrun = true;
+        const auto aborted = ++overruns[*call.script];
+        Logger::error(LogFacility::Script) << "Aborting " << *call.script << "." << *call.entrypoint << " after "
+                                           << executed << " instructions and " << elapsed.count()
+                                           << "ms, it is over budget (" << aborted << " aborted calls of "
+                                           << *call.script << " so far)" << Log::end;
+    }
+
+    // scripts may catch the error, so it is raised at every instruction until the call returns
+    lua_sethook(luaState, lua_gethook(luaState), LUA_MASKCOUNT, 1);
+    lua_pushstring(luaState, ("Lua budget exceeded in " + *call.script + "." + *call.entrypoint).c_str());
+    return true;
+}
+
+auto LuaWatchdog::getOverruns() const -> std::vector<std::pair<std::string, uint64_t>> {
+    std::vector<std::pair<std::string, uint64_t>> result(overruns.begin(), overruns.end());
+
+    std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) { return a.second > b.second; });
+
+    return result;
+}
@@ -0,0 +1,100 @@
+/*
+ *  illarionserver - server for the game Illarion
+ *  Copyright 2011 Illarion e.V.
+ *
+ *  This file is part of illarionserver.
+ *
+ *  illarionserver is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  illarionserver is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with illarionserver.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LUA_WATCHDOG_HPP
+#define LUA_WATCHDOG_HPP
+
+extern "C" {
+#include <lua.h>
+}
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Keeps a runaway script from freezing the game loop. Every entrypoint call
+ * gets a budget of Lua instructions and of time. The count hook checks the
+ * innermost running call and aborts it with a Lua error once it is over
+ * budget, the error unwinds to the pcall of that call. Calls made from within
+ * another call have budgets of their own, the instructions and time of such a
+ * call count towards its caller as well.
+ * Only to be used from the game loop.
+ */
+class LuaWatchdog {
+public:
+    // guards an entrypoint call for its lifetime, script and entrypoint have to outlive it
+    class Call {
+    public:
+        Call(const std::string &script, const std::string &entrypoint);
+        ~Call();
+        Call(const Call &) = delete;
+        auto operator=(const Call &) -> Call & = delete;
+        Call(Call &&) = delete;
+        auto operator=(Call &&) -> Call & = delete;
+
+    private:
+        friend class LuaWatchdog;
+
+        const std::string *script = nullptr;
+        const std::string *entrypoint = nullptr;
+        Call *caller = nullptr;
+        uint64_t instructionsAtStart = 0;
+        std::chrono::steady_clock::time_point start;
+        bool overrun = false;
+    };
+
+    LuaWatchdog(const LuaWatchdog &) = delete;
+    auto operator=(const LuaWatchdog &) -> LuaWatchdog & = delete;
+    LuaWatchdog(LuaWatchdog &&) = delete;
+    auto operator=(LuaWatchdog &&) -> LuaWatchdog & = delete;
+
+    static auto get() -> LuaWatchdog &;
+
+    // 0 for no limit
+    void setBudget(uint64_t instructions, std::chrono::milliseconds time);
+    [[nodiscard]] auto getInstructionBudget() const -> uint64_t { return instructionBudget; }
+    [[nodiscard]] auto getTimeBudget() const -> std::chrono::milliseconds { return timeBudget; }
+    [[nodiscard]] auto isEnabled() const -> bool { return instructionBudget > 0 || timeBudget.count() > 0; }
+
+    // called by the count hook, does not return if the running call is over budget
+    void instructionsExecuted(lua_State *luaState, int count);
+
+    // aborted calls per script, the most often aborted first
+    [[nodiscard]] auto getOverruns() const -> std::vector<std::pair<std::string, uint64_t>>;
+    void resetOverruns() { overruns.clear(); }
+
+private:
+    LuaWatchdog() = default;
+
+    // pushes the error message if the running call is over budget
+    auto isOverBudget(lua_State *luaState) -> bool;
+
+    uint64_t instructions = 0;
+    uint64_t instructionBudget = 0;
+    std::chrono::milliseconds timeBudget{0};
+    Call *currentCall = nullptr;
+    std::unordered_map<std::string, uint64_t> overruns;
+};
+
+#endif
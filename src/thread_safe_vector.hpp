@@ -20,6 +20,7 @@
 #define THREAD_SAFE_VECTOR_HPP
 
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <exception>
 #include <iostream>
@@ -31,8 +32,7 @@ template <class T> class thread_safe_vector : public std::list<T> {
 public:
     inline auto size() -> size_t {
         std::lock_guard<std::mutex> lock(vlock);
-        uint16_t s = std::list<T>::size();
-        return s;
+        return std::list<T>::size();
     }
 
     inline void clear() {
@@ -41,8 +41,12 @@ public:
     }
 
     inline void push_back(const T &item) {
-        std::lock_guard<std::mutex> lock(vlock);
-        std::list<T>::push_back(item);
+        {
+            std::lock_guard<std::mutex> lock(vlock);
+            std::list<T>::push_back(item);
+        }
+
+        itemAdded.notify_one();
     }
 
     inline auto empty() -> bool {
@@ -57,8 +61,23 @@ public:
         return item;
     }
 
+    // waits until an item is available or the timeout passed, returns false on timeout
+    template <class Rep, class Period>
+    inline auto wait_pop_front(T &item, const std::chrono::duration<Rep, Period> &timeout) -> bool {
+        std::unique_lock<std::mutex> lock(vlock);
+
+        if (!itemAdded.wait_for(lock, timeout, [this] { return !std::list<T>::empty(); })) {
+            return false;
+        }
+
+        item = std::list<T>::front();
+        std::list<T>::pop_front();
+        return true;
+    }
+
 private:
     std::mutex vlock;
+    std::condition_variable itemAdded;
 };
 
 #endif
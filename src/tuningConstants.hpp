@@ -31,12 +31,39 @@ constexpr auto scheduledScriptsInterval = 1s;
 constexpr auto wearReductionInterval = 3min;
 constexpr auto gameLoopInterval = 100ms;
 constexpr auto ingameTimeUpdateInterval = 8h;
+constexpr auto stripeCacheReportInterval = 10min;
+constexpr auto databasePoolReportInterval = 10min;
+constexpr auto persistenceQueueReportInterval = 10min;
+constexpr auto schedulerReportInterval = 10min;
+constexpr auto luaHeapReportInterval = 10min;
+
+// Lua instructions between two checks of the budget of the running entrypoint call
+constexpr auto luaWatchdogCheckInterval = 1000;
+
+// spawn times of spawnpoints are given in cycles of this length
+constexpr auto spawnCycleInterval = 1min;
 
 constexpr auto CLIENT_TIMEOUT = 50;
 
+// threads besides the main thread that build map stripes for logins and warps
+constexpr auto maxMapViewWorkers = 4;
+
+// threads writing saves of logged out players to the database
+constexpr auto playerSaveWorkers = 4;
+
+// threads checking logins and loading the characters from the database
+constexpr auto playerLoadWorkers = 4;
+
 // how many players to process each turn (maximum)
 constexpr auto MAXPLAYERSPROCESSED = 5;
 
+// bounded queues from the network and login threads to the game loop, commands
+// beyond the per player limit are dropped, players beyond the immediate limit
+// wait for the next turn
+constexpr auto playerCommandQueueSize = 256;
+constexpr auto immediatePlayerQueueSize = 4096;
+constexpr auto loggedInPlayerQueueSize = 256;
+
 constexpr auto MIN_AP_UPDATE = 100;
 
 constexpr auto P_MIN_AP = 7;
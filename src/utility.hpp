@@ -25,10 +25,4 @@ extern auto mypred(char c1, char c2) -> bool;
 extern auto comparestrings_nocase(const std::string &s1, const std::string &s2) -> bool;
 extern auto to_direction(uint8_t dir) -> direction;
 
-template <class T> struct iterator_range {
-    [[nodiscard]] auto begin() const -> T { return p.first; }
-    [[nodiscard]] auto end() const -> T { return p.second; }
-    std::pair<T, T> p;
-};
-
 #endif
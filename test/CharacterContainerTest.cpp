@@ -3,7 +3,13 @@
 #include "World.hpp"
 #include "Character.hpp"
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <random>
+
 using ::testing::AtLeast;
+using ::testing::NiceMock;
 using ::testing::Return;
 using ::testing::ReturnRef;
 
@@ -74,6 +80,117 @@ TEST_F(CharacterContainerTest, update) {
     EXPECT_EQ(1, container.size());
 }
 
+class CharacterContainerRangeTest : public ::testing::Test {
+public:
+    MockWorld world;
+    std::deque<position> positions;
+    std::deque<std::unique_ptr<NiceMock<MockCharacter>>> characters;
+    CharacterContainer<Character> container;
+
+    auto add(const position &where) -> MockCharacter & {
+        positions.push_back(where);
+        characters.push_back(std::make_unique<NiceMock<MockCharacter>>());
+        auto &character = *characters.back();
+        ON_CALL(character, getId()).WillByDefault(Return(characters.size()));
+        ON_CALL(character, getPosition()).WillByDefault(ReturnRef(positions.back()));
+        container.insert(&character);
+        return character;
+    }
+
+    void move(MockCharacter &character, const position &to) {
+        container.update(&character, to);
+        positions[character.getId() - 1] = to;
+    }
+
+    auto bruteForce(const position &pos, const Range &range) -> std::vector<Character *> {
+        std::vector<Character *> result;
+
+        for (const auto &character : characters) {
+            const auto &p = positions[character->getId() - 1];
+
+            if (container.find(character->getId()) != nullptr && std::abs(p.x - pos.x) <= range.radius &&
+                std::abs(p.y - pos.y) <= range.radius && std::abs(p.z - pos.z) <= range.zRadius) {
+                result.push_back(character.get());
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    auto query(const position &pos, const Range &range) -> std::vector<Character *> {
+        auto result = container.findAllCharactersInRangeOf(pos, range);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+TEST_F(CharacterContainerRangeTest, rangeQueriesMatchBruteForce) {
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<Coordinate> coordinate(-150, 150);
+    std::uniform_int_distribution<Coordinate> level(-3, 3);
+
+    for (int i = 0; i < 300; ++i) {
+        add(position(coordinate(generator), coordinate(generator), level(generator)));
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        const position pos(coordinate(generator), coordinate(generator), level(generator));
+        const Range range{Coordinate(i % 40), Coordinate(i % 3)};
+        EXPECT_EQ(bruteForce(pos, range), query(pos, range));
+    }
+}
+
+TEST_F(CharacterContainerRangeTest, forEachVisitsTheSameCharacters) {
+    for (Coordinate x = -40; x <= 40; x += 7) {
+        add(position(x, x / 2, 0));
+    }
+
+    const position pos(3, -1, 0);
+    const Range range{25, 0};
+    std::vector<Character *> visited;
+    container.forEachCharacterInRangeOf(pos, range, [&visited](Character *c) { visited.push_back(c); });
+    std::sort(visited.begin(), visited.end());
+
+    EXPECT_FALSE(visited.empty());
+    EXPECT_EQ(query(pos, range), visited);
+}
+
+TEST_F(CharacterContainerRangeTest, updateAcrossCells) {
+    const position start(31, 31, 0);
+    const position across(32, 64, 0);
+    auto &character = add(start);
+
+    move(character, across);
+
+    EXPECT_EQ(nullptr, container.find(start));
+    EXPECT_EQ(&character, container.find(across));
+    EXPECT_TRUE(query(start, Range{10, 0}).empty());
+    EXPECT_EQ(1, query(across, Range{0, 0}).size());
+
+    move(character, position(33, 65, 0));
+    EXPECT_EQ(&character, container.find(position(33, 65, 0)));
+    EXPECT_EQ(nullptr, container.find(across));
+}
+
+TEST_F(CharacterContainerRangeTest, negativeCoordinates) {
+    auto &character = add(position(-1, -1, -2));
+    add(position(0, 0, -2));
+
+    EXPECT_EQ(&character, container.find(position(-1, -1, -2)));
+    EXPECT_EQ(2, query(position(-1, 0, -2), Range{1, 0}).size());
+    EXPECT_EQ(1, query(position(-33, -33, -2), Range{32, 0}).size());
+}
+
+TEST_F(CharacterContainerRangeTest, erase) {
+    auto &character = add(position(5, 5, 0));
+    add(position(6, 5, 0));
+
+    EXPECT_TRUE(container.erase(character.getId()));
+    EXPECT_FALSE(container.erase(character.getId()));
+    EXPECT_EQ(nullptr, container.find(position(5, 5, 0)));
+    EXPECT_EQ(1, query(position(5, 5, 0), Range{3, 0}).size());
+}
 
 auto main(int argc, char **argv) -> int {
     ::testing::InitGoogleTest(&argc, argv);
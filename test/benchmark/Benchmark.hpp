@@ -0,0 +1,35 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Minimal timing helper for the micro benchmarks. Every benchmark prints one
+// line with the average cost per operation, so before/after runs can be
+// compared directly.
+template <typename Operation> auto measure(const std::string &name, uint64_t iterations, Operation &&operation) {
+    using std::chrono::duration;
+    using std::chrono::steady_clock;
+
+    const auto start = steady_clock::now();
+
+    for (uint64_t i = 0; i < iterations; ++i) {
+        operation(i);
+    }
+
+    const duration<double, std::nano> elapsed = steady_clock::now() - start;
+    const auto perOperation = elapsed.count() / double(iterations);
+
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(1) << perOperation << " ns/op" << std::endl;
+
+    return perOperation;
+}
+
+// keeps the optimiser from discarding results that are otherwise unused
+template <typename T> void doNotOptimise(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+#endif
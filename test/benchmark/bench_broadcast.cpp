@@ -0,0 +1,94 @@
+#include "Benchmark.hpp"
+#include "netinterface/CommandBufferPool.hpp"
+#include "netinterface/protocol/ServerCommands.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <new>
+#include <vector>
+
+// counts every heap allocation of the process
+std::atomic<uint64_t> allocations = 0;
+
+auto operator new(size_t size) -> void * {
+    ++allocations;
+
+    if (void *memory = std::malloc(size)) {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t /*size*/) noexcept { std::free(memory); }
+
+constexpr auto viewers = 100;
+constexpr auto broadcasts = 100'000;
+
+// stands in for the send queues of the viewers, emptied after each broadcast like a write would
+std::vector<std::deque<ServerCommandPointer>> sendQueues(viewers);
+
+void write() {
+    for (auto &queue : sendQueues) {
+        queue.clear();
+    }
+}
+
+template <typename Build> void broadcast(const std::string &name, Build &&build) {
+    // warm up the queues and the buffer pool, so that only steady state is counted
+    for (int i = 0; i < 10; ++i) {
+        for (auto &queue : sendQueues) {
+            queue.push_back(build());
+        }
+
+        write();
+    }
+
+    const uint64_t before = allocations;
+
+    measure(name + ", per viewer", broadcasts / viewers, [&](uint64_t i) {
+        for (auto &queue : sendQueues) {
+            ServerCommandPointer cmd = build();
+            cmd->freeze();
+            queue.push_back(cmd);
+        }
+
+        write();
+    });
+
+    const uint64_t perViewer = allocations - before;
+
+    measure(name + ", encoded once", broadcasts / viewers, [&](uint64_t i) {
+        ServerCommandPointer cmd = build();
+        cmd->freeze();
+
+        for (auto &queue : sendQueues) {
+            queue.push_back(cmd);
+        }
+
+        write();
+    });
+
+    const uint64_t encodedOnce = allocations - before - perViewer;
+
+    std::cout << "  allocations per broadcast to " << viewers << " viewers: "
+              << double(perViewer) / (broadcasts / viewers) << " per viewer, "
+              << double(encodedOnce) / (broadcasts / viewers) << " encoded once" << std::endl;
+}
+
+auto main() -> int {
+    const position pos(10, 20, 0);
+
+    broadcast("MoveAckTC", [&pos] { return std::make_shared<MoveAckTC>(4711, pos, NORMALMOVE, 700); });
+    broadcast("GraphicEffectTC", [&pos] { return std::make_shared<GraphicEffectTC>(pos, 12); });
+    broadcast("SoundTC", [&pos] { return std::make_shared<SoundTC>(pos, 3); });
+
+    const auto statistics = CommandBufferPool::get().getStatistics();
+    std::cout << "command buffers: " << statistics.allocations << " allocated, " << statistics.reuses << " reused"
+              << std::endl;
+
+    return 0;
+}
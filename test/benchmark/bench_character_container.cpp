@@ -0,0 +1,200 @@
+#include "Benchmark.hpp"
+#include "Character.hpp"
+#include "CharacterContainer.hpp"
+#include "World.hpp"
+#include "constants.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace {
+uint64_t allocations = 0;
+}
+
+auto operator new(std::size_t size) -> void * {
+    ++allocations;
+
+    if (void *p = std::malloc(size)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t /*unused*/) noexcept { std::free(p); }
+
+template <typename Operation> void countAllocations(const std::string &name, uint64_t iterations, Operation &&operation) {
+    const auto before = allocations;
+
+    for (uint64_t i = 0; i < iterations; ++i) {
+        operation(i);
+    }
+
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(2) << double(allocations - before) / double(iterations) << " allocs/op" << std::endl;
+}
+
+class BenchmarkWorld : public World {
+public:
+    BenchmarkWorld() { World::_self = this; }
+};
+
+class BenchmarkCharacter : public Character {
+    TYPE_OF_CHARACTER_ID id;
+    position pos;
+
+public:
+    BenchmarkCharacter(TYPE_OF_CHARACTER_ID id, const position &pos) : id(id), pos(pos) {}
+    auto getId() const -> TYPE_OF_CHARACTER_ID override { return id; }
+    auto getPosition() const -> const position & override { return pos; }
+    auto getType() const -> unsigned short override { return Character::monster; }
+    auto to_string() const -> std::string override { return "benchmark character"; }
+    void place(const position &newPosition) { pos = newPosition; }
+};
+
+constexpr auto characterCount = 5000;
+constexpr auto townSize = 400;
+constexpr auto queries = 200'000;
+
+// the x axis projection that CharacterContainer used before the grid
+class ProjectionIndex {
+    std::multimap<position, TYPE_OF_CHARACTER_ID, PositionComparison> positionToId;
+    std::unordered_map<TYPE_OF_CHARACTER_ID, Character *> characters;
+
+public:
+    void insert(Character *character) {
+        characters.emplace(character->getId(), character);
+        positionToId.emplace(character->getPosition(), character->getId());
+    }
+
+    auto findAllCharactersInRangeOf(const position &pos, const Range &range) const -> std::vector<Character *> {
+        std::vector<Character *> result;
+        const auto begin = positionToId.upper_bound(position(pos.x - range.radius - 1, 0, 0));
+        const auto end = positionToId.upper_bound(position(pos.x + range.radius + 1, 0, 0));
+
+        for (auto it = begin; it != end; ++it) {
+            const auto &p = it->first;
+
+            if (std::abs(p.x - pos.x) <= range.radius && std::abs(p.y - pos.y) <= range.radius &&
+                std::abs(p.z - pos.z) <= range.zRadius) {
+                result.push_back(characters.at(it->second));
+            }
+        }
+
+        return result;
+    }
+};
+
+auto main() -> int {
+    BenchmarkWorld world;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<Coordinate> coordinate(0, townSize - 1);
+    std::uniform_int_distribution<Coordinate> level(0, 2);
+
+    std::vector<std::unique_ptr<BenchmarkCharacter>> characters;
+    CharacterContainer<Character> container;
+    ProjectionIndex projection;
+
+    for (TYPE_OF_CHARACTER_ID id = 1; id <= characterCount; ++id) {
+        const position pos(coordinate(generator), coordinate(generator), level(generator));
+        characters.push_back(std::make_unique<BenchmarkCharacter>(id, pos));
+        container.insert(characters.back().get());
+        projection.insert(characters.back().get());
+    }
+
+    std::vector<position> centres;
+
+    for (int i = 0; i < 1 << 12; ++i) {
+        centres.emplace_back(coordinate(generator), coordinate(generator), level(generator));
+    }
+
+    const auto mask = centres.size() - 1;
+    const Range range{screenRange};
+
+    measure("range query, x axis projection", queries, [&](uint64_t i) {
+        doNotOptimise(projection.findAllCharactersInRangeOf(centres[i & mask], range).size());
+    });
+
+    measure("range query, grid", queries, [&](uint64_t i) {
+        doNotOptimise(container.findAllCharactersInRangeOf(centres[i & mask], range).size());
+    });
+
+    measure("range query, grid visitor", queries, [&](uint64_t i) {
+        size_t count = 0;
+        container.forEachCharacterInRangeOf(centres[i & mask], range, [&count](Character * /*unused*/) { ++count; });
+        doNotOptimise(count);
+    });
+
+    // monster targeting as World::checkMonsters does it, once per monster and tick
+    CharacterContainer<Character> monsters;
+    std::vector<std::unique_ptr<BenchmarkCharacter>> monsterCharacters;
+
+    for (TYPE_OF_CHARACTER_ID id = characterCount + 1; id <= 2 * characterCount; ++id) {
+        const position pos(coordinate(generator), coordinate(generator), level(generator));
+        monsterCharacters.push_back(std::make_unique<BenchmarkCharacter>(id, pos));
+        monsters.insert(monsterCharacters.back().get());
+    }
+
+    const Range targetRange{MONSTERVIEWRANGE, 0};
+
+    const auto targetsInVectors = [&](const position &pos) {
+        const auto players = container.findAllAliveCharactersInRangeOf(pos, targetRange);
+        const auto others = monsters.findAllAliveCharactersInRangeOf(pos, targetRange);
+        std::vector<Character *> targets;
+        targets.insert(targets.end(), players.begin(), players.end());
+        std::remove_copy_if(others.begin(), others.end(), std::back_inserter(targets),
+                            [&](const auto &monster) { return pos == monster->getPosition(); });
+        return targets;
+    };
+
+    std::vector<Character *> targets;
+
+    const auto targetsInBuffer = [&](const position &pos) {
+        targets.clear();
+
+        container.forEachCharacterInRangeOf(pos, targetRange, [&](Character *player) {
+            if (player->isAlive()) {
+                targets.push_back(player);
+            }
+        });
+
+        monsters.forEachCharacterInRangeOf(pos, targetRange, [&](Character *monster) {
+            if (monster->isAlive() && !(pos == monster->getPosition())) {
+                targets.push_back(monster);
+            }
+        });
+    };
+
+    measure("monster targets, result vectors", queries,
+            [&](uint64_t i) { doNotOptimise(targetsInVectors(centres[i & mask]).size()); });
+
+    measure("monster targets, reused buffer", queries, [&](uint64_t i) {
+        targetsInBuffer(centres[i & mask]);
+        doNotOptimise(targets.size());
+    });
+
+    countAllocations("monster targets, result vectors", queries,
+                     [&](uint64_t i) { doNotOptimise(targetsInVectors(centres[i & mask]).size()); });
+
+    countAllocations("monster targets, reused buffer", queries, [&](uint64_t i) {
+        targetsInBuffer(centres[i & mask]);
+        doNotOptimise(targets.size());
+    });
+
+    measure("update, one step", queries * 10, [&](uint64_t i) {
+        auto &character = *characters[i % characters.size()];
+        auto pos = character.getPosition();
+        pos.x = ((i / characters.size()) & 1U) != 0 ? pos.x + 1 : pos.x - 1;
+        container.update(&character, pos);
+        character.place(pos);
+    });
+
+    return 0;
+}
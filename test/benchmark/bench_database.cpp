@@ -0,0 +1,53 @@
+#include "Benchmark.hpp"
+#include "db/Connection.hpp"
+#include "db/ConnectionPool.hpp"
+
+#include <memory>
+#include <string>
+
+// needs a reachable PostgreSQL server, pass its connection string as first argument
+constexpr auto queries = 2'000;
+constexpr auto poolSize = 4;
+
+auto main(int argc, char *argv[]) -> int {
+    using namespace Database;
+
+    const std::string connectionString = argc > 1 ? argv[1] : "dbname=illarion";
+
+    try {
+        Connection probe(connectionString);
+    } catch (std::exception &e) {
+        std::cout << "cannot connect to database (" << e.what() << "), skipping" << std::endl;
+        return 0;
+    }
+
+    const auto pool = std::make_shared<ConnectionPool>(connectionString, poolSize);
+    const PreparedStatement statement{"bench_select", "SELECT $1::integer + 1"};
+
+    measure("query, new connection", queries, [&](uint64_t i) {
+        Connection connection(connectionString);
+        connection.beginTransaction();
+        doNotOptimise(connection.query("SELECT " + std::to_string(i) + "::integer + 1").size());
+        connection.commitTransaction();
+    });
+
+    measure("query, pooled connection", queries, [&](uint64_t i) {
+        auto connection = pool->checkout();
+        connection->beginTransaction();
+        doNotOptimise(connection->query("SELECT " + std::to_string(i) + "::integer + 1").size());
+        connection->commitTransaction();
+    });
+
+    measure("query, pooled connection, prepared", queries, [&](uint64_t i) {
+        auto connection = pool->checkout();
+        connection->beginTransaction();
+        doNotOptimise(connection->query(statement, static_cast<int>(i)).size());
+        connection->commitTransaction();
+    });
+
+    const auto statistics = pool->getStatistics();
+    std::cout << "pool: " << statistics.checkouts << " checkouts, " << statistics.maxInUse << " connections used"
+              << std::endl;
+
+    return 0;
+}
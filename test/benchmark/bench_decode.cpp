@@ -0,0 +1,190 @@
+#include "Benchmark.hpp"
+#include "netinterface/ClientCommandPool.hpp"
+#include "netinterface/CommandFactory.hpp"
+#include "netinterface/protocol/ClientCommands.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Decodes a recorded stream of client packets the way a connection does: the
+// stream arrives in reads of a fixed size, every complete message is decoded
+// and handed to the game loop, which drops its commands once per read.
+constexpr auto packets = 200'000;
+constexpr auto readSize = 4 * 1024;
+constexpr auto repetitions = 10;
+constexpr size_t headerSize = 6;
+
+class Recorder {
+public:
+    void add(unsigned char id) {
+        payload.clear();
+        record(id);
+    }
+
+    template <typename... Values> void add(unsigned char id, Values... values) {
+        payload.clear();
+        (append(values), ...);
+        record(id);
+    }
+
+    [[nodiscard]] auto getStream() const -> const std::vector<unsigned char> & { return stream; }
+
+private:
+    void append(unsigned char value) { payload.push_back(value); }
+
+    void append(short int value) {
+        payload.push_back(static_cast<unsigned char>(value >> CHAR_BIT));
+        payload.push_back(static_cast<unsigned char>(value));
+    }
+
+    void append(int value) {
+        append(static_cast<short int>(value >> 2 * CHAR_BIT));
+        append(static_cast<short int>(value));
+    }
+
+    void append(const std::string &value) {
+        append(static_cast<short int>(value.size()));
+        payload.insert(payload.end(), value.begin(), value.end());
+    }
+
+    void record(unsigned char id) {
+        uint32_t crc = 0;
+
+        for (auto byte : payload) {
+            crc += byte;
+        }
+
+        const auto checkSum = static_cast<uint16_t>(crc % 0xFFFF);
+        const auto length = static_cast<uint16_t>(payload.size());
+        stream.insert(stream.end(), {id, static_cast<unsigned char>(id ^ UCHAR_MAX),
+                                     static_cast<unsigned char>(length >> CHAR_BIT), static_cast<unsigned char>(length),
+                                     static_cast<unsigned char>(checkSum >> CHAR_BIT),
+                                     static_cast<unsigned char>(checkSum)});
+        stream.insert(stream.end(), payload.begin(), payload.end());
+    }
+
+    std::vector<unsigned char> payload;
+    std::vector<unsigned char> stream;
+};
+
+// mostly walking, with the occasional look, use and chat line
+auto record() -> std::vector<unsigned char> {
+    Recorder recorder;
+    const short int x = 120;
+    const short int y = -45;
+    const short int z = 0;
+
+    for (int i = 0; i < packets; ++i) {
+        switch (i % 10) {
+        case 0:
+            recorder.add(C_SAY_TS, std::string("Greetings, traveller! Have you seen the ferry to Runewick?"));
+            break;
+        case 1:
+            recorder.add(C_LOOKATMAPITEM_TS, x, y, z, static_cast<unsigned char>(1));
+            break;
+        case 2:
+            recorder.add(C_USE_TS, static_cast<unsigned char>(UID_KOORD), x, y, z);
+            break;
+        case 3:
+            recorder.add(C_KEEPALIVE_TS);
+            break;
+        default:
+            recorder.add(C_CHARMOVE_TS, 1000042, static_cast<unsigned char>(i % 8), static_cast<unsigned char>(1));
+        }
+    }
+
+    return recorder.getStream();
+}
+
+// returns the number of decoded commands
+template <typename Decode> auto decodeStream(const std::vector<unsigned char> &stream, Decode &&decode) -> size_t {
+    std::vector<unsigned char> receiveBuffer(readSize + 1024);
+    std::vector<ClientCommandPointer> commandQueue;
+    size_t bytesReceived = 0;
+    size_t decoded = 0;
+
+    for (size_t offset = 0; offset < stream.size(); offset += readSize) {
+        const auto bytes = std::min<size_t>(readSize, stream.size() - offset);
+        std::copy_n(stream.begin() + offset, bytes, receiveBuffer.begin() + bytesReceived);
+        bytesReceived += bytes;
+        size_t position = 0;
+
+        while (bytesReceived - position >= headerSize) {
+            const unsigned char *header = &receiveBuffer[position];
+            const auto length = static_cast<uint16_t>(header[2] << CHAR_BIT | header[3]);
+            const auto checkSum = static_cast<uint16_t>(header[4] << CHAR_BIT | header[5]);
+
+            if (bytesReceived - position < headerSize + length) {
+                break;
+            }
+
+            auto cmd = decode(header[0], header + headerSize, length, checkSum);
+
+            if (cmd->isDataOk()) {
+                commandQueue.push_back(std::move(cmd));
+            }
+
+            position += headerSize + length;
+        }
+
+        std::copy(receiveBuffer.begin() + position, receiveBuffer.begin() + bytesReceived, receiveBuffer.begin());
+        bytesReceived -= position;
+        decoded += commandQueue.size();
+        commandQueue.clear();
+    }
+
+    return decoded;
+}
+
+auto main() -> int {
+    const auto stream = record();
+    std::cout << "recorded " << packets << " packets, " << stream.size() << " bytes" << std::endl;
+
+    // the former factory: a map of templates and a fresh command with its own payload copy for every packet
+    std::unordered_map<unsigned char, std::function<ClientCommandPointer()>> templates = {
+            {C_SAY_TS, [] { return std::make_shared<SayTS>(); }},
+            {C_LOOKATMAPITEM_TS, [] { return std::make_shared<LookAtMapItemTS>(); }},
+            {C_USE_TS, [] { return std::make_shared<UseTS>(); }},
+            {C_KEEPALIVE_TS, [] { return std::make_shared<KeepAliveTS>(); }},
+            {C_CHARMOVE_TS, [] { return std::make_shared<CharMoveTS>(); }}};
+    std::vector<unsigned char> payload;
+
+    const auto allocating = [&](unsigned char id, const unsigned char *data, uint16_t length, uint16_t checkSum) {
+        auto cmd = templates.at(id)();
+        payload.assign(data, data + length);
+        cmd->setData(payload.data(), length, checkSum);
+        cmd->decodeData();
+        return cmd;
+    };
+
+    const CommandFactory factory;
+
+    const auto pooled = [&](unsigned char id, const unsigned char *data, uint16_t length, uint16_t checkSum) {
+        auto cmd = factory.getCommand(id);
+        cmd->setData(data, length, checkSum);
+        cmd->decodeData();
+        return cmd;
+    };
+
+    const auto perStream = [&](const std::string &name, auto &&decode) {
+        const auto nsPerStream = measure(name + ", per stream", repetitions,
+                                         [&](uint64_t i) { doNotOptimise(decodeStream(stream, decode)); });
+
+        std::cout << "  " << std::fixed << std::setprecision(1) << double(stream.size()) / nsPerStream * 1000
+                  << " MB/s, " << double(packets) / nsPerStream * 1000 << " M packets/s" << std::endl;
+    };
+
+    perStream("map lookup, allocated commands", allocating);
+    perStream("table lookup, pooled commands", pooled);
+
+    const auto statistics = ClientCommandPool::getStatistics();
+    std::cout << "command pool: " << statistics.allocations << " allocated, " << statistics.reuses << " reused"
+              << std::endl;
+
+    return 0;
+}
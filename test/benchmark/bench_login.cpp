@@ -0,0 +1,200 @@
+#include "Benchmark.hpp"
+#include "db/Connection.hpp"
+#include "db/ConnectionPool.hpp"
+#include "thread_safe_vector.hpp"
+#include "tuningConstants.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// needs a reachable PostgreSQL server, pass its connection string as first argument;
+// the character tables are stood in for by a scratch schema that is dropped afterwards
+constexpr auto characters = 200;
+constexpr auto logins = 1'000;
+constexpr auto poolSize = playerLoadWorkers;
+
+const std::vector<std::string> tables = {
+        "CREATE TABLE questprogress (qpg_userid integer, qpg_questid integer, qpg_progress integer, qpg_time integer)",
+        "CREATE TABLE introduction (intro_player integer, intro_known_player integer)",
+        "CREATE TABLE naming (name_player integer, name_named_player integer, name_player_name text)",
+        "CREATE TABLE playerskills (psk_playerid integer, psk_skill_id integer, psk_value integer, psk_minor integer)",
+        "CREATE TABLE playeritem_datavalues (idv_playerid integer, idv_linenumber integer, idv_key text, idv_value "
+        "text)",
+        "CREATE TABLE playeritems (pit_playerid integer, pit_linenumber integer, pit_in_container integer, pit_depot "
+        "integer, pit_itemid integer, pit_wear integer, pit_number integer, pit_quality integer, pit_containerslot "
+        "integer)",
+        "CREATE TABLE playerlteffects (plte_playerid integer, plte_effectid integer, plte_nextcalled integer, "
+        "plte_numbercalled integer)",
+        "CREATE TABLE playerlteffectvalues (pev_playerid integer, pev_effectid integer, pev_name text, pev_value "
+        "integer)"};
+
+const std::vector<std::string> rows = {
+        "INSERT INTO questprogress SELECT p, q, 1, 0 FROM generate_series(1, $c) p, generate_series(1, 40) q",
+        "INSERT INTO introduction SELECT p, k FROM generate_series(1, $c) p, generate_series(1, 30) k",
+        "INSERT INTO naming SELECT p, k, 'name' || k FROM generate_series(1, $c) p, generate_series(1, 10) k",
+        "INSERT INTO playerskills SELECT p, s, 50, 0 FROM generate_series(1, $c) p, generate_series(1, 40) s",
+        "INSERT INTO playeritem_datavalues SELECT p, l, 'key', 'value' FROM generate_series(1, $c) p, "
+        "generate_series(1, 20) l",
+        "INSERT INTO playeritems SELECT p, l, 0, (l > 60)::integer, 100 + l, 100, 1, 333, 0 FROM generate_series(1, "
+        "$c) p, generate_series(1, 120) l",
+        "INSERT INTO playerlteffects SELECT p, e, 10, 0 FROM generate_series(1, $c) p, generate_series(1, 3) e",
+        "INSERT INTO playerlteffectvalues SELECT p, e, 'value', 1 FROM generate_series(1, $c) p, generate_series(1, "
+        "3) e"};
+
+// the selects a login runs, like Player::load
+auto characterQueries(int id) -> std::vector<std::string> {
+    const auto player = std::to_string(id);
+    return {"SELECT qpg_questid, qpg_progress, qpg_time FROM questprogress WHERE qpg_userid = " + player,
+            "SELECT intro_known_player FROM introduction WHERE intro_player = " + player,
+            "SELECT name_named_player, name_player_name FROM naming WHERE name_player = " + player,
+            "SELECT psk_skill_id, psk_value, psk_minor FROM playerskills WHERE psk_playerid = " + player,
+            "SELECT idv_linenumber, idv_key, idv_value FROM playeritem_datavalues WHERE idv_playerid = " + player +
+                    " ORDER BY idv_linenumber",
+            "SELECT pit_linenumber, pit_in_container, pit_depot, pit_itemid, pit_wear, pit_number, pit_quality, "
+            "pit_containerslot FROM playeritems WHERE pit_playerid = " +
+                    player + " ORDER BY pit_linenumber",
+            "SELECT plte_effectid, plte_nextcalled, plte_numbercalled FROM playerlteffects WHERE plte_playerid = " +
+                    player + " ORDER BY plte_nextcalled",
+            "SELECT pev_effectid, pev_name, pev_value FROM playerlteffectvalues WHERE pev_playerid = " + player};
+}
+
+// one checkout and transaction per select, plus the distinct depot query, like before
+auto loadSeparately(Database::ConnectionPool &pool, int id) -> size_t {
+    auto queries = characterQueries(id);
+    queries.push_back("SELECT DISTINCT pit_depot FROM playeritems WHERE pit_playerid = " + std::to_string(id));
+    size_t rowCount = 0;
+
+    for (const auto &query : queries) {
+        auto connection = pool.checkout();
+        connection->beginTransaction();
+        rowCount += connection->query(query).size();
+        connection->commitTransaction();
+    }
+
+    return rowCount;
+}
+
+auto loadPipelined(Database::ConnectionPool &pool, int id) -> size_t {
+    auto connection = pool.checkout();
+    connection->beginTransaction();
+    const auto results = connection->queryAll(characterQueries(id));
+    connection->commitTransaction();
+    size_t rowCount = 0;
+
+    for (const auto &result : results) {
+        rowCount += result.size();
+    }
+
+    return rowCount;
+}
+
+// all logins arrive at once and are picked up by the given number of login threads
+template <typename Load> void loginStorm(const std::string &name, int threads, Load &&load) {
+    thread_safe_vector<int> queue;
+    std::atomic<int> done = 0;
+    std::atomic_bool running = true;
+    std::mutex doneMutex;
+    std::condition_variable allDone;
+    std::vector<std::thread> loginThreads;
+
+    for (int i = 0; i < threads; ++i) {
+        loginThreads.emplace_back([&] {
+            int id = 0;
+            using namespace std::chrono_literals;
+
+            while (running) {
+                if (queue.wait_pop_front(id, 100ms)) {
+                    doNotOptimise(load(id));
+
+                    if (++done == logins) {
+                        std::lock_guard<std::mutex> lock(doneMutex);
+                        allDone.notify_one();
+                    }
+                }
+            }
+        });
+    }
+
+    // the last iteration waits for the storm to be through, so the average covers every login
+    measure(name, logins, [&](uint64_t i) {
+        queue.push_back(int(i % characters) + 1);
+
+        if (i == logins - 1) {
+            std::unique_lock<std::mutex> lock(doneMutex);
+            allDone.wait(lock, [&] { return done == logins; });
+        }
+    });
+
+    running = false;
+
+    for (auto &thread : loginThreads) {
+        thread.join();
+    }
+}
+
+auto main(int argc, char *argv[]) -> int {
+    using namespace Database;
+
+    const std::string connectionString = argc > 1 ? argv[1] : "dbname=illarion";
+
+    try {
+        Connection probe(connectionString);
+    } catch (std::exception &e) {
+        std::cout << "cannot connect to database (" << e.what() << "), skipping" << std::endl;
+        return 0;
+    }
+
+    // every pooled connection works in the scratch schema
+    const auto pool = std::make_shared<ConnectionPool>(connectionString + " options='-csearch_path=bench_login'",
+                                                       poolSize);
+
+    {
+        auto connection = pool->checkout();
+        connection->beginTransaction();
+        connection->query("DROP SCHEMA IF EXISTS bench_login CASCADE");
+        connection->query("CREATE SCHEMA bench_login");
+
+        for (const auto &table : tables) {
+            connection->query(table);
+        }
+
+        for (auto insert : rows) {
+            insert.replace(insert.find("$c"), 2, std::to_string(characters));
+            connection->query(insert);
+        }
+
+        connection->query("CREATE INDEX ON questprogress (qpg_userid)");
+        connection->query("CREATE INDEX ON introduction (intro_player)");
+        connection->query("CREATE INDEX ON naming (name_player)");
+        connection->query("CREATE INDEX ON playerskills (psk_playerid)");
+        connection->query("CREATE INDEX ON playeritem_datavalues (idv_playerid)");
+        connection->query("CREATE INDEX ON playeritems (pit_playerid)");
+        connection->query("CREATE INDEX ON playerlteffects (plte_playerid)");
+        connection->query("CREATE INDEX ON playerlteffectvalues (pev_playerid)");
+        connection->commitTransaction();
+    }
+
+    const auto separately = [&](int id) { return loadSeparately(*pool, id); };
+    const auto pipelined = [&](int id) { return loadPipelined(*pool, id); };
+
+    loginStorm("login storm, 1 thread, query per table", 1, separately);
+    loginStorm("login storm, 1 thread, pipelined", 1, pipelined);
+    loginStorm("login storm, " + std::to_string(playerLoadWorkers) + " threads, query per table", playerLoadWorkers,
+               separately);
+    loginStorm("login storm, " + std::to_string(playerLoadWorkers) + " threads, pipelined", playerLoadWorkers,
+               pipelined);
+
+    {
+        auto connection = pool->checkout();
+        connection->beginTransaction();
+        connection->query("DROP SCHEMA bench_login CASCADE");
+        connection->commitTransaction();
+    }
+
+    return 0;
+}
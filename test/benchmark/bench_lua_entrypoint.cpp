@@ -0,0 +1,34 @@
+#include "Benchmark.hpp"
+#include "World.hpp"
+#include "script/LuaTestSupportScript.hpp"
+
+#include <luabind/object.hpp>
+
+// Calls an entrypoint that does nothing, so what is measured is the overhead
+// of getting from C++ into a script function and back.
+constexpr auto calls = 1'000'000;
+
+class BenchmarkWorld : public World {
+public:
+    BenchmarkWorld() { World::_self = this; }
+};
+
+auto main() -> int {
+    BenchmarkWorld world;
+    LuaTestSupportScript script("function test() end");
+
+    // the former lookup: walk from the registry to the module and its function on every call
+    measure("registry lookup, no-op entrypoint", calls, [](uint64_t i) {
+        luabind::object module = luabind::registry(LuaScript::getLuaState())["_LOADED"][""];
+        luabind::object entrypoint = module["test"];
+        entrypoint();
+    });
+
+    measure("cached entrypoint, no-op entrypoint", calls, [&script](uint64_t i) { script.test(); });
+
+    LuaTestSupportScript empty("");
+
+    measure("cached entrypoint, missing entrypoint", calls, [&empty](uint64_t i) { empty.test(); });
+
+    return 0;
+}
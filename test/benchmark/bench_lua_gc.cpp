@@ -0,0 +1,80 @@
+#include "Benchmark.hpp"
+#include "World.hpp"
+#include "script/LuaTestSupportScript.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// A tick calls a script that keeps a large table alive and leaves garbage
+// behind on every call, the way item and quest scripts do with their temporary
+// tables and strings. Without help, the collector does its work inside the
+// calls and some ticks pay for a lot of it; with idle collection, the time
+// between ticks is used for it instead. Only the ticks are timed.
+constexpr auto ticks = 5'000;
+constexpr auto callsPerTick = 200;
+constexpr auto idleTime = std::chrono::milliseconds(2);
+
+const auto *const scriptCode = R"(
+    local live = {}
+    for i = 1, 200000 do
+        live[i] = {i, tostring(i)}
+    end
+
+    function test()
+        local garbage = {}
+        for i = 1, 20 do
+            garbage[i] = {x = i, name = "item " .. i}
+        end
+        return #garbage + #live
+    end
+)";
+
+using Clock = std::chrono::steady_clock;
+
+class BenchmarkWorld : public World {
+public:
+    BenchmarkWorld() { World::_self = this; }
+};
+
+void run(const std::string &name, bool collectInIdleTime) {
+    LuaTestSupportScript script(scriptCode);
+    std::vector<double> tickTimes;
+    tickTimes.reserve(ticks);
+
+    for (int tick = 0; tick < ticks; ++tick) {
+        const auto start = Clock::now();
+
+        for (int i = 0; i < callsPerTick; ++i) {
+            script.test();
+        }
+
+        const std::chrono::duration<double, std::micro> duration = Clock::now() - start;
+        tickTimes.push_back(duration.count());
+
+        if (collectInIdleTime) {
+            LuaScript::collectGarbage(idleTime);
+        }
+    }
+
+    std::sort(tickTimes.begin(), tickTimes.end());
+    const auto percentile = [&tickTimes](double p) { return tickTimes[size_t(p * double(tickTimes.size() - 1))]; };
+    const auto statistics = LuaScript::getGarbageCollectionStatistics();
+
+    std::cout << name << ": tick p50 " << std::fixed << std::setprecision(0) << percentile(0.5) << " us, p99 "
+              << percentile(0.99) << " us, max " << tickTimes.back() << " us" << std::endl;
+    std::cout << "  heap " << statistics.heapBytes / 1024 << " KB, " << statistics.cycles << " idle cycles in "
+              << statistics.steps << " steps, "
+              << std::chrono::duration_cast<std::chrono::microseconds>(statistics.duration).count() << " us"
+              << std::endl;
+}
+
+auto main() -> int {
+    BenchmarkWorld world;
+
+    run("collector during calls", false);
+    LuaScript::shutdownLua();
+    run("collector in idle time", true);
+
+    return 0;
+}
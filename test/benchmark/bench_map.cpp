@@ -0,0 +1,84 @@
+#include "Benchmark.hpp"
+#include "World.hpp"
+#include "map/Map.hpp"
+
+#include <random>
+#include <vector>
+
+class BenchmarkWorld : public World {
+public:
+    BenchmarkWorld() { World::_self = this; }
+    using World::ageMaps;
+};
+
+constexpr auto mapSize = 1024;
+constexpr auto levels = 5;
+constexpr auto screenSize = 40;
+constexpr auto screens = 20'000;
+
+// the layout Map used before the contiguous array: one vector of fields per column
+class ColumnMap {
+    std::vector<std::vector<map::Field>> fields;
+
+public:
+    explicit ColumnMap(uint16_t tile) : fields(mapSize) {
+        for (Coordinate x = 0; x < mapSize; ++x) {
+            fields[x].reserve(mapSize);
+
+            for (Coordinate y = 0; y < mapSize; ++y) {
+                fields[x].emplace_back(tile, 0, position(x, y, 0));
+            }
+        }
+    }
+
+    auto at(Coordinate x, Coordinate y) const -> const map::Field & { return fields[x][y]; }
+};
+
+// visits a screen sized window row by row, like stripe building and visibility checks do
+template <typename Fields> void walkScreens(const std::string &name, const Fields &fields) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<Coordinate> distribution(0, mapSize - screenSize - 1);
+
+    measure(name, screens, [&](uint64_t /*unused*/) {
+        const Coordinate startX = distribution(generator);
+        const Coordinate startY = distribution(generator);
+
+        for (Coordinate y = startY; y < startY + screenSize; ++y) {
+            for (Coordinate x = startX; x < startX + screenSize; ++x) {
+                doNotOptimise(fields.at(x, y).getTileCode());
+            }
+        }
+    });
+}
+
+auto main() -> int {
+    BenchmarkWorld world;
+    const uint16_t tile = 2;
+
+    {
+        const ColumnMap columns(tile);
+        walkScreens("screen walk, per-column vectors", columns);
+    }
+
+    {
+        const map::Map contiguous("bench", position(0, 0, 0), mapSize, mapSize, tile);
+        walkScreens("screen walk, contiguous array", contiguous);
+    }
+
+    for (Coordinate z = -2; z < levels - 2; ++z) {
+        world.createMap("bench", position(0, 0, z), mapSize, mapSize, tile);
+    }
+
+    // roughly one field in a hundred holds a decaying item
+    for (Coordinate x = 0; x < mapSize; x += 10) {
+        for (Coordinate y = 0; y < mapSize; y += 10) {
+            const Item::wear_type wear = 1 + (x + y) % 200;
+            world.fieldAt(position(x, y, 0)).addItemOnStack(Item(1, 1, wear, Item::defaultQuality));
+        }
+    }
+
+    measure("ageing cycle, 5x1024x1024 fields, 10k decaying items", 200,
+            [&](uint64_t /*unused*/) { world.ageMaps(); });
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "Benchmark.hpp"
+#include "NewClientView.hpp"
+#include "WorkerPool.hpp"
+#include "World.hpp"
+#include "map/WorldMap.hpp"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+class BenchmarkWorld : public World {
+public:
+    BenchmarkWorld() { World::_self = this; }
+};
+
+constexpr auto mapSize = 512;
+constexpr auto logins = 200;
+
+auto main() -> int {
+    BenchmarkWorld world;
+    map::WorldMap worldMap;
+    const uint16_t tile = 2;
+
+    for (Coordinate z = -2; z <= 2; ++z) {
+        world.createMap("bench", position(0, 0, z), mapSize, mapSize, tile);
+        worldMap.createMap("bench", position(0, 0, z), mapSize, mapSize, tile);
+    }
+
+    for (Coordinate x = 0; x < mapSize; x += 3) {
+        for (Coordinate y = 0; y < mapSize; y += 7) {
+            const Item item(1, 1 + (x + y) % 5, Item::PERMANENT_WEAR);
+            world.fieldAt(position(x, y, 0)).addItemOnStack(item);
+            worldMap.at(position(x, y, 0)).addItemOnStack(item);
+        }
+    }
+
+    // every login asks for the full map around a different spot, half of the
+    // clients use the static view and half a large dynamic one
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<Coordinate> coordinate(50, mapSize - 50);
+    std::vector<std::vector<NewClientView::StripeRequest>> fullMaps(logins);
+    size_t stripes = 0;
+
+    for (int i = 0; i < logins; ++i) {
+        const position pos(coordinate(generator), coordinate(generator), 0);
+        const Coordinate screen = (i % 2 == 0) ? 0 : 15;
+        NewClientView::addFullMapStripes(pos, screen, screen, fullMaps[i]);
+        stripes += fullMaps[i].size();
+    }
+
+    std::cout << logins << " logins, " << stripes << " stripes" << std::endl;
+
+    const auto sendFullMaps = [&](WorkerPool &pool) {
+        for (const auto &fullMap : fullMaps) {
+            std::vector<NewClientView::EncodedStripe> encoded(fullMap.size());
+            pool.run(fullMap.size(),
+                     [&](size_t i) { encoded[i] = NewClientView::encodeStripe(worldMap, fullMap[i]); });
+            doNotOptimise(encoded.back().checkSum);
+        }
+    };
+
+    WorkerPool mainThreadOnly(0);
+    measure("full maps for 200 logins, main thread only", 20,
+            [&](uint64_t /*unused*/) { sendFullMaps(mainThreadOnly); });
+
+    const auto cores = std::thread::hardware_concurrency();
+
+    for (size_t threads = 1; threads < cores && threads <= 8; threads *= 2) {
+        WorkerPool workers(threads);
+        measure("full maps for 200 logins, " + std::to_string(threads) + " workers", 20,
+                [&](uint64_t /*unused*/) { sendFullMaps(workers); });
+    }
+
+    // what the server does: cache lookups on the main thread, misses on the workers
+    measure("full maps for 200 logins, World, cold cache", 20, [&](uint64_t /*unused*/) {
+        world.stripeCache.clear();
+
+        for (const auto &fullMap : fullMaps) {
+            doNotOptimise(world.getMapStripes(fullMap).back()->checkSum);
+        }
+    });
+
+    // MapStripeTC: 14 bytes of header per stripe, MapStripesTC: 8 bytes per stripe and 8 per command
+    size_t classicBytes = 0;
+    size_t compactBytes = 0;
+
+    for (const auto &fullMap : fullMaps) {
+        for (const auto &stripe : fullMap) {
+            classicBytes += 14 + NewClientView::encodeStripe(worldMap, stripe).bytes.size();
+            compactBytes += 8 + NewClientView::encodeStripe(worldMap, stripe, NewClientView::encoding_compact)
+                                        .bytes.size();
+        }
+
+        compactBytes += 8;
+    }
+
+    std::cout << "bytes per full map, MapStripeTC:            " << classicBytes / logins << std::endl;
+    std::cout << "bytes per full map, MapStripesTC, compact:  " << compactBytes / logins << std::endl;
+
+    measure("compact encoding, full maps for 200 logins", 20, [&](uint64_t /*unused*/) {
+        for (const auto &fullMap : fullMaps) {
+            for (const auto &stripe : fullMap) {
+                doNotOptimise(NewClientView::encodeStripe(worldMap, stripe, NewClientView::encoding_compact).checkSum);
+            }
+        }
+    });
+
+    return 0;
+}
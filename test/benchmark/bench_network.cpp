@@ -0,0 +1,145 @@
+#include "Benchmark.hpp"
+#include "netinterface/NetInterface.hpp"
+#include "netinterface/protocol/ServerCommands.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <memory>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+// Load generator for the network layer: local fake clients connect to
+// NetInterfaces served by a pool of I/O threads, while the calling thread
+// plays the game loop and sends one command per client and tick. Each command
+// carries its send time, so clients can report the send latency.
+constexpr auto maxClients = 2'000;
+constexpr auto ticks = 200;
+constexpr auto tickInterval = std::chrono::milliseconds(10);
+constexpr auto clientThreads = 2;
+constexpr auto commandSize = 10;
+
+using Clock = std::chrono::steady_clock;
+
+struct FakeClient {
+    explicit FakeClient(boost::asio::io_service &io) : socket(io) {}
+
+    boost::asio::ip::tcp::socket socket;
+    std::array<unsigned char, commandSize> buffer{};
+    std::vector<int> latencies;
+};
+
+void receive(FakeClient &client, Clock::time_point start, std::atomic<int> &received) {
+    boost::asio::async_read(client.socket, boost::asio::buffer(client.buffer),
+                            [&client, start, &received](const auto &error, auto bytes_transferred) {
+                                if (error) {
+                                    return;
+                                }
+
+                                const auto &data = client.buffer;
+                                const int sent = data[6] << 24 | data[7] << 16 | data[8] << 8 | data[9];
+                                const auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+                                        Clock::now() - start);
+                                client.latencies.push_back(int(now.count()) - sent);
+                                ++received;
+                                receive(client, start, received);
+                            });
+}
+
+void run(unsigned int networkThreads, int clients) {
+    boost::asio::io_service serverIo;
+    boost::asio::io_service clientIo;
+    auto serverWork = boost::asio::make_work_guard(serverIo);
+    auto clientWork = boost::asio::make_work_guard(clientIo);
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 0; i < networkThreads; ++i) {
+        threads.emplace_back([&serverIo] { serverIo.run(); });
+    }
+
+    for (int i = 0; i < clientThreads; ++i) {
+        threads.emplace_back([&clientIo] { clientIo.run(); });
+    }
+
+    using boost::asio::ip::tcp;
+    tcp::acceptor acceptor(serverIo, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    std::vector<std::shared_ptr<NetInterface>> connections;
+    std::vector<std::unique_ptr<FakeClient>> fakeClients;
+
+    for (int i = 0; i < clients; ++i) {
+        auto connection = std::make_shared<NetInterface>(serverIo);
+        auto client = std::make_unique<FakeClient>(clientIo);
+        client->socket.connect(acceptor.local_endpoint());
+        acceptor.accept(connection->getSocket());
+        connection->activate();
+        connections.push_back(std::move(connection));
+        fakeClients.push_back(std::move(client));
+    }
+
+    const auto start = Clock::now();
+    std::atomic<int> received = 0;
+
+    for (auto &client : fakeClients) {
+        receive(*client, start, received);
+    }
+
+    const auto total = clients * ticks;
+    auto nextTick = Clock::now();
+
+    for (int tick = 0; tick < ticks; ++tick) {
+        const auto now = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+        for (const auto &connection : connections) {
+            connection->addCommand(std::make_shared<IdTC>(int(now.count())));
+        }
+
+        nextTick += tickInterval;
+        std::this_thread::sleep_until(nextTick);
+    }
+
+    while (received < total) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    std::vector<int> latencies;
+
+    for (const auto &client : fakeClients) {
+        latencies.insert(latencies.end(), client->latencies.begin(), client->latencies.end());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) { return latencies[size_t(p * double(latencies.size() - 1))]; };
+
+    std::cout << networkThreads << " network threads, " << clients << " clients: " << std::fixed
+              << std::setprecision(0) << double(total) / elapsed.count() << " commands/s, send latency p50 "
+              << percentile(0.5) << " us, p99 " << percentile(0.99) << " us" << std::endl;
+
+    serverIo.stop();
+    clientIo.stop();
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+auto main(int argc, char *argv[]) -> int {
+    const unsigned int networkThreads =
+            argc > 1 ? std::stoi(argv[1]) : std::max(1U, std::thread::hardware_concurrency());
+
+    // every client needs two descriptors, one on each end
+    rlimit limit{};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    const int clients = std::min<rlim_t>(maxClients, (limit.rlim_cur - 64) / 2);
+
+    run(1, clients);
+
+    if (networkThreads > 1) {
+        run(networkThreads, clients);
+    }
+
+    return 0;
+}
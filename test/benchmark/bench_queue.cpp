@@ -0,0 +1,99 @@
+#include "Benchmark.hpp"
+#include "MPSCQueue.hpp"
+#include "thread_safe_vector.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Network threads hand commands to the game loop, which takes all of them
+// once per turn. Producers push as fast as they can, the consumer empties the
+// queue in a loop; reported is the cost per item handed over.
+constexpr auto itemsPerProducer = 500'000;
+constexpr auto queueSize = 4096;
+
+using Item = std::shared_ptr<int>;
+
+template <typename Push, typename Drain>
+void contention(const std::string &name, int producers, Push &&push, Drain &&drain) {
+    const auto item = std::make_shared<int>(1);
+    const auto total = uint64_t(producers) * itemsPerProducer;
+    std::atomic_bool start = false;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < producers; ++i) {
+        threads.emplace_back([&] {
+            while (!start) {
+                std::this_thread::yield();
+            }
+
+            for (int j = 0; j < itemsPerProducer; ++j) {
+                while (!push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    uint64_t received = 0;
+    uint64_t rounds = 0;
+
+    // one measured operation is one item, the first one runs the whole exchange
+    measure(name + ", " + std::to_string(producers) + " producers", total, [&](uint64_t i) {
+        if (i > 0) {
+            return;
+        }
+
+        start = true;
+
+        while (received < total) {
+            const uint64_t count = drain();
+
+            if (count == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            received += count;
+            ++rounds;
+        }
+    });
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "  " << double(received) / double(rounds) << " items per drain" << std::endl;
+}
+
+auto main() -> int {
+    for (int producers : {1, 2, 4}) {
+        thread_safe_vector<Item> lockedQueue;
+
+        contention(
+                "mutex guarded list", producers,
+                [&lockedQueue](const Item &item) {
+                    lockedQueue.push_back(item);
+                    return true;
+                },
+                [&lockedQueue] {
+                    uint64_t count = 0;
+
+                    while (!lockedQueue.empty()) {
+                        doNotOptimise(lockedQueue.pop_front());
+                        ++count;
+                    }
+
+                    return count;
+                });
+
+        MPSCQueue<Item> queue(queueSize);
+
+        contention(
+                "lock-free queue", producers, [&queue](const Item &item) { return queue.tryPush(item); },
+                [&queue] { return queue.drain([](Item &&item) { doNotOptimise(item); }); });
+    }
+
+    return 0;
+}
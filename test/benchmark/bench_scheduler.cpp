@@ -0,0 +1,155 @@
+#include "Benchmark.hpp"
+#include "Scheduler.hpp"
+
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+// 100k timers, like long time effects, actions and respawns of a busy server,
+// spread over ten minutes. Time is faked and advanced in turns of 100ms, so
+// only the bookkeeping of the timers is measured.
+constexpr auto timers = 100'000;
+constexpr auto span = std::chrono::minutes(10);
+constexpr auto turn = std::chrono::milliseconds(100);
+
+struct FakeClock {
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<FakeClock>;
+    static constexpr bool is_steady = true;
+
+    static auto now() -> time_point { return current; }
+
+    static time_point current;
+};
+
+FakeClock::time_point FakeClock::current{};
+
+// the former scheduler: a priority queue of tasks with their own name, copied on the way out
+class PriorityQueueScheduler {
+public:
+    void add(std::function<void()> task, FakeClock::duration delay, const std::string &name) {
+        tasks.push({std::move(task), FakeClock::now() + delay, name});
+    }
+
+    void run() {
+        const auto now = FakeClock::now();
+
+        while (!tasks.empty() && tasks.top().next <= now) {
+            auto task = tasks.top();
+            tasks.pop();
+            task.task();
+        }
+    }
+
+    [[nodiscard]] auto empty() const -> bool { return tasks.empty(); }
+
+private:
+    struct Task {
+        std::function<void()> task;
+        FakeClock::time_point next;
+        std::string name;
+
+        auto operator<(const Task &other) const -> bool { return next > other.next; }
+    };
+
+    std::priority_queue<Task> tasks;
+};
+
+auto delays() -> std::vector<FakeClock::duration> {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<FakeClock::rep> distribution(0, FakeClock::duration(span).count());
+    std::vector<FakeClock::duration> result;
+
+    for (int i = 0; i < timers; ++i) {
+        result.emplace_back(distribution(random));
+    }
+
+    return result;
+}
+
+// turns until everything ran, reported per timer
+template <typename Run, typename Empty> void runAll(Run &&run, Empty &&empty) {
+    while (!empty()) {
+        FakeClock::current += turn;
+        run();
+    }
+}
+
+auto main() -> int {
+    const auto delay = delays();
+    uint64_t fired = 0;
+    const auto task = [&fired] { ++fired; };
+
+    {
+        PriorityQueueScheduler scheduler;
+        measure("priority queue, add", timers, [&](uint64_t i) { scheduler.add(task, delay[i], "long_time_effects"); });
+        measure("priority queue, fire", timers, [&](uint64_t i) {
+            if (i == 0) {
+                runAll([&] { scheduler.run(); }, [&] { return scheduler.empty(); });
+            }
+        });
+    }
+
+    // what polling every timer each turn costs, like long time actions were
+    {
+        std::vector<FakeClock::time_point> due;
+
+        for (const auto &d : delay) {
+            due.push_back(FakeClock::now() + d);
+        }
+
+        measure("polling, per turn", 100, [&](uint64_t i) {
+            FakeClock::current += turn;
+
+            for (auto &next : due) {
+                if (next <= FakeClock::now()) {
+                    ++fired;
+                    next = FakeClock::time_point::max();
+                }
+            }
+        });
+    }
+
+    ClockBasedScheduler<FakeClock> scheduler;
+    std::vector<TaskHandle> handles(timers);
+    measure("timing wheel, add", timers, [&](uint64_t i) {
+        handles[i] = scheduler.addOneshotTask(task, delay[i], "long_time_effects");
+    });
+    measure("timing wheel, reschedule", timers, [&](uint64_t i) { scheduler.reschedule(handles[i], delay[i] / 2); });
+    measure("timing wheel, idle turn", 100, [&](uint64_t i) {
+        FakeClock::current += std::chrono::microseconds(1);
+        scheduler.run_once(std::chrono::nanoseconds::zero());
+    });
+    measure("timing wheel, fire", timers, [&](uint64_t i) {
+        if (i == 0) {
+            runAll([&] { scheduler.run_once(std::chrono::nanoseconds::zero()); },
+                   [&] { return scheduler.size() == 0; });
+        }
+    });
+
+    for (int i = 0; i < timers; ++i) {
+        handles[i] = scheduler.addOneshotTask(task, delay[i], "long_time_effects");
+    }
+
+    measure("timing wheel, cancel", timers, [&](uint64_t i) { scheduler.cancel(handles[i]); });
+
+    // all timers share one name, like the effects of all characters do
+    for (int i = 0; i < timers; ++i) {
+        handles[i] = scheduler.addOneshotTask(task, delay[i], "long_time_effects");
+    }
+
+    scheduler.setProfiling(true);
+    measure("timing wheel, fire, profiled", timers, [&](uint64_t i) {
+        if (i == 0) {
+            runAll([&] { scheduler.run_once(std::chrono::nanoseconds::zero()); },
+                   [&] { return scheduler.size() == 0; });
+        }
+    });
+
+    doNotOptimise(fired);
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "Benchmark.hpp"
+#include "World.hpp"
+#include "map/WorldMap.hpp"
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+class BenchmarkWorld : public World {
+public:
+    BenchmarkWorld() { World::_self = this; }
+};
+
+constexpr auto mapSize = 200;
+constexpr auto mapsPerAxis = 4;
+constexpr auto levels = 3;
+constexpr auto lookups = 10'000'000;
+
+// the per-tile hash index that WorldMap used before the chunk directory
+class HashIndex {
+    std::vector<map::Map> maps;
+    std::unordered_map<position, int> worldMap;
+    std::unordered_map<position, int> persistentFields;
+
+public:
+    void insert(map::Map &&newMap) {
+        maps.push_back(std::move(newMap));
+        const auto &map = maps.back();
+
+        for (auto x = map.getMinX(); x <= map.getMaxX(); ++x) {
+            for (auto y = map.getMinY(); y <= map.getMaxY(); ++y) {
+                worldMap[position(x, y, map.getLevel())] = maps.size() - 1;
+            }
+        }
+    }
+
+    auto at(const position &pos) -> map::Field & {
+        if (persistentFields.count(pos) > 0) {
+            throw FieldNotFound();
+        }
+
+        const auto it = worldMap.find(pos);
+
+        if (it == worldMap.end()) {
+            throw FieldNotFound();
+        }
+
+        return maps[it->second].at(pos.x, pos.y);
+    }
+
+    [[nodiscard]] auto indexBytes() const -> size_t {
+        // node: value, next pointer and cached hash
+        const auto nodeSize = sizeof(std::pair<const position, int>) + 2 * sizeof(void *);
+        return worldMap.size() * nodeSize + worldMap.bucket_count() * sizeof(void *);
+    }
+};
+
+auto main() -> int {
+    BenchmarkWorld world;
+    map::WorldMap worldMap;
+    HashIndex hashIndex;
+    const uint16_t tile = 2;
+
+    for (Coordinate z = 0; z < levels; ++z) {
+        for (Coordinate i = 0; i < mapsPerAxis; ++i) {
+            for (Coordinate j = 0; j < mapsPerAxis; ++j) {
+                // odd offset, so that map borders do not align with chunk borders
+                const position origin(i * mapSize - 333, j * mapSize + 17, z);
+                worldMap.createMap("bench", origin, mapSize, mapSize, tile);
+                hashIndex.insert(map::Map("bench", origin, mapSize, mapSize, tile));
+            }
+        }
+    }
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<Coordinate> xDistribution(-333, mapsPerAxis * mapSize - 334);
+    std::uniform_int_distribution<Coordinate> yDistribution(17, mapsPerAxis * mapSize + 16);
+    std::uniform_int_distribution<Coordinate> zDistribution(0, levels - 1);
+    std::vector<position> positions;
+
+    for (int i = 0; i < 1 << 16; ++i) {
+        positions.emplace_back(xDistribution(generator), yDistribution(generator), zDistribution(generator));
+    }
+
+    const auto mask = positions.size() - 1;
+
+    measure("WorldMap::at, per-tile hash index", lookups, [&](uint64_t i) {
+        doNotOptimise(hashIndex.at(positions[i & mask]).getTileCode());
+    });
+
+    measure("WorldMap::at, chunk directory", lookups, [&](uint64_t i) {
+        doNotOptimise(worldMap.at(positions[i & mask]).getTileCode());
+    });
+
+    // walk a screen sized window row by row, like stripe and visibility code does
+    measure("WorldMap::at, screen walk, per-tile hash index", lookups / 400, [&](uint64_t i) {
+        const auto &start = positions[i & mask];
+
+        for (Coordinate y = 0; y < 20; ++y) {
+            for (Coordinate x = 0; x < 20; ++x) {
+                try {
+                    doNotOptimise(hashIndex.at(position(start.x + x, start.y + y, start.z)).getTileCode());
+                } catch (FieldNotFound &) {
+                }
+            }
+        }
+    });
+
+    measure("WorldMap::at, screen walk, chunk directory", lookups / 400, [&](uint64_t i) {
+        const auto &start = positions[i & mask];
+
+        for (Coordinate y = 0; y < 20; ++y) {
+            for (Coordinate x = 0; x < 20; ++x) {
+                try {
+                    doNotOptimise(worldMap.at(position(start.x + x, start.y + y, start.z)).getTileCode());
+                } catch (FieldNotFound &) {
+                }
+            }
+        }
+    });
+
+    std::cout << "index memory, per-tile hash index: " << hashIndex.indexBytes() / 1024 << " KiB" << std::endl;
+    std::cout << "index memory, chunk directory:     " << worldMap.indexMemoryUsage() / 1024 << " KiB" << std::endl;
+
+    return 0;
+}
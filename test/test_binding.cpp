@@ -56,6 +56,7 @@ public:
         EXPECT_CALL(player, getId()).Times(AtLeast(0));
 	    ON_CALL(world, findCharacter(player.getId())).WillByDefault(Return(&player));
         EXPECT_CALL(world, findCharacter(player.getId())).Times(AtLeast(0));
+        world.characterHandles.add(&player);
     }
 };
 
@@ -104,6 +104,7 @@ public:
         monster = new MockMonster();
         ON_CALL(world, findCharacter(monster->getId())).WillByDefault(Return(monster));
         EXPECT_CALL(world, findCharacter(monster->getId())).Times(AtLeast(0));
+        world.characterHandles.add(monster);
     }
 };
 
@@ -40,6 +40,7 @@ class scriptitem_bindings : public ::testing::Test {
         EXPECT_CALL(character, getId()).Times(AtLeast(0));
         ON_CALL(world, findCharacter(character.getId())).WillByDefault(Return(&character));
         EXPECT_CALL(world, findCharacter(character.getId())).Times(AtLeast(0));
+        world.characterHandles.add(&character);
 	}
 };
 
@@ -108,6 +108,11 @@ public:
         ON_CALL(world, findCharacter(player->getId())).WillByDefault(Return(player));
         ON_CALL(world, findCharacter(npc->getId())).WillByDefault(Return(npc));
         EXPECT_CALL(world, findCharacter(_)).Times(AtLeast(0));
+        world.characterHandles.add(m1);
+        world.characterHandles.add(m2);
+        world.characterHandles.add(m3);
+        world.characterHandles.add(player);
+        world.characterHandles.add(npc);
     }
 };
 
@@ -0,0 +1,104 @@
+#include <gmock/gmock.h>
+
+#include "Character.hpp"
+#include "CharacterHandles.hpp"
+#include "World.hpp"
+#include "character_ptr.hpp"
+
+#include <stdexcept>
+
+class MockWorld : public World {
+public:
+    MockWorld() {
+        World::_self = this;
+    }
+};
+
+class MockCharacter : public Character {
+public:
+    MOCK_CONST_METHOD0(getType, unsigned short());
+    MOCK_CONST_METHOD0(to_string, std::string());
+};
+
+class character_handles : public ::testing::Test {
+public:
+    MockWorld world;
+    CharacterHandles &handles = world.characterHandles;
+    MockCharacter first;
+    MockCharacter second;
+};
+
+TEST_F(character_handles, default_handle_is_stale) {
+    handles.add(&first);
+    EXPECT_EQ(nullptr, handles.get(CharacterHandle{}));
+}
+
+TEST_F(character_handles, added_characters_resolve) {
+    handles.add(&first);
+    handles.add(&second);
+    EXPECT_EQ(&first, handles.get(first.getHandle()));
+    EXPECT_EQ(&second, handles.get(second.getHandle()));
+    EXPECT_EQ(2, handles.size());
+}
+
+TEST_F(character_handles, adding_twice_keeps_the_handle) {
+    handles.add(&first);
+    const auto handle = first.getHandle();
+    handles.add(&first);
+    EXPECT_EQ(handle.index, first.getHandle().index);
+    EXPECT_EQ(handle.generation, first.getHandle().generation);
+    EXPECT_EQ(1, handles.size());
+}
+
+TEST_F(character_handles, removed_characters_are_stale) {
+    handles.add(&first);
+    const auto handle = first.getHandle();
+    handles.remove(&first);
+    EXPECT_EQ(nullptr, handles.get(handle));
+    EXPECT_EQ(nullptr, handles.get(first.getHandle()));
+    EXPECT_EQ(0, handles.size());
+}
+
+TEST_F(character_handles, reused_slot_does_not_resolve_stale_handle) {
+    handles.add(&first);
+    const auto stale = first.getHandle();
+    handles.remove(&first);
+    handles.add(&second);
+    EXPECT_EQ(stale.index, second.getHandle().index);
+    EXPECT_EQ(nullptr, handles.get(stale));
+    EXPECT_EQ(&second, handles.get(second.getHandle()));
+}
+
+TEST_F(character_handles, returning_character_gets_new_handle) {
+    handles.add(&first);
+    const auto stale = first.getHandle();
+    handles.remove(&first);
+    handles.add(&first);
+    EXPECT_EQ(nullptr, handles.get(stale));
+    EXPECT_EQ(&first, handles.get(first.getHandle()));
+}
+
+TEST_F(character_handles, removing_unknown_character_does_nothing) {
+    handles.add(&first);
+    handles.remove(&second);
+    EXPECT_EQ(&first, handles.get(first.getHandle()));
+    EXPECT_EQ(1, handles.size());
+}
+
+TEST_F(character_handles, character_ptr_detects_stale_handle) {
+    handles.add(&first);
+    character_ptr ptr(&first);
+    EXPECT_TRUE(isValid(ptr));
+    EXPECT_EQ(&first, ptr.get());
+
+    handles.remove(&first);
+    handles.add(&second);
+    EXPECT_FALSE(isValid(ptr));
+    EXPECT_THROW(static_cast<void>(ptr.get()), std::logic_error);
+}
+
+TEST_F(character_handles, character_ptr_to_character_outside_world_is_invalid) {
+    character_ptr ptr(&first);
+    EXPECT_FALSE(isValid(ptr));
+    EXPECT_FALSE(isValid(character_ptr()));
+}
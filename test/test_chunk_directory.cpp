@@ -0,0 +1,78 @@
+#include "map/ChunkDirectory.hpp"
+
+#include <gtest/gtest.h>
+
+using map::ChunkDirectory;
+
+class chunk_directory_tests : public ::testing::Test {
+public:
+    ChunkDirectory directory;
+
+    chunk_directory_tests() {
+        directory.insert(-100, -50, 200, 30, 0, 0);
+        directory.insert(201, -50, 260, 30, 0, 1);
+        directory.insert(10, 10, 20, 20, -3, 2);
+    }
+};
+
+TEST_F(chunk_directory_tests, mapAt) {
+    for (Coordinate x = -300; x < 400; ++x) {
+        for (Coordinate y = -100; y < 100; ++y) {
+            auto expected = ChunkDirectory::noMap;
+
+            if (y >= -50 && y <= 30 && x >= -100 && x <= 200) {
+                expected = 0;
+            } else if (y >= -50 && y <= 30 && x >= 201 && x <= 260) {
+                expected = 1;
+            }
+
+            EXPECT_EQ(expected, directory.mapAt(position(x, y, 0)));
+
+            expected = ChunkDirectory::noMap;
+
+            if (x >= 10 && x <= 20 && y >= 10 && y <= 20) {
+                expected = 2;
+            }
+
+            EXPECT_EQ(expected, directory.mapAt(position(x, y, -3)));
+        }
+    }
+}
+
+TEST_F(chunk_directory_tests, outsideOfAllMaps) {
+    EXPECT_EQ(nullptr, directory.chunkAt(position(0, 0, 1)));
+    EXPECT_EQ(nullptr, directory.chunkAt(position(0, 0, -4)));
+    EXPECT_EQ(nullptr, directory.chunkAt(position(32767, 32767, 0)));
+    EXPECT_EQ(nullptr, directory.chunkAt(position(-32768, -32768, 0)));
+    EXPECT_EQ(ChunkDirectory::noMap, directory.mapAt(position(0, 0, -2)));
+}
+
+TEST_F(chunk_directory_tests, persistentFields) {
+    const position inMap(0, 0, 0);
+    const position outsideMaps(5000, 5000, 7);
+
+    directory.addPersistentField(inMap);
+    directory.addPersistentField(outsideMaps);
+
+    ASSERT_NE(nullptr, directory.chunkAt(outsideMaps));
+    EXPECT_TRUE(directory.chunkAt(inMap)->hasPersistentFields());
+    EXPECT_TRUE(directory.chunkAt(outsideMaps)->hasPersistentFields());
+    EXPECT_EQ(ChunkDirectory::noMap, directory.mapAt(outsideMaps));
+    EXPECT_EQ(0, directory.mapAt(inMap));
+
+    directory.removePersistentField(inMap);
+    directory.removePersistentField(outsideMaps);
+
+    EXPECT_FALSE(directory.chunkAt(inMap)->hasPersistentFields());
+    EXPECT_FALSE(directory.chunkAt(outsideMaps)->hasPersistentFields());
+}
+
+TEST_F(chunk_directory_tests, clear) {
+    directory.clear();
+    EXPECT_EQ(nullptr, directory.chunkAt(position(0, 0, 0)));
+}
+
+auto main(int argc, char **argv) -> int {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
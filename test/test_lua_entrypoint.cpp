@@ -0,0 +1,66 @@
+#include <gmock/gmock.h>
+
+#include "script/LuaTestSupportScript.hpp"
+
+#include "World.hpp"
+
+class MockWorld : public World {
+public:
+    MockWorld() {
+        World::_self = this;
+    }
+};
+
+class lua_entrypoint : public ::testing::Test {
+public:
+    MockWorld world;
+
+    ~lua_entrypoint() override {
+        LuaScript::shutdownLua();
+    }
+};
+
+TEST_F(lua_entrypoint, repeated_calls_use_the_same_function) {
+    LuaTestSupportScript script {"counter = 0 function test() counter = counter + 1 return counter end"};
+
+    EXPECT_EQ(1, script.test<int>());
+    EXPECT_EQ(2, script.test<int>());
+    EXPECT_EQ(3, script.test<int>());
+}
+
+TEST_F(lua_entrypoint, missing_entrypoint_returns_default) {
+    LuaTestSupportScript script {""};
+
+    EXPECT_EQ(0, script.test<int>());
+    EXPECT_EQ(0, script.test<int>());
+}
+
+TEST_F(lua_entrypoint, loading_a_module_replaces_cached_functions) {
+    LuaTestSupportScript first {"function test() return 1 end"};
+    EXPECT_EQ(1, first.test<int>());
+
+    // test scripts share their module name, so the second one replaces the module of the first
+    LuaTestSupportScript second {"function test() return 2 end"};
+    EXPECT_EQ(2, first.test<int>());
+    EXPECT_EQ(2, second.test<int>());
+}
+
+TEST_F(lua_entrypoint, shutdown_releases_cached_functions) {
+    {
+        LuaTestSupportScript script {"function test() return 1 end"};
+        EXPECT_EQ(1, script.test<int>());
+        LuaScript::shutdownLua();
+    }
+
+    LuaTestSupportScript script {"function test() return 2 end"};
+    EXPECT_EQ(2, script.test<int>());
+}
+
+TEST_F(lua_entrypoint, exists_entrypoint_uses_the_cache) {
+    LuaTestSupportScript script {"function test() return 1 end"};
+
+    EXPECT_TRUE(script.existsEntrypoint("test"));
+    EXPECT_FALSE(script.existsEntrypoint("missing"));
+    EXPECT_EQ(1, script.test<int>());
+    EXPECT_TRUE(script.existsEntrypoint("test"));
+}
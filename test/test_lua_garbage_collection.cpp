@@ -0,0 +1,102 @@
+#include <gmock/gmock.h>
+
+#include "script/LuaTestSupportScript.hpp"
+
+#include "World.hpp"
+
+#include <chrono>
+#include <luabind/object.hpp>
+
+using namespace std::chrono_literals;
+
+class MockWorld : public World {
+public:
+    MockWorld() {
+        World::_self = this;
+    }
+};
+
+// the automatic collector is stopped, so that only the tests decide when garbage is collected
+const auto *const garbageScript = R"(
+    collectgarbage()
+    collectgarbage("stop")
+
+    collect = false
+
+    function test()
+        if collect then
+            collectgarbage()
+            return
+        end
+
+        local garbage = {}
+        for i = 1, 100000 do
+            garbage[i] = {i}
+        end
+    end
+)";
+
+class lua_garbage_collection : public ::testing::Test {
+public:
+    MockWorld world;
+    LuaTestSupportScript script {garbageScript};
+
+    ~lua_garbage_collection() override {
+        LuaScript::shutdownLua();
+    }
+};
+
+TEST_F(lua_garbage_collection, idle_collection_finishes_a_cycle) {
+    const auto before = LuaScript::getGarbageCollectionStatistics();
+    script.test();
+    const auto garbage = LuaScript::getGarbageCollectionStatistics().heapBytes;
+
+    for (int i = 0; i < 10000 && LuaScript::getGarbageCollectionStatistics().cycles == before.cycles; ++i) {
+        LuaScript::collectGarbage(1ms);
+    }
+
+    const auto after = LuaScript::getGarbageCollectionStatistics();
+    EXPECT_EQ(before.cycles + 1, after.cycles);
+    EXPECT_GT(after.steps, before.steps);
+    EXPECT_LT(after.heapBytes, garbage);
+}
+
+TEST_F(lua_garbage_collection, idle_collection_keeps_to_its_budget) {
+    for (int i = 0; i < 5; ++i) {
+        script.test();
+    }
+
+    const auto before = LuaScript::getGarbageCollectionStatistics();
+    const auto budget = 200us;
+    LuaScript::collectGarbage(budget);
+    const auto after = LuaScript::getGarbageCollectionStatistics();
+
+    EXPECT_EQ(before.cycles, after.cycles);
+    EXPECT_GT(after.steps, before.steps);
+    // the last step may start just before the deadline, but it is short
+    EXPECT_LT(after.duration - before.duration, budget + 20ms);
+}
+
+TEST_F(lua_garbage_collection, cycle_finished_during_a_call_ends_idle_collection) {
+    script.test();
+    LuaScript::collectGarbage(1ns);
+    luabind::globals(LuaScript::getLuaState())["collect"] = true;
+    script.test();
+
+    const auto before = LuaScript::getGarbageCollectionStatistics();
+    LuaScript::collectGarbage(1ms);
+    const auto after = LuaScript::getGarbageCollectionStatistics();
+
+    // the heap is just collected, far from where the next idle cycle starts
+    EXPECT_EQ(before.steps, after.steps);
+}
+
+TEST_F(lua_garbage_collection, nothing_to_do_without_time) {
+    script.test();
+
+    const auto before = LuaScript::getGarbageCollectionStatistics();
+    LuaScript::collectGarbage(0ms);
+    const auto after = LuaScript::getGarbageCollectionStatistics();
+
+    EXPECT_EQ(before.steps, after.steps);
+}
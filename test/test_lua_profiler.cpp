@@ -0,0 +1,90 @@
+#include <gmock/gmock.h>
+
+#include "script/LuaProfiler.hpp"
+#include "script/LuaTestSupportScript.hpp"
+
+#include "World.hpp"
+
+#include <sstream>
+
+class MockWorld : public World {
+public:
+    MockWorld() {
+        World::_self = this;
+    }
+};
+
+class lua_profiler : public ::testing::Test {
+public:
+    MockWorld world;
+    LuaProfiler &profiler = LuaProfiler::get();
+
+    lua_profiler() {
+        profiler.setProfiling(true);
+    }
+
+    ~lua_profiler() override {
+        profiler.setProfiling(false);
+        profiler.setSampleInterval(0);
+        profiler.resetStatistics();
+        LuaScript::shutdownLua();
+    }
+};
+
+TEST_F(lua_profiler, counts_calls_and_allocations) {
+    LuaTestSupportScript script {"function test() local t = {} for i = 1, 100 do t[i] = i end return #t end"};
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(100, script.test<int>());
+    }
+
+    const auto statistics = profiler.getEntrypointStatistics();
+    ASSERT_EQ(1, statistics.size());
+    EXPECT_EQ("test", statistics[0].entrypoint);
+    EXPECT_EQ(3, statistics[0].calls);
+    EXPECT_GE(statistics[0].totalDuration, statistics[0].maxDuration);
+    EXPECT_GT(statistics[0].allocatedBytes, 0);
+}
+
+TEST_F(lua_profiler, measures_nothing_while_disabled) {
+    profiler.setProfiling(false);
+    LuaTestSupportScript script {"function test() end"};
+    script.test();
+
+    EXPECT_TRUE(profiler.getEntrypointStatistics().empty());
+}
+
+TEST_F(lua_profiler, reset_clears_statistics) {
+    LuaTestSupportScript script {"function test() end"};
+    script.test();
+    profiler.resetStatistics();
+
+    EXPECT_TRUE(profiler.getEntrypointStatistics().empty());
+
+    script.test();
+    const auto statistics = profiler.getEntrypointStatistics();
+    ASSERT_EQ(1, statistics.size());
+    EXPECT_EQ(1, statistics[0].calls);
+}
+
+TEST_F(lua_profiler, samples_folded_stacks) {
+    profiler.setSampleInterval(100);
+    LuaTestSupportScript script {"function busy(n) local sum = 0 for i = 1, n do sum = sum + i % 7 end return sum end\n"
+                                 "function test() local sum = 0 for i = 1, 200 do sum = sum + busy(1000) end "
+                                 "return sum end"};
+    script.test<int>();
+
+    EXPECT_GT(profiler.getSampleCount(), 0);
+
+    std::stringstream folded;
+    profiler.writeFoldedStacks(folded);
+    std::string line;
+    bool foundBusy = false;
+
+    while (std::getline(folded, line)) {
+        EXPECT_EQ(0, line.rfind(".test;", 0));
+        foundBusy = foundBusy || line.find("(busy)") != std::string::npos;
+    }
+
+    EXPECT_TRUE(foundBusy);
+}
@@ -0,0 +1,78 @@
+#include <gmock/gmock.h>
+
+#include "script/LuaTestSupportScript.hpp"
+#include "script/LuaWatchdog.hpp"
+
+#include "World.hpp"
+
+class MockWorld : public World {
+public:
+    MockWorld() {
+        World::_self = this;
+    }
+};
+
+class lua_watchdog : public ::testing::Test {
+public:
+    MockWorld world;
+    LuaWatchdog &watchdog = LuaWatchdog::get();
+
+    ~lua_watchdog() override {
+        LuaScript::shutdownLua();
+        watchdog.setBudget(0, std::chrono::milliseconds(0));
+        watchdog.resetOverruns();
+    }
+
+    [[nodiscard]] auto abortedCalls() const -> uint64_t {
+        uint64_t aborted = 0;
+
+        for (const auto &overrun : watchdog.getOverruns()) {
+            aborted += overrun.second;
+        }
+
+        return aborted;
+    }
+};
+
+TEST_F(lua_watchdog, calls_within_budget_run) {
+    LuaTestSupportScript script {"function test() local sum = 0 for i = 1, 100 do sum = sum + i end return sum end"};
+    watchdog.setBudget(100000, std::chrono::milliseconds(1000));
+
+    EXPECT_EQ(5050, script.test<int>());
+    EXPECT_EQ(0, abortedCalls());
+}
+
+TEST_F(lua_watchdog, aborts_after_instruction_budget) {
+    LuaTestSupportScript script {"function test() while true do end return 1 end"};
+    watchdog.setBudget(100000, std::chrono::milliseconds(0));
+
+    EXPECT_EQ(0, script.test<int>());
+    EXPECT_EQ(1, abortedCalls());
+}
+
+TEST_F(lua_watchdog, aborts_after_time_budget) {
+    LuaTestSupportScript script {"function test() while true do end return 1 end"};
+    watchdog.setBudget(0, std::chrono::milliseconds(50));
+
+    EXPECT_EQ(0, script.test<int>());
+    EXPECT_EQ(1, abortedCalls());
+}
+
+TEST_F(lua_watchdog, scripts_cannot_catch_the_abort) {
+    LuaTestSupportScript script {"function test() while true do pcall(function() while true do end end) end end"};
+    watchdog.setBudget(100000, std::chrono::milliseconds(0));
+
+    script.test();
+    EXPECT_EQ(1, abortedCalls());
+}
+
+TEST_F(lua_watchdog, next_call_has_full_budget) {
+    LuaTestSupportScript script {"function test(n) local sum = 0 for i = 1, n do sum = sum + 1 end return sum end"};
+    watchdog.setBudget(100000, std::chrono::milliseconds(0));
+
+    const auto aborted = script.test<int, int>(1000000);
+    const auto completed = script.test<int, int>(1000);
+    EXPECT_EQ(0, aborted);
+    EXPECT_EQ(1000, completed);
+    EXPECT_EQ(1, abortedCalls());
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include "World.hpp"
+#include "map/Field.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+class MockWorld : public World {
+public:
+    MockWorld() { World::_self = this; }
+    using World::ageMaps;
+};
+
+class map_ageing_tests : public ::testing::Test {
+public:
+    MockWorld world;
+    std::unordered_map<position, std::vector<Item>> expected;
+    static constexpr Coordinate mapSize = 20;
+
+    map_ageing_tests() { world.createSavedArea(2, position(0, 0, 0), mapSize, mapSize); }
+
+    void place(const position &pos, Item::wear_type wear) {
+        const Item item(1, 1, wear);
+        world.fieldAt(pos).addItemOnStack(item);
+        expected[pos].push_back(item);
+    }
+
+    // what ageing every field once per cycle used to do
+    void sweep() {
+        for (auto &entry : expected) {
+            auto &items = entry.second;
+            items.erase(std::remove_if(items.begin(), items.end(), [](Item &item) { return !item.survivesAgeing(); }),
+                        items.end());
+        }
+    }
+
+    void compare(int cycle) {
+        for (const auto &[pos, items] : expected) {
+            std::ostringstream trace;
+            trace << "cycle: " << cycle << ", field: " << pos;
+            SCOPED_TRACE(trace.str());
+
+            const auto &stack = world.fieldAt(pos).getItemStack();
+            ASSERT_EQ(items.size(), stack.size());
+
+            for (size_t i = 0; i < items.size(); ++i) {
+                EXPECT_EQ(items[i].getId(), stack[i].getId());
+                EXPECT_EQ(items[i].getWear(), stack[i].getWear());
+            }
+        }
+    }
+};
+
+TEST_F(map_ageing_tests, itemsRotInTheSameCycleAsWithAFullSweep) {
+    const std::vector<Item::wear_type> wears = {0, 1, 2, 3, 5, 17, 100, 254, Item::PERMANENT_WEAR};
+
+    for (Coordinate x = 0; x < mapSize; ++x) {
+        for (Coordinate y = 0; y < mapSize; y += 3) {
+            place(position(x, y, 0), wears[(x + y) % wears.size()]);
+
+            if (x % 4 == 0) {
+                place(position(x, y, 0), wears[(x * y) % wears.size()]);
+            }
+        }
+    }
+
+    for (int cycle = 1; cycle <= 260; ++cycle) {
+        world.ageMaps();
+        sweep();
+
+        // look at the fields only now and then, so that wear is caught up over several cycles
+        if (cycle % 7 == 0 || cycle < 5) {
+            compare(cycle);
+        }
+    }
+
+    compare(260);
+}
+
+TEST_F(map_ageing_tests, itemsAddedBetweenCyclesAgeFromTheirArrival) {
+    const position pos(3, 4, 0);
+    place(pos, 10);
+
+    for (int cycle = 1; cycle <= 30; ++cycle) {
+        world.ageMaps();
+        sweep();
+
+        if (cycle == 4) {
+            place(pos, 2);
+        }
+
+        if (cycle == 6) {
+            place(pos, 0);
+            place(position(5, 5, 0), 1);
+        }
+
+        compare(cycle);
+    }
+
+    EXPECT_EQ(0, world.fieldAt(pos).itemCount());
+}
+
+TEST_F(map_ageing_tests, permanentItemsNeverRot) {
+    const position pos(7, 7, 0);
+    place(pos, Item::PERMANENT_WEAR);
+
+    for (int cycle = 1; cycle <= 300; ++cycle) {
+        world.ageMaps();
+    }
+
+    ASSERT_EQ(1, world.fieldAt(pos).itemCount());
+    EXPECT_TRUE(world.fieldAt(pos).getItemStack().front().isPermanent());
+}
+
+auto main(int argc, char **argv) -> int {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
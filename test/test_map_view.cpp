@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include "NewClientView.hpp"
+#include "World.hpp"
+#include "map/Field.hpp"
+
+#include <numeric>
+#include <vector>
+
+class MockWorld : public World {
+public:
+    MockWorld() { World::_self = this; }
+};
+
+struct FieldLook {
+    int16_t tile;
+    uint8_t movementCost;
+    int16_t music;
+    std::vector<std::pair<int16_t, int16_t>> items;
+
+    auto operator==(const FieldLook &other) const -> bool {
+        return tile == other.tile && movementCost == other.movementCost && music == other.music &&
+               items == other.items;
+    }
+};
+
+class StripeReader {
+    const std::vector<char> &bytes;
+    size_t pos = 0;
+
+public:
+    explicit StripeReader(const std::vector<char> &bytes) : bytes(bytes) {}
+
+    [[nodiscard]] auto done() const -> bool { return pos == bytes.size(); }
+
+    auto getUnsignedChar() -> uint8_t { return static_cast<uint8_t>(bytes.at(pos++)); }
+
+    auto getShortInt() -> int16_t {
+        const auto high = getUnsignedChar();
+        return static_cast<int16_t>((high << 8) | getUnsignedChar());
+    }
+
+    auto getLook() -> FieldLook {
+        FieldLook look{};
+        look.tile = getShortInt();
+        look.movementCost = getUnsignedChar();
+        look.music = getShortInt();
+        return look;
+    }
+
+    void getItems(FieldLook &look) {
+        const auto count = getUnsignedChar();
+
+        for (int i = 0; i < count; ++i) {
+            const auto id = getShortInt();
+            look.items.emplace_back(id, getShortInt());
+        }
+    }
+};
+
+auto decodeClassic(const std::vector<char> &bytes) -> std::vector<FieldLook> {
+    std::vector<FieldLook> fields;
+    StripeReader reader(bytes);
+
+    while (!reader.done()) {
+        fields.push_back(reader.getLook());
+        reader.getItems(fields.back());
+    }
+
+    return fields;
+}
+
+auto decodeCompact(const std::vector<char> &bytes) -> std::vector<FieldLook> {
+    std::vector<FieldLook> fields;
+    StripeReader reader(bytes);
+
+    while (!reader.done()) {
+        const auto header = reader.getUnsignedChar();
+        const auto run = header & ~NewClientView::compactItemsFlag;
+        auto look = reader.getLook();
+
+        if ((header & NewClientView::compactItemsFlag) != 0) {
+            reader.getItems(look);
+        }
+
+        fields.insert(fields.end(), run, look);
+    }
+
+    return fields;
+}
+
+auto checkSum(const std::vector<char> &bytes) -> uint32_t {
+    return std::accumulate(bytes.begin(), bytes.end(), uint32_t(0),
+                           [](uint32_t sum, char byte) { return sum + static_cast<uint8_t>(byte); });
+}
+
+class map_view_tests : public ::testing::Test {
+public:
+    MockWorld world;
+    static constexpr Coordinate mapSize = 40;
+
+    map_view_tests() {
+        world.createSavedArea(2, position(0, 0, 0), mapSize, mapSize);
+
+        for (Coordinate i = 0; i < mapSize; i += 7) {
+            world.fieldAt(position(i, i, 0)).addItemOnStack(Item(1, 3, Item::PERMANENT_WEAR));
+            world.fieldAt(position(i, i, 0)).addItemOnStack(Item(5, 1, Item::PERMANENT_WEAR));
+            world.fieldAt(position(mapSize - 1 - i, i, 0)).setTileId(3);
+        }
+    }
+};
+
+TEST_F(map_view_tests, compactEncodingShowsTheSameFields) {
+    for (Coordinate start = -10; start < mapSize; start += 3) {
+        for (const auto dir : {NewClientView::dir_right, NewClientView::dir_down}) {
+            const NewClientView::StripeRequest stripe{position(start, start / 2, 0), dir, 37};
+            const auto classic = world.getMapStripe(stripe, NewClientView::encoding_classic);
+            const auto compact = world.getMapStripe(stripe, NewClientView::encoding_compact);
+
+            const auto fields = decodeClassic(classic->bytes);
+            ASSERT_EQ(size_t(stripe.length), fields.size());
+            EXPECT_EQ(fields, decodeCompact(compact->bytes));
+            EXPECT_LE(compact->bytes.size(), classic->bytes.size());
+            EXPECT_EQ(checkSum(classic->bytes), classic->checkSum);
+            EXPECT_EQ(checkSum(compact->bytes), compact->checkSum);
+        }
+    }
+}
+
+TEST_F(map_view_tests, changedFieldsAreEncodedAgain) {
+    const NewClientView::StripeRequest stripe{position(0, 0, 0), NewClientView::dir_right, 20};
+    const auto before = world.getMapStripe(stripe, NewClientView::encoding_compact);
+
+    world.fieldAt(position(3, 3, 0)).addItemOnStack(Item(7, 2, Item::PERMANENT_WEAR));
+    const auto after = world.getMapStripe(stripe, NewClientView::encoding_compact);
+
+    EXPECT_NE(before->bytes, after->bytes);
+    const auto fields = decodeCompact(after->bytes);
+    ASSERT_EQ(size_t(stripe.length), fields.size());
+    ASSERT_EQ(1, fields[3].items.size());
+    EXPECT_EQ(7, fields[3].items[0].first);
+    EXPECT_EQ(2, fields[3].items[0].second);
+}
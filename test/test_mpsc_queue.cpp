@@ -0,0 +1,121 @@
+#include "MPSCQueue.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(mpsc_queue_tests, capacity_is_rounded_up_to_power_of_two) {
+    MPSCQueue<int> queue(100);
+    EXPECT_EQ(128U, queue.capacity());
+}
+
+TEST(mpsc_queue_tests, pops_in_push_order) {
+    MPSCQueue<int> queue(4);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_FALSE(queue.empty());
+
+    int item = 0;
+    ASSERT_TRUE(queue.tryPop(item));
+    EXPECT_EQ(1, item);
+    ASSERT_TRUE(queue.tryPop(item));
+    EXPECT_EQ(2, item);
+    EXPECT_FALSE(queue.tryPop(item));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(mpsc_queue_tests, push_fails_when_full_and_succeeds_after_pop) {
+    MPSCQueue<int> queue(2);
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_FALSE(queue.tryPush(3));
+
+    int item = 0;
+    ASSERT_TRUE(queue.tryPop(item));
+    EXPECT_TRUE(queue.tryPush(3));
+    ASSERT_TRUE(queue.tryPop(item));
+    EXPECT_EQ(2, item);
+    ASSERT_TRUE(queue.tryPop(item));
+    EXPECT_EQ(3, item);
+}
+
+TEST(mpsc_queue_tests, peek_keeps_item_queued) {
+    MPSCQueue<int> queue(4);
+    EXPECT_EQ(nullptr, queue.peek());
+    queue.tryPush(7);
+
+    ASSERT_NE(nullptr, queue.peek());
+    EXPECT_EQ(7, *queue.peek());
+
+    int item = 0;
+    ASSERT_TRUE(queue.tryPop(item));
+    EXPECT_EQ(7, item);
+}
+
+TEST(mpsc_queue_tests, drain_hands_over_all_items_and_releases_them) {
+    MPSCQueue<std::shared_ptr<int>> queue(8);
+    auto shared = std::make_shared<int>(1);
+
+    for (int i = 0; i < 5; ++i) {
+        queue.tryPush(shared);
+    }
+
+    EXPECT_EQ(6, shared.use_count());
+
+    int count = 0;
+    EXPECT_EQ(5U, queue.drain([&count](const std::shared_ptr<int> &item) { count += *item; }));
+    EXPECT_EQ(5, count);
+    EXPECT_EQ(1, shared.use_count());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(mpsc_queue_tests, drain_leaves_items_pushed_during_drain) {
+    MPSCQueue<int> queue(8);
+    queue.tryPush(1);
+    queue.tryPush(2);
+
+    EXPECT_EQ(2U, queue.drain([&queue](int item) { queue.tryPush(item + 10); }));
+
+    std::vector<int> rest;
+    EXPECT_EQ(2U, queue.drain([&rest](int item) { rest.push_back(item); }));
+    EXPECT_EQ((std::vector<int>{11, 12}), rest);
+}
+
+TEST(mpsc_queue_tests, delivers_every_item_of_concurrent_producers_in_producer_order) {
+    constexpr int producers = 4;
+    constexpr int itemsPerProducer = 20'000;
+    MPSCQueue<int> queue(64);
+    std::vector<std::thread> threads;
+
+    for (int producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&queue, producer] {
+            for (int i = 0; i < itemsPerProducer; ++i) {
+                while (!queue.tryPush(producer * itemsPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    bool ordered = true;
+
+    while (received < producers * itemsPerProducer) {
+        received += static_cast<int>(queue.drain([&](int item) {
+            const int producer = item / itemsPerProducer;
+            ordered = ordered && item % itemsPerProducer == next[producer];
+            ++next[producer];
+        }));
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(std::vector<int>(producers, itemsPerProducer), next);
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,179 @@
+#include "map/PersistenceQueue.hpp"
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+using map::PersistenceQueue;
+using Row = PersistenceQueue::FieldWrite::Row;
+
+class persistence_queue_tests : public ::testing::Test {
+public:
+    std::mutex mutex;
+    std::vector<PersistenceQueue::Batch> batches;
+    bool fail = false;
+    // a field the database refuses, failing every batch it is part of
+    std::optional<position> broken;
+    PersistenceQueue queue{[this](const PersistenceQueue::Batch &batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (fail) {
+            throw std::runtime_error("database gone");
+        }
+
+        for (const auto &change : batch) {
+            if (change.first == broken) {
+                throw std::runtime_error("broken field");
+            }
+        }
+
+        batches.push_back(batch);
+    }};
+    const position here{1, 2, 3};
+    const position there{4, 5, 6};
+
+    auto written() -> std::vector<std::pair<position, PersistenceQueue::FieldWrite>> {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::pair<position, PersistenceQueue::FieldWrite>> writes;
+
+        for (const auto &batch : batches) {
+            writes.insert(writes.end(), batch.begin(), batch.end());
+        }
+
+        return writes;
+    }
+};
+
+TEST_F(persistence_queue_tests, flush_writes_everything) {
+    queue.updateField(here, 5, 6);
+    queue.updateField(there, 7, 8);
+    queue.flush();
+
+    const auto writes = written();
+    ASSERT_EQ(2, writes.size());
+
+    for (const auto &[pos, write] : writes) {
+        EXPECT_EQ(Row::update, write.row);
+        EXPECT_FALSE(write.itemsChanged);
+        EXPECT_FALSE(write.warpChanged);
+        EXPECT_EQ(pos == here ? 5 : 7, write.tile);
+    }
+
+    const auto statistics = queue.getStatistics();
+    EXPECT_EQ(0, statistics.depth);
+    EXPECT_EQ(2, statistics.queued);
+    EXPECT_EQ(2, statistics.written);
+}
+
+TEST_F(persistence_queue_tests, merges_changes_of_a_field) {
+    queue.updateItems(here, {Item(1, 1, 0)});
+    queue.updateItems(here, {Item(2, 1, 0), Item(3, 1, 0)});
+    queue.updateField(here, 1, 0);
+    queue.updateField(here, 2, 3);
+    queue.updateWarp(here, position(7, 7, 7));
+    queue.updateWarp(here, std::nullopt);
+    queue.flush();
+
+    const auto writes = written();
+    ASSERT_EQ(1, writes.size());
+    const auto &write = writes.front().second;
+    EXPECT_EQ(here, writes.front().first);
+    EXPECT_EQ(Row::update, write.row);
+    EXPECT_EQ(2, write.tile);
+    EXPECT_EQ(3, write.music);
+    EXPECT_TRUE(write.itemsChanged);
+    ASSERT_EQ(2, write.items.size());
+    EXPECT_EQ(2, write.items.front().getId());
+    EXPECT_TRUE(write.warpChanged);
+    EXPECT_FALSE(write.warptarget);
+    EXPECT_EQ(5, queue.getStatistics().merged);
+}
+
+TEST_F(persistence_queue_tests, merges_row_changes) {
+    queue.insertField(here, 1, 0);
+    queue.updateField(here, 2, 0);
+    queue.removeField(there);
+    queue.insertField(there, 3, 0);
+    queue.updateField(there, 4, 0);
+    queue.flush();
+
+    auto writes = written();
+    ASSERT_EQ(2, writes.size());
+
+    for (const auto &[pos, write] : writes) {
+        if (pos == here) {
+            EXPECT_EQ(Row::insert, write.row);
+            EXPECT_EQ(2, write.tile);
+        } else {
+            EXPECT_EQ(Row::replace, write.row);
+            EXPECT_EQ(4, write.tile);
+        }
+    }
+
+    queue.insertField(here, 1, 0);
+    queue.removeField(here);
+    queue.flush();
+
+    writes = written();
+    ASSERT_EQ(3, writes.size());
+    EXPECT_EQ(Row::remove, writes.back().second.row);
+}
+
+TEST_F(persistence_queue_tests, limits_batch_size) {
+    const auto fields = PersistenceQueue::maxFieldsPerBatch + 1;
+
+    for (size_t i = 0; i < fields; ++i) {
+        queue.updateField(position(i, 0, 0), 1, 0);
+    }
+
+    queue.flush();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(2, batches.size());
+    EXPECT_EQ(PersistenceQueue::maxFieldsPerBatch, batches.front().size());
+    EXPECT_EQ(1, batches.back().size());
+}
+
+TEST_F(persistence_queue_tests, counts_failed_batches) {
+    fail = true;
+    queue.updateField(here, 1, 0);
+    queue.flush();
+
+    const auto statistics = queue.getStatistics();
+    EXPECT_EQ(1, statistics.batches);
+    EXPECT_EQ(1, statistics.failedBatches);
+    EXPECT_EQ(1, statistics.lost);
+    EXPECT_EQ(0, statistics.written);
+}
+
+TEST_F(persistence_queue_tests, failed_batch_is_written_field_by_field) {
+    broken = there;
+    queue.updateField(here, 1, 0);
+    queue.updateField(there, 2, 0);
+    queue.updateField(position(7, 8, 9), 3, 0);
+    queue.flush();
+
+    const auto writes = written();
+    ASSERT_EQ(2, writes.size());
+
+    for (const auto &[pos, write] : writes) {
+        EXPECT_FALSE(pos == there);
+    }
+
+    const auto statistics = queue.getStatistics();
+    EXPECT_EQ(2, statistics.written);
+    EXPECT_EQ(1, statistics.lost);
+    EXPECT_EQ(2, statistics.failedBatches);
+}
+
+TEST(persistence_queue, writes_on_destruction) {
+    size_t writes = 0;
+
+    {
+        PersistenceQueue queue([&writes](const PersistenceQueue::Batch &batch) { writes += batch.size(); });
+        queue.updateField(position(1, 2, 3), 1, 0);
+    }
+
+    EXPECT_EQ(1, writes);
+}
@@ -0,0 +1,62 @@
+#include "PlayerSnapshot.hpp"
+
+#include <gtest/gtest.h>
+
+class player_snapshot_tests : public ::testing::Test {
+public:
+    PlayerSnapshot snapshot;
+    PlayerSnapshot::Tables saved;
+
+    player_snapshot_tests() {
+        saved.introductions = {2, 3};
+        saved.namings = {{2, "Bob"}};
+        saved.skills = {{1, 20, 300}, {2, 10, 0}};
+        saved.items = {{1, 0, 0, 97, 255, 1, 333, 0}, {18, 1, 0, 320, 255, 5, 333, 3}};
+        saved.itemData = {{18, "nameEn", "Apple"}};
+        snapshot.tables = saved;
+        snapshot.effects = {{5, 10, 1, {{"level", 2}}}};
+    }
+};
+
+TEST_F(player_snapshot_tests, unchanged_tables_are_skipped) {
+    snapshot.markChanges(saved);
+
+    EXPECT_FALSE(snapshot.introductionsChanged);
+    EXPECT_FALSE(snapshot.namingsChanged);
+    EXPECT_FALSE(snapshot.skillsChanged);
+    EXPECT_FALSE(snapshot.itemsChanged);
+    // chars, player and the effect with its value
+    EXPECT_EQ(4, snapshot.rows());
+}
+
+TEST_F(player_snapshot_tests, changed_tables_are_written) {
+    snapshot.tables.skills.back().minor = 1;
+    snapshot.tables.itemData.front().value = "Pear";
+    snapshot.markChanges(saved);
+
+    EXPECT_FALSE(snapshot.introductionsChanged);
+    EXPECT_FALSE(snapshot.namingsChanged);
+    EXPECT_TRUE(snapshot.skillsChanged);
+    EXPECT_TRUE(snapshot.itemsChanged);
+    EXPECT_EQ(4 + 2 + 3, snapshot.rows());
+}
+
+TEST_F(player_snapshot_tests, everything_is_written_without_saved_state) {
+    snapshot.markChanges({});
+
+    EXPECT_TRUE(snapshot.introductionsChanged);
+    EXPECT_TRUE(snapshot.namingsChanged);
+    EXPECT_TRUE(snapshot.skillsChanged);
+    EXPECT_TRUE(snapshot.itemsChanged);
+    EXPECT_EQ(4 + 2 + 1 + 2 + 3, snapshot.rows());
+}
+
+TEST_F(player_snapshot_tests, everything_is_written_after_a_failed_save) {
+    snapshot.markChanges(saved);
+    snapshot.markAllChanged();
+
+    EXPECT_TRUE(snapshot.introductionsChanged);
+    EXPECT_TRUE(snapshot.namingsChanged);
+    EXPECT_TRUE(snapshot.skillsChanged);
+    EXPECT_TRUE(snapshot.itemsChanged);
+}
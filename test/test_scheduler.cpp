@@ -0,0 +1,279 @@
+#include "Scheduler.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// time only moves when the test says so
+struct TestClock {
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<TestClock>;
+    static constexpr bool is_steady = true;
+
+    static auto now() -> time_point { return current; }
+    static void advance(duration by) { current += by; }
+
+    static time_point current;
+};
+
+TestClock::time_point TestClock::current{};
+
+class scheduler_tests : public ::testing::Test {
+protected:
+    // runs everything that is due, after moving the clock
+    void advance(TestClock::duration by) {
+        TestClock::advance(by);
+        scheduler.run_once(0ns);
+    }
+
+    ClockBasedScheduler<TestClock> scheduler;
+};
+
+TEST_F(scheduler_tests, oneshot_task_runs_once_when_due) {
+    int runs = 0;
+    scheduler.addOneshotTask([&runs] { ++runs; }, 10ms, "oneshot");
+
+    advance(9ms);
+    EXPECT_EQ(0, runs);
+    advance(1ms);
+    EXPECT_EQ(1, runs);
+    advance(1s);
+    EXPECT_EQ(1, runs);
+    EXPECT_EQ(0U, scheduler.size());
+}
+
+TEST_F(scheduler_tests, recurring_task_runs_every_interval) {
+    int runs = 0;
+    const auto handle = scheduler.addRecurringTask([&runs] { ++runs; }, 100ms, "recurring");
+
+    for (int i = 0; i < 10; ++i) {
+        advance(100ms);
+    }
+
+    EXPECT_EQ(10, runs);
+    EXPECT_TRUE(scheduler.isScheduled(handle));
+}
+
+TEST_F(scheduler_tests, cancelled_task_does_not_run) {
+    int runs = 0;
+    auto handle = scheduler.addOneshotTask([&runs] { ++runs; }, 10ms, "cancelled");
+
+    EXPECT_TRUE(scheduler.cancel(handle));
+    EXPECT_FALSE(handle.isValid());
+    EXPECT_FALSE(scheduler.cancel(handle));
+    advance(1s);
+    EXPECT_EQ(0, runs);
+}
+
+TEST_F(scheduler_tests, handle_of_finished_task_does_not_match_later_task) {
+    auto first = scheduler.addOneshotTask([] {}, 1ms, "first");
+    advance(1ms);
+    EXPECT_FALSE(scheduler.isScheduled(first));
+
+    int runs = 0;
+    scheduler.addOneshotTask([&runs] { ++runs; }, 1ms, "second");
+    EXPECT_FALSE(scheduler.cancel(first));
+    advance(1ms);
+    EXPECT_EQ(1, runs);
+}
+
+TEST_F(scheduler_tests, reschedule_moves_next_run) {
+    int runs = 0;
+    const auto handle = scheduler.addOneshotTask([&runs] { ++runs; }, 10ms, "rescheduled");
+
+    advance(5ms);
+    EXPECT_TRUE(scheduler.reschedule(handle, 20ms));
+    advance(10ms);
+    EXPECT_EQ(0, runs);
+    advance(10ms);
+    EXPECT_EQ(1, runs);
+}
+
+TEST_F(scheduler_tests, task_may_cancel_or_reschedule_itself) {
+    int runs = 0;
+    TaskHandle handle;
+    handle = scheduler.addRecurringTask(
+            [&] {
+                if (++runs == 3) {
+                    scheduler.cancel(handle);
+                }
+            },
+            10ms, "self cancelling");
+
+    for (int i = 0; i < 10; ++i) {
+        advance(10ms);
+    }
+
+    EXPECT_EQ(3, runs);
+
+    int oneshotRuns = 0;
+    TaskHandle oneshot;
+    oneshot = scheduler.addOneshotTask(
+            [&] {
+                if (++oneshotRuns < 3) {
+                    scheduler.reschedule(oneshot, 50ms);
+                }
+            },
+            10ms, "self rescheduling");
+
+    for (int i = 0; i < 20; ++i) {
+        advance(10ms);
+    }
+
+    EXPECT_EQ(3, oneshotRuns);
+    EXPECT_EQ(0U, scheduler.size());
+}
+
+TEST_F(scheduler_tests, task_may_cancel_task_due_at_same_time) {
+    int runs = 0;
+    TaskHandle second;
+    scheduler.addOneshotTask([&] { scheduler.cancel(second); }, 10ms, "first");
+    second = scheduler.addOneshotTask([&runs] { ++runs; }, 10ms, "second");
+
+    advance(10ms);
+
+    // whichever ran first, the second one must not run after being cancelled
+    EXPECT_LE(runs, 1);
+    EXPECT_EQ(0U, scheduler.size());
+}
+
+TEST_F(scheduler_tests, far_tasks_run_on_time) {
+    std::vector<std::chrono::milliseconds> delays = {300ms, 70s, 5h, std::chrono::hours(24 * 60)};
+    std::vector<TestClock::time_point> ranAt(delays.size());
+    const auto start = TestClock::now();
+
+    for (size_t i = 0; i < delays.size(); ++i) {
+        scheduler.addOneshotTask([&ranAt, i] { ranAt[i] = TestClock::now(); }, delays[i], "far");
+    }
+
+    // in steps of a minute, so the tasks are at most that late
+    while (scheduler.size() > 0) {
+        advance(1min);
+    }
+
+    for (size_t i = 0; i < delays.size(); ++i) {
+        EXPECT_GE(ranAt[i] - start, delays[i]);
+        EXPECT_LT(ranAt[i] - start, delays[i] + 1min);
+    }
+}
+
+TEST_F(scheduler_tests, random_tasks_run_in_due_order) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> delay(1, 100'000);
+    std::vector<int> due;
+    std::vector<int> ran;
+
+    for (int i = 0; i < 10'000; ++i) {
+        const int milliseconds = delay(random);
+        due.push_back(milliseconds);
+        scheduler.addOneshotTask([&ran, milliseconds] { ran.push_back(milliseconds); },
+                                 std::chrono::milliseconds(milliseconds), "random");
+    }
+
+    while (scheduler.size() > 0) {
+        advance(7ms);
+    }
+
+    std::sort(due.begin(), due.end());
+    EXPECT_EQ(due, ran);
+}
+
+TEST_F(scheduler_tests, idle_task_gets_time_until_next_task) {
+    std::vector<std::chrono::nanoseconds> idle;
+    scheduler.setIdleTask([&idle](std::chrono::nanoseconds available) { idle.push_back(available); });
+    scheduler.addRecurringTask([] {}, 100ms, "recurring");
+
+    // the task is due, so nothing is waited for
+    TestClock::advance(100ms);
+    scheduler.run_once(1s);
+    ASSERT_EQ(1U, idle.size());
+    EXPECT_EQ(100ms, idle[0]);
+
+    TestClock::advance(100ms);
+    scheduler.run_once(30ms);
+    ASSERT_EQ(2U, idle.size());
+    EXPECT_EQ(30ms, idle[1]);
+}
+
+TEST_F(scheduler_tests, idle_task_does_not_run_without_time_left) {
+    int runs = 0;
+    scheduler.setIdleTask([&runs](std::chrono::nanoseconds /*available*/) { ++runs; });
+    scheduler.addRecurringTask([] {}, 100ms, "recurring");
+
+    advance(100ms);
+    EXPECT_EQ(0, runs);
+}
+
+TEST_F(scheduler_tests, profiling_is_off_by_default) {
+    scheduler.addOneshotTask([] {}, 1ms, "unprofiled");
+    advance(1ms);
+
+    EXPECT_FALSE(scheduler.isProfiling());
+    EXPECT_TRUE(scheduler.getTaskStatistics().empty());
+    EXPECT_EQ(0U, scheduler.getTickStatistics().ticks);
+}
+
+TEST_F(scheduler_tests, profiling_measures_tasks_by_name) {
+    scheduler.setProfiling(true);
+    scheduler.setTickBudget(50ms);
+
+    // the fake clock lets the tasks take as long as wanted
+    scheduler.addRecurringTask([] { TestClock::advance(10ms); }, 1s, "short");
+    scheduler.addRecurringTask([] { TestClock::advance(60ms); }, 1s, "long");
+    scheduler.addOneshotTask([] { TestClock::advance(1ms); }, 1s, "short");
+
+    // the tasks push the clock, but every round stays within its second
+    for (int i = 0; i < 3; ++i) {
+        advance(1s);
+    }
+
+    const auto statistics = scheduler.getTaskStatistics();
+    ASSERT_EQ(2U, statistics.size());
+
+    const auto &longTask = statistics[0];
+    EXPECT_EQ("long", longTask.name);
+    EXPECT_EQ(3U, longTask.runs);
+    EXPECT_EQ(180ms, longTask.totalDuration);
+    EXPECT_EQ(60ms, longTask.maxDuration);
+    EXPECT_EQ(3U, longTask.overruns);
+
+    const auto &shortTask = statistics[1];
+    EXPECT_EQ("short", shortTask.name);
+    EXPECT_EQ(4U, shortTask.runs);
+    EXPECT_EQ(31ms, shortTask.totalDuration);
+    EXPECT_EQ(0U, shortTask.overruns);
+
+    uint64_t runs = 0;
+
+    for (auto count : shortTask.lateness) {
+        runs += count;
+    }
+
+    EXPECT_EQ(shortTask.runs, runs);
+
+    const auto ticks = scheduler.getTickStatistics();
+    EXPECT_EQ(3U, ticks.ticks);
+    EXPECT_EQ(3U, ticks.overruns);
+
+    scheduler.resetStatistics();
+    EXPECT_TRUE(scheduler.getTaskStatistics().empty());
+    EXPECT_EQ(0U, scheduler.getTickStatistics().ticks);
+}
+
+TEST_F(scheduler_tests, profiling_buckets_lateness) {
+    scheduler.setProfiling(true);
+    scheduler.addOneshotTask([] {}, 10ms, "on time");
+    scheduler.addOneshotTask([] {}, 10ms - 7ms, "late");
+    advance(10ms);
+
+    for (const auto &statistics : scheduler.getTaskStatistics()) {
+        // 7ms late is between the 5ms and the 10ms limit
+        const size_t bucket = statistics.name == "late" ? 3 : 0;
+        EXPECT_EQ(1U, statistics.lateness[bucket]) << statistics.name;
+    }
+}
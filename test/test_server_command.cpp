@@ -0,0 +1,50 @@
+#include "netinterface/CommandBufferPool.hpp"
+#include "netinterface/protocol/ServerCommands.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+TEST(server_command_tests, freeze_finalises_header_once) {
+    MoveAckTC cmd(4711, position(1, 2, 3), NORMALMOVE, 700);
+    EXPECT_FALSE(cmd.isFrozen());
+
+    cmd.freeze();
+    const std::vector<char> encoded(cmd.cmdData().begin(), cmd.cmdData().begin() + cmd.getLength());
+    cmd.freeze();
+
+    EXPECT_TRUE(cmd.isFrozen());
+    EXPECT_TRUE(std::equal(encoded.begin(), encoded.end(), cmd.cmdData().begin()));
+
+    const auto dataLength = (static_cast<unsigned char>(encoded[2]) << 8) | static_cast<unsigned char>(encoded[3]);
+    EXPECT_EQ(cmd.getLength() - 6, dataLength);
+}
+
+TEST(server_command_tests, buffers_of_dropped_commands_are_reused) {
+    auto &pool = CommandBufferPool::get();
+
+    { GraphicEffectTC warmUp(position(1, 2, 3), 1); }
+
+    const auto before = pool.getStatistics();
+
+    for (int i = 0; i < 10; ++i) {
+        GraphicEffectTC cmd(position(1, 2, 3), 1);
+    }
+
+    const auto after = pool.getStatistics();
+    EXPECT_EQ(before.allocations, after.allocations);
+    EXPECT_EQ(before.reuses + 10, after.reuses);
+}
+
+TEST(server_command_tests, oversized_buffers_are_not_pooled) {
+    auto &pool = CommandBufferPool::get();
+    const auto before = pool.getStatistics();
+
+    pool.release(CommandBufferPool::Buffer(CommandBufferPool::maxBufferSize + 1));
+
+    EXPECT_EQ(before.pooled, pool.getStatistics().pooled);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
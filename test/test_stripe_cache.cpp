@@ -0,0 +1,72 @@
+#include "StripeCache.hpp"
+
+#include <gtest/gtest.h>
+
+class stripe_cache_tests : public ::testing::Test {
+public:
+    StripeCache cache;
+    const NewClientView::StripeRequest right{position(10, 20, 0), NewClientView::dir_right, 5};
+    const NewClientView::StripeRequest down{position(10, 20, 0), NewClientView::dir_down, 5};
+    const std::vector<char> data = {1, 2, 3, char(200)};
+    static constexpr auto classic = NewClientView::encoding_classic;
+    static constexpr auto compact = NewClientView::encoding_compact;
+
+    stripe_cache_tests() {
+        cache.insert(right, classic, std::make_shared<StripeCache::Stripe>(StripeCache::Stripe{data, 206}));
+        cache.insert(down, classic, std::make_shared<StripeCache::Stripe>(StripeCache::Stripe{data, 206}));
+    }
+};
+
+TEST_F(stripe_cache_tests, find) {
+    const auto stripe = cache.find(right, classic);
+    ASSERT_NE(nullptr, stripe);
+    EXPECT_EQ(data, stripe->bytes);
+    EXPECT_EQ(206, stripe->checkSum);
+
+    EXPECT_EQ(nullptr, cache.find({position(10, 20, 0), NewClientView::dir_right, 4}, classic));
+    EXPECT_EQ(nullptr, cache.find({position(11, 21, 0), NewClientView::dir_right, 5}, classic));
+    EXPECT_EQ(nullptr, cache.find({position(10, 20, 1), NewClientView::dir_right, 5}, classic));
+
+    EXPECT_EQ(1, cache.getStatistics().hits);
+    EXPECT_EQ(3, cache.getStatistics().misses);
+    EXPECT_EQ(data.size(), cache.getStatistics().bytesSaved);
+    EXPECT_DOUBLE_EQ(0.25, cache.hitRate());
+}
+
+TEST_F(stripe_cache_tests, encodings) {
+    EXPECT_EQ(nullptr, cache.find(right, compact));
+
+    cache.insert(right, compact, std::make_shared<StripeCache::Stripe>(StripeCache::Stripe{{char(5)}, 5}));
+    ASSERT_NE(nullptr, cache.find(right, compact));
+    EXPECT_EQ(5, cache.find(right, compact)->checkSum);
+    ASSERT_NE(nullptr, cache.find(right, classic));
+    EXPECT_EQ(206, cache.find(right, classic)->checkSum);
+
+    cache.invalidate(position(12, 22, 0));
+    EXPECT_EQ(nullptr, cache.find(right, compact));
+    EXPECT_EQ(nullptr, cache.find(right, classic));
+}
+
+TEST_F(stripe_cache_tests, invalidate_field_on_stripe) {
+    cache.invalidate(position(14, 24, 0));
+    EXPECT_EQ(nullptr, cache.find(right, classic));
+    EXPECT_NE(nullptr, cache.find(down, classic));
+
+    cache.invalidate(position(8, 22, 0));
+    EXPECT_EQ(nullptr, cache.find(down, classic));
+}
+
+TEST_F(stripe_cache_tests, invalidate_field_off_stripe) {
+    cache.invalidate(position(15, 25, 0));
+    cache.invalidate(position(9, 19, 0));
+    cache.invalidate(position(11, 20, 0));
+    cache.invalidate(position(12, 22, 1));
+    EXPECT_NE(nullptr, cache.find(right, classic));
+    EXPECT_NE(nullptr, cache.find(down, classic));
+}
+
+TEST_F(stripe_cache_tests, clear) {
+    cache.clear();
+    EXPECT_EQ(nullptr, cache.find(right, classic));
+    EXPECT_EQ(nullptr, cache.find(down, classic));
+}
@@ -0,0 +1,46 @@
+#include "thread_safe_vector.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST(thread_safe_vector_tests, wait_times_out_when_empty) {
+    thread_safe_vector<int> queue;
+    int item = 0;
+    EXPECT_FALSE(queue.wait_pop_front(item, 10ms));
+}
+
+TEST(thread_safe_vector_tests, wait_returns_queued_item_in_order) {
+    thread_safe_vector<int> queue;
+    queue.push_back(1);
+    queue.push_back(2);
+    int item = 0;
+
+    ASSERT_TRUE(queue.wait_pop_front(item, 0ms));
+    EXPECT_EQ(1, item);
+    ASSERT_TRUE(queue.wait_pop_front(item, 0ms));
+    EXPECT_EQ(2, item);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(thread_safe_vector_tests, push_wakes_waiting_thread) {
+    thread_safe_vector<int> queue;
+    int item = 0;
+    bool received = false;
+
+    std::thread waiter([&] { received = queue.wait_pop_front(item, 10s); });
+    std::this_thread::sleep_for(10ms);
+    const auto pushed = std::chrono::steady_clock::now();
+    queue.push_back(42);
+    waiter.join();
+
+    EXPECT_TRUE(received);
+    EXPECT_EQ(42, item);
+    EXPECT_LT(std::chrono::steady_clock::now() - pushed, 5s);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,46 @@
+#include "WorkerPool.hpp"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(worker_pool_tests, threads_start_with_the_first_shared_batch) {
+    WorkerPool pool(4);
+    EXPECT_FALSE(pool.isStarted());
+
+    int calls = 0;
+    pool.run(1, [&calls](size_t /*job*/) { ++calls; });
+    EXPECT_EQ(1, calls);
+    EXPECT_FALSE(pool.isStarted());
+
+    std::atomic<int> sharedCalls = 0;
+    pool.run(2, [&sharedCalls](size_t /*job*/) { ++sharedCalls; });
+    EXPECT_EQ(2, sharedCalls);
+    EXPECT_TRUE(pool.isStarted());
+}
+
+TEST(worker_pool_tests, every_job_runs_once) {
+    WorkerPool pool(3);
+
+    for (size_t jobs : {2, 3, 4, 100}) {
+        std::vector<std::atomic<int>> calls(jobs);
+
+        for (int batch = 0; batch < 50; ++batch) {
+            pool.run(jobs, [&calls](size_t job) { ++calls[job]; });
+        }
+
+        for (const auto &count : calls) {
+            EXPECT_EQ(50, count);
+        }
+    }
+}
+
+TEST(worker_pool_tests, without_threads_jobs_run_on_the_caller) {
+    WorkerPool pool(0);
+    std::vector<int> order;
+
+    pool.run(3, [&order](size_t job) { order.push_back(int(job)); });
+
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), order);
+    EXPECT_FALSE(pool.isStarted());
+}